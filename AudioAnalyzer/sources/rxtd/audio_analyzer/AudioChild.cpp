@@ -25,6 +25,7 @@ void AudioChild::vReload() {
 	}
 
 	options = std::move(newOptions);
+	valueHandle = {};
 	setUseResultString(!options.infoRequest.empty());
 
 	if (!options.procName.empty()) {
@@ -41,8 +42,12 @@ double AudioChild::vUpdate() {
 		return 0.0;
 	}
 
+	if (!parent->isHandleValid(valueHandle)) {
+		valueHandle = parent->makeValueHandle(options.procName, options.handlerName, options.channel);
+	}
+
 	try {
-		double result = parent->getValue(options.procName, options.handlerName, options.channel, options.valueIndex);
+		double result = parent->getValue(valueHandle, options.valueIndex);
 		result = options.transformer.apply(result);
 		return result;
 	} catch (AudioParent::InvalidIndexException&) {
@@ -34,6 +34,7 @@ namespace rxtd::audio_analyzer {
 		} options;
 
 		AudioParent* parent = nullptr;
+		AudioParent::ValueHandle valueHandle;
 		mutable option_parsing::OptionParser parser = option_parsing::OptionParser::getDefault();
 
 		Version version;
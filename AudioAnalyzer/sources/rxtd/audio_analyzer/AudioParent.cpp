@@ -14,6 +14,7 @@ void AudioParent::LogHelpers::setLogger(Logger logger) {
 	sourceTypeIsNotRecognized.setLogger(logger);
 	unknownCommand.setLogger(logger);
 	currentDeviceUnknownProp.setLogger(logger);
+	captureUnknownProp.setLogger(logger);
 	unknownSectionVariable.setLogger(logger);
 	processingNotFound.setLogger(logger);
 	channelNotRecognized.setLogger(logger);
@@ -31,6 +32,7 @@ void AudioParent::LogHelpers::reset() {
 	// sourceTypeIsNotRecognized.reset();
 	// unknownCommand.reset();
 	// currentDeviceUnknownProp.reset();
+	// captureUnknownProp.reset();
 	// unknownSectionVariable.reset();
 
 	processingNotFound.reset();
@@ -42,7 +44,7 @@ void AudioParent::LogHelpers::reset() {
 }
 
 AudioParent::AudioParent(Rainmeter&& _rain) :
-	ParentMeasureBase(std::move(_rain)) {
+	ParentMeasureBase(std::move(_rain)), optionProvider(rain) {
 	setUseResultString(false);
 	initLogHelpers();
 
@@ -66,15 +68,17 @@ AudioParent::AudioParent(Rainmeter&& _rain) :
 
 	paramHelper.setParser(parser);
 
+	auto downmix = DownmixMatrix::parse(rain.read(L"Downmix"), parser, logger);
+
 	const auto threadingParams = rain.read(L"threading").asMap(L'|', L' ');
 	auto onDeviceListChange = rain.read(L"callback-onDeviceListChange", false).asString();
-	helper.init(rain, logger, threadingParams, parser, version, blockCaptureLoudnessChange, onDeviceListChange);
+	helper.init(rain, logger, threadingParams, parser, version, blockCaptureLoudnessChange, onDeviceListChange, std::move(downmix));
 	const auto untouchedOptions = threadingParams.getListOfUntouched();
 	if (!untouchedOptions.empty()) {
 		logger.warning(L"threading: unused options: {}", untouchedOptions);
 	}
 
-	paramHelper.setRainmeter(rain);
+	paramHelper.setOptionProvider(optionProvider);
 }
 
 void AudioParent::vReload() {
@@ -100,6 +104,10 @@ void AudioParent::vReload() {
 	}
 
 	if (paramsChanged) {
+		// names in the slots may not exist anymore
+		valueSlots.clear();
+		slotsGeneration++;
+
 		using std_fixes::MapUtils;
 		MapUtils::intersectKeyCollection(clearProcessings, paramHelper.getParseResult());
 		MapUtils::intersectKeyCollection(clearSnapshot, paramHelper.getParseResult());
@@ -151,12 +159,12 @@ double AudioParent::vUpdate() {
 		cleanersExecuted = false;
 	}
 
-	{
-		auto& snapshotData = helper.getSnapshot().data;
-		auto lock = snapshotData.getLock();
-
-		runFinishers(snapshotData._);
+	// child measures and resolve requests will see the same data until the next parent update
+	auto& snapshotData = helper.getSnapshot().data;
+	if (snapshotData.acquire()) {
+		updateValueSlots();
 	}
+	runFinishers(snapshotData.getReadBuffer()._);
 
 	return 1.0;
 }
@@ -256,6 +264,30 @@ void AudioParent::vResolve(array_view<isview> args, string& resolveBufferString)
 		return;
 	}
 
+	if (optionName == L"capture") {
+		if (args.size() < 2) {
+			logHelpers.generic.log(L"resolve: capture: second argument is required");
+			setInvalid(true);
+			return;
+		}
+
+		const auto stats = helper.getCaptureStats();
+		const isview captureProperty = args[1];
+
+		if (captureProperty == L"overruns") {
+			resolveBufferString = std::to_wstring(stats.overruns);
+		} else if (captureProperty == L"lostFrames") {
+			resolveBufferString = std::to_wstring(stats.lostFrames);
+		} else if (captureProperty == L"underruns") {
+			resolveBufferString = std::to_wstring(stats.underruns);
+		} else {
+			logHelpers.captureUnknownProp.log(captureProperty);
+			setInvalid(true);
+		}
+
+		return;
+	}
+
 	if (optionName == L"deviceList") {
 		auto& wrapper = helper.getSnapshot().deviceListWrapper;
 		auto lock = wrapper.getLock();
@@ -338,7 +370,7 @@ void AudioParent::vResolve(array_view<isview> args, string& resolveBufferString)
 
 			buffer_printer::BufferPrinter bp;
 			try {
-				const auto value = getValue(procName, handlerName, channelOpt.value(), ind);
+				const auto value = getValue(makeValueHandle(procName, handlerName, channelOpt.value()), ind);
 				bp.print(value);
 			} catch (InvalidIndexException&) {
 				logger.error(L"fatal error: section variable requested value with out of bounds index");
@@ -364,41 +396,48 @@ void AudioParent::vResolve(array_view<isview> args, string& resolveBufferString)
 	setInvalid(true);
 }
 
-double AudioParent::getValue(isview unitName, isview handlerName, Channel channel, index ind) {
-	if (!helper.getSnapshot().deviceIsAvailable) {
-		return 0.0;
+AudioParent::ValueHandle AudioParent::makeValueHandle(isview unitName, isview handlerName, Channel channel) {
+	ValueHandle result;
+	result.generation = slotsGeneration;
+
+	for (index i = 0; i < static_cast<index>(valueSlots.size()); i++) {
+		const auto& slot = valueSlots[static_cast<size_t>(i)];
+		if (slot.procName == unitName && slot.channel == channel && slot.handlerName == handlerName) {
+			result.slot = i;
+			return result;
+		}
 	}
 
-	auto& data = helper.getSnapshot().data;
-	auto lock = data.getLock();
+	result.slot = static_cast<index>(valueSlots.size());
+	auto& slot = valueSlots.emplace_back();
+	slot.procName = unitName;
+	slot.channel = channel;
+	slot.handlerName = handlerName;
+	updateValueSlot(slot);
 
-	auto procIter = data._.find(unitName);
-	if (procIter == data._.end()) {
-		return 0.0;
-	}
+	return result;
+}
 
-	const auto& processingSnapshot = procIter->second;
-	auto channelSnapshotIter = processingSnapshot.find(channel);
-	if (channelSnapshotIter == processingSnapshot.end()) {
+double AudioParent::getValue(ValueHandle handle, index ind) {
+	if (!helper.getSnapshot().deviceIsAvailable) {
 		return 0.0;
 	}
 
-	auto& channelSnapshot = channelSnapshotIter->second;
-	auto handlerSnapshotIter = channelSnapshot.find(handlerName);
-	if (handlerSnapshotIter == channelSnapshot.end()) {
+	const auto& slot = valueSlots[static_cast<size_t>(handle.slot)];
+	if (slot.values == nullptr) {
 		return 0.0;
 	}
 
-	auto& values = handlerSnapshotIter->second.values;
+	auto& values = *slot.values;
 	const auto layersCount = values.getBuffersCount();
 	if (layersCount == 0) {
-		logger.error(L"{}: {}: value was requested but handler doesn't have values", unitName, handlerName);
+		logger.error(L"{}: {}: value was requested but handler doesn't have values", slot.procName, slot.handlerName);
 		setInvalid(true);
 		throw InvalidIndexException{};
 	}
 	const auto valuesCount = values.getBufferSize();
 	if (ind >= valuesCount) {
-		logger.error(L"{}: {}: there are {} values but index {} was requested", unitName, handlerName, valuesCount, ind);
+		logger.error(L"{}: {}: there are {} values but index {} was requested", slot.procName, slot.handlerName, valuesCount, ind);
 		setInvalid(true);
 		throw InvalidIndexException{};
 	}
@@ -459,6 +498,11 @@ void AudioParent::initLogHelpers() {
 			logger.error(L"unknown device property '{}'", deviceProperty);
 		}
 	);
+	logHelpers.captureUnknownProp.setLogFunction(
+		[](Logger& logger, istring captureProperty) {
+			logger.error(L"unknown capture property '{}'", captureProperty);
+		}
+	);
 	logHelpers.unknownSectionVariable.setLogFunction(
 		[](Logger& logger, istring optionName) {
 			logger.error(L"unknown section variable '{}'", optionName);
@@ -572,8 +616,7 @@ void AudioParent::resolveProp(
 		return;
 	}
 
-	auto& data = helper.getSnapshot().data;
-	auto lock = data.getLock();
+	const auto& data = helper.getSnapshot().data.getReadBuffer()._;
 
 	// "not found" errors below are not logged because we have already checked everything above,
 	// and if we still don't find requested info then it is caused either by delay in updating second thread
@@ -591,9 +634,9 @@ void AudioParent::resolveProp(
 				channelSnapshotIter != processingSnapshot.end()) {
 				auto& channelSnapshot = channelSnapshotIter->second;
 
-				if (auto handlerSnapshotIter = channelSnapshot.find(handlerName);
-					handlerSnapshotIter != channelSnapshot.end()) {
-					return &handlerSnapshotIter->second.handlerSpecificData;
+				if (auto handlerSnapshot = channelSnapshot.find(handlerName);
+					handlerSnapshot != nullptr) {
+					return &handlerSnapshot->handlerSpecificData;
 				}
 			}
 		}
@@ -601,7 +644,7 @@ void AudioParent::resolveProp(
 		return nullptr;
 	};
 
-	handlerExternalData = findExternalData(data._);
+	handlerExternalData = findExternalData(data);
 
 	if (handlerExternalData == nullptr) {
 		handlerExternalData = findExternalData(clearSnapshot);
@@ -641,6 +684,37 @@ void AudioParent::resolveProp(
 	resolveBufferString = context.printer.getBufferView();
 }
 
+void AudioParent::updateValueSlots() {
+	for (auto& slot : valueSlots) {
+		updateValueSlot(slot);
+	}
+}
+
+void AudioParent::updateValueSlot(ValueSlot& slot) {
+	slot.values = nullptr;
+
+	const auto& data = helper.getSnapshot().data.getReadBuffer()._;
+
+	auto procIter = data.find(slot.procName);
+	if (procIter == data.end()) {
+		return;
+	}
+
+	const auto& processingSnapshot = procIter->second;
+	auto channelSnapshotIter = processingSnapshot.find(slot.channel);
+	if (channelSnapshotIter == processingSnapshot.end()) {
+		return;
+	}
+
+	auto& channelSnapshot = channelSnapshotIter->second;
+	auto handlerSnapshot = channelSnapshot.find(slot.handlerName);
+	if (handlerSnapshot == nullptr) {
+		return;
+	}
+
+	slot.values = &handlerSnapshot->values;
+}
+
 void AudioParent::runFinishers(ProcessingOrchestrator::Snapshot& snapshot) const {
 	for (const auto& [procName, procInfo] : paramHelper.getParseResult()) {
 		auto procIter = snapshot.find(procName);
@@ -653,13 +727,12 @@ void AudioParent::runFinishers(ProcessingOrchestrator::Snapshot& snapshot) const
 			ProcessingManager::ChannelSnapshot& channelSnapshot = channelIter->second;
 
 			for (const auto& [handlerName, handlerInfo] : procInfo.handlers) {
-				auto handlerIter = channelSnapshot.find(handlerName);
-				if (handlerIter == channelSnapshot.end()) { continue; }
-				handler::HandlerBase::Snapshot& handlerSnapshot = handlerIter->second;
+				handler::HandlerBase::Snapshot* handlerSnapshot = channelSnapshot.find(handlerName);
+				if (handlerSnapshot == nullptr) { continue; }
 
 				const handler::ExternalMethods::FinishMethodType finisher = handlerInfo.meta.externalMethods.finish;
 				runFinisher(
-					finisher, handlerSnapshot.handlerSpecificData, procName, channel,
+					finisher, handlerSnapshot->handlerSpecificData, procName, channel,
 					handlerName
 				);
 			}
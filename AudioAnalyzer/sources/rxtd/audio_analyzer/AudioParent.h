@@ -4,10 +4,11 @@
 #pragma once
 
 #include "ParentHelper.h"
-#include "Version.h"
-#include "options/ParamHelper.h"
+#include "RainmeterOptionProvider.h"
+#include "rxtd/audio_analyzer/Version.h"
+#include "rxtd/audio_analyzer/options/ParamHelper.h"
+#include "rxtd/audio_analyzer/sound_processing/LogErrorHelper.h"
 #include "rxtd/rainmeter/MeasureBase.h"
-#include "sound_processing/LogErrorHelper.h"
 
 namespace rxtd::audio_analyzer {
 	class AudioParent : public utils::ParentMeasureBase {
@@ -18,6 +19,7 @@ namespace rxtd::audio_analyzer {
 			LogErrorHelper<istring> sourceTypeIsNotRecognized;
 			LogErrorHelper<istring> unknownCommand;
 			LogErrorHelper<istring> currentDeviceUnknownProp;
+			LogErrorHelper<istring> captureUnknownProp;
 			LogErrorHelper<istring> unknownSectionVariable;
 
 			LogErrorHelper<istring> processingNotFound;
@@ -38,6 +40,7 @@ namespace rxtd::audio_analyzer {
 		mutable option_parsing::OptionParser parser = option_parsing::OptionParser::getDefault();
 
 		Version version{};
+		RainmeterOptionProvider optionProvider;
 		options::ParamHelper paramHelper;
 
 		DeviceRequest requestedSource;
@@ -49,12 +52,33 @@ namespace rxtd::audio_analyzer {
 		std::map<istring, ProcessingManager, std::less<>> clearProcessings;
 		ProcessingOrchestrator::Snapshot clearSnapshot;
 
+		struct ValueSlot {
+			istring procName;
+			Channel channel{};
+			istring handlerName;
+
+			// points into current read buffer of the snapshot
+			const std_fixes::Vector2D<float>* values = nullptr;
+		};
+
+		std::vector<ValueSlot> valueSlots;
+		index slotsGeneration = 0;
+
 	public:
 		class InvalidIndexException : public std::runtime_error {
 		public:
 			explicit InvalidIndexException() : runtime_error("") {}
 		};
 
+		/// <summary>
+		/// Identifies values of a handler.
+		/// Is only valid until parent measure options are changed, see #isHandleValid.
+		/// </summary>
+		struct ValueHandle {
+			index slot = -1;
+			index generation = -1;
+		};
+
 		explicit AudioParent(Rainmeter&& rain);
 
 	protected:
@@ -64,11 +88,24 @@ namespace rxtd::audio_analyzer {
 
 	public:
 		/// <summary>
-		/// Returns value of a handler with specified name.
+		/// Finds place of the handler values in the snapshot once,
+		/// so that #getValue doesn't need to search it by names.
+		/// </summary>
+		[[nodiscard]]
+		ValueHandle makeValueHandle(isview unitName, isview handlerName, Channel channel);
+
+		[[nodiscard]]
+		bool isHandleValid(ValueHandle handle) const {
+			return handle.generation == slotsGeneration;
+		}
+
+		/// <summary>
+		/// Returns value of a handler.
+		/// Handle must be valid.
 		/// Function can throw InvalidIndexException when index is out of bounds.
 		/// </summary>
 		[[nodiscard]]
-		double getValue(isview unitName, isview handlerName, Channel channel, index ind);
+		double getValue(ValueHandle handle, index ind);
 
 		Version getVersion() const {
 			return version;
@@ -94,5 +131,9 @@ namespace rxtd::audio_analyzer {
 		);
 
 		void runFinishers(ProcessingOrchestrator::Snapshot& snapshot) const;
+
+		// must be called each time read buffer of the snapshot changes
+		void updateValueSlots();
+		void updateValueSlot(ValueSlot& slot);
 	};
 }
@@ -9,6 +9,7 @@ ParentHelper::~ParentHelper() {
 	threadSafeFields.notificationClient.ref().deinit(enumeratorWrapper);
 	try {
 		stopThread();
+		stopCaptureThread();
 	} catch (...) { }
 }
 
@@ -19,7 +20,8 @@ void ParentHelper::init(
 	option_parsing::OptionParser& parser,
 	Version version,
 	bool suppressVolumeChange,
-	sview devListChangeCallback
+	sview devListChangeCallback,
+	DownmixMatrix downmix
 ) {
 	mainFields.rain = std::move(_rain);
 	mainFields.logger = std::move(_logger);
@@ -64,6 +66,9 @@ void ParentHelper::init(
 	mainFields.orchestrator.setWarnTime(warnTime);
 	mainFields.orchestrator.setKillTimeout(killTimeout);
 
+	const index processingThreads = std::clamp<index>(parser.parse(threadingMap, L"processingThreads").valueOr<index>(1), 1, 16);
+	mainFields.orchestrator.setThreadsCount(processingThreads);
+
 	double bufferSize = 1.0;
 	if (constFields.useThreading) {
 		double updateRate = parser.parse(threadingMap, L"updateRate").valueOr(60.0);
@@ -80,9 +85,47 @@ void ParentHelper::init(
 	mainFields.captureManager.setVersion(constFields.version);
 	mainFields.captureManager.setBufferSizeInSec(bufferSize);
 
+	constFields.useCaptureThread = parser.parse(threadingMap, L"captureThread").valueOr(true);
+	constFields.useSharedCapture = parser.parse(threadingMap, L"sharedCapture").valueOr(false);
+	// processing may stall for this long before audio is lost
+	constFields.captureRingSize = std::max(bufferSize, 0.5) * 2.0;
+
+	if (constFields.useSharedCapture) {
+		// shared stream has its own capture thread
+		constFields.useCaptureThread = false;
+
+		CaptureHub::Params captureParams;
+		captureParams.version = constFields.version;
+		captureParams.bufferSizeSec = bufferSize;
+		captureParams.ringSizeSec = constFields.captureRingSize;
+		captureParams.suppressVolumeChange = suppressVolumeChange;
+		mainFields.sharedCapture.setParams(captureParams);
+		mainFields.sharedCapture.setLogger(mainFields.logger);
+	}
+
+	// capture thread copies only the channels of the device,
+	// so downmix is done by the source that is processed,
+	// and shared stream does it once for all subscribers with the same downmix
+	if (constFields.useSharedCapture) {
+		mainFields.sharedCapture.setDownmix(std::move(downmix));
+	} else if (constFields.useCaptureThread) {
+		captureRing.setDownmix(std::move(downmix));
+	} else {
+		mainFields.captureManager.setDownmix(std::move(downmix));
+	}
+
 	requestFields.setUseLocking(constFields.useThreading);
 	threadSleepFields.setUseLocking(constFields.useThreading);
+	captureFields.setUseLocking(constFields.useCaptureThread);
 	snapshot.setThreading(constFields.useThreading);
+
+	if (constFields.useCaptureThread) {
+		captureFields.thread = std::thread{
+			[this]() {
+				captureThreadFunction();
+			}
+		};
+	}
 }
 
 void ParentHelper::setInvalid() {
@@ -200,7 +243,64 @@ void ParentHelper::threadFunction() {
 	CoUninitialize();
 }
 
+void ParentHelper::stopCaptureThread() {
+	if (!captureFields.thread.joinable()) {
+		return;
+	}
+
+	captureFields.runGuarded(
+		[&] {
+			captureFields.stopRequest = true;
+			captureFields.sleepVariable.notify_one();
+		}
+	);
+
+	captureFields.thread.join();
+}
+
+void ParentHelper::captureThreadFunction() {
+	using namespace std::chrono_literals;
+	using clock = std::chrono::high_resolution_clock;
+	static_assert(clock::is_steady);
+
+	const auto res = CoInitializeEx(nullptr, COINIT_MULTITHREADED | COINIT_DISABLE_OLE1DDE);
+
+	if (res != S_OK) {
+		mainFields.logger.error(L"capture thread: CoInitializeEx failed");
+		return;
+	}
+
+	const auto sleepTime = std::chrono::duration_cast<clock::duration>(1.0s * captureTime);
+
+	try {
+		auto captureLock = captureFields.getLock();
+		while (!captureFields.stopRequest) {
+			const auto nextWakeTime = clock::now() + sleepTime;
+
+			// state can only become OK in pUpdate, which also prepares the ring for the new format
+			if (mainFields.captureManager.getState() == CaptureManager::State::eOK
+				&& mainFields.captureManager.capture()) {
+				captureRing.write(mainFields.captureManager.getChannelMixer());
+			}
+
+			// lock is released while waiting
+			captureFields.sleepVariable.wait_until(
+				captureLock, nextWakeTime, [&] {
+					return captureFields.stopRequest;
+				}
+			);
+		}
+	} catch (std::runtime_error&) {
+		mainFields.logger.error(L"capture thread: capture unexpectedly failed");
+		exceptionHappened = true;
+	}
+
+	CoUninitialize();
+}
+
 void ParentHelper::pUpdate() {
+	auto captureLock = captureFields.getLock();
+
 	bool needToUpdateDevice = false;
 	bool needToUpdateHandlers = !mainFields.orchestrator.isValid();
 
@@ -261,26 +361,30 @@ void ParentHelper::pUpdate() {
 	}
 
 	if (mainFields.settings.device.type == CaptureManager::SourceDesc::Type::eID
-		&& changes.removed.find(mainFields.captureManager.getSnapshot().id) != changes.removed.end()) {
+		&& changes.removed.find(getDeviceSnapshot().id) != changes.removed.end()) {
 		mainFields.logger.warning(L"Specified device has been disabled or disconnected");
-		mainFields.captureManager.disconnect();
+		disconnectDevice();
 		needToUpdateDevice = false;
 		snapshot.deviceInfo.runGuarded(
 			[&] {
-				snapshot.deviceInfo._.state = mainFields.captureManager.getState();
+				snapshot.deviceInfo._.state = getDeviceState();
 			}
 		);
 		mainFields.rain.executeCommandAsync(mainFields.callbacks.onDeviceDisconnected);
-	} else if (mainFields.captureManager.getState() == CaptureManager::State::eDEVICE_CONNECTION_ERROR
-		&& changes.stateChanged.count(mainFields.captureManager.getSnapshot().id) > 0) {
+	} else if (getDeviceState() == CaptureManager::State::eDEVICE_CONNECTION_ERROR
+		&& changes.stateChanged.count(getDeviceSnapshot().id) > 0) {
 		needToUpdateDevice = true;
 	}
 
-	if (mainFields.captureManager.getState() == CaptureManager::State::eDEVICE_IS_EXCLUSIVE) {
-		mainFields.captureManager.tryToRecoverFromExclusive();
+	if (getDeviceState() == CaptureManager::State::eDEVICE_IS_EXCLUSIVE) {
+		if (constFields.useSharedCapture) {
+			mainFields.sharedCapture.tryToRecoverFromExclusive();
+		} else {
+			mainFields.captureManager.tryToRecoverFromExclusive();
+		}
 	}
 
-	if (mainFields.captureManager.getState() == CaptureManager::State::eRECONNECT_NEEDED) {
+	if (getDeviceState() == CaptureManager::State::eRECONNECT_NEEDED) {
 		needToUpdateDevice = true;
 	}
 
@@ -292,7 +396,7 @@ void ParentHelper::pUpdate() {
 		}
 	}
 
-	if (!needToUpdateDevice && mainFields.captureManager.getState() != CaptureManager::State::eOK) {
+	if (!needToUpdateDevice && getDeviceState() != CaptureManager::State::eOK) {
 		return;
 	}
 
@@ -303,10 +407,13 @@ void ParentHelper::pUpdate() {
 	// then process current captured data
 	//	which may take some time, so we would miss some data
 	//	if we didn't reconnect to device before processing
+	// capture thread, if it is used, has already grabbed the data into the captureRing,
+	// and shared stream captures on its own
 
-	const bool anyCaptured = mainFields.captureManager.capture();
+	bool anyCaptured = !constFields.useCaptureThread && !constFields.useSharedCapture
+		&& mainFields.captureManager.capture();
 
-	if (mainFields.captureManager.getState() == CaptureManager::State::eRECONNECT_NEEDED) {
+	if (getDeviceState() == CaptureManager::State::eRECONNECT_NEEDED) {
 		needToUpdateDevice = true;
 	}
 
@@ -314,30 +421,37 @@ void ParentHelper::pUpdate() {
 		const bool formatChanged = reconnectToDevice();
 		needToUpdateHandlers |= formatChanged;
 
-		snapshot.deviceIsAvailable = mainFields.captureManager.getState() == CaptureManager::State::eOK;
+		snapshot.deviceIsAvailable = getDeviceState() == CaptureManager::State::eOK;
 		if (!snapshot.deviceIsAvailable) {
 			doDisconnectRoutine();
 			return;
 		}
 		snapshot.deviceInfo.runGuarded(
 			[&] {
-				snapshot.deviceInfo._ = mainFields.captureManager.getSnapshot();
+				snapshot.deviceInfo._ = getDeviceSnapshot();
 			}
 		);
+
+		if (constFields.useCaptureThread) {
+			const index sampleRate = mainFields.captureManager.getSampleRate();
+			captureRing.setFormat(
+				sampleRate,
+				mainFields.captureManager.getChannelLayout(),
+				static_cast<index>(static_cast<double>(sampleRate) * constFields.captureRingSize)
+			);
+		}
 	}
 	if (needToUpdateHandlers) {
 		updateProcessings();
-		snapshot.data.runGuarded(
-			[&] {
-				mainFields.orchestrator.configureSnapshot(snapshot.data._);
-			}
-		);
+		// reader must see new configuration even if nothing is captured
+		syncConfiguration(snapshot.data.getWriteBuffer());
+		snapshot.data.publish();
 	}
 	if (needToUpdateDevice) {
 		// callback may want to use some data from snapshot.data,
 		// that is updated in the "if (needToUpdateHandlers)" branch
 		// so we call the callback in this separate if() branch
-		switch (mainFields.captureManager.getState()) {
+		switch (getDeviceState()) {
 		case CaptureManager::State::eOK:
 			mainFields.rain.executeCommandAsync(mainFields.callbacks.onDeviceChange);
 			break;
@@ -350,45 +464,101 @@ void ParentHelper::pUpdate() {
 		}
 	}
 
-	if (anyCaptured) {
-		mainFields.orchestrator.process(mainFields.captureManager.getChannelMixer());
-		snapshot.data.runGuarded(
+	AudioSource* source = &mainFields.captureManager;
+	if (constFields.useSharedCapture) {
+		source = &mainFields.sharedCapture.getSource();
+		anyCaptured = source->capture();
+
+		const auto stats = mainFields.sharedCapture.getStats();
+		snapshot.captureStats.runGuarded(
 			[&] {
-				mainFields.orchestrator.exchangeData(snapshot.data._);
+				snapshot.captureStats._ = stats;
 			}
 		);
+	} else if (constFields.useCaptureThread) {
+		// processing doesn't touch the device, so capture thread can work while it runs
+		captureLock.unlock();
+
+		anyCaptured = captureRing.capture();
+		source = &captureRing;
+	}
+
+	if (anyCaptured) {
+		mainFields.orchestrator.process(source->getChannelMixer());
+		auto& buffer = snapshot.data.getWriteBuffer();
+		// after exchange orchestrator will write into this buffer,
+		// so it must not be left from older configuration
+		syncConfiguration(buffer);
+		mainFields.orchestrator.exchangeData(buffer._);
+		snapshot.data.publish();
 		mainFields.rain.executeCommandAsync(mainFields.callbacks.onUpdate);
 	}
 }
 
 void ParentHelper::doDisconnectRoutine() {
-	mainFields.captureManager.disconnect();
+	disconnectDevice();
 	mainFields.orchestrator.reset();
 	snapshot.deviceInfo.runGuarded(
 		[&] {
-			snapshot.deviceInfo._.state = mainFields.captureManager.getState();
+			snapshot.deviceInfo._.state = getDeviceState();
 		}
 	);
 	mainFields.rain.executeCommandAsync(mainFields.callbacks.onDeviceDisconnected);
 }
 
 bool ParentHelper::reconnectToDevice() {
-	const auto oldFormat = mainFields.captureManager.getSnapshot().format;
-	mainFields.captureManager.setSource(mainFields.settings.device);
+	const auto oldFormat = getDeviceSnapshot().format;
+	if (constFields.useSharedCapture) {
+		mainFields.sharedCapture.setSource(mainFields.settings.device);
+	} else {
+		mainFields.captureManager.setSource(mainFields.settings.device);
+	}
 
-	if (mainFields.captureManager.getState() != CaptureManager::State::eOK) {
+	if (getDeviceState() != CaptureManager::State::eOK) {
 		return false;
 	}
 
-	return oldFormat != mainFields.captureManager.getSnapshot().format;
+	return oldFormat != getDeviceSnapshot().format;
 }
 
 void ParentHelper::updateProcessings() {
 	mainFields.orchestrator.patch(
 		mainFields.settings.patches, constFields.version,
-		mainFields.captureManager.getSnapshot().format.samplesPerSec,
-		mainFields.captureManager.getSnapshot().format.channelLayout.getOrdered()
+		getDeviceSnapshot().format.samplesPerSec,
+		getDeviceSnapshot().format.channelLayout.getOrdered()
 	);
+	mainFields.configurationId++;
+}
+
+void ParentHelper::syncConfiguration(SnapshotStruct::DataBuffer& buffer) {
+	if (buffer.configurationId == mainFields.configurationId) {
+		return;
+	}
+
+	mainFields.orchestrator.configureSnapshot(buffer._);
+	buffer.configurationId = mainFields.configurationId;
+}
+
+rxtd::audio_analyzer::CaptureManager::State ParentHelper::getDeviceState() const {
+	if (constFields.useSharedCapture) {
+		return mainFields.sharedCapture.getState();
+	}
+	return mainFields.captureManager.getState();
+}
+
+const rxtd::audio_analyzer::CaptureManager::Snapshot& ParentHelper::getDeviceSnapshot() const {
+	if (constFields.useSharedCapture) {
+		return mainFields.sharedCapture.getSnapshot();
+	}
+	return mainFields.captureManager.getSnapshot();
+}
+
+void ParentHelper::disconnectDevice() {
+	if (constFields.useSharedCapture) {
+		mainFields.sharedCapture.disconnect();
+	} else {
+		mainFields.captureManager.disconnect();
+	}
 }
 
 bool ParentHelper::updateDeviceListStrings() {
@@ -4,9 +4,12 @@
 #pragma once
 
 #include "rxtd/DataWithLock.h"
+#include "rxtd/TripleBuffer.h"
+#include "rxtd/audio_analyzer/sound_processing/ProcessingManager.h"
+#include "rxtd/audio_analyzer/sound_processing/ProcessingOrchestrator.h"
+#include "rxtd/audio_analyzer/sound_processing/audio_sources/CaptureRing.h"
 #include "rxtd/rainmeter/Rainmeter.h"
-#include "sound_processing/ProcessingManager.h"
-#include "sound_processing/ProcessingOrchestrator.h"
+#include "sound_processing/device_management/CaptureHub.h"
 #include "sound_processing/device_management/CaptureManager.h"
 #include "wasapi_wrappers/implementations/MediaDeviceListNotificationClient.h"
 
@@ -18,9 +21,15 @@ namespace rxtd::audio_analyzer {
 		using MediaDeviceType = wasapi_wrappers::MediaDeviceType;
 
 		struct SnapshotStruct {
-			struct LockableData : DataWithLock {
+			struct DataBuffer {
 				ProcessingOrchestrator::Snapshot _;
-			} data;
+				// configuration of processings that this buffer was last synchronized with
+				index configurationId = -1;
+			};
+
+			// Written by processing thread, read by main thread.
+			// All readers of the plugin are called from main thread, so one read buffer is enough
+			TripleBuffer<DataBuffer> data;
 
 			struct LockableDeviceInfo : DataWithLock {
 				CaptureManager::Snapshot _;
@@ -30,12 +39,17 @@ namespace rxtd::audio_analyzer {
 				string list;
 			} deviceListWrapper;
 
+			// only used with shared capture, because reader of the shared stream is replaced on reconnection
+			struct LockableCaptureStats : DataWithLock {
+				CaptureRing::Stats _;
+			} captureStats;
+
 			std::atomic<bool> deviceIsAvailable{ false };
 
 			void setThreading(bool value) {
-				data.setUseLocking(value);
 				deviceInfo.setUseLocking(value);
 				deviceListWrapper.setUseLocking(value);
+				captureStats.setUseLocking(value);
 			}
 		};
 
@@ -59,12 +73,21 @@ namespace rxtd::audio_analyzer {
 		};
 
 	private:
+		// WASAPI buffer is at least 1/30 of a second,
+		// so polling it this often leaves enough time for scheduling delays
+		static constexpr double captureTime = 0.01;
+
 		wasapi_wrappers::MediaDeviceEnumerator enumeratorWrapper;
 
 		struct {
 			Version version{};
 			bool useThreading = false;
 			double updateTime{};
+			bool useCaptureThread = false;
+			// length of the captureRing in seconds
+			double captureRingSize{};
+			// device is read by CaptureHub, together with other measures that listen to the same device
+			bool useSharedCapture = false;
 		} constFields;
 
 		struct {
@@ -81,7 +104,9 @@ namespace rxtd::audio_analyzer {
 			Rainmeter rain;
 			Logger logger;
 			CaptureManager captureManager;
+			CaptureHub::Subscription sharedCapture;
 			ProcessingOrchestrator orchestrator;
+			index configurationId = 0;
 
 			struct {
 				CaptureManager::SourceDesc device;
@@ -103,6 +128,17 @@ namespace rxtd::audio_analyzer {
 			bool disconnect = false;
 		} requestFields;
 
+		// Capture thread holds the lock while it reads the device,
+		// processing thread holds it while it manages the device, but not while it processes captured data
+		struct CaptureFields : DataWithLock {
+			std::thread thread;
+			std::condition_variable sleepVariable;
+			bool stopRequest = false;
+		} captureFields;
+
+		// written by capture thread, read by processing thread
+		CaptureRing captureRing;
+
 		SnapshotStruct snapshot;
 		std::atomic_bool exceptionHappened = false;
 
@@ -117,7 +153,8 @@ namespace rxtd::audio_analyzer {
 			option_parsing::OptionParser& parser,
 			Version version,
 			bool suppressVolumeChange,
-			sview devListChangeCallback
+			sview devListChangeCallback,
+			DownmixMatrix downmix
 		);
 
 		void setInvalid();
@@ -134,6 +171,18 @@ namespace rxtd::audio_analyzer {
 
 		void update();
 
+		[[nodiscard]]
+		CaptureRing::Stats getCaptureStats() {
+			if (constFields.useSharedCapture) {
+				return snapshot.captureStats.runGuarded(
+					[&] {
+						return snapshot.captureStats._;
+					}
+				);
+			}
+			return captureRing.getStats();
+		}
+
 		void assertNoExceptions() const;
 
 	private:
@@ -144,13 +193,25 @@ namespace rxtd::audio_analyzer {
 		void stopThread();
 		void threadFunction();
 
+		void stopCaptureThread();
+		void captureThreadFunction();
+
 		void pUpdate();
 		void doDisconnectRoutine();
 		// returns true device format changed, false otherwise
 		bool reconnectToDevice();
 		void updateProcessings();
+		// makes sure that buffer has the same structure as orchestrator snapshot
+		void syncConfiguration(SnapshotStruct::DataBuffer& buffer);
 		bool updateDeviceListStrings();
 
+		// device functions work with either captureManager or sharedCapture
+		[[nodiscard]]
+		CaptureManager::State getDeviceState() const;
+		[[nodiscard]]
+		const CaptureManager::Snapshot& getDeviceSnapshot() const;
+		void disconnectDevice();
+
 		string makeDeviceListString(MediaDeviceType type);
 	};
 }
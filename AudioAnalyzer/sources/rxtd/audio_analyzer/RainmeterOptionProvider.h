@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "rxtd/audio_analyzer/options/OptionProvider.h"
+#include "rxtd/rainmeter/Rainmeter.h"
+
+namespace rxtd::audio_analyzer {
+	class RainmeterOptionProvider : public options::OptionProvider {
+		rainmeter::Rainmeter rain;
+
+	public:
+		explicit RainmeterOptionProvider(rainmeter::Rainmeter rain) : rain(std::move(rain)) {}
+
+		[[nodiscard]]
+		option_parsing::Option read(sview optionName) const override {
+			return rain.read(optionName);
+		}
+
+		[[nodiscard]]
+		string getPathFromCurrent(string folder) const override {
+			return rain.getPathFromCurrent(std::move(folder));
+		}
+
+		[[nodiscard]]
+		Logger createLogger() const override {
+			return rain.createLogger();
+		}
+	};
+}
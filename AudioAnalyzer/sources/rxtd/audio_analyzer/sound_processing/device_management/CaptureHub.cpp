@@ -0,0 +1,255 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "CaptureHub.h"
+
+#include <condition_variable>
+#include <thread>
+
+#include "rxtd/rainmeter/Rainmeter.h"
+
+using rxtd::audio_analyzer::CaptureHub;
+
+using rxtd::winapi_wrappers::ComException;
+
+class CaptureHub::Stream : NonMovableBase {
+	// same as in ParentHelper
+	static constexpr double captureTime = 0.01;
+
+	// guards the manager
+	mutable std::mutex mutex;
+	CaptureManager manager;
+	Snapshot initialSnapshot;
+
+	std::shared_ptr<CaptureFanOut> fanOut;
+
+	std::thread thread;
+	std::condition_variable sleepVariable;
+	bool stopRequest = false;
+
+public:
+	Stream(const SourceDesc& desc, const Params& params, const Logger& logger) {
+		manager.setSuppressVolumeChange(params.suppressVolumeChange);
+		manager.setVersion(params.version);
+		manager.setBufferSizeInSec(params.bufferSizeSec);
+
+		// errors of opening the device are reported to the measure that has asked for it
+		manager.setLogger(logger);
+		manager.setSource(desc);
+
+		// but after that the stream can outlive the measure, so it can't log into the skin of the measure
+		manager.setLogger(rainmeter::Rainmeter{}.createLogger().context(L"Shared capture: "));
+
+		initialSnapshot = manager.getSnapshot();
+		if (manager.getState() != State::eOK) {
+			return;
+		}
+
+		const index sampleRate = manager.getSampleRate();
+		fanOut = std::make_shared<CaptureFanOut>(
+			sampleRate,
+			manager.getChannelLayout(),
+			static_cast<index>(static_cast<double>(sampleRate) * params.ringSizeSec)
+		);
+
+		thread = std::thread{
+			[this]() {
+				threadFunction();
+			}
+		};
+	}
+
+	~Stream() {
+		if (!thread.joinable()) {
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			stopRequest = true;
+			sleepVariable.notify_one();
+		}
+
+		thread.join();
+	}
+
+	[[nodiscard]]
+	const Snapshot& getInitialSnapshot() const {
+		return initialSnapshot;
+	}
+
+	[[nodiscard]]
+	State getState() const {
+		std::lock_guard<std::mutex> lock{ mutex };
+		return manager.getState();
+	}
+
+	void tryToRecoverFromExclusive() {
+		std::lock_guard<std::mutex> lock{ mutex };
+		if (manager.getState() == State::eDEVICE_IS_EXCLUSIVE) {
+			manager.tryToRecoverFromExclusive();
+		}
+	}
+
+	/// <summary>
+	/// Returns nullptr if the stream can't be used by a new subscriber.
+	/// </summary>
+	[[nodiscard]]
+	std::shared_ptr<CaptureFanOut::Reader> createReader(const DownmixMatrix& downmix) const {
+		if (fanOut == nullptr || getState() != State::eOK) {
+			return nullptr;
+		}
+		return fanOut->createReader(downmix);
+	}
+
+private:
+	void threadFunction() {
+		using namespace std::chrono_literals;
+		using clock = std::chrono::high_resolution_clock;
+		static_assert(clock::is_steady);
+
+		const auto res = CoInitializeEx(nullptr, COINIT_MULTITHREADED | COINIT_DISABLE_OLE1DDE);
+
+		if (res != S_OK) {
+			// subscribers will only see underruns
+			return;
+		}
+
+		const auto sleepTime = std::chrono::duration_cast<clock::duration>(1.0s * captureTime);
+
+		try {
+			std::unique_lock<std::mutex> lock{ mutex };
+			while (!stopRequest) {
+				const auto nextWakeTime = clock::now() + sleepTime;
+
+				// after the state has changed subscribers reconnect, and the stream is abandoned
+				if (manager.getState() == State::eOK && manager.capture()) {
+					fanOut->write(manager.getChannelMixer());
+				}
+
+				// lock is released while waiting
+				sleepVariable.wait_until(
+					lock, nextWakeTime, [&] {
+						return stopRequest;
+					}
+				);
+			}
+		} catch (std::runtime_error&) {
+			// subscribers will only see underruns
+		}
+
+		CoUninitialize();
+	}
+};
+
+void CaptureHub::Subscription::setSource(const SourceDesc& desc) {
+	// old stream must be released before the new one is opened:
+	// when reconnection is needed, the old one is no longer valid
+	reader = {};
+	stream = {};
+
+	stream = acquireStream(desc, params, logger, downmix, reader);
+	snapshot = stream->getInitialSnapshot();
+}
+
+void CaptureHub::Subscription::disconnect() {
+	// same as CaptureManager::disconnect:
+	// stream that isn't OK is kept, so that it can detect when the device is available again
+	if (getState() != State::eOK) {
+		return;
+	}
+
+	reader = {};
+	stream = {};
+	snapshot.state = State::eMANUALLY_DISCONNECTED;
+}
+
+CaptureHub::State CaptureHub::Subscription::getState() const {
+	if (stream == nullptr) {
+		return snapshot.state;
+	}
+	return stream->getState();
+}
+
+void CaptureHub::Subscription::tryToRecoverFromExclusive() {
+	if (stream != nullptr) {
+		stream->tryToRecoverFromExclusive();
+	}
+}
+
+CaptureHub::Stats CaptureHub::Subscription::getStats() const {
+	if (reader == nullptr) {
+		return {};
+	}
+	return reader->getStats();
+}
+
+std::shared_ptr<CaptureHub::Stream> CaptureHub::acquireStream(
+	const SourceDesc& desc, const Params& params, const Logger& logger, const DownmixMatrix& downmix,
+	std::shared_ptr<CaptureFanOut::Reader>& reader
+) {
+	static std::mutex mutex;
+	static std::vector<std::weak_ptr<Stream>> streams;
+
+	// streams are identified by the actual device and its format,
+	// so that default device and its explicit ID share a stream
+	std::optional<string> id;
+	std::optional<wasapi_wrappers::WaveFormat> format;
+	try {
+		wasapi_wrappers::MediaDeviceEnumerator enumerator;
+		auto device = [&] {
+			switch (desc.type) {
+			case SourceDesc::Type::eDEFAULT_INPUT:
+				return enumerator.getDefaultDevice(wasapi_wrappers::MediaDeviceType::eINPUT);
+			case SourceDesc::Type::eDEFAULT_OUTPUT:
+				return enumerator.getDefaultDevice(wasapi_wrappers::MediaDeviceType::eOUTPUT);
+			case SourceDesc::Type::eID: break;
+			}
+			return enumerator.getDeviceByID(desc.id);
+		}();
+		id = string{ device.getId() };
+		format = device.openAudioClient().getFormat();
+	} catch (ComException&) {
+		// new stream will log the error
+	} catch (wasapi_wrappers::FormatException&) { }
+
+	std::lock_guard<std::mutex> lock{ mutex };
+
+	if (id.has_value() && format.has_value()) {
+		for (const auto& weak : streams) {
+			auto stream = weak.lock();
+			if (stream == nullptr) {
+				continue;
+			}
+			const auto& streamSnapshot = stream->getInitialSnapshot();
+			if (streamSnapshot.id != id.value() || streamSnapshot.format != format.value()) {
+				continue;
+			}
+
+			reader = stream->createReader(downmix);
+			if (reader != nullptr) {
+				return stream;
+			}
+		}
+	}
+
+	// new stream is created under the lock, so that concurrent subscribers don't open the same device twice
+	auto stream = std::make_shared<Stream>(desc, params, logger);
+	reader = stream->createReader(downmix);
+	if (reader == nullptr) {
+		// stream is kept by the subscriber to track the state of the device, but it can't be shared
+		return stream;
+	}
+
+	streams.erase(
+		std::remove_if(
+			streams.begin(), streams.end(), [](const std::weak_ptr<Stream>& weak) {
+				return weak.expired();
+			}
+		),
+		streams.end()
+	);
+	streams.push_back(stream);
+
+	return stream;
+}
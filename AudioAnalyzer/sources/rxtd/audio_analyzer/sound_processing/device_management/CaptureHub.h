@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+
+#include "CaptureManager.h"
+#include "rxtd/audio_analyzer/sound_processing/audio_sources/CaptureFanOut.h"
+
+namespace rxtd::audio_analyzer {
+	/// <summary>
+	/// Process-wide registry of capture streams.
+	/// All subscribers that listen to the same device with the same format share one stream:
+	/// one WASAPI client, one capture thread and one copy of captured data.
+	/// Each subscriber reads the data through its own CaptureFanOut::Reader,
+	/// so all processing stays separate, and subscribers with the same downmix share the mixing.
+	///
+	/// Stream is closed when its last subscriber is disconnected.
+	/// Parameters of the stream are defined by the subscriber that has opened it.
+	/// </summary>
+	class CaptureHub {
+		class Stream;
+
+	public:
+		using SourceDesc = CaptureManager::SourceDesc;
+		using State = CaptureManager::State;
+		using Snapshot = CaptureManager::Snapshot;
+		using Stats = CaptureFanOut::Stats;
+
+		struct Params {
+			Version version{};
+			double bufferSizeSec = 0.0;
+			// length of the fan-out ring in seconds
+			double ringSizeSec = 0.0;
+			bool suppressVolumeChange = false;
+		};
+
+		/// <summary>
+		/// Counterpart of CaptureManager for shared streams.
+		/// Not thread-safe: all functions must be called from the same thread.
+		/// </summary>
+		class Subscription : MovableOnlyBase {
+			// used by streams that this subscription opens, until the device is opened
+			Logger logger;
+			Params params;
+			DownmixMatrix downmix;
+
+			std::shared_ptr<Stream> stream;
+			std::shared_ptr<CaptureFanOut::Reader> reader;
+			Snapshot snapshot;
+
+		public:
+			void setLogger(Logger value) {
+				logger = std::move(value);
+			}
+
+			void setParams(Params value) {
+				params = value;
+			}
+
+			void setDownmix(DownmixMatrix value) {
+				downmix = std::move(value);
+			}
+
+			void setSource(const SourceDesc& desc);
+
+			void disconnect();
+
+			/// <summary>
+			/// State field is only updated on connection and disconnection,
+			/// use #getState() for the current state.
+			/// </summary>
+			[[nodiscard]]
+			const Snapshot& getSnapshot() const {
+				return snapshot;
+			}
+
+			[[nodiscard]]
+			State getState() const;
+
+			void tryToRecoverFromExclusive();
+
+			/// <summary>
+			/// Only valid when state is OK.
+			/// </summary>
+			[[nodiscard]]
+			AudioSource& getSource() {
+				return *reader;
+			}
+
+			[[nodiscard]]
+			Stats getStats() const;
+		};
+
+	private:
+		[[nodiscard]]
+		static std::shared_ptr<Stream> acquireStream(
+			const SourceDesc& desc, const Params& params, const Logger& logger, const DownmixMatrix& downmix,
+			std::shared_ptr<CaptureFanOut::Reader>& reader
+		);
+	};
+}
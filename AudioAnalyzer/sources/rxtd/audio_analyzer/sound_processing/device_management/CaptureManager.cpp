@@ -177,7 +177,7 @@ bool CaptureManager::capture() {
 		break;
 	}
 
-	channelMixer.createAuto();
+	channelMixer.mix();
 
 	return anyCaptured;
 }
@@ -7,6 +7,7 @@
 
 #include "rxtd/Logger.h"
 #include "rxtd/audio_analyzer/Version.h"
+#include "rxtd/audio_analyzer/sound_processing/AudioSource.h"
 #include "rxtd/audio_analyzer/sound_processing/ChannelMixer.h"
 #include "rxtd/audio_analyzer/wasapi_wrappers/AudioCaptureClient.h"
 #include "rxtd/audio_analyzer/wasapi_wrappers/MediaDeviceEnumerator.h"
@@ -14,7 +15,7 @@
 #include "rxtd/audio_analyzer/wasapi_wrappers/implementations/AudioSessionEventsImpl.h"
 
 namespace rxtd::audio_analyzer {
-	class CaptureManager {
+	class CaptureManager : public AudioSource {
 	public:
 		template<typename T>
 		using GenericComWrapper = winapi_wrappers::GenericComWrapper<T>;
@@ -93,6 +94,10 @@ namespace rxtd::audio_analyzer {
 			bufferSizeSec = std::clamp(value, 0.0, 1.0);
 		}
 
+		void setDownmix(DownmixMatrix value) {
+			channelMixer.setDownmix(std::move(value));
+		}
+
 		void setSource(const SourceDesc& desc) {
 			snapshot.state = setSourceAndGetState(desc);
 		}
@@ -113,11 +118,20 @@ namespace rxtd::audio_analyzer {
 			return snapshot.state;
 		}
 
-		// returns true if at least one buffer was captured
-		bool capture();
+		bool capture() override;
+
+		[[nodiscard]]
+		index getSampleRate() const override {
+			return snapshot.format.samplesPerSec;
+		}
+
+		[[nodiscard]]
+		const ChannelLayout& getChannelLayout() const override {
+			return snapshot.format.channelLayout;
+		}
 
 		[[nodiscard]]
-		const auto& getChannelMixer() const {
+		const ChannelMixer& getChannelMixer() const override {
 			return channelMixer;
 		}
 
@@ -30,45 +30,11 @@ HRESULT AudioCaptureClient::readBuffer() {
 	if (silent) {
 		buffer.fill(0.0);
 	} else {
-		switch (type) {
-		case Type::eInt16:
-			for (index i = 0; i < channelsCount; i++) {
-				copyInt(data, buffer[i], i, channelsCount);
-			}
-			break;
-		case Type::eFloat:
-			for (index i = 0; i < channelsCount; i++) {
-				copyFloat(data, buffer[i], i, channelsCount);
-			}
-			break;
-		}
+		using SampleType = filter_utils::SampleConverter::SampleType;
+		const auto sampleType = type == Type::eInt16 ? SampleType::eINT16 : SampleType::eFLOAT32;
+		converter.deinterleave(reinterpret_cast<const std::byte*>(data), sampleType, buffer);
 	}
 
 	ref().ReleaseBuffer(dataSize);
 	return S_OK;
 }
-
-void AudioCaptureClient::copyFloat(void* source, array_span<float> dest, index offset, index stride) {
-	const auto bufferInt = static_cast<const float*>(source);
-	const auto framesCount = dest.size();
-
-	auto channelSourceBuffer = bufferInt + offset;
-
-	for (index frame = 0; frame < framesCount; ++frame) {
-		dest[frame] = *channelSourceBuffer;
-		channelSourceBuffer += stride;
-	}
-}
-
-void AudioCaptureClient::copyInt(void* source, array_span<float> dest, index offset, index stride) {
-	const auto bufferInt = static_cast<const int16_t*>(source);
-	const auto framesCount = dest.size();
-
-	auto channelSourceBuffer = bufferInt + offset;
-
-	for (index frame = 0; frame < framesCount; ++frame) {
-		const float value = static_cast<float>(*channelSourceBuffer) * (1.0f / static_cast<float>(std::numeric_limits<int16_t>::max()));
-		dest[frame] = value;
-		channelSourceBuffer += stride;
-	}
-}
@@ -8,6 +8,7 @@
 // ReSharper disable once CppWrongIncludesOrder
 #include <Audioclient.h>
 
+#include "rxtd/filter_utils/SampleConverter.h"
 #include "rxtd/std_fixes/Vector2D.h"
 #include "rxtd/winapi_wrappers/GenericComWrapper.h"
 
@@ -27,6 +28,7 @@ namespace rxtd::audio_analyzer::wasapi_wrappers {
 		index channelsCount{};
 
 		Vector2D<float> buffer;
+		filter_utils::SampleConverter converter;
 
 	public:
 		AudioCaptureClient() = default;
@@ -45,10 +47,5 @@ namespace rxtd::audio_analyzer::wasapi_wrappers {
 		std_fixes::array2d_view<float> getBuffer() const {
 			return buffer;
 		}
-
-	private:
-		static void copyFloat(void* source, array_span<float> dest, index offset, index stride);
-
-		static void copyInt(void* source, array_span<float> dest, index offset, index stride);
 	};
 }
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using rxtd::audio_analyzer::benchmark::AllocationCounter;
+
+namespace {
+	std::atomic<rxtd::index> allocationsCount{ 0 };
+	std::atomic<rxtd::index> allocationsBytes{ 0 };
+
+	void* countedAllocate(std::size_t size) {
+		allocationsCount.fetch_add(1, std::memory_order_relaxed);
+		allocationsBytes.fetch_add(static_cast<rxtd::index>(size), std::memory_order_relaxed);
+
+		// malloc(0) is allowed to return nullptr, operator new is not
+		void* result = std::malloc(size == 0 ? 1 : size);
+		if (result == nullptr) {
+			throw std::bad_alloc{};
+		}
+		return result;
+	}
+}
+
+AllocationCounter::Stats AllocationCounter::get() {
+	return { allocationsCount.load(std::memory_order_relaxed), allocationsBytes.load(std::memory_order_relaxed) };
+}
+
+void* operator new(std::size_t size) {
+	return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+	return countedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+
+namespace rxtd::audio_analyzer::benchmark {
+	/// <summary>
+	/// Counts calls to global operator new.
+	/// Counting works by replacing global allocation functions, see AllocationCounter.cpp,
+	/// so it covers everything in the executable, including std containers.
+	/// Over-aligned allocations are not counted.
+	/// </summary>
+	class AllocationCounter {
+	public:
+		struct Stats {
+			index count = 0;
+			index bytes = 0;
+
+			[[nodiscard]]
+			Stats operator+(const Stats& other) const {
+				return { count + other.count, bytes + other.bytes };
+			}
+
+			[[nodiscard]]
+			Stats operator-(const Stats& other) const {
+				return { count - other.count, bytes - other.bytes };
+			}
+		};
+
+		[[nodiscard]]
+		static Stats get();
+	};
+}
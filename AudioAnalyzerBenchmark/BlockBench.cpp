@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "BlockBench.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "rxtd/audio_analyzer/audio_utils/RandomGenerator.h"
+#include "rxtd/filter_utils/BlockKernels.h"
+#include "rxtd/std_fixes/StringUtils.h"
+
+namespace rxtd::audio_analyzer::benchmark {
+	namespace {
+		using BlockKernels = filter_utils::BlockKernels;
+		using InstructionSet = BlockKernels::InstructionSet;
+		using clock = std::chrono::steady_clock;
+
+		struct BenchArguments {
+			index samples = 50'000'000;
+			index chunk = 480;
+		};
+
+		BenchArguments parseBenchArguments(array_view<string> args) {
+			BenchArguments result;
+
+			for (index i = 0; i < args.size(); i += 2) {
+				if (i + 1 >= args.size()) {
+					throw std::runtime_error{ "option without value" };
+				}
+
+				const isview name = args[i] % ciView();
+				const sview value = args[i + 1];
+
+				if (name == L"--samples") {
+					result.samples = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--chunk") {
+					result.chunk = std_fixes::StringUtils::parseInt(value);
+				} else {
+					throw std::runtime_error{ "unknown option" };
+				}
+			}
+
+			if (result.samples <= 0 || result.chunk <= 0) {
+				throw std::runtime_error{ "samples and chunk must be positive" };
+			}
+
+			return result;
+		}
+
+		sview getInstructionSetName(InstructionSet value) {
+			switch (value) {
+			case InstructionSet::eSCALAR: return L"scalar";
+			case InstructionSet::eSSE: return L"SSE";
+			case InstructionSet::eAVX: return L"AVX";
+			}
+			return {};
+		}
+
+		enum class Reduction {
+			eRMS,
+			ePEAK,
+		};
+
+		// checksum makes sure that results are used
+		double runPerSample(Reduction reduction, array_view<float> chunk, index chunksCount, index blockSize, double& checksum) {
+			double sum = 0.0;
+			float peak = 0.0f;
+			index counter = 0;
+
+			const auto begin = clock::now();
+			for (index c = 0; c < chunksCount; c++) {
+				for (const auto x : chunk) {
+					if (reduction == Reduction::eRMS) {
+						sum += x * x;
+					} else {
+						peak = std::max(peak, std::abs(x));
+					}
+					counter++;
+					if (counter >= blockSize) {
+						checksum += sum + static_cast<double>(peak);
+						sum = 0.0;
+						peak = 0.0f;
+						counter = 0;
+					}
+				}
+			}
+			const auto end = clock::now();
+
+			return std::chrono::duration<double, std::milli>{ end - begin }.count();
+		}
+
+		// splits chunks the same way BlockHandler does
+		double runKernels(
+			Reduction reduction, const BlockKernels& kernels,
+			array_view<float> chunk, index chunksCount, index blockSize, double& checksum
+		) {
+			double sum = 0.0;
+			float peak = 0.0f;
+			index counter = 0;
+
+			const auto begin = clock::now();
+			for (index c = 0; c < chunksCount; c++) {
+				array_view<float> wave = chunk;
+				while (!wave.empty()) {
+					const index partSize = std::min(blockSize - counter, wave.size());
+					const array_view<float> part{ wave.data(), partSize };
+					if (reduction == Reduction::eRMS) {
+						sum += kernels.sumOfSquares(part);
+					} else {
+						peak = std::max(peak, kernels.maxAbs(part));
+					}
+					wave.remove_prefix(partSize);
+					counter += partSize;
+
+					if (counter >= blockSize) {
+						checksum += sum + static_cast<double>(peak);
+						sum = 0.0;
+						peak = 0.0f;
+						counter = 0;
+					}
+				}
+			}
+			const auto end = clock::now();
+
+			return std::chrono::duration<double, std::milli>{ end - begin }.count();
+		}
+	}
+
+	int runBlockBench(array_view<string> args) {
+		const BenchArguments benchArgs = parseBenchArguments(args);
+
+		std::vector<float> chunk;
+		chunk.resize(static_cast<size_t>(benchArgs.chunk));
+		audio_utils::RandomGenerator random;
+		for (auto& value : chunk) {
+			value = static_cast<float>(random.next());
+		}
+
+		const index chunksCount = std::max<index>(benchArgs.samples / benchArgs.chunk, 1);
+		const double samplesCount = static_cast<double>(chunksCount * benchArgs.chunk);
+
+		std::wcout << samplesCount << L" samples in chunks of " << benchArgs.chunk << L", time in ns per sample\n";
+
+		double checksum = 0.0;
+		for (const auto reduction : { Reduction::eRMS, Reduction::ePEAK }) {
+			std::wcout << (reduction == Reduction::eRMS ? L"rms\n" : L"peak\n");
+
+			for (const index blockSize : { 1, 4, 16, 64, 256, 1024, 4096 }) {
+				std::wcout << L"  block " << blockSize << L":";
+
+				const double perSampleMs = runPerSample(reduction, chunk, chunksCount, blockSize, checksum);
+				std::wcout << L" per sample " << perSampleMs * 1e6 / samplesCount;
+
+				for (const auto set : { InstructionSet::eSCALAR, InstructionSet::eSSE, InstructionSet::eAVX }) {
+					if (!BlockKernels::isSupported(set)) {
+						continue;
+					}
+					const double timeMs = runKernels(reduction, BlockKernels{ set }, chunk, chunksCount, blockSize, checksum);
+					std::wcout << L", " << getInstructionSetName(set) << L" " << timeMs * 1e6 / samplesCount;
+				}
+				std::wcout << L'\n';
+			}
+		}
+		std::wcout << L"checksum " << checksum << L'\n';
+
+		return 0;
+	}
+}
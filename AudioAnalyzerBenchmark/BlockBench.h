@@ -0,0 +1,24 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+//
+// Compares block reductions of BlockRms and BlockPeak.
+//
+// For each block size the same signal is reduced sample by sample,
+// checking for the end of block on every sample, like handlers used to do,
+// and with BlockKernels on parts of chunks split at block boundaries, like handlers do now,
+// with each supported instruction set.
+//
+// Usage:
+//   AudioAnalyzerBenchmark --block-bench [options]
+//
+// Options:
+//   --samples <count>    count of reduced samples for each case, default: 50000000
+//   --chunk <samples>    size of chunks of the signal, like size of captured buffers, default: 480
+//
+
+#pragma once
+
+namespace rxtd::audio_analyzer::benchmark {
+	int runBlockBench(array_view<string> args);
+}
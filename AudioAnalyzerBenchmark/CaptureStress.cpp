@@ -0,0 +1,306 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "CaptureStress.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#include "rxtd/audio_analyzer/sound_processing/audio_sources/CaptureFanOut.h"
+#include "rxtd/audio_analyzer/sound_processing/audio_sources/CaptureRing.h"
+#include "rxtd/audio_analyzer/sound_processing/audio_sources/PcmFileSource.h"
+#include "rxtd/audio_analyzer/sound_processing/audio_sources/SyntheticSource.h"
+#include "rxtd/std_fixes/StringUtils.h"
+
+namespace rxtd::audio_analyzer::benchmark {
+	namespace {
+		using clock = std::chrono::steady_clock;
+
+		struct StressArguments {
+			string source = L"sweep";
+			index sampleRate = 48000;
+			index channelsCount = 2;
+			double captureRate = 100.0;
+			double updateRate = 60.0;
+			double slow = 0.0;
+			double ringSize = 1.0;
+			double duration = 5.0;
+			index readersCount = 0;
+			index stalledCount = 0;
+		};
+
+		StressArguments parseStressArguments(array_view<string> args) {
+			StressArguments result;
+
+			for (index i = 0; i < args.size(); i += 2) {
+				if (i + 1 >= args.size()) {
+					throw std::runtime_error{ "option without value" };
+				}
+
+				const isview name = args[i] % ciView();
+				const sview value = args[i + 1];
+
+				if (name == L"--source") {
+					result.source = value;
+				} else if (name == L"--rate") {
+					result.sampleRate = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--channels") {
+					result.channelsCount = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--capture-rate") {
+					result.captureRate = std_fixes::StringUtils::parseFloat(value);
+				} else if (name == L"--update-rate") {
+					result.updateRate = std_fixes::StringUtils::parseFloat(value);
+				} else if (name == L"--slow") {
+					result.slow = std_fixes::StringUtils::parseFloat(value);
+				} else if (name == L"--ring") {
+					result.ringSize = std_fixes::StringUtils::parseFloat(value);
+				} else if (name == L"--duration") {
+					result.duration = std_fixes::StringUtils::parseFloat(value);
+				} else if (name == L"--readers") {
+					result.readersCount = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--stalled") {
+					result.stalledCount = std_fixes::StringUtils::parseInt(value);
+				} else {
+					throw std::runtime_error{ "unknown option" };
+				}
+			}
+
+			if (result.sampleRate <= 0 || result.channelsCount <= 0
+				|| result.captureRate <= 0.0 || result.updateRate <= 0.0
+				|| result.ringSize <= 0.0 || result.duration <= 0.0) {
+				throw std::runtime_error{ "rate, channels, capture rate, update rate, ring and duration must be positive" };
+			}
+			if (result.slow < 0.0 || result.readersCount < 0) {
+				throw std::runtime_error{ "slow and readers must not be negative" };
+			}
+			if (result.stalledCount < 0 || (result.stalledCount > 0 && result.stalledCount >= result.readersCount)) {
+				throw std::runtime_error{ "stalled must be less than readers" };
+			}
+
+			return result;
+		}
+
+		std::unique_ptr<OfflineSource> createSource(const StressArguments& args) {
+			const isview source = args.source % ciView();
+
+			if (source.substr(0, 4) == L"wav:") {
+				auto wav = PcmFileSource::readWav(std::filesystem::path{ args.source.c_str() + 4 });
+				wav.setLoop(true);
+				return std::make_unique<PcmFileSource>(std::move(wav));
+			}
+
+			const auto signalOpt = parseEnum<SyntheticSource::Signal>(source);
+			if (!signalOpt.has_value()) {
+				throw std::runtime_error{ "unknown source" };
+			}
+
+			SyntheticSource::Params params;
+			params.signal = signalOpt.value();
+			params.sampleRate = args.sampleRate;
+			params.channelsCount = args.channelsCount;
+			return std::make_unique<SyntheticSource>(params);
+		}
+
+		clock::duration toDuration(double seconds) {
+			return std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>{ seconds });
+		}
+
+		// compares everything that is in the mixer with the next portion of reference source
+		bool compareWithReference(const ChannelMixer& mixer, OfflineSource& reference) {
+			const auto layoutChannels = reference.getChannelLayout().ordered();
+			const index size = mixer.getChannelPCM(layoutChannels[0]).size();
+
+			reference.setBlockSize(size);
+			if (!reference.capture()) {
+				return false;
+			}
+
+			// readers of a fan-out get the mixed channel from the writer
+			std::vector<Channel> channels{ layoutChannels.begin(), layoutChannels.end() };
+			channels.push_back(Channel::eAUTO);
+			for (const auto channel : channels) {
+				const auto expected = reference.getChannelMixer().getChannelPCM(channel);
+				const auto actual = mixer.getChannelPCM(channel);
+				if (expected.size() != size || !std::equal(actual.begin(), actual.end(), expected.begin())) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// one processing thread, that takes all available data on each update
+		struct Consumer {
+			AudioSource* source = nullptr;
+			std::function<CaptureRing::Stats()> getStats;
+			std::unique_ptr<OfflineSource> reference;
+			// only reads after the test, like a measure that isn't updated
+			bool stalled = false;
+
+			index updates = 0;
+			index framesRead = 0;
+			index maxFramesPerUpdate = 0;
+			index framesVerified = 0;
+			bool dataIsValid = true;
+		};
+
+		// everything that was read before the first overrun must match the reference exactly
+		void consume(Consumer& consumer) {
+			if (!consumer.source->capture()) {
+				return;
+			}
+
+			const auto& mixer = consumer.source->getChannelMixer();
+			const index size = mixer.getChannelPCM(consumer.source->getChannelLayout().ordered()[0]).size();
+			consumer.framesRead += size;
+			consumer.maxFramesPerUpdate = std::max(consumer.maxFramesPerUpdate, size);
+
+			// Reader of a fan-out can skip data while it captures, so overruns are checked after capture.
+			// Overrun that has happened after the data was taken doesn't affect it,
+			// but it still stops the verification
+			if (consumer.dataIsValid && consumer.getStats().overruns == 0) {
+				consumer.dataIsValid = compareWithReference(mixer, *consumer.reference);
+				if (consumer.dataIsValid) {
+					consumer.framesVerified += size;
+				}
+			}
+		}
+	}
+
+	int runCaptureStress(array_view<string> args) {
+		const auto stressArgs = parseStressArguments(args);
+
+		auto source = createSource(stressArgs);
+		source->setBlockSizeForUpdateRate(stressArgs.captureRate);
+
+		const index sampleRate = source->getSampleRate();
+		const index capacity = static_cast<index>(static_cast<double>(sampleRate) * stressArgs.ringSize);
+
+		CaptureRing ring;
+		std::shared_ptr<CaptureFanOut> fanOut;
+		std::vector<std::shared_ptr<CaptureFanOut::Reader>> readers;
+		std::vector<Consumer> consumers;
+
+		if (stressArgs.readersCount == 0) {
+			ring.setFormat(sampleRate, source->getChannelLayout(), capacity);
+			auto& consumer = consumers.emplace_back();
+			consumer.source = &ring;
+			consumer.getStats = [&] { return ring.getStats(); };
+		} else {
+			fanOut = std::make_shared<CaptureFanOut>(sampleRate, source->getChannelLayout(), capacity);
+			for (index i = 0; i < stressArgs.readersCount; i++) {
+				auto reader = fanOut->createReader({});
+				if (reader == nullptr) {
+					throw std::runtime_error{ "too many readers" };
+				}
+				auto& consumer = consumers.emplace_back();
+				consumer.source = reader.get();
+				consumer.stalled = i < stressArgs.stalledCount;
+				consumer.getStats = [reader = reader.get()] { return reader->getStats(); };
+				readers.push_back(std::move(reader));
+			}
+		}
+		for (auto& consumer : consumers) {
+			consumer.reference = createSource(stressArgs);
+		}
+
+		std::wcout << L"source:           " << stressArgs.source << L", " << sampleRate << L" Hz, "
+			<< source->getChannelLayout().ordered().size() << L" channels\n";
+		std::wcout << L"capture:          " << stressArgs.captureRate << L" polls per second, "
+			<< source->getBlockSize() << L" frames each\n";
+		std::wcout << L"processing:       " << stressArgs.updateRate << L" updates per second, "
+			<< stressArgs.slow << L" ms each";
+		if (fanOut != nullptr) {
+			std::wcout << L", " << stressArgs.readersCount << L" readers of one fan-out";
+			if (stressArgs.stalledCount > 0) {
+				std::wcout << L", " << stressArgs.stalledCount << L" of them stalled";
+			}
+		}
+		std::wcout << L'\n';
+		std::wcout << L"ring:             " << capacity << L" frames\n";
+
+		std::atomic<bool> stopRequest{ false };
+		std::thread captureThread{
+			[&] {
+				const auto period = toDuration(1.0 / stressArgs.captureRate);
+				auto nextTime = clock::now();
+				while (!stopRequest.load(std::memory_order_relaxed)) {
+					if (source->capture()) {
+						if (fanOut != nullptr) {
+							fanOut->write(source->getChannelMixer());
+						} else {
+							ring.write(source->getChannelMixer());
+						}
+					}
+					nextTime += period;
+					std::this_thread::sleep_until(nextTime);
+				}
+			}
+		};
+
+		// each consumer works like a processing thread of a separate measure
+		const auto updatePeriod = toDuration(1.0 / stressArgs.updateRate);
+		const auto slowTime = toDuration(stressArgs.slow * 0.001);
+		const auto stopTime = clock::now() + toDuration(stressArgs.duration);
+		auto runConsumer = [&](Consumer& consumer) {
+			if (consumer.stalled) {
+				std::this_thread::sleep_until(stopTime);
+				return;
+			}
+
+			auto nextUpdateTime = clock::now();
+			while (clock::now() < stopTime) {
+				consume(consumer);
+				consumer.updates++;
+
+				// processing stage
+				std::this_thread::sleep_for(slowTime);
+
+				nextUpdateTime = std::max(nextUpdateTime + updatePeriod, clock::now());
+				std::this_thread::sleep_until(nextUpdateTime);
+			}
+		};
+
+		std::vector<std::thread> consumerThreads;
+		for (index i = 1; i < static_cast<index>(consumers.size()); i++) {
+			consumerThreads.emplace_back(runConsumer, std::ref(consumers[static_cast<size_t>(i)]));
+		}
+		runConsumer(consumers[0]);
+		for (auto& thread : consumerThreads) {
+			thread.join();
+		}
+
+		stopRequest = true;
+		captureThread.join();
+
+		const index framesProduced = source->getFramesProduced();
+		std::wcout << L"frames produced:  " << framesProduced << L'\n';
+
+		bool allValid = true;
+		for (index i = 0; i < static_cast<index>(consumers.size()); i++) {
+			auto& consumer = consumers[static_cast<size_t>(i)];
+
+			// underruns of the run, before the ring is drained
+			const index underruns = consumer.getStats().underruns;
+			// stalled reader only finds out that it has lost data when it reads
+			consume(consumer);
+			const auto stats = consumer.getStats();
+
+			const bool framesMatch = framesProduced == consumer.framesRead + stats.lostFrames;
+			allValid = allValid && consumer.dataIsValid && framesMatch;
+
+			if (fanOut != nullptr) {
+				std::wcout << L"reader " << i << (consumer.stalled ? L", stalled:\n" : L":\n");
+			}
+			std::wcout << L"updates:          " << consumer.updates << L'\n';
+			std::wcout << L"frames read:      " << consumer.framesRead << L", max " << consumer.maxFramesPerUpdate << L" per update\n";
+			std::wcout << L"overruns:         " << stats.overruns << L", " << stats.lostFrames << L" frames lost\n";
+			std::wcout << L"underruns:        " << underruns << L'\n';
+			std::wcout << L"frames verified:  " << consumer.framesVerified << (consumer.dataIsValid ? L", ok" : L", MISMATCH") << L'\n';
+			std::wcout << L"frames accounted: " << (framesMatch ? L"ok" : L"MISMATCH") << L'\n';
+		}
+
+		return allValid ? 0 : 1;
+	}
+}
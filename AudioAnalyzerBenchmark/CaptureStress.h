@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+//
+// Checks how CaptureRing passes audio from a capture thread to a slow processing thread.
+//
+// Capture thread works like the capture thread of the plugin: it polls the source in real time
+// and writes everything it gets into the ring.
+// Main thread works like the processing thread: on each update it takes all data from the ring
+// and then sleeps for the time that processing would take.
+// Data from the ring is compared with the same source read without the ring, until the first overrun.
+//
+// With --readers the capture thread writes into a CaptureFanOut instead,
+// and each reader runs its own processing loop in its own thread, like measures that share one device.
+// Stalled readers don't read until the end, like measures that are not updated:
+// they must lose their own data without causing overruns for other readers.
+//
+// Usage:
+//   AudioAnalyzerBenchmark --capture-stress [options]
+//
+// Options:
+//   --source <silence|sweep|pink|wav:<path>>    default: sweep
+//   --rate <samples per second>        sample rate of generated signals, default: 48000
+//   --channels <count>                 channels count of generated signals, default: 2
+//   --capture-rate <polls per second>  how often the source is polled, default: 100
+//   --update-rate <updates per second> how often the processing is run, default: 60
+//   --slow <milliseconds>              time of each processing update, default: 0
+//   --ring <seconds>                   length of the ring, default: 1
+//   --duration <seconds>               running time, default: 5
+//   --readers <count>                  readers of a shared CaptureFanOut, 0 for a CaptureRing, default: 0
+//   --stalled <count>                  readers that don't read, must be less than readers, default: 0
+//
+
+#pragma once
+
+namespace rxtd::audio_analyzer::benchmark {
+	int runCaptureStress(array_view<string> args);
+}
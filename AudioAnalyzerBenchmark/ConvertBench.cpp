@@ -0,0 +1,260 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "ConvertBench.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "rxtd/audio_analyzer/audio_utils/RandomGenerator.h"
+#include "rxtd/filter_utils/SampleConverter.h"
+#include "rxtd/std_fixes/StringUtils.h"
+
+namespace rxtd::audio_analyzer::benchmark {
+	namespace {
+		using SampleConverter = filter_utils::SampleConverter;
+		using SampleType = SampleConverter::SampleType;
+		using InstructionSet = SampleConverter::InstructionSet;
+		using clock = std::chrono::steady_clock;
+
+		struct BenchArguments {
+			index channelsCount = 8;
+			index sampleRate = 192000;
+			double bufferMs = 10.0;
+			double duration = 60.0;
+		};
+
+		BenchArguments parseBenchArguments(array_view<string> args) {
+			BenchArguments result;
+
+			for (index i = 0; i < args.size(); i += 2) {
+				if (i + 1 >= args.size()) {
+					throw std::runtime_error{ "option without value" };
+				}
+
+				const isview name = args[i] % ciView();
+				const sview value = args[i + 1];
+
+				if (name == L"--channels") {
+					result.channelsCount = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--rate") {
+					result.sampleRate = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--buffer") {
+					result.bufferMs = std_fixes::StringUtils::parseFloat(value);
+				} else if (name == L"--duration") {
+					result.duration = std_fixes::StringUtils::parseFloat(value);
+				} else {
+					throw std::runtime_error{ "unknown option" };
+				}
+			}
+
+			if (result.channelsCount <= 0 || result.sampleRate <= 0 || result.bufferMs <= 0.0 || result.duration <= 0.0) {
+				throw std::runtime_error{ "channels, rate, buffer and duration must be positive" };
+			}
+
+			return result;
+		}
+
+		sview getInstructionSetName(InstructionSet value) {
+			switch (value) {
+			case InstructionSet::eSCALAR: return L"scalar";
+			case InstructionSet::eSSSE3: return L"SSSE3";
+			case InstructionSet::eAVX2: return L"AVX2";
+			}
+			return {};
+		}
+
+		sview getSampleTypeName(SampleType value) {
+			switch (value) {
+			case SampleType::eINT16: return L"int16";
+			case SampleType::eINT24: return L"int24";
+			case SampleType::eINT32: return L"int32";
+			case SampleType::eFLOAT32: return L"float32";
+			}
+			return {};
+		}
+
+		// random bytes for integer samples, values in [-1, 1] for floats, so that there are no NaNs
+		std::vector<std::byte> generateBuffer(SampleType type, index count) {
+			audio_utils::RandomGenerator random;
+			std::vector<std::byte> result(static_cast<size_t>(count * SampleConverter::getSampleSize(type)));
+
+			if (type == SampleType::eFLOAT32) {
+				for (index i = 0; i < count; i++) {
+					const float value = static_cast<float>(random.next());
+					std::memcpy(result.data() + i * 4, &value, sizeof(value));
+				}
+				return result;
+			}
+
+			for (auto& value : result) {
+				value = static_cast<std::byte>(static_cast<int>((random.next() + 1.0) * 127.5));
+			}
+			return result;
+		}
+
+		float decodeSample(const std::byte* ptr, SampleType type) {
+			switch (type) {
+			case SampleType::eINT16: {
+				int16_t value;
+				std::memcpy(&value, ptr, sizeof(value));
+				return static_cast<float>(value) / 32768.0f;
+			}
+			case SampleType::eINT24: {
+				const int32_t value = static_cast<int32_t>(
+					static_cast<uint32_t>(ptr[0]) << 8
+					| static_cast<uint32_t>(ptr[1]) << 16
+					| static_cast<uint32_t>(ptr[2]) << 24
+				) >> 8;
+				return static_cast<float>(value) / 8388608.0f;
+			}
+			case SampleType::eINT32: {
+				int32_t value;
+				std::memcpy(&value, ptr, sizeof(value));
+				return static_cast<float>(value) / 2147483648.0f;
+			}
+			case SampleType::eFLOAT32: {
+				float value;
+				std::memcpy(&value, ptr, sizeof(value));
+				return value;
+			}
+			}
+			return 0.0f;
+		}
+
+		// whole buffer is walked once for each channel
+		double runStrided(
+			const std::vector<std::byte>& buffer, SampleType type, index buffersCount,
+			std_fixes::array2d_span<float> dest
+		) {
+			const index channelsCount = dest.getBuffersCount();
+			const index framesCount = dest.getBufferSize();
+			const index sampleSize = SampleConverter::getSampleSize(type);
+
+			const auto begin = clock::now();
+			for (index b = 0; b < buffersCount; b++) {
+				for (index channel = 0; channel < channelsCount; channel++) {
+					auto channelBuffer = dest[channel];
+					const std::byte* ptr = buffer.data() + channel * sampleSize;
+					for (index frame = 0; frame < framesCount; frame++) {
+						channelBuffer[frame] = decodeSample(ptr, type);
+						ptr += channelsCount * sampleSize;
+					}
+				}
+			}
+			const auto end = clock::now();
+
+			return std::chrono::duration<double, std::milli>{ end - begin }.count();
+		}
+
+		double runConverter(
+			const SampleConverter& converter,
+			const std::vector<std::byte>& buffer, SampleType type, index buffersCount,
+			std_fixes::array2d_span<float> dest
+		) {
+			const auto begin = clock::now();
+			for (index b = 0; b < buffersCount; b++) {
+				converter.deinterleave(buffer.data(), type, dest);
+			}
+			const auto end = clock::now();
+
+			return std::chrono::duration<double, std::milli>{ end - begin }.count();
+		}
+
+		bool isEqual(const std_fixes::Vector2D<float>& left, const std_fixes::Vector2D<float>& right) {
+			for (index channel = 0; channel < left.getBuffersCount(); channel++) {
+				const auto l = left[channel];
+				const auto r = right[channel];
+				if (std::memcmp(l.data(), r.data(), static_cast<size_t>(l.size()) * sizeof(float)) != 0) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	int runConvertBench(array_view<string> args) {
+		const BenchArguments benchArgs = parseBenchArguments(args);
+
+		const index framesCount = std::max<index>(
+			static_cast<index>(static_cast<double>(benchArgs.sampleRate) * benchArgs.bufferMs * 0.001), 1
+		);
+		const index buffersCount = std::max<index>(
+			static_cast<index>(benchArgs.duration * static_cast<double>(benchArgs.sampleRate)) / framesCount, 1
+		);
+		const double totalFrames = static_cast<double>(buffersCount * framesCount);
+		const double audioMs = totalFrames * 1000.0 / static_cast<double>(benchArgs.sampleRate);
+
+		std::wcout << benchArgs.channelsCount << L" channels, " << benchArgs.sampleRate << L" Hz, "
+			<< buffersCount << L" buffers of " << framesCount << L" frames\n";
+		std::wcout << L"time in ns per frame, and in % of realtime\n";
+
+		std_fixes::Vector2D<float> expected;
+		expected.setBuffersCount(benchArgs.channelsCount);
+		expected.setBufferSize(framesCount);
+		std_fixes::Vector2D<float> dest;
+		dest.setBuffersCount(benchArgs.channelsCount);
+		dest.setBufferSize(framesCount);
+
+		bool allEqual = true;
+		bool avx2IsSlower = false;
+		for (const auto type : { SampleType::eINT16, SampleType::eINT24, SampleType::eINT32, SampleType::eFLOAT32 }) {
+			const auto buffer = generateBuffer(type, framesCount * benchArgs.channelsCount);
+
+			std::wcout << getSampleTypeName(type) << L":";
+
+			const double stridedMs = runStrided(buffer, type, buffersCount, expected);
+			std::wcout << L" strided " << stridedMs * 1e6 / totalFrames << L" (" << stridedMs * 100.0 / audioMs << L"%)";
+
+			const std::array<InstructionSet, 3> sets{ InstructionSet::eSCALAR, InstructionSet::eSSSE3, InstructionSet::eAVX2 };
+			std::array<double, 3> timesMs{};
+			timesMs.fill(std::numeric_limits<double>::infinity());
+			std::array<bool, 3> equal{ true, true, true };
+
+			// sets take turns, and the fastest round of each set is used,
+			// so that noise from other processes doesn't make one set look slower than another
+			constexpr index roundsCount = 10;
+			const index roundBuffersCount = std::max<index>(buffersCount / roundsCount, 1);
+			for (index round = 0; round < roundsCount; round++) {
+				for (index i = 0; i < static_cast<index>(sets.size()); i++) {
+					const auto set = sets[static_cast<size_t>(i)];
+					if (!SampleConverter::isSupported(set)) {
+						continue;
+					}
+
+					auto& timeMs = timesMs[static_cast<size_t>(i)];
+					timeMs = std::min(timeMs, runConverter(SampleConverter{ set }, buffer, type, roundBuffersCount, dest));
+					if (!isEqual(expected, dest)) {
+						equal[static_cast<size_t>(i)] = false;
+						allEqual = false;
+					}
+				}
+			}
+
+			for (index i = 0; i < static_cast<index>(sets.size()); i++) {
+				const auto set = sets[static_cast<size_t>(i)];
+				if (!SampleConverter::isSupported(set)) {
+					continue;
+				}
+
+				const double timeMs = timesMs[static_cast<size_t>(i)] * static_cast<double>(buffersCount) / static_cast<double>(roundBuffersCount);
+				std::wcout << L", " << getInstructionSetName(set) << L" " << timeMs * 1e6 / totalFrames
+					<< L" (" << timeMs * 100.0 / audioMs << L"%)" << (equal[static_cast<size_t>(i)] ? L"" : L" MISMATCH");
+			}
+
+			// AVX2 split of 8 channels used to be slower than SSSE3,
+			// small difference is allowed because of timer noise
+			if (SampleConverter::isSupported(InstructionSet::eAVX2) && timesMs[2] > timesMs[1] * 1.1) {
+				avx2IsSlower = true;
+			}
+			std::wcout << L'\n';
+		}
+		std::wcout << (allEqual ? L"all results are bit-exact\n" : L"results differ\n");
+		if (avx2IsSlower) {
+			std::wcout << L"warning: AVX2 is slower than SSSE3\n";
+		}
+
+		return allEqual ? 0 : 1;
+	}
+}
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+//
+// Compares conversion of captured interleaved buffers into per-channel float buffers.
+//
+// Old way: each channel is read separately with a strided loop over the whole buffer,
+// like AudioCaptureClient used to do.
+// New way: SampleConverter with each supported instruction set.
+// Results of all methods are checked to be bit-exact,
+// and a warning is printed if AVX2 is more than 10% slower than SSSE3 for some sample type.
+//
+// Usage:
+//   AudioAnalyzerBenchmark --convert-bench [options]
+//
+// Options:
+//   --channels <count>     channels in the buffer, default: 8
+//   --rate <count>         samples per second, default: 192000
+//   --buffer <ms>          length of one captured buffer, default: 10
+//   --duration <seconds>   length of audio converted for each case, default: 60
+//
+
+#pragma once
+
+namespace rxtd::audio_analyzer::benchmark {
+	int runConvertBench(array_view<string> args);
+}
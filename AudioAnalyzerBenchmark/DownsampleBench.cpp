@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "DownsampleBench.h"
+
+#include <chrono>
+#include <iostream>
+#include <numeric>
+
+#include "rxtd/audio_analyzer/audio_utils/RandomGenerator.h"
+#include "rxtd/filter_utils/DownsampleHelper.h"
+#include "rxtd/std_fixes/MyMath.h"
+#include "rxtd/std_fixes/StringUtils.h"
+
+namespace rxtd::audio_analyzer::benchmark {
+	namespace {
+		using DownsampleHelper = filter_utils::DownsampleHelper;
+		using Method = DownsampleHelper::Method;
+		using clock = std::chrono::steady_clock;
+
+		struct BenchArguments {
+			index rate = 192000;
+			double duration = 60.0;
+			index chunk = 1920;
+		};
+
+		BenchArguments parseBenchArguments(array_view<string> args) {
+			BenchArguments result;
+
+			for (index i = 0; i < args.size(); i += 2) {
+				if (i + 1 >= args.size()) {
+					throw std::runtime_error{ "option without value" };
+				}
+
+				const isview name = args[i] % ciView();
+				const sview value = args[i + 1];
+
+				if (name == L"--rate") {
+					result.rate = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--duration") {
+					result.duration = std_fixes::StringUtils::parseFloat(value);
+				} else if (name == L"--chunk") {
+					result.chunk = std_fixes::StringUtils::parseInt(value);
+				} else {
+					throw std::runtime_error{ "unknown option" };
+				}
+			}
+
+			if (result.rate <= 0 || result.duration <= 0.0 || result.chunk <= 0) {
+				throw std::runtime_error{ "rate, duration and chunk must be positive" };
+			}
+
+			return result;
+		}
+
+		sview getMethodName(Method method) {
+			switch (method) {
+			case Method::eIIR: return L"IIR";
+			case Method::ePOLYPHASE: return L"Polyphase";
+			case Method::eRATIONAL: return L"Rational";
+			}
+			return {};
+		}
+
+		// calls DownsampleHelper the same way ProcessingManager does
+		class Runner {
+			DownsampleHelper helper;
+			std::vector<float> result;
+
+		public:
+			Runner(Method method, index up, index down) {
+				helper.setMethod(method);
+				helper.setRatio(up, down);
+			}
+
+			array_view<float> process(array_view<float> chunk) {
+				result.resize(static_cast<size_t>(helper.pushData(chunk)));
+				const index size = helper.downsample(result);
+				array_view<float> view = result;
+				view.remove_suffix(static_cast<size_t>(view.size() - size));
+				return view;
+			}
+		};
+
+		// checksum makes sure that results are used
+		double measureSpeed(Method method, index up, index down, array_view<float> noise, index totalSize, index chunk, double& checksum) {
+			Runner runner{ method, up, down };
+
+			const auto begin = clock::now();
+			for (index processed = 0; processed < totalSize; processed += chunk) {
+				for (const auto value : runner.process(noise)) {
+					checksum += static_cast<double>(value);
+				}
+			}
+			const auto end = clock::now();
+
+			return std::chrono::duration<double, std::milli>{ end - begin }.count();
+		}
+
+		// frequencyRatio is sine frequency relative to new nyquist frequency
+		double measureGainDb(Method method, index up, index down, double frequencyRatio, index chunk) {
+			Runner runner{ method, up, down };
+
+			constexpr index outputSize = 8192;
+			const double frequency = frequencyRatio * 0.5 * static_cast<double>(up) / static_cast<double>(down);
+			const index inputSize = outputSize * down / up;
+
+			std::vector<float> wave;
+			std::vector<float> output;
+			for (index offset = 0; offset < inputSize; offset += chunk) {
+				wave.resize(static_cast<size_t>(std::min(chunk, inputSize - offset)));
+				for (index i = 0; i < static_cast<index>(wave.size()); i++) {
+					const double phase = 2.0 * std_fixes::MyMath::pi<double>() * frequency * static_cast<double>(offset + i);
+					wave[static_cast<size_t>(i)] = static_cast<float>(std::sin(phase));
+				}
+
+				const auto result = runner.process(wave);
+				output.insert(output.end(), result.begin(), result.end());
+			}
+
+			// skip filter warm up
+			double sum = 0.0;
+			const index begin = static_cast<index>(output.size()) / 4;
+			for (index i = begin; i < static_cast<index>(output.size()); i++) {
+				const auto value = static_cast<double>(output[static_cast<size_t>(i)]);
+				sum += value * value;
+			}
+			const double rms = std::sqrt(sum / static_cast<double>(static_cast<index>(output.size()) - begin));
+
+			return 20.0 * std::log10(std::max(rms * std::sqrt(2.0), 1e-12));
+		}
+	}
+
+	int runDownsampleBench(array_view<string> args) {
+		const BenchArguments benchArgs = parseBenchArguments(args);
+
+		std::vector<float> noise;
+		noise.resize(static_cast<size_t>(benchArgs.chunk));
+		audio_utils::RandomGenerator random;
+		for (auto& value : noise) {
+			value = static_cast<float>(random.next());
+		}
+
+		const auto totalSize = static_cast<index>(benchArgs.duration * static_cast<double>(benchArgs.rate));
+		const double realTimeMs = benchArgs.duration * 1000.0;
+
+		std::wcout << L"input rate " << benchArgs.rate << L", " << benchArgs.duration << L" s of audio, chunk " << benchArgs.chunk << L'\n';
+
+		double checksum = 0.0;
+		auto measure = [&](Method method, index up, index down) {
+			const double timeMs = measureSpeed(method, up, down, noise, totalSize, benchArgs.chunk, checksum);
+
+			// frequencies relative to the nyquist frequency of the resulting rate
+			double passbandError = 0.0;
+			for (double ratio = 0.05; ratio <= 0.8; ratio += 0.05) {
+				passbandError = std::max(passbandError, std::abs(measureGainDb(method, up, down, ratio, benchArgs.chunk)));
+			}
+
+			double worstStopband = -std::numeric_limits<double>::infinity();
+			const double maxRatio = static_cast<double>(down) / static_cast<double>(up);
+			for (double ratio = 1.2; ratio < maxRatio; ratio += 0.1) {
+				worstStopband = std::max(worstStopband, measureGainDb(method, up, down, ratio, benchArgs.chunk));
+			}
+
+			std::wcout << L"  " << getMethodName(method) << L":"
+				<< L" " << timeMs << L" ms (" << realTimeMs / timeMs << L"x realtime)"
+				<< L", passband error " << passbandError << L" dB";
+			// ratios close to 1 don't have anything to alias
+			if (maxRatio > 1.2) {
+				std::wcout << L", stopband " << -worstStopband << L" dB";
+			}
+			std::wcout << L'\n';
+		};
+
+		for (const index factor : { 2, 3, 4, 8 }) {
+			std::wcout << L"factor " << factor << L" (" << benchArgs.rate / factor << L" Hz)\n";
+
+			for (const auto method : { Method::eIIR, Method::ePOLYPHASE, Method::eRATIONAL }) {
+				measure(method, 1, factor);
+			}
+		}
+
+		// IIR can only reach the closest integer divider, Rational gets exactly the target rate
+		for (const index target : { 48000, 44100, 32000 }) {
+			if (target >= benchArgs.rate) {
+				continue;
+			}
+			const index divider = benchArgs.rate / target;
+			const index divisor = std::gcd(benchArgs.rate, target);
+			std::wcout << L"target " << target << L" Hz\n";
+
+			std::wcout << L"  divider " << divider << L" (" << benchArgs.rate / divider << L" Hz)\n";
+			if (divider > 1) {
+				measure(Method::eIIR, 1, divider);
+			} else {
+				std::wcout << L"  no resampling\n";
+			}
+			std::wcout << L"  ratio " << target / divisor << L"/" << benchArgs.rate / divisor << L" (" << target << L" Hz)\n";
+			measure(Method::eRATIONAL, target, benchArgs.rate);
+		}
+		std::wcout << L"checksum " << checksum << L'\n';
+
+		return 0;
+	}
+}
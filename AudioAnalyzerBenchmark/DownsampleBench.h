@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+//
+// Compares downsampling methods of DownsampleHelper.
+//
+// For each factor all methods are run on white noise to measure speed,
+// then on sine waves to measure accuracy:
+// passband error is the largest gain deviation below 0.8 of new nyquist frequency,
+// stopband is the smallest attenuation above 1.2 of new nyquist frequency.
+//
+// Then for common target rates below the input rate
+// IIR with the integer divider that ProcessingManager would use is compared
+// with Rational, which resamples to exactly the target rate.
+//
+// Usage:
+//   AudioAnalyzerBenchmark --downsample-bench [options]
+//
+// Options:
+//   --rate <samples per second>    input sample rate, default: 192000
+//   --duration <seconds>           length of processed signal for speed test, default: 60
+//   --chunk <samples>              block size passed to DownsampleHelper, default: 1920
+//
+
+#pragma once
+
+namespace rxtd::audio_analyzer::benchmark {
+	int runDownsampleBench(array_view<string> args);
+}
@@ -0,0 +1,344 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "ExchangeStress.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "Statistics.h"
+#include "rxtd/DataWithLock.h"
+#include "rxtd/TripleBuffer.h"
+#include "rxtd/audio_analyzer/sound_processing/ProcessingOrchestrator.h"
+#include "rxtd/std_fixes/StringUtils.h"
+
+namespace rxtd::audio_analyzer::benchmark {
+	namespace {
+		using Snapshot = ProcessingOrchestrator::Snapshot;
+		using clock = std::chrono::steady_clock;
+
+		struct StressArguments {
+			index children = 200;
+			index handlers = 8;
+			index values = 100;
+			index readers = 1;
+			double duration = 2.0;
+		};
+
+		struct ValueRequest {
+			istring processing;
+			Channel channel;
+			istring handler;
+			index ind;
+		};
+
+		StressArguments parseStressArguments(array_view<string> args) {
+			StressArguments result;
+
+			for (index i = 0; i < args.size(); i += 2) {
+				if (i + 1 >= args.size()) {
+					throw std::runtime_error{ "option without value" };
+				}
+
+				const isview name = args[i] % ciView();
+				const sview value = args[i + 1];
+
+				if (name == L"--children") {
+					result.children = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--handlers") {
+					result.handlers = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--values") {
+					result.values = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--readers") {
+					result.readers = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--duration") {
+					result.duration = std_fixes::StringUtils::parseFloat(value);
+				} else {
+					throw std::runtime_error{ "unknown option" };
+				}
+			}
+
+			if (result.children <= 0 || result.handlers <= 0 || result.values <= 0 || result.readers <= 0 || result.duration <= 0.0) {
+				throw std::runtime_error{ "children, handlers, values, readers and duration must be positive" };
+			}
+
+			return result;
+		}
+
+		istring makeName(sview prefix, index number) {
+			const string name = string{ prefix } + std::to_wstring(number);
+			return name % ciView() % own();
+		}
+
+		// same lookups as AudioParent::getValue
+		double findValue(const Snapshot& snapshot, const ValueRequest& request) {
+			const auto procIter = snapshot.find(request.processing);
+			if (procIter == snapshot.end()) {
+				return 0.0;
+			}
+			const auto channelIter = procIter->second.find(request.channel);
+			if (channelIter == procIter->second.end()) {
+				return 0.0;
+			}
+			const auto handlerSnapshot = channelIter->second.find(request.handler);
+			if (handlerSnapshot == nullptr) {
+				return 0.0;
+			}
+			return static_cast<double>(handlerSnapshot->values[0][request.ind]);
+		}
+
+		// ParentHelper before TripleBuffer: swap under lock, lock for each child.
+		// All readers share the same data.
+		class LockingExchange {
+			struct LockableData : DataWithLock {
+				Snapshot _;
+			} data;
+
+			Snapshot writerSnapshot;
+
+		public:
+			// each child is locked separately, so writer can publish in the middle of a tick
+			static constexpr bool ticksAreConsistent = false;
+
+			static sview getName() {
+				return L"mutex + swap";
+			}
+
+			void configure(const Snapshot& snapshot, index readersCount) {
+				data.setUseLocking(true);
+				data._ = snapshot;
+				writerSnapshot = snapshot;
+			}
+
+			template<typename Callback>
+			void fill(Callback callback) {
+				callback(writerSnapshot);
+			}
+
+			void publish() {
+				auto lock = data.getLock();
+				std::swap(writerSnapshot, data._);
+			}
+
+			void beginRead(index reader) { }
+
+			double read(index reader, const ValueRequest& request) {
+				auto lock = data.getLock();
+				return findValue(data._, request);
+			}
+		};
+
+		// TripleBuffer only has one read buffer, so each reader has its own TripleBuffer,
+		// and writer fills and publishes all of them
+		class TripleBufferExchange {
+			std::vector<std::unique_ptr<TripleBuffer<Snapshot>>> buffers;
+
+		public:
+			static constexpr bool ticksAreConsistent = true;
+
+			static sview getName() {
+				return L"triple buffer";
+			}
+
+			void configure(const Snapshot& snapshot, index readersCount) {
+				for (index reader = 0; reader < readersCount; reader++) {
+					auto& buffer = *buffers.emplace_back(std::make_unique<TripleBuffer<Snapshot>>());
+					// each iteration moves next buffer into writer's hands
+					for (index i = 0; i < 3; i++) {
+						buffer.getWriteBuffer() = snapshot;
+						buffer.publish();
+						buffer.acquire();
+					}
+				}
+			}
+
+			template<typename Callback>
+			void fill(Callback callback) {
+				for (auto& buffer : buffers) {
+					callback(buffer->getWriteBuffer());
+				}
+			}
+
+			void publish() {
+				for (auto& buffer : buffers) {
+					buffer->publish();
+				}
+			}
+
+			void beginRead(index reader) {
+				buffers[static_cast<size_t>(reader)]->acquire();
+			}
+
+			double read(index reader, const ValueRequest& request) {
+				return findValue(buffers[static_cast<size_t>(reader)]->getReadBuffer(), request);
+			}
+		};
+
+		// results of one reader thread
+		struct ReaderResult {
+			std::vector<double> times;
+			double sum = 0.0;
+			// ticks where values of different children came from different publications
+			index tornTicks = 0;
+			// ticks that saw older data than the previous tick
+			index staleTicks = 0;
+		};
+
+		void printStats(sview title, std::vector<double>& times) {
+			if (times.empty()) {
+				std::wcout << title << L"no data\n";
+				return;
+			}
+			std::sort(times.begin(), times.end());
+			std::wcout << title << L"count " << times.size()
+				<< L", p50 " << getPercentile(times, 0.5)
+				<< L", p99 " << getPercentile(times, 0.99)
+				<< L", p99.9 " << getPercentile(times, 0.999)
+				<< L", max " << times.back() << L'\n';
+		}
+
+		// returns false if snapshots that must be consistent weren't
+		template<typename Exchange>
+		bool runMethod(const StressArguments& args, const Snapshot& prototype, array_view<ValueRequest> requests) {
+			Exchange exchange;
+			exchange.configure(prototype, args.readers);
+
+			std::atomic<bool> stopRequest{ false };
+			std::vector<double> writerTimes;
+			std::vector<ReaderResult> readerResults(static_cast<size_t>(args.readers));
+
+			std::thread writer{
+				[&] {
+					// each publication fills all values with its number, so readers can detect torn ticks
+					float counter = 0.0f;
+					while (!stopRequest.load(std::memory_order_relaxed)) {
+						counter += 1.0f;
+						exchange.fill(
+							[&](Snapshot& writerSnapshot) {
+								for (auto& [procName, procSnapshot] : writerSnapshot) {
+									for (auto& [channel, channelSnapshot] : procSnapshot) {
+										for (auto& handlerSnapshot : channelSnapshot.handlers) {
+											handlerSnapshot.values.fill(counter);
+										}
+									}
+								}
+							}
+						);
+
+						const auto begin = clock::now();
+						exchange.publish();
+						const auto end = clock::now();
+						writerTimes.push_back(std::chrono::duration<double, std::micro>{ end - begin }.count());
+					}
+				}
+			};
+
+			const auto stopTime = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>{ args.duration });
+			std::vector<std::thread> readers;
+			for (index reader = 0; reader < args.readers; reader++) {
+				readers.emplace_back(
+					[&, reader] {
+						auto& result = readerResults[static_cast<size_t>(reader)];
+						double previousValue = 0.0;
+						while (clock::now() < stopTime) {
+							const auto begin = clock::now();
+							exchange.beginRead(reader);
+							double minValue = std::numeric_limits<double>::max();
+							double maxValue = 0.0;
+							for (const auto& request : requests) {
+								const double value = exchange.read(reader, request);
+								minValue = std::min(minValue, value);
+								maxValue = std::max(maxValue, value);
+								result.sum += value;
+							}
+							const auto end = clock::now();
+							result.times.push_back(std::chrono::duration<double, std::micro>{ end - begin }.count());
+
+							if (minValue != maxValue) {
+								result.tornTicks++;
+							}
+							if (minValue < previousValue) {
+								result.staleTicks++;
+							}
+							previousValue = maxValue;
+						}
+					}
+				);
+			}
+
+			for (auto& reader : readers) {
+				reader.join();
+			}
+			stopRequest = true;
+			writer.join();
+
+			std::vector<double> readerTimes;
+			double sum = 0.0;
+			index tornTicks = 0;
+			index staleTicks = 0;
+			for (const auto& result : readerResults) {
+				readerTimes.insert(readerTimes.end(), result.times.begin(), result.times.end());
+				sum += result.sum;
+				tornTicks += result.tornTicks;
+				staleTicks += result.staleTicks;
+			}
+
+			std::wcout << Exchange::getName() << L" (checksum " << sum << L")\n";
+			printStats(L"  reader tick, us:     ", readerTimes);
+			printStats(L"  writer publish, us:  ", writerTimes);
+			std::wcout << L"  torn ticks:          " << tornTicks << L'\n';
+			std::wcout << L"  stale ticks:         " << staleTicks << L'\n';
+
+			if (Exchange::ticksAreConsistent && (tornTicks > 0 || staleTicks > 0)) {
+				std::wcout << L"error: readers have seen inconsistent snapshots\n";
+				return false;
+			}
+			return true;
+		}
+	}
+
+	int runExchangeStress(array_view<string> args) {
+		const StressArguments stressArgs = parseStressArguments(args);
+
+		constexpr index processingsCount = 4;
+		const std::array<Channel, 2> channels{ Channel::eFRONT_LEFT, Channel::eFRONT_RIGHT };
+
+		// same layout as ProcessingManager::buildPlan makes
+		auto indices = std::make_shared<ProcessingManager::SnapshotIndices>();
+		for (index handler = 0; handler < stressArgs.handlers; handler++) {
+			(*indices)[makeName(L"Handler", handler)] = handler;
+		}
+
+		Snapshot prototype;
+		for (index proc = 0; proc < processingsCount; proc++) {
+			auto& procSnapshot = prototype[makeName(L"Processing", proc)];
+			for (auto channel : channels) {
+				auto& channelSnapshot = procSnapshot[channel];
+				channelSnapshot.indices = indices;
+				channelSnapshot.handlers.resize(static_cast<size_t>(stressArgs.handlers));
+				for (auto& handlerSnapshot : channelSnapshot.handlers) {
+					handlerSnapshot.values.setBuffersCount(1);
+					handlerSnapshot.values.setBufferSize(stressArgs.values);
+				}
+			}
+		}
+
+		std::vector<ValueRequest> requests;
+		for (index i = 0; i < stressArgs.children; i++) {
+			requests.push_back(
+				{
+					makeName(L"processing", i % processingsCount),
+					channels[static_cast<size_t>(i % static_cast<index>(channels.size()))],
+					makeName(L"handler", i / processingsCount % stressArgs.handlers),
+					i % stressArgs.values,
+				}
+			);
+		}
+
+		bool ok = runMethod<LockingExchange>(stressArgs, prototype, requests);
+		ok = runMethod<TripleBufferExchange>(stressArgs, prototype, requests) && ok;
+
+		return ok ? 0 : 1;
+	}
+}
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+//
+// Measures how the processing thread and the main thread interfere with each other
+// when processing results are passed between them.
+//
+// Writer thread works like the processing thread: fills values and publishes them as fast as possible.
+// Reader works like the main thread: on each tick it gets the latest data and makes one lookup per child measure.
+// Both sides are run once with mutex-guarded swap (the old way) and once with TripleBuffer.
+//
+// With --readers several reader threads run at the same time.
+// Mutex-guarded data is shared by all readers, and each reader gets its own TripleBuffer.
+// Writer fills all values of each publication with its number, and readers check that
+// values of one tick come from the same publication, and that they never go back in time.
+// Mutex is locked for each child, so it is expected to tear ticks,
+// but any inconsistent tick with TripleBuffer is an error.
+//
+// Usage:
+//   AudioAnalyzerBenchmark --exchange-stress [options]
+//
+// Options:
+//   --children <count>    value lookups per reader tick, default: 200
+//   --handlers <count>    handlers in each of 4 processings with 2 channels, default: 8
+//   --values <count>      values in each handler, default: 100
+//   --readers <count>     reader threads, default: 1
+//   --duration <seconds>  running time of each method, default: 2
+//
+
+#pragma once
+
+namespace rxtd::audio_analyzer::benchmark {
+	int runExchangeStress(array_view<string> args);
+}
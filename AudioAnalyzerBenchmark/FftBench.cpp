@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "FftBench.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "rxtd/audio_analyzer/audio_utils/RandomGenerator.h"
+#include "rxtd/fft_utils/RealFft.h"
+#include "rxtd/fft_utils/WindowFunctionHelper.h"
+#include "rxtd/std_fixes/StringUtils.h"
+
+namespace rxtd::audio_analyzer::benchmark {
+	namespace {
+		using RealFft = fft_utils::RealFft;
+		using clock = std::chrono::steady_clock;
+
+		struct BenchArguments {
+			index samples = 50'000'000;
+		};
+
+		BenchArguments parseBenchArguments(array_view<string> args) {
+			BenchArguments result;
+
+			for (index i = 0; i < args.size(); i += 2) {
+				if (i + 1 >= args.size()) {
+					throw std::runtime_error{ "option without value" };
+				}
+
+				const isview name = args[i] % ciView();
+				const sview value = args[i + 1];
+
+				if (name == L"--samples") {
+					result.samples = std_fixes::StringUtils::parseInt(value);
+				} else {
+					throw std::runtime_error{ "unknown option" };
+				}
+			}
+
+			if (result.samples <= 0) {
+				throw std::runtime_error{ "samples must be positive" };
+			}
+
+			return result;
+		}
+
+		struct Case {
+			index fftSize = 0;
+			index batchSize = 0;
+			index batchesCount = 0;
+
+			std::vector<float> wave;
+			std::vector<array_view<float>> frames;
+			std::vector<float> result;
+
+			Case(index fftSize, index batchSize, index totalSamples) : fftSize(fftSize), batchSize(batchSize) {
+				batchesCount = std::max<index>(totalSamples / (fftSize * batchSize), 1);
+
+				const index stride = fftSize / 4;
+				wave.resize(static_cast<size_t>(fftSize + stride * (batchSize - 1)));
+				audio_utils::RandomGenerator random;
+				for (auto& value : wave) {
+					value = static_cast<float>(random.next());
+				}
+
+				for (index i = 0; i < batchSize; i++) {
+					frames.emplace_back(wave.data() + i * stride, fftSize);
+				}
+
+				result.resize(static_cast<size_t>(batchSize * fftSize / 2));
+			}
+		};
+
+		// checksum makes sure that results are used
+		double measureSingle(RealFft& fft, Case& c, double& checksum) {
+			const index valuesCount = c.fftSize / 2;
+
+			const auto begin = clock::now();
+			for (index batch = 0; batch < c.batchesCount; batch++) {
+				for (index i = 0; i < c.batchSize; i++) {
+					fft.process(c.frames[static_cast<size_t>(i)]);
+					fft.fillMagnitudes({ c.result.data() + i * valuesCount, valuesCount });
+				}
+				checksum += static_cast<double>(c.result[1]);
+			}
+			const auto end = clock::now();
+
+			return std::chrono::duration<double, std::milli>{ end - begin }.count();
+		}
+
+		double measureBatch(RealFft& fft, Case& c, double& checksum) {
+			const auto begin = clock::now();
+			for (index batch = 0; batch < c.batchesCount; batch++) {
+				fft.processBatch(c.frames, c.result);
+				checksum += static_cast<double>(c.result[1]);
+			}
+			const auto end = clock::now();
+
+			return std::chrono::duration<double, std::milli>{ end - begin }.count();
+		}
+	}
+
+	int runFftBench(array_view<string> args) {
+		const BenchArguments benchArgs = parseBenchArguments(args);
+
+		std::wcout << benchArgs.samples << L" samples for each case\n";
+
+		double checksum = 0.0;
+		for (const index fftSize : { 256, 1024, 4096, 16384 }) {
+			RealFft fft;
+			std::vector<float> window;
+			window.resize(static_cast<size_t>(fftSize));
+			fft_utils::WindowFunctionHelper::createCosineSum(window, 0.5f);
+			fft.setParams(fftSize, window);
+
+			std::wcout << L"fft size " << fftSize << L'\n';
+
+			for (const index batchSize : { 1, 2, 8, 16 }) {
+				Case c{ fftSize, batchSize, benchArgs.samples };
+
+				const double singleMs = measureSingle(fft, c, checksum);
+				const double batchMs = measureBatch(fft, c, checksum);
+				const double transformsCount = static_cast<double>(c.batchesCount * batchSize);
+
+				std::wcout << L"  batch " << batchSize << L":"
+					<< L" single " << singleMs * 1000.0 / transformsCount << L" us per frame"
+					<< L", batch " << batchMs * 1000.0 / transformsCount << L" us per frame"
+					<< L" (" << singleMs / batchMs << L"x)\n";
+			}
+		}
+		std::wcout << L"checksum " << checksum << L'\n';
+
+		return 0;
+	}
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+//
+// Compares RealFft::processBatch with transforming frames one by one.
+//
+// For each fft size and batch size, the same amount of samples is transformed
+// with RealFft::process + RealFft::fillMagnitudes called for each frame,
+// and with one RealFft::processBatch call for each batch.
+// Frames overlap the same way they do in FftCascade with overlap boost of 4.
+//
+// Usage:
+//   AudioAnalyzerBenchmark --fft-bench [options]
+//
+// Options:
+//   --samples <count>    count of transformed samples for each case, default: 50000000
+//
+
+#pragma once
+
+namespace rxtd::audio_analyzer::benchmark {
+	int runFftBench(array_view<string> args);
+}
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "FftTune.h"
+
+#include <filesystem>
+#include <iostream>
+
+#include "rxtd/fft_utils/FftSizeTuner.h"
+#include "rxtd/std_fixes/StringUtils.h"
+
+namespace rxtd::audio_analyzer::benchmark {
+	namespace {
+		using FftSizeTuner = fft_utils::FftSizeTuner;
+
+		struct TuneArguments {
+			index minSize = 256;
+			index maxSize = 16384;
+			std::filesystem::path cache;
+		};
+
+		TuneArguments parseTuneArguments(array_view<string> args) {
+			TuneArguments result;
+
+			for (index i = 0; i < args.size(); i += 2) {
+				if (i + 1 >= args.size()) {
+					throw std::runtime_error{ "option without value" };
+				}
+
+				const isview name = args[i] % ciView();
+				const sview value = args[i + 1];
+
+				if (name == L"--min-size") {
+					result.minSize = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--max-size") {
+					result.maxSize = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--cache") {
+					result.cache = std::filesystem::path{ std::wstring_view{ value } };
+				} else {
+					throw std::runtime_error{ "unknown option" };
+				}
+			}
+
+			if (result.minSize <= 0 || result.maxSize < result.minSize) {
+				throw std::runtime_error{ "invalid size range" };
+			}
+
+			return result;
+		}
+	}
+
+	int runFftTune(array_view<string> args) {
+		const TuneArguments tuneArgs = parseTuneArguments(args);
+
+		const index fastest = FftSizeTuner::findFastestSize(tuneArgs.cache, tuneArgs.minSize, tuneArgs.maxSize, 0, true);
+
+		auto measurements = FftSizeTuner::getMeasurements(tuneArgs.cache);
+		if (tuneArgs.cache.empty()) {
+			// without cache file, only the requested range was measured
+			std::sort(
+				measurements.begin(), measurements.end(), [](const auto& a, const auto& b) {
+					return a.size < b.size;
+				}
+			);
+		}
+		FftSizeTuner::exportCsv(measurements, std::cout);
+
+		std::cerr << "cpu: " << FftSizeTuner::getCpuModel() << '\n';
+		std::cerr << "fastest size in range: " << fastest << '\n';
+
+		return 0;
+	}
+}
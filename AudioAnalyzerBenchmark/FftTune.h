@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+//
+// Measures real fft sizes the same way FftAnalyzer does with Autotune=1,
+// and prints the table as CSV, so that results can be compared across machines.
+//
+// All sizes that FftAnalyzer can use in the range are measured.
+// With --cache, sizes that are already in the file for this CPU are not measured again,
+// new results are added to the file, and the whole file is printed, including other CPUs.
+//
+// Usage:
+//   AudioAnalyzerBenchmark --fft-tune [options]
+//
+// Options:
+//   --min-size <size>    default: 256
+//   --max-size <size>    default: 16384
+//   --cache <path>       file in the format of FftSizeTuning.tsv, default: none
+//
+
+#pragma once
+
+namespace rxtd::audio_analyzer::benchmark {
+	int runFftTune(array_view<string> args);
+}
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "ImageBench.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+#include "rxtd/TripleBuffer.h"
+#include "rxtd/audio_analyzer/image_utils/BmpWriter.h"
+#include "rxtd/audio_analyzer/image_utils/ImageWriteHelper.h"
+#include "rxtd/audio_analyzer/image_utils/StripedImage.h"
+#include "rxtd/audio_analyzer/image_utils/StripedImageCopy.h"
+#include "rxtd/std_fixes/StringUtils.h"
+
+namespace rxtd::audio_analyzer::benchmark {
+	namespace {
+		using IntColor = image_utils::IntColor;
+		using StripedImage = image_utils::StripedImage<IntColor>;
+		using clock = std::chrono::steady_clock;
+
+		struct BenchArguments {
+			index width = 1920;
+			index height = 512;
+			index strips = 4;
+			index updates = 600;
+			double updateRate = 60.0;
+			string folder = L"bench_output/";
+		};
+
+		BenchArguments parseBenchArguments(array_view<string> args) {
+			BenchArguments result;
+
+			for (index i = 0; i < args.size(); i += 2) {
+				if (i + 1 >= args.size()) {
+					throw std::runtime_error{ "option without value" };
+				}
+
+				const isview name = args[i] % ciView();
+				const sview value = args[i + 1];
+
+				if (name == L"--width") {
+					result.width = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--height") {
+					result.height = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--strips") {
+					result.strips = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--updates") {
+					result.updates = std_fixes::StringUtils::parseInt(value);
+				} else if (name == L"--update-rate") {
+					result.updateRate = std_fixes::StringUtils::parseFloat(value);
+				} else if (name == L"--folder") {
+					result.folder = value;
+				} else {
+					throw std::runtime_error{ "unknown option" };
+				}
+			}
+
+			if (result.width <= 0 || result.height <= 0 || result.strips <= 0 || result.updates <= 0 || result.updateRate <= 0.0) {
+				throw std::runtime_error{ "all values must be positive" };
+			}
+
+			return result;
+		}
+
+		enum class Method {
+			eFULL,
+			eINCREMENTAL,
+		};
+
+		struct Result {
+			double publishMs = 0.0;
+			double timeMs = 0.0;
+			index bytes = 0;
+			bool fileIsValid = false;
+		};
+
+		void fillStrip(std::vector<IntColor>& strip, std::mt19937& random) {
+			for (auto& pixel : strip) {
+				pixel.value.full = static_cast<uint32_t>(random()) | 0xFF000000u;
+			}
+		}
+
+		bool checkFile(const std::filesystem::path& path, std_fixes::array2d_view<IntColor> pixels) {
+			std::ostringstream expected;
+			image_utils::BmpWriter::writeFile(expected, pixels);
+
+			std::ifstream file(path, std::ios::binary);
+			const std::string actual{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+			return actual == expected.str();
+		}
+
+		Result runCase(const BenchArguments& benchArgs, bool stationary, Method method, const std::filesystem::path& path) {
+			StripedImage image;
+			image.setParams(benchArgs.width, benchArgs.height, {}, stationary);
+
+			std::vector<IntColor> strip;
+			strip.resize(static_cast<size_t>(benchArgs.height));
+			std::mt19937 random{ 42 };
+
+			// Snapshots travel like in ParentHelper: handler updates the copy that the orchestrator owns,
+			// then it is swapped into the write buffer of a TripleBuffer, and the main thread acquires the latest one.
+			// So there are 4 copies in rotation, and the copy that comes back to the handler is several updates old.
+			std_fixes::Vector2D<IntColor> fullSnapshot;
+			TripleBuffer<std_fixes::Vector2D<IntColor>> fullSnapshots;
+			image_utils::StripedImageCopy snapshot;
+			TripleBuffer<image_utils::StripedImageCopy> snapshots;
+
+			image_utils::ImageWriteHelper writeHelper;
+			const string pathString = path.wstring();
+
+			Result result;
+			for (index update = 0; update < benchArgs.updates; update++) {
+				for (index i = 0; i < benchArgs.strips; i++) {
+					fillStrip(strip, random);
+					image.pushStrip(strip);
+				}
+
+				const auto publishBegin = clock::now();
+				if (method == Method::eFULL) {
+					fullSnapshot.copyWithResize(image.getPixels());
+					std::swap(fullSnapshot, fullSnapshots.getWriteBuffer());
+					fullSnapshots.publish();
+				} else {
+					snapshot.update(image.getPixels(), image.getVersion());
+					std::swap(snapshot, snapshots.getWriteBuffer());
+					snapshots.publish();
+				}
+				const auto publishEnd = clock::now();
+
+				// main thread reads after each update
+				if (method == Method::eFULL) {
+					fullSnapshots.acquire();
+					std::ofstream fileStream(path, std::ios::binary);
+					image_utils::BmpWriter::writeFile(fileStream, fullSnapshots.getReadBuffer());
+					result.bytes += image_utils::BmpWriter::getFileSize(benchArgs.width, benchArgs.height);
+				} else {
+					snapshots.acquire();
+					writeHelper.write(snapshots.getReadBuffer(), false, pathString);
+				}
+				const auto writeEnd = clock::now();
+
+				result.publishMs += std::chrono::duration<double, std::milli>{ publishEnd - publishBegin }.count();
+				result.timeMs += std::chrono::duration<double, std::milli>{ writeEnd - publishEnd }.count();
+			}
+
+			if (method == Method::eINCREMENTAL) {
+				result.bytes = writeHelper.getBytesWritten();
+			}
+			result.fileIsValid = checkFile(path, image.getPixels());
+
+			return result;
+		}
+	}
+
+	int runImageBench(array_view<string> args) {
+		const BenchArguments benchArgs = parseBenchArguments(args);
+
+		const std::filesystem::path folder{ static_cast<const std::wstring&>(benchArgs.folder) };
+		std::filesystem::create_directories(folder);
+
+		std::wcout << benchArgs.width << L"x" << benchArgs.height << L" image, "
+			<< benchArgs.strips << L" strips per update, " << benchArgs.updates << L" updates\n";
+
+		bool allValid = true;
+		for (const bool stationary : { true, false }) {
+			std::wcout << (stationary ? L"stationary\n" : L"scrolling\n");
+
+			for (const auto method : { Method::eFULL, Method::eINCREMENTAL }) {
+				const auto path = folder / (method == Method::eFULL ? L"image-bench-full.bmp" : L"image-bench-incremental.bmp");
+				const auto result = runCase(benchArgs, stationary, method, path);
+
+				const double updates = static_cast<double>(benchArgs.updates);
+				const double bytesPerUpdate = static_cast<double>(result.bytes) / updates;
+				std::wcout << (method == Method::eFULL ? L"  full rewrite: " : L"  incremental:  ")
+					<< L"copy " << result.publishMs / updates << L" ms, "
+					<< L"write " << result.timeMs / updates << L" ms per update, "
+					<< bytesPerUpdate / 1024.0 << L" KiB per update, "
+					<< bytesPerUpdate * benchArgs.updateRate / (1024.0 * 1024.0) << L" MiB/s"
+					<< (result.fileIsValid ? L"" : L", FILE IS INVALID") << L'\n';
+
+				allValid = allValid && result.fileIsValid;
+			}
+		}
+
+		return allValid ? 0 : 1;
+	}
+}
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+//
+// Compares snapshot copies and file writes of Spectrogram images.
+//
+// A stationary and a scrolling image get new strips before each update.
+// After each update the image is copied into a snapshot and written into a file.
+// Old way: full copy of all pixels and rewrite of the whole file.
+// New way: StripedImageCopy, which only copies new strips,
+// and ImageWriteHelper, which only writes changed columns.
+// After the last update the file is checked against the image.
+//
+// Usage:
+//   AudioAnalyzerBenchmark --image-bench [options]
+//
+// Options:
+//   --width <pixels>         width of the image, default: 1920
+//   --height <pixels>        height of the image, default: 512
+//   --strips <count>         new strips before each update, default: 4
+//   --updates <count>        count of updates for each case, default: 600
+//   --update-rate <count>    updates per second, to compute bytes per second, default: 60
+//   --folder <path>          where files are written, default: bench_output/
+//
+
+#pragma once
+
+namespace rxtd::audio_analyzer::benchmark {
+	int runImageBench(array_view<string> args);
+}
@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "IniOptionProvider.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "rxtd/std_fixes/StringUtils.h"
+
+using rxtd::audio_analyzer::benchmark::IniOptionProvider;
+using rxtd::std_fixes::StringUtils;
+
+IniOptionProvider::IniOptionProvider(const std::filesystem::path& file, sview sectionName) {
+	currentPath = std::filesystem::absolute(file).parent_path();
+
+	const string text = readText(file);
+
+	Section* currentSection = nullptr;
+	bool sectionFound = false;
+	sview textView = text;
+	while (!textView.empty()) {
+		const auto lineEnd = textView.find(L'\n');
+		sview line = textView.substr(0, lineEnd);
+		textView = lineEnd == sview::npos ? sview{} : textView.substr(lineEnd + 1);
+
+		line = StringUtils::trim(line);
+		if (line.empty() || line.front() == L';') {
+			continue;
+		}
+
+		if (line.front() == L'[') {
+			const auto nameEnd = line.find(L']');
+			if (nameEnd == sview::npos) {
+				currentSection = nullptr;
+				continue;
+			}
+			const auto name = StringUtils::trim(line.substr(1, nameEnd - 1)) % ciView();
+			if (name == L"Variables") {
+				currentSection = &variables;
+			} else if (name == sectionName % ciView()) {
+				currentSection = &options;
+				sectionFound = true;
+			} else {
+				currentSection = nullptr;
+			}
+			continue;
+		}
+
+		if (currentSection == nullptr) {
+			continue;
+		}
+
+		const auto delimiter = line.find(L'=');
+		if (delimiter == sview::npos) {
+			continue;
+		}
+
+		const auto key = StringUtils::trim(line.substr(0, delimiter)) % ciView();
+		sview value = StringUtils::trim(line.substr(delimiter + 1));
+		// same as in Rainmeter: one pair of quotes around the value is removed
+		if (value.length() >= 2 && value.front() == L'"' && value.back() == L'"') {
+			value = value.substr(1, value.length() - 2);
+		}
+
+		// same as in Rainmeter: first definition wins
+		currentSection->emplace(key % own(), value % own());
+	}
+
+	if (!sectionFound) {
+		throw FileException{ "section is not found" };
+	}
+
+	variables[L"CURRENTPATH"] = getPathFromCurrent({});
+	variables[L"@"] = getPathFromCurrent(L"@Resources");
+}
+
+rxtd::option_parsing::Option IniOptionProvider::read(sview optionName) const {
+	const auto iter = options.find(optionName % ciView());
+	if (iter == options.end()) {
+		return {};
+	}
+
+	const string value = replaceVariables(iter->second);
+	option_parsing::Option result{ sview{ value } };
+	result.own();
+	return result;
+}
+
+rxtd::string IniOptionProvider::getPathFromCurrent(string folder) const {
+	std::filesystem::path path{ static_cast<std::wstring&>(folder) };
+	if (!path.is_absolute()) {
+		path = currentPath / path;
+	}
+
+	string result = std::filesystem::absolute(path).wstring();
+	if (result.back() != static_cast<wchar_t>(std::filesystem::path::preferred_separator)) {
+		result += static_cast<wchar_t>(std::filesystem::path::preferred_separator);
+	}
+
+	return result;
+}
+
+rxtd::Logger IniOptionProvider::createLogger() const {
+	return Logger{ {}, &writeLog };
+}
+
+rxtd::string IniOptionProvider::replaceVariables(sview value) const {
+	string result{ value };
+
+	// variables can reference other variables, but there is no point in going too deep
+	for (int pass = 0; pass < 10; pass++) {
+		bool changed = false;
+		string next;
+
+		sview view = result;
+		while (true) {
+			const auto begin = view.find(L'#');
+			if (begin == sview::npos) {
+				next += view;
+				break;
+			}
+			const auto end = view.find(L'#', begin + 1);
+			if (end == sview::npos) {
+				next += view;
+				break;
+			}
+
+			const auto name = view.substr(begin + 1, end - begin - 1);
+			const auto iter = variables.find(name % ciView());
+			if (iter == variables.end()) {
+				// not a variable, keep the first # and continue from the second
+				next += view.substr(0, end);
+				view = view.substr(end);
+				continue;
+			}
+
+			next += view.substr(0, begin);
+			next += iter->second;
+			view = view.substr(end + 1);
+			changed = true;
+		}
+
+		result = std::move(next);
+		if (!changed) {
+			break;
+		}
+	}
+
+	return result;
+}
+
+rxtd::string IniOptionProvider::readText(const std::filesystem::path& file) {
+	std::ifstream stream{ file, std::ios::binary };
+	if (!stream) {
+		throw FileException{ "can't open file" };
+	}
+
+	const std::string bytes{ std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{} };
+
+	// Rainmeter skins are usually either UTF-16 LE with BOM or UTF-8
+	if (bytes.size() >= 2 && bytes[0] == '\xFF' && bytes[1] == '\xFE') {
+		string result;
+		result.reserve(bytes.size() / 2);
+		for (size_t i = 2; i + 1 < bytes.size(); i += 2) {
+			const auto low = static_cast<uint8_t>(bytes[i]);
+			const auto high = static_cast<uint8_t>(bytes[i + 1]);
+			result += static_cast<wchar_t>(low | high << 8);
+		}
+		return result;
+	}
+
+	sview::size_type offset = 0;
+	if (bytes.size() >= 3 && bytes.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+		offset = 3;
+	}
+
+	return string{ std::filesystem::u8path(bytes.begin() + offset, bytes.end()).wstring() };
+}
+
+void IniOptionProvider::writeLog(std_fixes::AnyContainer&, Logger::LogLevel level, sview message) {
+	const wchar_t* prefix = L"";
+	switch (level) {
+	case Logger::LogLevel::eERROR: prefix = L"error: ";
+		break;
+	case Logger::LogLevel::eWARNING: prefix = L"warning: ";
+		break;
+	case Logger::LogLevel::eNOTICE: prefix = L"notice: ";
+		break;
+	case Logger::LogLevel::eDEBUG: prefix = L"debug: ";
+		break;
+	}
+
+	std::wcerr << prefix << message << L'\n';
+}
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include <filesystem>
+
+#include "rxtd/audio_analyzer/options/OptionProvider.h"
+
+namespace rxtd::audio_analyzer::benchmark {
+	/// <summary>
+	/// Reads options of one section of a skin file,
+	/// so that the same parent measure description can be used both in Rainmeter and in the benchmark.
+	/// Supports variables from [Variables] section and #CURRENTPATH#, #@#.
+	/// Doesn't support @include, measure values or anything else that needs Rainmeter.
+	/// </summary>
+	class IniOptionProvider : public options::OptionProvider {
+	public:
+		class FileException : public std::runtime_error {
+		public:
+			explicit FileException(const char* reason) : runtime_error(reason) {}
+		};
+
+	private:
+		using Section = std::map<istring, string, std::less<>>;
+
+		std::filesystem::path currentPath;
+		Section variables;
+		Section options;
+
+	public:
+		// Can throw FileException
+		IniOptionProvider(const std::filesystem::path& file, sview sectionName);
+
+		[[nodiscard]]
+		option_parsing::Option read(sview optionName) const override;
+
+		[[nodiscard]]
+		string getPathFromCurrent(string folder) const override;
+
+		[[nodiscard]]
+		Logger createLogger() const override;
+
+	private:
+		[[nodiscard]]
+		string replaceVariables(sview value) const;
+
+		[[nodiscard]]
+		static string readText(const std::filesystem::path& file);
+
+		static void writeLog(std_fixes::AnyContainer& dataContainer, Logger::LogLevel level, sview message);
+	};
+}
@@ -0,0 +1,12 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+
+namespace rxtd::audio_analyzer::benchmark {
+	[[nodiscard]]
+	inline double getPercentile(array_view<double> sorted, double percentile) {
+		const auto position = static_cast<index>(percentile * static_cast<double>(sorted.size() - 1));
+		return sorted[position];
+	}
+}
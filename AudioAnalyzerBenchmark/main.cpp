@@ -0,0 +1,353 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+//
+// Runs processings of a parent measure outside of Rainmeter, as fast as possible,
+// and reports time and memory allocations per update.
+//
+// Usage:
+//   AudioAnalyzerBenchmark <skin file> <parent section> [options]
+//   AudioAnalyzerBenchmark --exchange-stress [options]    see ExchangeStress.h
+//   AudioAnalyzerBenchmark --block-bench [options]        see BlockBench.h
+//   AudioAnalyzerBenchmark --downsample-bench [options]   see DownsampleBench.h
+//   AudioAnalyzerBenchmark --fft-bench [options]          see FftBench.h
+//   AudioAnalyzerBenchmark --fft-tune [options]           see FftTune.h
+//   AudioAnalyzerBenchmark --image-bench [options]        see ImageBench.h
+//   AudioAnalyzerBenchmark --capture-stress [options]     see CaptureStress.h
+//   AudioAnalyzerBenchmark --convert-bench [options]      see ConvertBench.h
+//
+// Options:
+//   --source <silence|sweep|pink|wav:<path>|raw:<path>>    default: sweep
+//   --sample-type <s16|s24|s32|f32>     sample format of raw files, default: f32
+//   --rate <samples per second>         sample rate of generated signals and raw files, default: 48000
+//   --channels <count>                  channels count of generated signals and raw files, default: 2
+//   --update-rate <updates per second>  how often the skin would be updated, default: 60
+//   --duration <seconds>                length of audio to process, default: 60
+//   --warmup <updates>                  updates excluded from statistics, default: 10
+//   --threads <count>                   processing threads, like ProcessingThreads in Threading option, default: 1
+//
+// Update time covers capture and processing, like in the processing thread of the plugin.
+// Finish time covers what the plugin does in the main thread on each skin update, like writing images.
+//
+
+#include <chrono>
+#include <iostream>
+#include <numeric>
+
+#include "AllocationCounter.h"
+#include "BlockBench.h"
+#include "CaptureStress.h"
+#include "ConvertBench.h"
+#include "DownsampleBench.h"
+#include "ExchangeStress.h"
+#include "FftBench.h"
+#include "FftTune.h"
+#include "ImageBench.h"
+#include "IniOptionProvider.h"
+#include "Statistics.h"
+#include "rxtd/audio_analyzer/options/ParamHelper.h"
+#include "rxtd/audio_analyzer/sound_processing/ProcessingOrchestrator.h"
+#include "rxtd/audio_analyzer/sound_processing/audio_sources/PcmFileSource.h"
+#include "rxtd/audio_analyzer/sound_processing/audio_sources/SyntheticSource.h"
+#include "rxtd/std_fixes/StringUtils.h"
+
+namespace rxtd::audio_analyzer::benchmark {
+	struct Arguments {
+		std::filesystem::path skinFile;
+		string section;
+		string source = L"sweep";
+		PcmFileSource::SampleType sampleType = PcmFileSource::SampleType::eFLOAT32;
+		index sampleRate = 48000;
+		index channelsCount = 2;
+		double updateRate = 60.0;
+		double duration = 60.0;
+		index warmup = 10;
+		index threadsCount = 1;
+	};
+
+	class ArgumentsException : public std::runtime_error {
+	public:
+		explicit ArgumentsException(const char* reason) : runtime_error(reason) {}
+	};
+
+	Arguments parseArguments(array_view<string> args) {
+		if (args.size() < 2) {
+			throw ArgumentsException{ "skin file and section name are required" };
+		}
+
+		Arguments result;
+		result.skinFile = std::filesystem::path{ static_cast<const std::wstring&>(args[0]) };
+		result.section = args[1];
+
+		for (index i = 2; i < args.size(); i += 2) {
+			if (i + 1 >= args.size()) {
+				throw ArgumentsException{ "option without value" };
+			}
+
+			const isview name = args[i] % ciView();
+			const sview value = args[i + 1];
+
+			if (name == L"--source") {
+				result.source = value;
+			} else if (name == L"--sample-type") {
+				const auto typeOpt = parseEnum<PcmFileSource::SampleType>(value % ciView());
+				if (!typeOpt.has_value()) {
+					throw ArgumentsException{ "unknown sample type" };
+				}
+				result.sampleType = typeOpt.value();
+			} else if (name == L"--rate") {
+				result.sampleRate = std_fixes::StringUtils::parseInt(value);
+			} else if (name == L"--channels") {
+				result.channelsCount = std_fixes::StringUtils::parseInt(value);
+			} else if (name == L"--update-rate") {
+				result.updateRate = std_fixes::StringUtils::parseFloat(value);
+			} else if (name == L"--duration") {
+				result.duration = std_fixes::StringUtils::parseFloat(value);
+			} else if (name == L"--warmup") {
+				result.warmup = std_fixes::StringUtils::parseInt(value);
+			} else if (name == L"--threads") {
+				result.threadsCount = std_fixes::StringUtils::parseInt(value);
+			} else {
+				throw ArgumentsException{ "unknown option" };
+			}
+		}
+
+		if (result.sampleRate <= 0 || result.channelsCount <= 0 || result.updateRate <= 0.0 || result.duration <= 0.0 || result.threadsCount <= 0) {
+			throw ArgumentsException{ "rate, channels, update rate, duration and threads must be positive" };
+		}
+
+		return result;
+	}
+
+	std::unique_ptr<OfflineSource> createSource(const Arguments& args) {
+		const isview source = args.source % ciView();
+
+		if (source.substr(0, 4) == L"wav:") {
+			auto wav = PcmFileSource::readWav(std::filesystem::path{ args.source.c_str() + 4 });
+			wav.setLoop(true);
+			return std::make_unique<PcmFileSource>(std::move(wav));
+		}
+
+		if (source.substr(0, 4) == L"raw:") {
+			PcmFileSource::RawFormat format;
+			format.type = args.sampleType;
+			format.sampleRate = args.sampleRate;
+			format.channelsCount = args.channelsCount;
+			auto raw = PcmFileSource::readRaw(std::filesystem::path{ args.source.c_str() + 4 }, format);
+			raw.setLoop(true);
+			return std::make_unique<PcmFileSource>(std::move(raw));
+		}
+
+		const auto signalOpt = parseEnum<SyntheticSource::Signal>(source);
+		if (!signalOpt.has_value()) {
+			throw ArgumentsException{ "unknown source" };
+		}
+
+		SyntheticSource::Params params;
+		params.signal = signalOpt.value();
+		params.sampleRate = args.sampleRate;
+		params.channelsCount = args.channelsCount;
+		return std::make_unique<SyntheticSource>(params);
+	}
+
+	// Same as AudioParent::runFinishers: this is where images are written
+	void runFinishers(
+		const options::ParamHelper::ProcessingsInfoMap& processings,
+		const ProcessingOrchestrator::Snapshot& snapshot,
+		Version version,
+		buffer_printer::BufferPrinter& printer,
+		option_parsing::OptionParser& parser
+	) {
+		for (const auto& [procName, procInfo] : processings) {
+			auto procIter = snapshot.find(procName);
+			if (procIter == snapshot.end()) { continue; }
+
+			for (const auto channel : procInfo.channels) {
+				auto channelIter = procIter->second.find(channel);
+				if (channelIter == procIter->second.end()) { continue; }
+
+				for (const auto& [handlerName, handlerInfo] : procInfo.handlers) {
+					const auto finisher = handlerInfo.meta.externalMethods.finish;
+					auto handlerSnapshot = channelIter->second.find(handlerName);
+					if (finisher == nullptr || handlerSnapshot == nullptr) { continue; }
+
+					handler::ExternalMethods::CallContext context{
+						version,
+						ChannelUtils::getTechnicalName(channel),
+						L"",
+						printer,
+						parser
+					};
+
+					printer.print(L"{}-{}-{}", procName, handlerName, context.channelName);
+					string filePrefix = string{ printer.getBufferView() };
+					context.filePrefix = filePrefix;
+
+					finisher(handlerSnapshot->handlerSpecificData, context);
+				}
+			}
+		}
+	}
+
+	int run(const Arguments& args) {
+		const IniOptionProvider optionProvider{ args.skinFile, args.section };
+		const Logger logger = optionProvider.createLogger();
+		const Version version{};
+
+		auto parser = option_parsing::OptionParser::getDefault();
+		parser.setLogger(logger);
+		buffer_printer::BufferPrinter printer;
+
+		options::ParamHelper paramHelper;
+		paramHelper.setParser(parser);
+		paramHelper.setOptionProvider(optionProvider);
+		try {
+			paramHelper.readOptions(version);
+		} catch (options::ParamHelper::InvalidOptionsException&) {
+			logger.error(L"invalid options");
+			return 1;
+		}
+
+		auto source = createSource(args);
+		source->setBlockSizeForUpdateRate(args.updateRate);
+		try {
+			source->setDownmix(DownmixMatrix::parse(optionProvider.read(L"Downmix"), parser, logger));
+		} catch (option_parsing::OptionParser::Exception&) {
+			logger.error(L"invalid options");
+			return 1;
+		}
+
+		ProcessingOrchestrator orchestrator;
+		orchestrator.setLogger(logger);
+		// measurements must not be affected by limits that make sense for real time
+		orchestrator.setWarnTime(-1.0);
+		orchestrator.setKillTimeout(std::numeric_limits<double>::max() / 2.0);
+		orchestrator.setThreadsCount(args.threadsCount);
+		orchestrator.patch(
+			paramHelper.getParseResult(),
+			version,
+			source->getSampleRate(),
+			source->getChannelLayout().getOrdered()
+		);
+
+		ProcessingOrchestrator::Snapshot snapshot;
+		orchestrator.configureSnapshot(snapshot);
+
+		const auto updatesCount = static_cast<index>(args.duration * args.updateRate);
+		std::vector<double> updateTimes;
+		updateTimes.reserve(static_cast<size_t>(updatesCount));
+		double finishTime = 0.0;
+
+		using clock = std::chrono::steady_clock;
+		AllocationCounter::Stats allocations{};
+		AllocationCounter::Stats finishAllocations{};
+		index framesMeasured = 0;
+
+		for (index i = 0; i < args.warmup + updatesCount; i++) {
+			const auto allocationsBefore = AllocationCounter::get();
+			const auto framesBefore = source->getFramesProduced();
+			const auto begin = clock::now();
+
+			if (!source->capture()) {
+				break;
+			}
+			orchestrator.process(source->getChannelMixer());
+			orchestrator.exchangeData(snapshot);
+
+			const auto end = clock::now();
+			const auto allocationsAfter = AllocationCounter::get();
+
+			runFinishers(paramHelper.getParseResult(), snapshot, version, printer, parser);
+
+			const auto finishEnd = clock::now();
+			if (i < args.warmup) {
+				continue;
+			}
+
+			updateTimes.push_back(std::chrono::duration<double, std::milli>{ end - begin }.count());
+			finishTime += std::chrono::duration<double, std::milli>{ finishEnd - end }.count();
+			allocations = allocations + (allocationsAfter - allocationsBefore);
+			finishAllocations = finishAllocations + (AllocationCounter::get() - allocationsAfter);
+			framesMeasured += source->getFramesProduced() - framesBefore;
+		}
+
+		if (updateTimes.empty()) {
+			logger.error(L"source didn't produce any data");
+			return 1;
+		}
+
+		const double totalTime = std::accumulate(updateTimes.begin(), updateTimes.end(), 0.0);
+		std::sort(updateTimes.begin(), updateTimes.end());
+		const double audioTime = static_cast<double>(framesMeasured) / static_cast<double>(source->getSampleRate());
+		const auto updates = static_cast<double>(updateTimes.size());
+
+		std::wcout << L"updates:          " << updateTimes.size() << L" x " << source->getBlockSize() << L" frames\n";
+		std::wcout << L"update time, ms:  mean " << totalTime / updates
+			<< L", p50 " << getPercentile(updateTimes, 0.5)
+			<< L", p99 " << getPercentile(updateTimes, 0.99)
+			<< L", max " << updateTimes.back() << L'\n';
+		std::wcout << L"finish time, ms:  mean " << finishTime / updates << L'\n';
+		std::wcout << L"realtime ratio:   " << audioTime / (totalTime / 1000.0) << L'\n';
+		std::wcout << L"allocations:      " << allocations.count << L" (" << allocations.bytes << L" bytes), "
+			<< static_cast<double>(allocations.count) / updates << L" per update\n";
+		std::wcout << L"finish allocs:    " << finishAllocations.count << L" (" << finishAllocations.bytes << L" bytes), "
+			<< static_cast<double>(finishAllocations.count) / updates << L" per update\n";
+
+		return 0;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	std::vector<rxtd::string> args;
+	for (int i = 1; i < argc; i++) {
+		args.emplace_back(std::filesystem::path{ argv[i] }.wstring());
+	}
+
+	try {
+		using namespace rxtd::audio_analyzer::benchmark;
+		if (!args.empty() && args[0] == L"--exchange-stress") {
+			array_view<rxtd::string> options = args;
+			options.remove_prefix(1);
+			return runExchangeStress(options);
+		}
+		if (!args.empty() && args[0] == L"--block-bench") {
+			array_view<rxtd::string> options = args;
+			options.remove_prefix(1);
+			return runBlockBench(options);
+		}
+		if (!args.empty() && args[0] == L"--downsample-bench") {
+			array_view<rxtd::string> options = args;
+			options.remove_prefix(1);
+			return runDownsampleBench(options);
+		}
+		if (!args.empty() && args[0] == L"--fft-bench") {
+			array_view<rxtd::string> options = args;
+			options.remove_prefix(1);
+			return runFftBench(options);
+		}
+		if (!args.empty() && args[0] == L"--fft-tune") {
+			array_view<rxtd::string> options = args;
+			options.remove_prefix(1);
+			return runFftTune(options);
+		}
+		if (!args.empty() && args[0] == L"--image-bench") {
+			array_view<rxtd::string> options = args;
+			options.remove_prefix(1);
+			return runImageBench(options);
+		}
+		if (!args.empty() && args[0] == L"--capture-stress") {
+			array_view<rxtd::string> options = args;
+			options.remove_prefix(1);
+			return runCaptureStress(options);
+		}
+		if (!args.empty() && args[0] == L"--convert-bench") {
+			array_view<rxtd::string> options = args;
+			options.remove_prefix(1);
+			return runConvertBench(options);
+		}
+		return run(parseArguments(args));
+	} catch (std::runtime_error& e) {
+		std::cerr << "error: " << e.what() << '\n';
+		return 1;
+	}
+}
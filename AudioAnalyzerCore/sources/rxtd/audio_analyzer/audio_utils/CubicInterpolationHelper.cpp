@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2020 Danil Uzlov
+
+#include "CubicInterpolationHelper.h"
+
+using rxtd::audio_analyzer::audio_utils::CubicInterpolationHelper;
+
+void CubicInterpolationHelper::calcDerivatives(array_view<float> values, array_span<float> result) {
+	//	Derivatives are calculated using FritschCarlson method as in
+	//		https://math.stackexchange.com/questions/45218/implementation-of-monotone-cubic-interpolation/51412#51412
+	//	to ensure monotonic behavior
+	//
+
+	const index size = values.size();
+	if (size < 2) {
+		std::fill(result.begin(), result.end(), 0.0f);
+		return;
+	}
+
+	result[0] = values[1] - values[0];
+	for (index ind = 1; ind < size - 1; ind++) {
+		const float left = values[ind] - values[ind - 1];
+		const float right = values[ind + 1] - values[ind];
+
+		result[ind] = left * right <= 0.0f ? 0.0f : 6.0f / (3.0f / left + 3.0f / right);
+	}
+	result[size - 1] = values[size - 1] - values[size - 2];
+}
+
+CubicInterpolationHelper::Weights CubicInterpolationHelper::calcWeights(double dx) {
+	// Solving:
+	// f(x) == a*x^3 + b*x^2 + c*x + d
+	// f(x1) == v1
+	// f(x2) == v2
+	// f'(x1) == q1
+	// f'(x2) == q2
+	// 
+	// a*x1^3 + b*x1^2 + c*x1 + d == v1
+	// a*x2^3 + b*x2^2 + c*x2 + d == v2
+	// 3*a*x1^2 + 2*b*x1 + c == q1
+	// 3*a*x2^2 + 2*b*x2 + c == q2
+	//
+	// We shift x1 to 0.0 and x2 to 1.0 and get:
+	//	d == v1
+	//	a + b + c + d == v2
+	//	c == q1
+	//	3*a + 2*b + c == q2
+	//
+	//	a + b == v2 - c - d == v2 - q1 - v1
+	//	3*a + 2*b == q2 - c == q2 - q1
+	//	a == (q2 - q1) - (v2 - q1 - v1) * 2
+	//	  == 2*v1 - 2*v2 + q1 + q2
+	//	b == v2 - q1 - v1 - a
+	//	  == v2 - q1 - v1 - (2*v1 - 2*v2 + q1 + q2)
+	//	  == -3*v1 + 3*v2 - 2*q1 - q2
+	//
+	//	Grouping a*dx^3 + b*dx^2 + c*dx + d by v1, v2, q1, q2 gives the weights
+	//
+
+	const double dx2 = dx * dx;
+	const double dx3 = dx2 * dx;
+
+	Weights result;
+	result.value1 = static_cast<float>(2.0 * dx3 - 3.0 * dx2 + 1.0);
+	result.value2 = static_cast<float>(-2.0 * dx3 + 3.0 * dx2);
+	result.derivative1 = static_cast<float>(dx3 - 2.0 * dx2 + dx);
+	result.derivative2 = static_cast<float>(dx3 - dx2);
+	return result;
+}
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2020 Danil Uzlov
+
+#pragma once
+
+namespace rxtd::audio_analyzer::audio_utils {
+	//
+	// Monotone cubic interpolation of values on integer coordinates.
+	// Interpolated value is a linear combination of two neighbour values and their derivatives,
+	// so when coordinates don't change, weights can be computed once and applied to any values.
+	//
+	class CubicInterpolationHelper {
+	public:
+		struct Weights {
+			// weights of values in points floor(x) and floor(x) + 1
+			float value1{};
+			float value2{};
+			// weights of derivatives in the same points
+			float derivative1{};
+			float derivative2{};
+		};
+
+		// Result must have the same size as values
+		static void calcDerivatives(array_view<float> values, array_span<float> result);
+
+		// dx is distance from floor(x) to x, in [0, 1)
+		[[nodiscard]]
+		static Weights calcWeights(double dx);
+	};
+}
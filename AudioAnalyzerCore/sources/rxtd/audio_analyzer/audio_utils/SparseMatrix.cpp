@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "SparseMatrix.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || (defined(__i386__) && defined(__SSE__))
+#define AUDIO_UTILS_SSE
+#include <immintrin.h>
+#endif
+
+using rxtd::audio_analyzer::audio_utils::SparseMatrix;
+
+namespace {
+	using rxtd::index;
+
+	float dotProduct(const float* a, const float* b, index size) {
+		index i = 0;
+		float result = 0.0f;
+
+#ifdef AUDIO_UTILS_SSE
+		if (size >= 4) {
+			__m128 sum = _mm_setzero_ps();
+			for (; i + 4 <= size; i += 4) {
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+			}
+			sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+			sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+			result = _mm_cvtss_f32(sum);
+		}
+#endif
+
+		for (; i < size; i++) {
+			result += a[i] * b[i];
+		}
+		return result;
+	}
+}
+
+array_span<float> SparseMatrix::addRow(index firstColumn, index size) {
+	const index begin = rowStarts.back();
+	firstColumns.push_back(firstColumn);
+	rowStarts.push_back(begin + size);
+	weights.resize(static_cast<size_t>(begin + size), 0.0f);
+	return { weights.data() + begin, size };
+}
+
+void SparseMatrix::multiply(array_view<float> vector, array_span<float> result) const {
+	for (index row = 0; row < getRowsCount(); row++) {
+		const index begin = rowStarts[static_cast<size_t>(row)];
+		const index size = rowStarts[static_cast<size_t>(row + 1)] - begin;
+		result[row] = dotProduct(weights.data() + begin, vector.data() + firstColumns[static_cast<size_t>(row)], size);
+	}
+}
+
+void SparseMatrix::multiplyAdd(array_view<float> vector, array_span<float> result) const {
+	for (index row = 0; row < getRowsCount(); row++) {
+		const index begin = rowStarts[static_cast<size_t>(row)];
+		const index size = rowStarts[static_cast<size_t>(row + 1)] - begin;
+		if (size == 0) {
+			continue;
+		}
+		result[row] += dotProduct(weights.data() + begin, vector.data() + firstColumns[static_cast<size_t>(row)], size);
+	}
+}
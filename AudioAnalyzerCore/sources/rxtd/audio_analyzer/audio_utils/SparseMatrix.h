@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+
+namespace rxtd::audio_analyzer::audio_utils {
+	/// <summary>
+	/// Sparse matrix in CSR format, for matrices where nonzero elements of each row are adjacent.
+	/// Such rows only need index of the first column instead of a column index for each element,
+	/// and the product with a vector is a set of dense dot products.
+	///
+	/// Rows are added in order. Empty rows are allowed.
+	/// </summary>
+	class SparseMatrix {
+		// weights of the row i are in [rowStarts[i], rowStarts[i + 1])
+		std::vector<index> rowStarts{ 0 };
+		std::vector<index> firstColumns;
+		std::vector<float> weights;
+
+	public:
+		void clear() {
+			rowStarts.assign(1, 0);
+			firstColumns.clear();
+			weights.clear();
+		}
+
+		/// <summary>
+		/// Adds a row with size nonzero elements starting from firstColumn.
+		/// Returns memory for the weights of the row, filled with zeros.
+		/// The span is only valid until the next call of addRow.
+		/// </summary>
+		array_span<float> addRow(index firstColumn, index size);
+
+		[[nodiscard]]
+		index getRowsCount() const {
+			return static_cast<index>(firstColumns.size());
+		}
+
+		[[nodiscard]]
+		index getNonZeroCount() const {
+			return static_cast<index>(weights.size());
+		}
+
+		/// <summary>
+		/// Size of the vector must be big enough for all rows, result must have getRowsCount() elements.
+		/// </summary>
+		void multiply(array_view<float> vector, array_span<float> result) const;
+
+		/// <summary>
+		/// Same as multiply, but the product is added to the values in the result.
+		/// </summary>
+		void multiplyAdd(array_view<float> vector, array_span<float> result) const;
+	};
+}
@@ -64,3 +64,16 @@ void BmpWriter::writeFile(std::ostream& stream, std_fixes::array2d_view<IntColor
 	// file.write(&header, sizeof(header));
 	// file.write(imageData[0].data(), header.dibHeader.bitmapSizeInBytes);
 }
+
+void BmpWriter::writeHeader(std::ostream& stream, index width, index height) {
+	BMPHeader header(width, height);
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+rxtd::index BmpWriter::getHeaderSize() {
+	return sizeof(BMPHeader);
+}
+
+rxtd::index BmpWriter::getFileSize(index width, index height) {
+	return getHeaderSize() + width * height * static_cast<index>(sizeof(uint32_t));
+}
@@ -9,5 +9,16 @@ namespace rxtd::audio_analyzer::image_utils {
 	class BmpWriter {
 	public:
 		static void writeFile(std::ostream& stream, std_fixes::array2d_view<IntColor> imageData);
+
+		static void writeHeader(std::ostream& stream, index width, index height);
+
+		/// <summary>
+		/// Pixels of a row start at getHeaderSize() + row * width * sizeof(IntColor).
+		/// </summary>
+		[[nodiscard]]
+		static index getHeaderSize();
+
+		[[nodiscard]]
+		static index getFileSize(index width, index height);
 	};
 }
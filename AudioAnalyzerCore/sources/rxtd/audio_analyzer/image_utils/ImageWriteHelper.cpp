@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2020 Danil Uzlov
+
+#include "ImageWriteHelper.h"
+
+#include <filesystem>
+#include <fstream>
+
+using rxtd::audio_analyzer::image_utils::ImageWriteHelper;
+using rxtd::audio_analyzer::image_utils::StripedImageCopy;
+using rxtd::audio_analyzer::image_utils::StripedImageVersion;
+
+void ImageWriteHelper::write(const StripedImageCopy& image, bool empty, sview filepath) {
+	if (state == State::eEMPTY && empty) {
+		return;
+	}
+
+	const index width = image.getWidth();
+	const index height = image.getHeight();
+	const auto& version = image.getVersion();
+
+	const bool fileIsKnown = state != State::eUNINITIALIZED
+		&& sview{ writtenPath } == filepath
+		&& writtenWidth == width
+		&& writtenHeight == height;
+
+	bool success = false;
+	if (fileIsKnown) {
+		// rotation of a scrolling image moves all pixels in the file
+		const auto columns = version.displayOffset == writtenDisplayOffset
+			? version.getChangedColumns(writtenVersion, width)
+			: StripedImageVersion::ColumnRange{ 0, width };
+		success = writeChanges(image, columns);
+	}
+	if (!success) {
+		// file could have been changed or deleted by someone else
+		success = writeFull(image, filepath);
+	}
+
+	if (!success) {
+		state = State::eUNINITIALIZED;
+		return;
+	}
+
+	if (!fileIsKnown) {
+		writtenPath = filepath;
+		writtenWidth = width;
+		writtenHeight = height;
+	}
+	writtenVersion = version.version;
+	writtenDisplayOffset = version.displayOffset;
+	state = empty ? State::eEMPTY : State::eNOT_EMPTY;
+}
+
+bool ImageWriteHelper::writeChanges(const StripedImageCopy& image, StripedImageVersion::ColumnRange columns) {
+	if (columns.count == 0) {
+		return true;
+	}
+
+	const std::filesystem::path path{ std::wstring_view{ writtenPath } };
+	std::fstream fileStream(path, std::ios::in | std::ios::out | std::ios::binary);
+	if (!fileStream.is_open()) {
+		return false;
+	}
+
+	const index width = image.getWidth();
+	const index height = image.getHeight();
+
+	// seeking has its own cost, so big changes are written in one piece
+	if (columns.count * 2 > width) {
+		fileStream.seekp(static_cast<std::streamoff>(BmpWriter::getHeaderSize()));
+		writePixels(fileStream, image);
+		return fileStream.good();
+	}
+
+	index begin = columns.begin - image.getVersion().displayOffset;
+	if (begin < 0) {
+		begin += width;
+	}
+	const index firstSize = std::min(columns.count, width - begin);
+	const index secondSize = columns.count - firstSize;
+
+	const auto writeSegment = [&](index row, index segmentBegin, index count) {
+		const index offset = BmpWriter::getHeaderSize() + (row * width + segmentBegin) * static_cast<index>(sizeof(IntColor));
+		fileStream.seekp(static_cast<std::streamoff>(offset));
+		writeRowPart(fileStream, image, row, segmentBegin, count);
+	};
+
+	for (index row = 0; row < height; row++) {
+		writeSegment(row, begin, firstSize);
+		if (secondSize > 0) {
+			writeSegment(row, 0, secondSize);
+		}
+	}
+
+	return fileStream.good();
+}
+
+bool ImageWriteHelper::writeFull(const StripedImageCopy& image, sview filepath) {
+	const std::filesystem::path path{ std::wstring_view{ filepath } };
+	auto directory = path;
+	directory.remove_filename();
+	std::error_code ec;
+	create_directories(directory, ec);
+	if (ec) {
+		// Something went wrong.
+		// It's unlikely we can fix it.
+		return false;
+	}
+
+	auto tempPath = path;
+	tempPath += L".tmp";
+
+	{
+		std::ofstream fileStream(tempPath, std::ios::binary);
+		if (fileStream.is_open()) {
+			BmpWriter::writeHeader(fileStream, image.getWidth(), image.getHeight());
+			bytesWritten += BmpWriter::getHeaderSize();
+			writePixels(fileStream, image);
+		}
+		if (!fileStream.good()) {
+			fileStream.close();
+			remove(tempPath, ec);
+			return false;
+		}
+	}
+
+	rename(tempPath, path, ec);
+	if (!ec) {
+		return true;
+	}
+
+	// target can be locked by a reader, which doesn't allow replacing it,
+	// but still allows writing into it
+	remove(tempPath, ec);
+
+	std::ofstream fileStream(path, std::ios::binary);
+	if (!fileStream.is_open()) {
+		return false;
+	}
+
+	BmpWriter::writeHeader(fileStream, image.getWidth(), image.getHeight());
+	bytesWritten += BmpWriter::getHeaderSize();
+	writePixels(fileStream, image);
+	return fileStream.good();
+}
+
+void ImageWriteHelper::writePixels(std::ostream& stream, const StripedImageCopy& image) {
+	const index width = image.getWidth();
+	const index height = image.getHeight();
+	for (index row = 0; row < height; row++) {
+		writeRowPart(stream, image, row, 0, width);
+	}
+}
+
+void ImageWriteHelper::writeRowPart(std::ostream& stream, const StripedImageCopy& image, index row, index begin, index count) {
+	const index width = image.getWidth();
+	const auto pixels = image.getPixels()[row];
+
+	index pixelsBegin = begin + image.getVersion().displayOffset;
+	if (pixelsBegin >= width) {
+		pixelsBegin -= width;
+	}
+	const index firstSize = std::min(count, width - pixelsBegin);
+
+	const auto writeColumns = [&](const IntColor* data, index size) {
+		stream.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size * static_cast<index>(sizeof(IntColor))));
+		bytesWritten += size * static_cast<index>(sizeof(IntColor));
+	};
+
+	writeColumns(pixels.data() + pixelsBegin, firstSize);
+	if (count > firstSize) {
+		writeColumns(pixels.data(), count - firstSize);
+	}
+}
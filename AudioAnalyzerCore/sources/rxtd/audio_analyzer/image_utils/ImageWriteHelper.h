@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2020 Danil Uzlov
+
+#pragma once
+#include "BmpWriter.h"
+#include "StripedImageCopy.h"
+
+namespace rxtd::audio_analyzer::image_utils {
+	/// <summary>
+	/// Keeps an image file in sync with a StripedImageCopy.
+	///
+	/// The first write creates the whole file in a temporary file and then replaces the target,
+	/// so the file never has a partially written header.
+	/// Following writes only update pixels that changed since the last write,
+	/// in place, without touching the header.
+	///
+	/// The file is reopened for each update instead of holding the handle:
+	/// Rainmeter reloads images when their modification time changes,
+	/// and an open handle can delay the update of modification time.
+	/// </summary>
+	class ImageWriteHelper {
+		enum class State {
+			eUNINITIALIZED,
+			eEMPTY,
+			eNOT_EMPTY,
+		};
+		State state = State::eUNINITIALIZED;
+
+		string writtenPath;
+		index writtenWidth = 0;
+		index writtenHeight = 0;
+		index writtenVersion = -1;
+		index writtenDisplayOffset = 0;
+
+		index bytesWritten = 0;
+
+	public:
+		void write(const StripedImageCopy& image, bool empty, sview filepath);
+
+		/// <summary>
+		/// Total amount of bytes written into files, for diagnostics.
+		/// </summary>
+		[[nodiscard]]
+		index getBytesWritten() const {
+			return bytesWritten;
+		}
+
+	private:
+		[[nodiscard]]
+		bool writeChanges(const StripedImageCopy& image, StripedImageVersion::ColumnRange columns);
+
+		[[nodiscard]]
+		bool writeFull(const StripedImageCopy& image, sview filepath);
+
+		void writePixels(std::ostream& stream, const StripedImageCopy& image);
+
+		// writes shown columns [begin, begin + count) of the row, which must not wrap
+		void writeRowPart(std::ostream& stream, const StripedImageCopy& image, index row, index begin, index count);
+	};
+}
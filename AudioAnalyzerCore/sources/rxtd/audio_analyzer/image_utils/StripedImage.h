@@ -6,6 +6,58 @@
 #include "rxtd/std_fixes/Vector2D.h"
 
 namespace rxtd::audio_analyzer::image_utils {
+	/// <summary>
+	/// Version of the pixels of a StripedImage,
+	/// which allows to find columns that changed since some older version.
+	///
+	/// Columns are counted in stationary layout, where strips never move.
+	/// Scrolling image is the same layout rotated by displayOffset,
+	/// so in this layout scrolling only changes new strips.
+	/// </summary>
+	struct StripedImageVersion {
+		struct ColumnRange {
+			index begin = 0;
+			// range can wrap around the end of the image
+			index count = 0;
+		};
+
+		// incremented on each change of pixels
+		index version = 0;
+		// all pixels changed at this version
+		index fullChangeVersion = 0;
+		// new strips are written just before this column
+		index pastLastStripIndex = 0;
+		// columns after pastLastStripIndex that change with each new strip, like a border
+		index extraColumns = 0;
+		// column that is shown as the first column of the image
+		index displayOffset = 0;
+
+		void markFullChange() {
+			fullChangeVersion = version;
+		}
+
+		/// <summary>
+		/// Returns columns that may be different from the pixels of olderVersion.
+		/// Negative olderVersion means that nothing is known about old pixels.
+		/// </summary>
+		[[nodiscard]]
+		ColumnRange getChangedColumns(index olderVersion, index width) const {
+			const index stripsCount = version - olderVersion;
+			if (olderVersion < 0 || olderVersion < fullChangeVersion || stripsCount < 0 || stripsCount + extraColumns >= width) {
+				return { 0, width };
+			}
+			if (stripsCount == 0) {
+				return {};
+			}
+
+			index begin = (pastLastStripIndex - stripsCount) % width;
+			if (begin < 0) {
+				begin += width;
+			}
+			return { begin, stripsCount + extraColumns };
+		}
+	};
+
 	template<typename PixelValueT>
 	class StripedImage {
 		using PixelValueType = PixelValueT;
@@ -19,6 +71,11 @@ namespace rxtd::audio_analyzer::image_utils {
 		index sameStripsCount = 0;
 		bool stationary = false;
 		index stationaryOffset = 0;
+		// position of next strip in stationary layout when image is not stationary
+		index scrollingOffset = 0;
+
+		index version = 0;
+		index fullChangeVersion = 0;
 
 	public:
 		void setParams(index _width, index _height, PixelValueType _backgroundValue, bool _stationary) {
@@ -43,6 +100,10 @@ namespace rxtd::audio_analyzer::image_utils {
 
 			lastFillValue = backgroundValue;
 			sameStripsCount = _width - 1;
+			scrollingOffset = 0;
+
+			version++;
+			fullChangeVersion = version;
 		}
 
 		void pushStrip(array_view<PixelValueType> stripData) {
@@ -106,15 +167,30 @@ namespace rxtd::audio_analyzer::image_utils {
 			return stationaryOffset;
 		}
 
+		[[nodiscard]]
+		StripedImageVersion getVersion() const {
+			StripedImageVersion result;
+			result.version = version;
+			result.fullChangeVersion = fullChangeVersion;
+			result.pastLastStripIndex = stationary ? stationaryOffset : scrollingOffset;
+			result.displayOffset = stationary ? 0 : scrollingOffset;
+			return result;
+		}
+
 	private:
 		// returns index of next string to write to
 		index incrementAndGetIndex() {
+			version++;
 			if (stationary) {
 				const index resultIndex = stationaryOffset;
 				incrementStationary();
 				return resultIndex;
 			}
 
+			scrollingOffset++;
+			if (scrollingOffset >= width) {
+				scrollingOffset = 0;
+			}
 			incrementStrip();
 			return width - 1;
 		}
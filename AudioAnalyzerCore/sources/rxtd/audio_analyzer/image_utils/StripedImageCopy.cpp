@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "StripedImageCopy.h"
+
+using rxtd::audio_analyzer::image_utils::StripedImageCopy;
+using rxtd::audio_analyzer::image_utils::StripedImageVersion;
+using rxtd::std_fixes::array2d_view;
+
+void StripedImageCopy::update(array2d_view<IntColor> source, const StripedImageVersion& sourceVersion) {
+	const index width = source.getBufferSize();
+	const index height = source.getBuffersCount();
+
+	index olderVersion = version.version;
+	if (pixels.getBufferSize() != width || pixels.getBuffersCount() != height) {
+		pixels.setBuffersCount(height);
+		pixels.setBufferSize(width);
+		olderVersion = -1;
+	}
+
+	const auto columns = sourceVersion.getChangedColumns(olderVersion, width);
+	version = sourceVersion;
+
+	if (columns.count == 0) {
+		return;
+	}
+
+	// copies columns [begin, begin + count) of stationary layout, which must not wrap
+	const auto copyColumns = [&](array_view<IntColor> sourceRow, array_span<IntColor> destRow, index begin, index count) {
+		index sourceBegin = begin - sourceVersion.displayOffset;
+		if (sourceBegin < 0) {
+			sourceBegin += width;
+		}
+		const index firstSize = std::min(count, width - sourceBegin);
+		std::copy_n(sourceRow.data() + sourceBegin, firstSize, destRow.data() + begin);
+		std::copy_n(sourceRow.data(), count - firstSize, destRow.data() + begin + firstSize);
+	};
+
+	const index firstSize = std::min(columns.count, width - columns.begin);
+	for (index row = 0; row < height; row++) {
+		copyColumns(source[row], pixels[row], columns.begin, firstSize);
+		if (columns.count > firstSize) {
+			copyColumns(source[row], pixels[row], 0, columns.count - firstSize);
+		}
+	}
+}
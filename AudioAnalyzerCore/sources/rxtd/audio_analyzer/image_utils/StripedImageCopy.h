@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "IntColor.h"
+#include "StripedImage.h"
+#include "rxtd/std_fixes/Vector2D.h"
+
+namespace rxtd::audio_analyzer::image_utils {
+	/// <summary>
+	/// Copy of an image made of strips, for handler snapshots.
+	///
+	/// Pixels are kept in stationary layout (see StripedImageVersion),
+	/// so when the source only got a few new strips, only these strips are copied,
+	/// even if the source image is scrolling.
+	/// Each copy remembers its own version, so any number of copies can be updated from the same source.
+	/// </summary>
+	class StripedImageCopy {
+		std_fixes::Vector2D<IntColor> pixels;
+		StripedImageVersion version{ -1 };
+
+	public:
+		/// <summary>
+		/// Source pixels are in the order they are shown, like pixels of a StripedImage.
+		/// </summary>
+		void update(std_fixes::array2d_view<IntColor> source, const StripedImageVersion& sourceVersion);
+
+		/// <summary>
+		/// Pixels in stationary layout: column version.displayOffset is shown first.
+		/// </summary>
+		[[nodiscard]]
+		std_fixes::array2d_view<IntColor> getPixels() const {
+			return pixels;
+		}
+
+		[[nodiscard]]
+		const StripedImageVersion& getVersion() const {
+			return version;
+		}
+
+		[[nodiscard]]
+		index getWidth() const {
+			return pixels.getBufferSize();
+		}
+
+		[[nodiscard]]
+		index getHeight() const {
+			return pixels.getBuffersCount();
+		}
+	};
+}
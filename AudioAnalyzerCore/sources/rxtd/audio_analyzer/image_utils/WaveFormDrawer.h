@@ -103,6 +103,20 @@ namespace rxtd::audio_analyzer::image_utils {
 			return minMaxBuffer.isEmpty();
 		}
 
+		/// <summary>
+		/// Version of the pixels of the result buffer.
+		/// </summary>
+		[[nodiscard]]
+		StripedImageVersion getVersion() const {
+			auto result = minMaxBuffer.getVersion();
+			result.extraColumns = borderSize;
+			if (fading != 0.0) {
+				// fading changes all pixels with each new strip
+				result.markFullChange();
+			}
+			return result;
+		}
+
 		void inflate();
 
 	private:
@@ -46,7 +46,7 @@ const MapValue& HandlerCacheHelper::getHandlerInfo(const istring& name, isview s
 
 bool HandlerCacheHelper::parseHandler(sview name, isview source, HandlerInfo& info, Logger& cl) const {
 	string optionName = L"Handler-"s += name;
-	auto descriptionOption = rain.read(optionName);
+	auto descriptionOption = optionProvider->read(optionName);
 
 	if (descriptionOption.empty()) {
 		cl.error(L"description is not found", name);
@@ -99,7 +99,7 @@ HandlerBase::HandlerMetaInfo HandlerCacheHelper::createHandlerPatcher(
 		throw HandlerBase::InvalidOptionsException{};
 	}
 
-	HandlerBase::ParamParseContext parseContext{ optionMap, cl, rain, version, *parserPtr };
+	HandlerBase::ParamParseContext parseContext{ optionMap, cl, *optionProvider, version, *parserPtr };
 
 	if (type == L"rms") {
 		return HandlerBase::createMetaForClass<BlockRms>(parseContext);
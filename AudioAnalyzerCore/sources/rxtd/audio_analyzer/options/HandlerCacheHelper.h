@@ -3,14 +3,13 @@
 
 #pragma once
 #include "HandlerInfo.h"
+#include "OptionProvider.h"
 #include "rxtd/Logger.h"
 #include "rxtd/audio_analyzer/sound_processing/sound_handlers/HandlerBase.h"
-#include "rxtd/rainmeter/Rainmeter.h"
 
 namespace rxtd::audio_analyzer::options {
 	class HandlerCacheHelper {
 	public:
-		using Rainmeter = rainmeter::Rainmeter;
 		using OptionMap = option_parsing::OptionMap;
 
 		struct MapValue {
@@ -24,7 +23,7 @@ namespace rxtd::audio_analyzer::options {
 		using PatchersMap = std::map<istring, MapValue, std::less<>>;
 
 		mutable PatchersMap patchersCache;
-		Rainmeter rain;
+		const OptionProvider* optionProvider = nullptr;
 		bool unusedOptionsWarning = false;
 		Version version{};
 		option_parsing::OptionParser* parserPtr = nullptr;
@@ -34,8 +33,8 @@ namespace rxtd::audio_analyzer::options {
 			parserPtr = &parser;
 		}
 
-		void setRain(Rainmeter value) {
-			rain = std::move(value);
+		void setOptionProvider(const OptionProvider& value) {
+			optionProvider = &value;
 		}
 
 		void setUnusedOptionsWarning(bool value) {
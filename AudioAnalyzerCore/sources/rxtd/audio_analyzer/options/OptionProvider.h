@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "rxtd/Logger.h"
+#include "rxtd/option_parsing/Option.h"
+
+namespace rxtd::audio_analyzer::options {
+	/// <summary>
+	/// Everything that the processing core needs from the host application.
+	/// Inside of Rainmeter it is backed by the measure options,
+	/// standalone tools can read options from anywhere else.
+	/// </summary>
+	class OptionProvider : VirtualDestructorBase {
+	public:
+		// Read named option of the parent measure
+		[[nodiscard]]
+		virtual option_parsing::Option read(sview optionName) const = 0;
+
+		// Transforms relative folder path into absolute one, with trailing separator
+		[[nodiscard]]
+		virtual string getPathFromCurrent(string folder) const = 0;
+
+		[[nodiscard]]
+		virtual Logger createLogger() const = 0;
+	};
+}
@@ -15,18 +15,18 @@ using rxtd::filter_utils::FilterCascadeParser;
 bool ParamHelper::readOptions(Version _version) {
 	version = _version;
 
-	auto logger = rain.createLogger();
+	auto logger = optionProvider->createLogger();
 	parser.setLogger(logger);
 
-	auto defaultTargetRate = parser.parse(rain.read(L"TargetRate"), L"TargetRate").valueOr(44100);
+	auto defaultTargetRate = parser.parse(optionProvider->read(L"TargetRate"), L"TargetRate").valueOr(44100);
 	if (defaultTargetRate < 0) {
 		logger.warning(L"Invalid TargetRate {}, must be > 0. Assume 0.", defaultTargetRate);
 		defaultTargetRate = 0;
 	}
 
-	unusedOptionsWarning = parser.parse(rain.read(L"LogUnusedOptions"), L"LogUnusedOptions").valueOr(true);
+	unusedOptionsWarning = parser.parse(optionProvider->read(L"LogUnusedOptions"), L"LogUnusedOptions").valueOr(true);
 
-	auto processingIndices = rain.read(L"ProcessingUnits").asList(L',');
+	auto processingIndices = optionProvider->read(L"ProcessingUnits").asList(L',');
 	if (!checkListUnique(processingIndices)) {
 		logger.error(L"Found repeating processing units, aborting");
 		return true;
@@ -60,7 +60,7 @@ bool ParamHelper::readOptions(Version _version) {
 
 bool ParamHelper::parseProcessing(sview procName, Logger cl, ProcessingData& data) const {
 	string processingOptionIndex = L"unit-"s += procName;
-	auto processingDescriptionOption = rain.read(processingOptionIndex);
+	auto processingDescriptionOption = optionProvider->read(processingOptionIndex);
 
 	if (processingDescriptionOption.empty()) {
 		cl.error(L"unit description is not found");
@@ -145,6 +145,8 @@ bool ParamHelper::parseProcessing(sview procName, Logger cl, ProcessingData& dat
 
 	anyChanges |= parseFilter(processingMap, data.filter, cl);
 	anyChanges |= parseTargetRate(processingMap, data.targetRate, cl);
+	anyChanges |= parseDownsampling(processingMap, data.downsampling, cl);
+	anyChanges |= parseFilterBatching(processingMap, data.filterBatching);
 
 	if (unusedOptionsWarning) {
 		const auto untouched = processingMap.getListOfUntouched();
@@ -210,6 +212,32 @@ bool ParamHelper::parseTargetRate(const OptionMap& optionMap, index& rate, Logge
 	return true;
 }
 
+bool ParamHelper::parseDownsampling(const OptionMap& optionMap, filter_utils::DownsampleHelper::Method& method, Logger& cl) {
+	const auto methodStr = optionMap.get(L"downsampling").asIString(L"IIR");
+	const auto methodOpt = parseEnum<filter_utils::DownsampleHelper::Method>(methodStr);
+	if (!methodOpt.has_value()) {
+		cl.error(L"downsampling: unknown value: {}", methodStr);
+		throw InvalidOptionsException{};
+	}
+
+	if (methodOpt.value() == method) {
+		return false;
+	}
+
+	method = methodOpt.value();
+	return true;
+}
+
+bool ParamHelper::parseFilterBatching(const OptionMap& optionMap, bool& batching) const {
+	const bool value = parser.parse(optionMap, L"filterBatching").valueOr(false);
+	if (value == batching) {
+		return false;
+	}
+
+	batching = value;
+	return true;
+}
+
 bool ParamHelper::checkListUnique(const OptionList& list) {
 	std::set<isview> set;
 	for (auto option : list) {
@@ -282,7 +310,8 @@ bool ParamHelper::parseHandlers(array_view<std::pair<GhostOption, GhostOption>>
 			throw InvalidOptionsException{};
 		}
 
-		auto& handlerInfo = hch.getHandlerInfo(name, sourceOpt.asIString(), cl.context(L"{}: ", name));
+		auto handlerLogger = cl.context(L"{}: ", name);
+		auto& handlerInfo = hch.getHandlerInfo(name, sourceOpt.asIString(), handlerLogger);
 
 		if (!handlerInfo.valid) {
 			if (handlerInfo.changed) {
@@ -3,14 +3,13 @@
 
 #pragma once
 #include "HandlerCacheHelper.h"
+#include "OptionProvider.h"
 #include "ProcessingData.h"
 #include "rxtd/Logger.h"
 #include "rxtd/audio_analyzer/sound_processing/Channel.h"
-#include "rxtd/rainmeter/Rainmeter.h"
 
 namespace rxtd::audio_analyzer::options {
 	class ParamHelper {
-		using Rainmeter = rainmeter::Rainmeter;
 		using OptionMap = option_parsing::OptionMap;
 		using OptionList = option_parsing::OptionList;
 		using OptionSequence = option_parsing::OptionSequence;
@@ -26,7 +25,7 @@ namespace rxtd::audio_analyzer::options {
 		using ProcessingsInfoMap = std::map<istring, ProcessingData, std::less<>>;
 
 	private:
-		Rainmeter rain;
+		const OptionProvider* optionProvider = nullptr;
 
 		bool unusedOptionsWarning = true;
 		index defaultTargetRate = 44100;
@@ -42,9 +41,9 @@ namespace rxtd::audio_analyzer::options {
 			hch.setParser(parser);
 		}
 
-		void setRainmeter(Rainmeter value) {
-			rain = std::move(value);
-			hch.setRain(rain);
+		void setOptionProvider(const OptionProvider& value) {
+			optionProvider = &value;
+			hch.setOptionProvider(value);
 		}
 
 		// return true if there were any changes since last update, false if there were none
@@ -72,6 +71,15 @@ namespace rxtd::audio_analyzer::options {
 		[[nodiscard]]
 		bool parseTargetRate(const OptionMap& optionMap, index& rate, Logger& cl) const;
 
+		// returns true when something changed, false otherwise
+		// can throw InvalidOptionsException
+		[[nodiscard]]
+		static bool parseDownsampling(const OptionMap& optionMap, filter_utils::DownsampleHelper::Method& method, Logger& cl);
+
+		// returns true when something changed, false otherwise
+		[[nodiscard]]
+		bool parseFilterBatching(const OptionMap& optionMap, bool& batching) const;
+
 		[[nodiscard]]
 		static bool checkListUnique(const OptionList& list);
 
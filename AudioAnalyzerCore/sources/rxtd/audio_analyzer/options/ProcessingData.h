@@ -4,6 +4,7 @@
 #pragma once
 #include "rxtd/audio_analyzer/sound_processing/Channel.h"
 #include "rxtd/audio_analyzer/sound_processing/sound_handlers/ExternalMethods.h"
+#include "rxtd/filter_utils/DownsampleHelper.h"
 #include "rxtd/filter_utils/FilterCascadeParser.h"
 
 namespace rxtd::audio_analyzer::options {
@@ -23,6 +24,8 @@ namespace rxtd::audio_analyzer::options {
 
 		FilterInfo filter;
 		index targetRate{};
+		filter_utils::DownsampleHelper::Method downsampling{};
+		bool filterBatching{};
 		std::vector<Channel> channels;
 		istring handlersRaw;
 		std::vector<istring> handlerOrder;
@@ -32,6 +35,8 @@ namespace rxtd::audio_analyzer::options {
 		friend bool operator==(const ProcessingData& lhs, const ProcessingData& rhs) {
 			return lhs.filter == rhs.filter
 				&& lhs.targetRate == rhs.targetRate
+				&& lhs.downsampling == rhs.downsampling
+				&& lhs.filterBatching == rhs.filterBatching
 				&& lhs.channels == rhs.channels
 				&& lhs.handlersRaw == rhs.handlersRaw
 				&& lhs.handlers == rhs.handlers;
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "Channel.h"
+#include "ChannelMixer.h"
+
+namespace rxtd::audio_analyzer {
+	/// <summary>
+	/// Anything that can provide audio for ProcessingOrchestrator:
+	/// WASAPI device, audio file or generated signal.
+	/// Each #capture() call replaces contents of the channel mixer
+	/// with all the data that became available since the previous call.
+	/// </summary>
+	class AudioSource : VirtualDestructorBase {
+	public:
+		// returns true if at least one buffer was captured
+		virtual bool capture() = 0;
+
+		[[nodiscard]]
+		virtual index getSampleRate() const = 0;
+
+		[[nodiscard]]
+		virtual const ChannelLayout& getChannelLayout() const = 0;
+
+		[[nodiscard]]
+		virtual const ChannelMixer& getChannelMixer() const = 0;
+	};
+}
@@ -0,0 +1,215 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2019 Danil Uzlov
+
+#include "Channel.h"
+
+using rxtd::audio_analyzer::ChannelUtils;
+using rxtd::audio_analyzer::Channel;
+using rxtd::audio_analyzer::ChannelLayout;
+
+std::optional<Channel> ChannelUtils::parse(isview string) {
+	if (string == L"Auto") {
+		return Channel::eAUTO;
+	}
+	if (string == L"Left" || string == L"FrontLeft" || string == L"FL") {
+		return Channel::eFRONT_LEFT;
+	}
+	if (string == L"Right" || string == L"FrontRight" || string == L"FR") {
+		return Channel::eFRONT_RIGHT;
+	}
+	if (string == L"Center" || string == L"C") {
+		return Channel::eCENTER;
+	}
+	if (string == L"CenterBack" || string == L"CB") {
+		return Channel::eCENTER_BACK;
+	}
+	if (string == L"LowFrequency" || string == L"LFE") {
+		return Channel::eLOW_FREQUENCY;
+	}
+	if (string == L"BackLeft" || string == L"BL") {
+		return Channel::eBACK_LEFT;
+	}
+	if (string == L"BackRight" || string == L"BR") {
+		return Channel::eBACK_RIGHT;
+	}
+	if (string == L"SideLeft" || string == L"SL") {
+		return Channel::eSIDE_LEFT;
+	}
+	if (string == L"SideRight" || string == L"SR") {
+		return Channel::eSIDE_RIGHT;
+	}
+
+	return {};
+}
+
+rxtd::sview ChannelUtils::getTechnicalName(Channel channel) {
+	switch (channel) {
+	case Channel::eFRONT_LEFT: return L"fl";
+	case Channel::eFRONT_RIGHT: return L"fr";
+	case Channel::eCENTER: return L"c";
+	case Channel::eCENTER_BACK: return L"cb";
+	case Channel::eLOW_FREQUENCY: return L"lfe";
+	case Channel::eBACK_LEFT: return L"bl";
+	case Channel::eBACK_RIGHT: return L"br";
+	case Channel::eSIDE_LEFT: return L"sl";
+	case Channel::eSIDE_RIGHT: return L"sr";
+	case Channel::eAUTO: return L"a";
+	}
+	return {};
+}
+
+rxtd::sview ChannelUtils::getHumanName(Channel channel) {
+	switch (channel) {
+	case Channel::eFRONT_LEFT: return L"FrontLeft";
+	case Channel::eFRONT_RIGHT: return L"FrontRight";
+	case Channel::eCENTER: return L"Center";
+	case Channel::eCENTER_BACK: return L"CenterBack";
+	case Channel::eLOW_FREQUENCY: return L"LFE";
+	case Channel::eBACK_LEFT: return L"BackLeft";
+	case Channel::eBACK_RIGHT: return L"BackRight";
+	case Channel::eSIDE_LEFT: return L"SideLeft";
+	case Channel::eSIDE_RIGHT: return L"SideRight";
+	case Channel::eAUTO: return L"Auto";
+	}
+	return {};
+}
+
+
+ChannelLayout::ChannelLayout(sview _name, std::vector<std::optional<Channel>> channels) {
+	name = _name;
+
+	for (index i = 0; i < static_cast<index>(channels.size()); i++) {
+		auto channelOpt = channels[static_cast<size_t>(i)];
+		if (!channelOpt.has_value()) {
+			continue;
+		}
+
+		auto channel = channelOpt.value();
+		channelMap[channel] = i;
+		channelOrder.push_back(channel);
+	}
+}
+
+std::optional<rxtd::index> ChannelLayout::indexOf(Channel channel) const {
+	const auto iter = channelMap.find(channel);
+	if (iter == channelMap.end()) {
+		return std::nullopt;
+	}
+	return iter->second;
+}
+
+namespace {
+	// Values of WAVEFORMATEXTENSIBLE::dwChannelMask, see SPEAKER_* and KSAUDIO_SPEAKER_* in ksmedia.h
+	// They are duplicated here so that channel parsing doesn't depend on Windows headers
+	enum SpeakerMask : uint32_t {
+		eSPEAKER_FRONT_LEFT = 0x1,
+		eSPEAKER_FRONT_RIGHT = 0x2,
+		eSPEAKER_FRONT_CENTER = 0x4,
+		eSPEAKER_LOW_FREQUENCY = 0x8,
+		eSPEAKER_BACK_LEFT = 0x10,
+		eSPEAKER_BACK_RIGHT = 0x20,
+		eSPEAKER_FRONT_LEFT_OF_CENTER = 0x40,
+		eSPEAKER_FRONT_RIGHT_OF_CENTER = 0x80,
+		eSPEAKER_BACK_CENTER = 0x100,
+		eSPEAKER_SIDE_LEFT = 0x200,
+		eSPEAKER_SIDE_RIGHT = 0x400,
+		eSPEAKER_TOP_CENTER = 0x800,
+		eSPEAKER_TOP_FRONT_LEFT = 0x1000,
+		eSPEAKER_TOP_FRONT_CENTER = 0x2000,
+		eSPEAKER_TOP_FRONT_RIGHT = 0x4000,
+		eSPEAKER_TOP_BACK_LEFT = 0x8000,
+		eSPEAKER_TOP_BACK_CENTER = 0x10000,
+		eSPEAKER_TOP_BACK_RIGHT = 0x20000,
+
+		eLAYOUT_MONO = eSPEAKER_FRONT_CENTER,
+		eLAYOUT_1POINT1 = eSPEAKER_FRONT_CENTER | eSPEAKER_LOW_FREQUENCY,
+		eLAYOUT_STEREO = eSPEAKER_FRONT_LEFT | eSPEAKER_FRONT_RIGHT,
+		eLAYOUT_2POINT1 = eLAYOUT_STEREO | eSPEAKER_LOW_FREQUENCY,
+		eLAYOUT_3POINT0 = eLAYOUT_STEREO | eSPEAKER_FRONT_CENTER,
+		eLAYOUT_3POINT1 = eLAYOUT_3POINT0 | eSPEAKER_LOW_FREQUENCY,
+		eLAYOUT_QUAD = eLAYOUT_STEREO | eSPEAKER_BACK_LEFT | eSPEAKER_BACK_RIGHT,
+		eLAYOUT_SURROUND = eLAYOUT_3POINT0 | eSPEAKER_BACK_CENTER,
+		eLAYOUT_5POINT0 = eLAYOUT_3POINT0 | eSPEAKER_SIDE_LEFT | eSPEAKER_SIDE_RIGHT,
+		eLAYOUT_5POINT1 = eLAYOUT_3POINT1 | eSPEAKER_BACK_LEFT | eSPEAKER_BACK_RIGHT,
+		eLAYOUT_5POINT1_SURROUND = eLAYOUT_3POINT1 | eSPEAKER_SIDE_LEFT | eSPEAKER_SIDE_RIGHT,
+		eLAYOUT_7POINT0 = eLAYOUT_5POINT0 | eSPEAKER_BACK_LEFT | eSPEAKER_BACK_RIGHT,
+		eLAYOUT_7POINT1_SURROUND = eLAYOUT_5POINT1_SURROUND | eSPEAKER_BACK_LEFT | eSPEAKER_BACK_RIGHT,
+	};
+}
+
+rxtd::sview getLayoutName(uint32_t bitMask) {
+	switch (bitMask) {
+	case eLAYOUT_MONO: return L"1.0 mono";
+	case eLAYOUT_1POINT1: return L"1.1";
+	case eLAYOUT_STEREO: return L"2.0 stereo";
+	case eLAYOUT_2POINT1: return L"2.1";
+	case eLAYOUT_3POINT0: return L"3.0";
+	case eLAYOUT_3POINT1: return L"3.1";
+	case eLAYOUT_QUAD: return L"4.0 quad";
+	case eLAYOUT_SURROUND: return L"4.0 surround";
+	case eLAYOUT_5POINT0: return L"5.0";
+	case eLAYOUT_5POINT1: return L"5.1";
+	case eLAYOUT_5POINT1_SURROUND: return L"5.1 surround";
+	case eLAYOUT_7POINT0: return L"7.0";
+	case eLAYOUT_7POINT1_SURROUND: return L"7.1 surround";
+	default: break;
+	}
+
+	return L"";
+}
+
+ChannelLayout ChannelUtils::parseLayout(uint32_t bitMask, bool forbid5Point1Surround) {
+	if (bitMask == eLAYOUT_5POINT1_SURROUND && forbid5Point1Surround) {
+		bitMask = eLAYOUT_5POINT1;
+	}
+
+	struct {
+		uint32_t channelBit;
+		std::optional<Channel> channelOpt;
+	} speakersBitMasks[] = {
+			{ eSPEAKER_FRONT_LEFT, Channel::eFRONT_LEFT },
+			{ eSPEAKER_FRONT_RIGHT, Channel::eFRONT_RIGHT },
+			{ eSPEAKER_FRONT_CENTER, Channel::eCENTER },
+			{ eSPEAKER_LOW_FREQUENCY, Channel::eLOW_FREQUENCY },
+			{ eSPEAKER_BACK_LEFT, Channel::eBACK_LEFT },
+			{ eSPEAKER_BACK_RIGHT, Channel::eBACK_RIGHT },
+			{ eSPEAKER_FRONT_LEFT_OF_CENTER, std::nullopt },
+			{ eSPEAKER_FRONT_RIGHT_OF_CENTER, std::nullopt },
+			{ eSPEAKER_BACK_CENTER, Channel::eCENTER_BACK },
+			{ eSPEAKER_SIDE_LEFT, Channel::eSIDE_LEFT },
+			{ eSPEAKER_SIDE_RIGHT, Channel::eSIDE_RIGHT },
+			{ eSPEAKER_TOP_CENTER, std::nullopt },
+			{ eSPEAKER_TOP_FRONT_LEFT, std::nullopt },
+			{ eSPEAKER_TOP_FRONT_CENTER, std::nullopt },
+			{ eSPEAKER_TOP_FRONT_RIGHT, std::nullopt },
+			{ eSPEAKER_TOP_BACK_LEFT, std::nullopt },
+			{ eSPEAKER_TOP_BACK_CENTER, std::nullopt },
+			{ eSPEAKER_TOP_BACK_RIGHT, std::nullopt },
+		};
+
+	std::vector<std::optional<Channel>> channels;
+	for (auto [bit, channelOpt] : speakersBitMasks) {
+		if ((bitMask & bit) == 0) {
+			continue;
+		}
+		channels.push_back(channelOpt);
+	}
+
+	const sview name = getLayoutName(bitMask);
+	return { name, std::move(channels) };
+}
+
+ChannelLayout ChannelUtils::getDefaultLayout(index channelsCount) {
+	switch (channelsCount) {
+	case 1: return parseLayout(eLAYOUT_MONO, false);
+	case 2: return parseLayout(eLAYOUT_STEREO, false);
+	case 4: return parseLayout(eLAYOUT_QUAD, false);
+	case 6: return parseLayout(eLAYOUT_5POINT1, false);
+	case 8: return parseLayout(eLAYOUT_7POINT1_SURROUND, false);
+	default: break;
+	}
+
+	// same as WAVE_FORMAT_PCM: channels are assigned to speakers in the order of mask bits
+	const auto count = std::clamp<index>(channelsCount, 0, 18);
+	return parseLayout(static_cast<uint32_t>((1 << count) - 1), false);
+}
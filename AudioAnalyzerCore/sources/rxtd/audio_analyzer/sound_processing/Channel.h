@@ -73,5 +73,9 @@ namespace rxtd::audio_analyzer {
 
 		[[nodiscard]]
 		static ChannelLayout parseLayout(uint32_t bitMask, bool forbid5Point1Surround);
+
+		// Layout for sources that only know the number of channels, like raw PCM or plain WAV files
+		[[nodiscard]]
+		static ChannelLayout getDefaultLayout(index channelsCount);
 	};
 }
@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2020 Danil Uzlov
+
+#include "ChannelMixer.h"
+#include "Channel.h"
+
+using rxtd::audio_analyzer::ChannelMixer;
+
+void ChannelMixer::setLayout(const ChannelLayout& _layout) {
+	if (layout == _layout) {
+		return;
+	}
+
+	layout = _layout;
+	updateSlots();
+}
+
+void ChannelMixer::setDownmix(DownmixMatrix value) {
+	if (downmix == value) {
+		return;
+	}
+
+	downmix = std::move(value);
+	updateSlots();
+}
+
+void ChannelMixer::saveChannelsData(std_fixes::array2d_view<float> channelsData) {
+	const index size = channelsData.getBufferSize();
+	index maxSize = 0;
+	for (index slot = 0; slot < static_cast<index>(streamIndices.size()); slot++) {
+		maxSize = std::max(maxSize, slotSizes[static_cast<size_t>(slot)] + size);
+	}
+	reserve(maxSize);
+
+	for (index slot = 0; slot < static_cast<index>(streamIndices.size()); slot++) {
+		auto channelData = channelsData[streamIndices[static_cast<size_t>(slot)]];
+		auto& slotSize = slotSizes[static_cast<size_t>(slot)];
+		std::copy(channelData.begin(), channelData.end(), getSlotData(slot) + slotSize);
+		slotSize += size;
+	}
+}
+
+void ChannelMixer::appendSlotData(index slot, array_view<float> data) {
+	auto& slotSize = slotSizes[static_cast<size_t>(slot)];
+	reserve(slotSize + data.size());
+	std::copy(data.begin(), data.end(), getSlotData(slot) + slotSize);
+	slotSize += data.size();
+}
+
+void ChannelMixer::mix() {
+	for (const auto& row : mixRows) {
+		index size = slotSizes[static_cast<size_t>(row.sourceSlots[0])];
+		sourcePointers.clear();
+		for (const index slot : row.sourceSlots) {
+			size = std::min(size, slotSizes[static_cast<size_t>(slot)]);
+			sourcePointers.push_back(getSlotData(slot));
+		}
+
+		kernels.weightedSum(sourcePointers, row.weights, { getSlotData(row.destSlot), size });
+		slotSizes[static_cast<size_t>(row.destSlot)] = size;
+	}
+}
+
+array_view<float> ChannelMixer::getChannelPCM(Channel channel) const {
+	const index slot = outputSlots[static_cast<size_t>(channel)];
+	if (slot == noSlot) {
+		return {};
+	}
+
+	return { getSlotData(slot), slotSizes[static_cast<size_t>(slot)] };
+}
+
+void ChannelMixer::updateSlots() {
+	sourceSlots.fill(noSlot);
+	streamIndices.clear();
+	for (const auto channel : layout.ordered()) {
+		sourceSlots[static_cast<size_t>(channel)] = static_cast<index>(streamIndices.size());
+		streamIndices.push_back(layout.indexOf(channel).value());
+	}
+	slotsCount = static_cast<index>(streamIndices.size());
+	outputSlots = sourceSlots;
+	mixRows.clear();
+
+	// there is nothing to mix in a single channel
+	if (slotsCount > 1) {
+		for (const auto& row : downmix.getRows()) {
+			addMixRow(row);
+		}
+	}
+
+	auto hasChannel = [&](Channel channel) {
+		return sourceSlots[static_cast<size_t>(channel)] != noSlot;
+	};
+
+	if (outputSlots[static_cast<size_t>(Channel::eAUTO)] == noSlot) {
+		if (hasChannel(Channel::eFRONT_LEFT) && hasChannel(Channel::eFRONT_RIGHT)) {
+			DownmixMatrix::Row average;
+			average.target = Channel::eAUTO;
+			average.weights[static_cast<size_t>(Channel::eFRONT_LEFT)] = 0.5f;
+			average.weights[static_cast<size_t>(Channel::eFRONT_RIGHT)] = 0.5f;
+			addMixRow(average);
+		} else if (hasChannel(Channel::eFRONT_LEFT)) {
+			outputSlots[static_cast<size_t>(Channel::eAUTO)] = sourceSlots[static_cast<size_t>(Channel::eFRONT_LEFT)];
+		} else if (hasChannel(Channel::eFRONT_RIGHT)) {
+			outputSlots[static_cast<size_t>(Channel::eAUTO)] = sourceSlots[static_cast<size_t>(Channel::eFRONT_RIGHT)];
+		} else if (hasChannel(Channel::eCENTER)) {
+			outputSlots[static_cast<size_t>(Channel::eAUTO)] = sourceSlots[static_cast<size_t>(Channel::eCENTER)];
+		} else if (!layout.ordered().empty()) {
+			outputSlots[static_cast<size_t>(Channel::eAUTO)] = 0;
+		}
+	}
+
+	sourcePointers.reserve(static_cast<size_t>(channelsCount));
+	slotSizes.assign(static_cast<size_t>(slotsCount), 0);
+	buffer.resize(static_cast<size_t>(slotsCount * slotCapacity + slotAlignment));
+}
+
+void ChannelMixer::addMixRow(const DownmixMatrix::Row& row) {
+	const auto targetIndex = static_cast<size_t>(row.target);
+	if (row.target != Channel::eAUTO && sourceSlots[targetIndex] == noSlot) {
+		return;
+	}
+
+	MixRow mixRow;
+	for (index i = 0; i < channelsCount; i++) {
+		const float weight = row.weights[static_cast<size_t>(i)];
+		const index slot = sourceSlots[static_cast<size_t>(i)];
+		if (weight == 0.0f || slot == noSlot || static_cast<Channel>(i) == Channel::eAUTO) {
+			continue;
+		}
+		mixRow.sourceSlots.push_back(slot);
+		mixRow.weights.push_back(weight);
+	}
+
+	if (mixRow.sourceSlots.empty()) {
+		return;
+	}
+	// channel that stays as it is doesn't need a copy
+	if (mixRow.sourceSlots.size() == 1 && mixRow.sourceSlots[0] == sourceSlots[targetIndex] && mixRow.weights[0] == 1.0f) {
+		return;
+	}
+
+	mixRow.destSlot = slotsCount;
+	slotsCount++;
+	outputSlots[targetIndex] = mixRow.destSlot;
+	mixRows.push_back(std::move(mixRow));
+}
+
+void ChannelMixer::reserve(index size) {
+	if (size <= slotCapacity) {
+		return;
+	}
+
+	const index newCapacity = (std::max(size, slotCapacity * 2) + slotAlignment - 1) / slotAlignment * slotAlignment;
+
+	std::vector<float> newBuffer(static_cast<size_t>(slotsCount * newCapacity + slotAlignment));
+	float* newData = newBuffer.data() + getAlignmentOffset(newBuffer.data());
+	for (index slot = 0; slot < slotsCount; slot++) {
+		std::copy_n(getSlotData(slot), slotSizes[static_cast<size_t>(slot)], newData + slot * newCapacity);
+	}
+
+	buffer = std::move(newBuffer);
+	slotCapacity = newCapacity;
+}
+
+rxtd::index ChannelMixer::getAlignmentOffset(const float* data) {
+	constexpr auto alignmentBytes = static_cast<uintptr_t>(slotAlignment) * sizeof(float);
+	const auto address = reinterpret_cast<uintptr_t>(data);
+	const auto misalignment = address % alignmentBytes;
+	if (misalignment == 0) {
+		return 0;
+	}
+	return static_cast<index>((alignmentBytes - misalignment) / sizeof(float));
+}
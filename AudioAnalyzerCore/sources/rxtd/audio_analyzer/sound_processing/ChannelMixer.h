@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2020 Danil Uzlov
+
+#pragma once
+#include "Channel.h"
+#include "DownmixMatrix.h"
+#include "rxtd/filter_utils/BlockKernels.h"
+#include "rxtd/std_fixes/Vector2D.h"
+
+namespace rxtd::audio_analyzer {
+	/// <summary>
+	/// Stores captured data of all channels in one planar buffer,
+	/// and creates channels described by DownmixMatrix.
+	///
+	/// Each channel has a slot in the buffer, which is found directly by the Channel value.
+	/// Slots of the layout go first, results of the matrix go after them.
+	/// All slots have the same capacity, and are aligned to cache lines.
+	/// Not copyable: a copy of the buffer can have a different alignment.
+	/// </summary>
+	class ChannelMixer : MovableOnlyBase {
+		static constexpr index channelsCount = DownmixMatrix::channelsCount;
+		// in floats, 64 bytes
+		static constexpr index slotAlignment = 16;
+		static constexpr index noSlot = -1;
+
+		struct MixRow {
+			index destSlot = 0;
+			std::vector<index> sourceSlots;
+			std::vector<float> weights;
+		};
+
+		ChannelLayout layout;
+		DownmixMatrix downmix;
+		filter_utils::BlockKernels kernels;
+
+		// index of the channel in the data that is passed to #saveChannelsData(), for each slot of the layout
+		std::vector<index> streamIndices;
+		// slot with the data of the channel from the source
+		std::array<index, channelsCount> sourceSlots{};
+		// slot that #getChannelPCM() returns for the channel
+		std::array<index, channelsCount> outputSlots{};
+		std::vector<MixRow> mixRows;
+		// sources of a row, kept here to avoid allocations
+		std::vector<const float*> sourcePointers;
+
+		std::vector<float> buffer;
+		index slotsCount = 0;
+		index slotCapacity = 0;
+		std::vector<index> slotSizes;
+
+	public:
+		ChannelMixer() {
+			sourceSlots.fill(noSlot);
+			outputSlots.fill(noSlot);
+		}
+
+		void setLayout(const ChannelLayout& _layout);
+
+		void setDownmix(DownmixMatrix value);
+
+		void saveChannelsData(std_fixes::array2d_view<float> channelsData);
+		// channel must be in the layout
+		void appendChannelData(Channel channel, array_view<float> data) {
+			appendSlotData(sourceSlots[static_cast<size_t>(channel)], data);
+		}
+
+		// creates channels of the downmix matrix from everything that was saved since the last #reset()
+		void mix();
+
+		// empty if the channel doesn't exist
+		[[nodiscard]]
+		array_view<float> getChannelPCM(Channel channel) const;
+
+		void reset() {
+			std::fill(slotSizes.begin(), slotSizes.end(), 0);
+		}
+
+		// Mixers with the same layout and downmix have the same slots,
+		// so mixed data can be moved from one to another slot by slot, without mixing it again.
+		[[nodiscard]]
+		index getSlotsCount() const {
+			return slotsCount;
+		}
+
+		[[nodiscard]]
+		array_view<float> getSlotPCM(index slot) const {
+			return { getSlotData(slot), slotSizes[static_cast<size_t>(slot)] };
+		}
+
+		void appendSlotData(index slot, array_view<float> data);
+
+	private:
+		void updateSlots();
+		void addMixRow(const DownmixMatrix::Row& row);
+
+		// makes sure that each slot can hold at least #size values
+		void reserve(index size);
+
+		[[nodiscard]]
+		float* getSlotData(index slot) {
+			return buffer.data() + getAlignmentOffset(buffer.data()) + slot * slotCapacity;
+		}
+
+		[[nodiscard]]
+		const float* getSlotData(index slot) const {
+			return buffer.data() + getAlignmentOffset(buffer.data()) + slot * slotCapacity;
+		}
+
+		// offset of the first slot from the beginning of the buffer
+		[[nodiscard]]
+		static index getAlignmentOffset(const float* data);
+	};
+}
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "DownmixMatrix.h"
+
+using rxtd::audio_analyzer::DownmixMatrix;
+using rxtd::audio_analyzer::Channel;
+using rxtd::option_parsing::OptionParser;
+
+namespace {
+	float& weightOf(DownmixMatrix::Row& row, Channel channel) {
+		return row.weights[static_cast<size_t>(channel)];
+	}
+}
+
+DownmixMatrix DownmixMatrix::getItu(bool stereo) {
+	// -3 dB
+	constexpr float surroundWeight = 0.70710678f;
+
+	Row left;
+	left.target = Channel::eFRONT_LEFT;
+	weightOf(left, Channel::eFRONT_LEFT) = 1.0f;
+	weightOf(left, Channel::eCENTER) = surroundWeight;
+	weightOf(left, Channel::eSIDE_LEFT) = surroundWeight;
+	weightOf(left, Channel::eBACK_LEFT) = surroundWeight;
+	// center back is split between both sides
+	weightOf(left, Channel::eCENTER_BACK) = 0.5f;
+
+	Row right;
+	right.target = Channel::eFRONT_RIGHT;
+	weightOf(right, Channel::eFRONT_RIGHT) = 1.0f;
+	weightOf(right, Channel::eCENTER) = surroundWeight;
+	weightOf(right, Channel::eSIDE_RIGHT) = surroundWeight;
+	weightOf(right, Channel::eBACK_RIGHT) = surroundWeight;
+	weightOf(right, Channel::eCENTER_BACK) = 0.5f;
+
+	Row mono;
+	mono.target = Channel::eAUTO;
+	for (index i = 0; i < channelsCount; i++) {
+		mono.weights[static_cast<size_t>(i)] = (left.weights[static_cast<size_t>(i)] + right.weights[static_cast<size_t>(i)]) * 0.5f;
+	}
+
+	if (stereo) {
+		return DownmixMatrix{ { left, right, mono } };
+	}
+	return DownmixMatrix{ { mono } };
+}
+
+DownmixMatrix DownmixMatrix::parse(const option_parsing::Option& option, OptionParser& parser, const Logger& cl) {
+	const auto name = option.asIString();
+	if (name.empty() || name == L"Average") {
+		return {};
+	}
+	if (name == L"ITU") {
+		return getItu(false);
+	}
+	if (name == L"ITUStereo") {
+		return getItu(true);
+	}
+
+	std::vector<Row> rows;
+	for (auto rowOption : option.asList(L'|')) {
+		auto [targetOption, weightsOption] = rowOption.breakFirst(L' ');
+
+		const auto targetOpt = ChannelUtils::parse(targetOption.asIString());
+		if (!targetOpt.has_value()) {
+			cl.error(L"Downmix: channel '{}' is not recognized", targetOption);
+			throw OptionParser::Exception{};
+		}
+		for (const auto& row : rows) {
+			if (row.target == targetOpt.value()) {
+				cl.error(L"Downmix: channel '{}' is described more than once", targetOption);
+				throw OptionParser::Exception{};
+			}
+		}
+
+		Row row;
+		row.target = targetOpt.value();
+		for (auto weightOption : weightsOption.asList(L',')) {
+			auto [channelOption, valueOption] = weightOption.breakFirst(L' ');
+
+			const auto channelOpt = ChannelUtils::parse(channelOption.asIString());
+			if (!channelOpt.has_value() || channelOpt.value() == Channel::eAUTO) {
+				cl.error(L"Downmix: '{}' can't be used as a source channel", channelOption);
+				throw OptionParser::Exception{};
+			}
+			weightOf(row, channelOpt.value()) = parser.parse(valueOption, L"Downmix").as<float>();
+		}
+
+		rows.push_back(row);
+	}
+
+	return DownmixMatrix{ std::move(rows) };
+}
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "Channel.h"
+#include "rxtd/Logger.h"
+#include "rxtd/option_parsing/OptionParser.h"
+
+namespace rxtd::audio_analyzer {
+	/// <summary>
+	/// Describes channels that ChannelMixer creates from other channels.
+	///
+	/// Each row replaces its target channel with a weighted sum of source channels.
+	/// Sources are always the channels of the device, so rows don't depend on each other.
+	/// Sources that the device doesn't have are ignored,
+	/// and rows that don't have any existing source are not applied.
+	/// Devices with only one channel don't use the matrix.
+	/// Without a row for Auto, Auto is the average of front left and front right channels.
+	/// </summary>
+	class DownmixMatrix {
+	public:
+		static constexpr index channelsCount = static_cast<index>(Channel::eAUTO) + 1;
+
+		struct Row {
+			Channel target = Channel::eAUTO;
+			// indexed by Channel, weight of Auto is not used
+			std::array<float, channelsCount> weights{};
+
+			// autogenerated
+			friend bool operator==(const Row& lhs, const Row& rhs) {
+				return lhs.target == rhs.target
+					&& lhs.weights == rhs.weights;
+			}
+
+			friend bool operator!=(const Row& lhs, const Row& rhs) {
+				return !(lhs == rhs);
+			}
+		};
+
+	private:
+		std::vector<Row> rows;
+
+	public:
+		DownmixMatrix() = default;
+
+		explicit DownmixMatrix(std::vector<Row> rows) : rows(std::move(rows)) { }
+
+		/// <summary>
+		/// Downmix of ITU-R BS.775: center and surround channels are mixed with -3 dB into the front channels,
+		/// and Auto is the average of the mixed front channels.
+		/// If #stereo is true, the front channels are replaced with the mixed ones as well.
+		/// LFE is not used.
+		/// </summary>
+		[[nodiscard]]
+		static DownmixMatrix getItu(bool stereo);
+
+		/// <summary>
+		/// Parses value of the Downmix option:
+		///   Average (or empty) — default matrix
+		///   ITU, ITUStereo — see #getItu()
+		///   <target> <channel> <weight>, <channel> <weight>, ... | <target> ... — custom rows
+		/// On error writes a log message and throws OptionParser::Exception.
+		/// </summary>
+		[[nodiscard]]
+		static DownmixMatrix parse(const option_parsing::Option& option, option_parsing::OptionParser& parser, const Logger& cl);
+
+		[[nodiscard]]
+		array_view<Row> getRows() const {
+			return rows;
+		}
+
+		// autogenerated
+		friend bool operator==(const DownmixMatrix& lhs, const DownmixMatrix& rhs) {
+			return lhs.rows == rhs.rows;
+		}
+
+		friend bool operator!=(const DownmixMatrix& lhs, const DownmixMatrix& rhs) {
+			return !(lhs == rhs);
+		}
+	};
+}
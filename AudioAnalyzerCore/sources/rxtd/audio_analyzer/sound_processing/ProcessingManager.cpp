@@ -0,0 +1,303 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2019 Danil Uzlov
+
+#include "ProcessingManager.h"
+
+#include <numeric>
+
+#include "rxtd/std_fixes/MapUtils.h"
+
+using rxtd::audio_analyzer::ProcessingManager;
+using rxtd::std_fixes::MapUtils;
+using rxtd::audio_analyzer::options::HandlerInfo;
+
+void ProcessingManager::setParams(
+	Logger _logger,
+	const ProcessingData& pd,
+	Version version,
+	index sampleRate, array_view<Channel> channelsView,
+	Snapshot& snapshot
+) {
+	logger = std::move(_logger);
+
+	std::set<Channel> channels;
+	for (const auto channel : pd.channels) {
+		if (channel == Channel::eAUTO || channelsView.contains(channel)) {
+			channels.insert(channel);
+		}
+	}
+
+	resamplingMultiplier = 1;
+	resamplingDivider = 1;
+	if (pd.targetRate != 0) {
+		const index divisor = std::gcd(sampleRate, pd.targetRate);
+		const bool isRational = pd.downsampling == DownsampleHelper::Method::eRATIONAL;
+		if (isRational && pd.targetRate / divisor <= filter_utils::RationalResampler::maxPhases) {
+			// exactly target rate, so that all devices give the same results
+			resamplingMultiplier = pd.targetRate / divisor;
+			resamplingDivider = sampleRate / divisor;
+		} else {
+			if (isRational) {
+				logger.warning(L"target rate {} can't be reached from sample rate {}, integer divider is used", pd.targetRate, sampleRate);
+			}
+			const auto ratio = static_cast<double>(sampleRate) / static_cast<double>(pd.targetRate);
+			resamplingDivider = ratio > 1 ? static_cast<index>(ratio) : 1;
+		}
+	}
+	const index finalSampleRate = sampleRate * resamplingMultiplier / resamplingDivider;
+
+	auto oldChannelMap = std::exchange(channelMap, {});
+
+	// handlers are patched by name, and their snapshots are put into flat vectors when all handlers are known
+	std::map<Channel, NamedSnapshots> namedSnapshots;
+	for (auto& [channel, channelSnapshot] : snapshot) {
+		if (channelSnapshot.indices == nullptr) {
+			continue;
+		}
+		for (auto& [name, snapshotIndex] : *channelSnapshot.indices) {
+			namedSnapshots[channel][name] = std::move(channelSnapshot.handlers[static_cast<size_t>(snapshotIndex)]);
+		}
+	}
+
+	for (auto channel : channels) {
+		auto& newChannelStruct = channelMap[channel];
+		auto& oldChannelStruct = oldChannelMap[channel];
+		if (oldChannelStruct.filterSource != newChannelStruct.filterSource) {
+			newChannelStruct.filter = std::move(oldChannelStruct.filter);
+		} else {
+			newChannelStruct.filter = pd.filter.creator.getInstance(static_cast<double>(finalSampleRate));
+		}
+		newChannelStruct.downsampleHelper.setMethod(pd.downsampling);
+		newChannelStruct.downsampleHelper.setRatio(resamplingMultiplier, resamplingDivider);
+	}
+
+	order.clear();
+	for (auto& handlerName : pd.handlerOrder) {
+		const HandlerInfo& patchInfo = pd.handlers.find(handlerName)->second;
+
+		bool handlerIsValid = true;
+		for (auto channel : channels) {
+			auto& channelDataNew = channelMap[channel].handlerMap;
+			auto cl = logger.context(L"{}: ", handlerName);
+
+			auto handlerPtr = patchInfo.meta.transform(std::move(oldChannelMap[channel].handlerMap[handlerName]));
+			if (handlerPtr == nullptr) {
+				cl.error(L"invalid handler");
+
+				handlerIsValid = false;
+				break;
+			}
+
+			handler::HandlerBase* source = nullptr;
+			if (patchInfo.meta.sourcesCount == 1) {
+				const auto iter = channelDataNew.find(patchInfo.source);
+				if (iter == channelDataNew.end()) {
+					cl.error(L"source (handler {}) is not found", patchInfo.source);
+					handlerIsValid = false;
+					break;
+				}
+				source = iter->second.get();
+			}
+			const bool success = handlerPtr->patch(
+				handlerName % csView() % own(),
+				patchInfo.meta.params, source,
+				finalSampleRate, version,
+				cl,
+				namedSnapshots[channel][handlerName]
+			);
+
+			if (!success) {
+				cl.error(L"invalid handler");
+
+				handlerIsValid = false;
+				break;
+			}
+
+			channelDataNew[handlerName] = std::move(handlerPtr);
+		}
+
+		if (handlerIsValid) {
+			order.push_back(handlerName);
+		} else {
+			order.clear();
+			break;
+		}
+	}
+
+	MapUtils::intersectKeyCollection(snapshot, channels);
+	for (auto& [channel, channelStruct] : channelMap) {
+		buildPlan(channelStruct, namedSnapshots[channel], snapshot[channel]);
+	}
+
+	createFilterBatches(pd, finalSampleRate);
+}
+
+void ProcessingManager::buildPlan(ChannelStruct& channelStruct, NamedSnapshots& namedSnapshots, ChannelSnapshot& channelSnapshot) const {
+	auto& handlerMap = channelStruct.handlerMap;
+
+	auto indices = std::make_shared<SnapshotIndices>();
+	channelSnapshot.handlers.clear();
+	for (auto& [name, handler] : handlerMap) {
+		(*indices)[name] = static_cast<index>(channelSnapshot.handlers.size());
+		channelSnapshot.handlers.push_back(std::move(namedSnapshots[name]));
+	}
+
+	channelStruct.plan.clear();
+	for (auto& handlerName : order) {
+		PlanStep step;
+		step.handler = handlerMap.find(handlerName)->second.get();
+		step.snapshotIndex = indices->find(handlerName)->second;
+		channelStruct.plan.push_back(step);
+	}
+
+	channelStruct.snapshotIndices = indices;
+	channelSnapshot.indices = std::move(indices);
+}
+
+void ProcessingManager::createFilterBatches(const ProcessingData& pd, index sampleRate) {
+	// batches that haven't changed keep the state of their filters
+	auto oldBatches = std::exchange(filterBatches, {});
+	for (auto& [channel, channelStruct] : channelMap) {
+		channelStruct.batched = false;
+	}
+
+	// single channel gains nothing from batching
+	if (!pd.filterBatching || channelMap.size() < 2) {
+		return;
+	}
+
+	// all channels use the same filter description, so one instance describes all of them
+	const auto cascade = pd.filter.creator.getInstance(static_cast<double>(sampleRate));
+	if (cascade.isEmpty()) {
+		return;
+	}
+
+	std::vector<filter_utils::BiquadCoefficients> sections;
+	double gainAmp = 1.0;
+	if (!cascade.exportSections(sections, gainAmp)) {
+		logger.warning(L"filter can't be batched, channels will be filtered separately");
+		return;
+	}
+
+	for (auto& [channel, channelStruct] : channelMap) {
+		if (filterBatches.empty() || static_cast<index>(filterBatches.back().members.size()) == MultiChannelBiquadCascade::maxChannels) {
+			filterBatches.emplace_back();
+		}
+		filterBatches.back().members.emplace_back(channel, &channelStruct);
+		channelStruct.batched = true;
+	}
+
+	for (auto& batch : filterBatches) {
+		const auto sameChannels = [&](const FilterBatch& old) {
+			return std::equal(
+				old.members.begin(), old.members.end(), batch.members.begin(), batch.members.end(),
+				[](const auto& left, const auto& right) {
+					return left.first == right.first;
+				}
+			);
+		};
+		const auto oldBatch = std::find_if(
+			oldBatches.begin(), oldBatches.end(), [&](const FilterBatch& old) {
+				return sameChannels(old) && old.filter.hasCoefficients(sections, gainAmp);
+			}
+		);
+
+		if (oldBatch != oldBatches.end()) {
+			batch.filter = std::move(oldBatch->filter);
+		} else {
+			batch.filter = { sections, gainAmp };
+		}
+	}
+}
+
+void ProcessingManager::appendTasks(Snapshot& snapshot, std::vector<FilterBatchTask>& batchTasks, std::vector<ChannelTask>& tasks) {
+	for (auto& batch : filterBatches) {
+		batchTasks.push_back({ this, &batch });
+	}
+	for (auto& [channel, channelStruct] : channelMap) {
+		tasks.push_back({ this, channel, &channelStruct, &snapshot[channel] });
+	}
+}
+
+void ProcessingManager::prepareChannel(Channel channel, ChannelStruct& channelStruct, const ChannelMixer& mixer) const {
+	if (auto wave = mixer.getChannelPCM(channel);
+		resamplingMultiplier == 1 && resamplingDivider <= 1) {
+		channelStruct.originalWave = wave;
+	} else {
+		const index nextBufferSize = channelStruct.downsampleHelper.pushData(wave);
+		channelStruct.downsampledBuffer.resize(static_cast<size_t>(nextBufferSize));
+		channelStruct.downsampleHelper.downsample(channelStruct.downsampledBuffer);
+		channelStruct.originalWave = channelStruct.downsampledBuffer;
+	}
+	channelStruct.originalWave.transferToVector(channelStruct.filteredBuffer);
+}
+
+void ProcessingManager::processFilterBatch(FilterBatch& batch, const ChannelMixer& mixer) noexcept {
+	try {
+		batch.buffers.clear();
+		for (auto [channel, channelStruct] : batch.members) {
+			prepareChannel(channel, *channelStruct, mixer);
+			batch.buffers.emplace_back(channelStruct->filteredBuffer);
+		}
+
+		batch.filter.apply(batch.buffers);
+	} catch (...) {
+		batch.exception = std::current_exception();
+	}
+}
+
+void ProcessingManager::processChannel(const ChannelTask& task, const ChannelMixer& mixer, clock::time_point killTime) noexcept {
+	auto& channelStruct = *task.channelStruct;
+	auto& channelSnapshot = *task.snapshot;
+
+	try {
+		if (!channelStruct.batched) {
+			prepareChannel(task.channel, channelStruct, mixer);
+			channelStruct.filter.applyInPlace(channelStruct.filteredBuffer);
+		}
+
+		handler::HandlerBase::ProcessContext context{};
+		context.originalWave = channelStruct.originalWave;
+		context.wave = channelStruct.filteredBuffer;
+		context.killTime = killTime;
+
+		// all copies of the snapshot that were made after the last configuration share indices
+		if (channelSnapshot.indices != channelStruct.snapshotIndices) {
+			// snapshot is not configured for current handlers, which normally shouldn't happen
+			channelSnapshot.indices = channelStruct.snapshotIndices;
+			channelSnapshot.handlers.clear();
+			channelSnapshot.handlers.resize(channelStruct.snapshotIndices->size());
+		}
+
+		for (const auto& step : channelStruct.plan) {
+			step.handler->process(context, channelSnapshot.handlers[static_cast<size_t>(step.snapshotIndex)]);
+		}
+	} catch (...) {
+		channelStruct.exception = std::current_exception();
+	}
+}
+
+void ProcessingManager::finishTasks() {
+	try {
+		for (auto& batch : filterBatches) {
+			if (batch.exception != nullptr) {
+				std::rethrow_exception(std::exchange(batch.exception, nullptr));
+			}
+		}
+		for (auto& [channel, channelStruct] : channelMap) {
+			if (channelStruct.exception != nullptr) {
+				std::rethrow_exception(std::exchange(channelStruct.exception, nullptr));
+			}
+		}
+	} catch (handler::HandlerBase::TooManyValuesException& e) {
+		logger.error(L"{}: memory usage exceeded limit. Check your settings", e.getSourceName());
+		logger.error(L"processing stopped");
+		filterBatches.clear();
+		channelMap.clear();
+	} catch (handler::HandlerBase::InvalidOptionsException&) {
+		logger.error(L"{}: unknown runtime error");
+		logger.error(L"processing stopped");
+		filterBatches.clear();
+		channelMap.clear();
+	}
+}
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2019 Danil Uzlov
+
+#pragma once
+#include <chrono>
+
+#include "Channel.h"
+#include "ChannelMixer.h"
+#include "rxtd/audio_analyzer/options/ParamHelper.h"
+#include "rxtd/filter_utils/DownsampleHelper.h"
+#include "rxtd/filter_utils/MultiChannelBiquadCascade.h"
+
+namespace rxtd::audio_analyzer {
+	class ProcessingManager {
+	public:
+		using SnapshotIndices = std::map<istring, index, std::less<>>;
+
+		/// <summary>
+		/// Snapshots of all handlers of one channel.
+		/// Processing finds snapshots of its handlers by position,
+		/// names are only needed to find them from outside.
+		/// </summary>
+		struct ChannelSnapshot {
+			// position of each handler in #handlers,
+			// shared by all copies of the snapshot, so that processing can check that the snapshot matches its configuration
+			std::shared_ptr<const SnapshotIndices> indices;
+			std::vector<handler::HandlerBase::Snapshot> handlers;
+
+			// nullptr if there is no such handler
+			[[nodiscard]]
+			handler::HandlerBase::Snapshot* find(isview name) {
+				return const_cast<handler::HandlerBase::Snapshot*>(std::as_const(*this).find(name));
+			}
+
+			// nullptr if there is no such handler
+			[[nodiscard]]
+			const handler::HandlerBase::Snapshot* find(isview name) const {
+				if (indices == nullptr) {
+					return nullptr;
+				}
+				const auto iter = indices->find(name);
+				if (iter == indices->end()) {
+					return nullptr;
+				}
+				return &handlers[static_cast<size_t>(iter->second)];
+			}
+		};
+
+		using Snapshot = std::map<Channel, ChannelSnapshot, std::less<>>;
+		using ProcessingData = options::ProcessingData;
+		using FilterCascade = filter_utils::FilterCascade;
+		using DownsampleHelper = filter_utils::DownsampleHelper;
+		using MultiChannelBiquadCascade = filter_utils::MultiChannelBiquadCascade;
+
+		using clock = handler::HandlerBase::clock;
+
+		using HandlerMap = std::map<istring, std::unique_ptr<handler::HandlerBase>, std::less<>>;
+
+		struct PlanStep {
+			handler::HandlerBase* handler = nullptr;
+			// position of the handler in ChannelSnapshot::handlers
+			index snapshotIndex = 0;
+		};
+
+		struct ChannelStruct {
+			HandlerMap handlerMap;
+
+			// handlers in the order of execution, with sources before handlers that use them
+			std::vector<PlanStep> plan;
+			// same object as in ChannelSnapshot that is configured for this plan
+			std::shared_ptr<const SnapshotIndices> snapshotIndices;
+
+			string filterSource;
+			FilterCascade filter;
+			DownsampleHelper downsampleHelper;
+
+			std::vector<float> downsampledBuffer;
+			std::vector<float> filteredBuffer;
+			// filled on each process call, points either to the mixer or to downsampledBuffer
+			array_view<float> originalWave;
+
+			// when true, filteredBuffer is filled by FilterBatchTask before the channel task runs
+			bool batched = false;
+
+			// exception thrown while processing, reported after all channels are finished
+			std::exception_ptr exception;
+		};
+
+		/// <summary>
+		/// Independent unit of work: one channel of one processing.
+		/// Tasks of different channels don't share any mutable state, so they can be run concurrently.
+		/// </summary>
+		struct ChannelTask {
+			ProcessingManager* manager = nullptr;
+			Channel channel{};
+			ChannelStruct* channelStruct = nullptr;
+			ChannelSnapshot* snapshot = nullptr;
+
+			void process(const ChannelMixer& mixer, clock::time_point killTime) const noexcept {
+				manager->processChannel(*this, mixer, killTime);
+			}
+		};
+
+		/// <summary>
+		/// Channels that are filtered together with one MultiChannelBiquadCascade.
+		/// </summary>
+		struct FilterBatch {
+			std::vector<std::pair<Channel, ChannelStruct*>> members;
+			MultiChannelBiquadCascade filter;
+			std::vector<array_span<float>> buffers;
+
+			std::exception_ptr exception;
+		};
+
+		/// <summary>
+		/// Prepares filtered waves for all channels of one FilterBatch.
+		/// Must be finished before ChannelTask of any of these channels is started.
+		/// Different batches don't share any mutable state.
+		/// </summary>
+		struct FilterBatchTask {
+			ProcessingManager* manager = nullptr;
+			FilterBatch* batch = nullptr;
+
+			void process(const ChannelMixer& mixer) const noexcept {
+				manager->processFilterBatch(*batch, mixer);
+			}
+		};
+
+	private:
+		Logger logger;
+		std::vector<istring> order;
+		std::map<Channel, ChannelStruct> channelMap;
+		std::vector<FilterBatch> filterBatches;
+		// final sample rate is sample rate * multiplier / divider
+		index resamplingMultiplier{};
+		index resamplingDivider{};
+
+	public:
+		void setParams(
+			Logger _logger,
+			const ProcessingData& pd,
+			Version version,
+			index sampleRate, array_view<Channel> layout,
+			Snapshot& snapshot
+		);
+
+		/// <summary>
+		/// Adds one task per filter batch into batchTasks, and one task per channel into tasks.
+		/// All batch tasks must be finished before any of the channel tasks is started.
+		/// Snapshot must not be modified until tasks are finished.
+		/// </summary>
+		void appendTasks(Snapshot& snapshot, std::vector<FilterBatchTask>& batchTasks, std::vector<ChannelTask>& tasks);
+
+		/// <summary>
+		/// Must be called after all tasks from #appendTasks are finished.
+		/// Reports errors that happened in tasks.
+		/// </summary>
+		void finishTasks();
+
+	private:
+		using NamedSnapshots = std::map<istring, handler::HandlerBase::Snapshot, std::less<>>;
+
+		void buildPlan(ChannelStruct& channelStruct, NamedSnapshots& namedSnapshots, ChannelSnapshot& channelSnapshot) const;
+		void createFilterBatches(const ProcessingData& pd, index sampleRate);
+		void prepareChannel(Channel channel, ChannelStruct& channelStruct, const ChannelMixer& mixer) const;
+		void processFilterBatch(FilterBatch& batch, const ChannelMixer& mixer) noexcept;
+		void processChannel(const ChannelTask& task, const ChannelMixer& mixer, clock::time_point killTime) noexcept;
+	};
+}
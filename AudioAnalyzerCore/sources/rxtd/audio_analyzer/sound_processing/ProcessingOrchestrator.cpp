@@ -46,8 +46,24 @@ void ProcessingOrchestrator::process(const ChannelMixer& channelMixer) {
 	const clock::time_point killTime = processBeginTime
 		+ std::chrono::duration_cast<clock::duration>(1.0ms * killTimeoutMs);
 
+	batchTasks.clear();
+	tasks.clear();
 	for (auto& [name, sa] : saMap) {
-		sa.process(channelMixer, killTime, snapshot[name]);
+		sa.appendTasks(snapshot[name], batchTasks, tasks);
+	}
+
+	auto runBatchTask = [&](index taskIndex) {
+		batchTasks[static_cast<size_t>(taskIndex)].process(channelMixer);
+	};
+	workerPool.run(static_cast<index>(batchTasks.size()), runBatchTask);
+
+	auto runTask = [&](index taskIndex) {
+		tasks[static_cast<size_t>(taskIndex)].process(channelMixer, killTime);
+	};
+	workerPool.run(static_cast<index>(tasks.size()), runTask);
+
+	for (auto& [name, sa] : saMap) {
+		sa.finishTasks();
 	}
 
 	if (warnTimeMs >= 0.0) {
@@ -3,6 +3,7 @@
 
 #pragma once
 #include "ProcessingManager.h"
+#include "WorkerPool.h"
 
 namespace rxtd::audio_analyzer {
 	class ProcessingOrchestrator {
@@ -19,6 +20,10 @@ namespace rxtd::audio_analyzer {
 		std::map<istring, ProcessingManager, std::less<>> saMap;
 		Snapshot snapshot;
 
+		WorkerPool workerPool;
+		std::vector<ProcessingManager::FilterBatchTask> batchTasks;
+		std::vector<ProcessingManager::ChannelTask> tasks;
+
 		bool valid = false;
 
 	public:
@@ -34,6 +39,14 @@ namespace rxtd::audio_analyzer {
 			warnTimeMs = value;
 		}
 
+		/// <summary>
+		/// Channels of all processings are distributed between threadsCount threads,
+		/// one of which is the thread that calls #process.
+		/// </summary>
+		void setThreadsCount(index value) {
+			workerPool.setThreadsCount(value);
+		}
+
 		[[nodiscard]]
 		bool isValid() const {
 			return valid;
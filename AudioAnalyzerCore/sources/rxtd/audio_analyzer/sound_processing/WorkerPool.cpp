@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "WorkerPool.h"
+
+using rxtd::audio_analyzer::WorkerPool;
+
+WorkerPool::~WorkerPool() {
+	stopThreads();
+}
+
+void WorkerPool::setThreadsCount(index value) {
+	value = std::max<index>(value, 1);
+	if (value == getThreadsCount()) {
+		return;
+	}
+
+	stopThreads();
+
+	stopRequest = false;
+	threads.reserve(static_cast<size_t>(value - 1));
+	for (index i = 1; i < value; i++) {
+		threads.emplace_back(
+			[this]() {
+				threadFunction();
+			}
+		);
+	}
+}
+
+void WorkerPool::runBatch(TaskFunction function, void* data, index tasksCount) {
+	{
+		auto lock = std::unique_lock<std::mutex>{ mutex };
+		// A worker that was woken up for the previous batch can register only after that batch has finished.
+		// It still works with the previous batch, so the batch can't be replaced until it leaves.
+		doneVariable.wait(
+			lock, [&] {
+				return busyWorkers == 0;
+			}
+		);
+		batch.function = function;
+		batch.data = data;
+		batch.tasksCount = tasksCount;
+		batch.nextTask = 0;
+		generation++;
+	}
+	wakeVariable.notify_all();
+
+	executeTasks(function, data, tasksCount);
+
+	// When all tasks are taken, only busy workers can still be running some of them.
+	// Workers that wake up later will find the batch empty.
+	auto lock = std::unique_lock<std::mutex>{ mutex };
+	doneVariable.wait(
+		lock, [&] {
+			return busyWorkers == 0;
+		}
+	);
+}
+
+void WorkerPool::stopThreads() {
+	{
+		auto lock = std::unique_lock<std::mutex>{ mutex };
+		stopRequest = true;
+	}
+	wakeVariable.notify_all();
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	threads.clear();
+}
+
+void WorkerPool::threadFunction() {
+	auto lock = std::unique_lock<std::mutex>{ mutex };
+	index lastGeneration = generation;
+
+	while (true) {
+		wakeVariable.wait(
+			lock, [&] {
+				return stopRequest || generation != lastGeneration;
+			}
+		);
+		if (stopRequest) {
+			return;
+		}
+
+		// batch can only be changed when there are no busy workers,
+		// so these values stay consistent with batch.nextTask until this worker is done
+		lastGeneration = generation;
+		const auto function = batch.function;
+		const auto data = batch.data;
+		const index tasksCount = batch.tasksCount;
+		busyWorkers++;
+		lock.unlock();
+
+		executeTasks(function, data, tasksCount);
+
+		lock.lock();
+		busyWorkers--;
+		if (busyWorkers == 0) {
+			doneVariable.notify_one();
+		}
+	}
+}
+
+void WorkerPool::executeTasks(TaskFunction function, void* data, index tasksCount) {
+	while (true) {
+		// Batch values were read under the mutex, after they were written,
+		// and the mutex also orders task results before #runBatch returns,
+		// so the counter itself doesn't need any ordering
+		const index taskIndex = batch.nextTask.fetch_add(1, std::memory_order_relaxed);
+		if (taskIndex >= tasksCount) {
+			return;
+		}
+		function(data, taskIndex);
+	}
+}
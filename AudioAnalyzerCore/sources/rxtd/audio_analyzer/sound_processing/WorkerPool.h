@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "rxtd/GenericBaseClasses.h"
+
+namespace rxtd::audio_analyzer {
+	/// <summary>
+	/// Fixed-size pool of threads that runs batches of independent tasks.
+	/// Tasks of a batch are not bound to any thread:
+	/// every participant, including the caller of #run, takes the next free task until there are none left,
+	/// so a thread that finished a cheap task immediately picks up work that would otherwise wait for a busy one.
+	/// With threads count of 1 tasks are executed on the calling thread without any synchronization.
+	/// </summary>
+	class WorkerPool : NonMovableBase {
+		using TaskFunction = void(*)(void* data, index taskIndex);
+
+		struct Batch {
+			TaskFunction function = nullptr;
+			void* data = nullptr;
+			index tasksCount = 0;
+			std::atomic<index> nextTask{ 0 };
+		};
+
+		std::vector<std::thread> threads;
+
+		std::mutex mutex;
+		std::condition_variable wakeVariable;
+		std::condition_variable doneVariable;
+		index generation = 0;
+		index busyWorkers = 0;
+		bool stopRequest = false;
+
+		Batch batch;
+
+	public:
+		WorkerPool() = default;
+		~WorkerPool();
+
+		/// <summary>
+		/// Total count of threads that execute tasks, including the thread that calls #run.
+		/// Values less than 1 are treated as 1.
+		/// Must not be called while #run is executing.
+		/// </summary>
+		void setThreadsCount(index value);
+
+		[[nodiscard]]
+		index getThreadsCount() const {
+			return static_cast<index>(threads.size()) + 1;
+		}
+
+		/// <summary>
+		/// Calls callable(taskIndex) for every taskIndex in [0, tasksCount) and returns when all calls have finished.
+		/// Calls can happen concurrently from different threads, in any order.
+		/// Callable must not throw.
+		/// </summary>
+		template<typename Callable>
+		void run(index tasksCount, Callable& callable) {
+			if (threads.empty() || tasksCount <= 1) {
+				for (index i = 0; i < tasksCount; i++) {
+					callable(i);
+				}
+				return;
+			}
+
+			runBatch(
+				[](void* data, index taskIndex) {
+					(*static_cast<Callable*>(data))(taskIndex);
+				},
+				&callable,
+				tasksCount
+			);
+		}
+
+	private:
+		void runBatch(TaskFunction function, void* data, index tasksCount);
+		void stopThreads();
+		void threadFunction();
+
+		// returns when there are no more free tasks in current batch
+		// batch values must be read under the mutex
+		void executeTasks(TaskFunction function, void* data, index tasksCount);
+	};
+}
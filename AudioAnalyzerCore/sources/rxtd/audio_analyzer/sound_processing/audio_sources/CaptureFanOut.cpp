@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "CaptureFanOut.h"
+
+using rxtd::audio_analyzer::CaptureFanOut;
+
+CaptureFanOut::Reader::Reader(std::shared_ptr<CaptureFanOut> _fanOut, std::shared_ptr<MixGroup> _group, index _id) :
+	fanOut(std::move(_fanOut)), group(std::move(_group)), id(_id) {
+	channelMixer.setLayout(fanOut->layout);
+	channelMixer.setDownmix(group->downmix);
+}
+
+CaptureFanOut::Reader::~Reader() {
+	std::lock_guard<std::mutex> lock{ fanOut->mutex };
+	fanOut->leaveGroup(*group, id);
+	fanOut->readersCount--;
+}
+
+void CaptureFanOut::Reader::setDownmix(DownmixMatrix value) {
+	if (group->downmix == value) {
+		return;
+	}
+
+	auto [newGroup, newId] = fanOut->joinGroup(value);
+	{
+		std::lock_guard<std::mutex> lock{ fanOut->mutex };
+		fanOut->leaveGroup(*group, id);
+	}
+	group = std::move(newGroup);
+	id = newId;
+
+	channelMixer.setDownmix(std::move(value));
+	channelMixer.reset();
+}
+
+bool CaptureFanOut::Reader::capture() {
+	channelMixer.reset();
+
+	auto& ring = group->ring;
+	const index skipped = ring.beginRead(id);
+	if (skipped > 0) {
+		// this reader was too slow, and writer has overwritten its data
+		overruns.fetch_add(1, std::memory_order_relaxed);
+		lostFrames.fetch_add(skipped, std::memory_order_relaxed);
+	}
+
+	const index size = ring.getAvailableSize(id);
+	if (size == 0) {
+		ring.endRead(id, 0);
+		underruns.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	// writer has already mixed the data with the same matrix
+	for (index slot = 0; slot < ring.getChannelsCount(); slot++) {
+		const auto parts = ring.read(id, slot, size);
+		channelMixer.appendSlotData(slot, parts.first);
+		channelMixer.appendSlotData(slot, parts.second);
+	}
+	ring.endRead(id, size);
+
+	return true;
+}
+
+CaptureFanOut::Stats CaptureFanOut::Reader::getStats() const {
+	// data that writer has dropped is lost for all readers of the group
+	Stats result;
+	result.overruns = fanOut->overruns.load(std::memory_order_relaxed) + overruns.load(std::memory_order_relaxed);
+	result.lostFrames = fanOut->lostFrames.load(std::memory_order_relaxed) + lostFrames.load(std::memory_order_relaxed);
+	result.underruns = underruns.load(std::memory_order_relaxed);
+	return result;
+}
+
+CaptureFanOut::CaptureFanOut(index _sampleRate, const ChannelLayout& _layout, index _capacity) :
+	sampleRate(_sampleRate), layout(_layout), capacity(_capacity) { }
+
+std::shared_ptr<CaptureFanOut::Reader> CaptureFanOut::createReader(const DownmixMatrix& downmix) {
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		if (readersCount >= SpmcChannelRing<float>::maxReaders) {
+			return nullptr;
+		}
+		readersCount++;
+	}
+
+	auto [group, id] = joinGroup(downmix);
+	return std::make_shared<Reader>(shared_from_this(), std::move(group), id);
+}
+
+void CaptureFanOut::write(const ChannelMixer& source) {
+	const auto channels = layout.ordered();
+	if (channels.empty()) {
+		return;
+	}
+
+	const index size = source.getChannelPCM(channels[0]).size();
+	index maxLostFrames = 0;
+
+	std::lock_guard<std::mutex> lock{ mutex };
+	for (const auto& group : groups) {
+		auto& ring = group->ring;
+		const index writeSize = ring.reserve(size);
+		maxLostFrames = std::max(maxLostFrames, size - writeSize);
+		if (writeSize == 0) {
+			continue;
+		}
+
+		auto& mixer = group->mixer;
+		mixer.reset();
+		for (const auto channel : channels) {
+			auto data = source.getChannelPCM(channel);
+			data.remove_suffix(data.size() - writeSize);
+			mixer.appendChannelData(channel, data);
+		}
+		mixer.mix();
+
+		for (index slot = 0; slot < mixer.getSlotsCount(); slot++) {
+			ring.write(slot, 0, mixer.getSlotPCM(slot));
+		}
+		ring.commit(writeSize);
+	}
+
+	if (maxLostFrames > 0) {
+		overruns.fetch_add(1, std::memory_order_relaxed);
+		lostFrames.fetch_add(maxLostFrames, std::memory_order_relaxed);
+	}
+}
+
+std::pair<std::shared_ptr<CaptureFanOut::MixGroup>, rxtd::index> CaptureFanOut::joinGroup(const DownmixMatrix& downmix) {
+	std::shared_ptr<MixGroup> newGroup;
+	while (true) {
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			auto group = findGroup(downmix);
+			if (group == nullptr && newGroup != nullptr) {
+				group = std::move(newGroup);
+				groups.push_back(group);
+			}
+			if (group != nullptr) {
+				group->readersCount++;
+				// count of readers is limited, so there is always a free cursor
+				return { group, group->ring.addReader() };
+			}
+		}
+
+		// ring is allocated without the lock, so that the writer isn't blocked by it
+		newGroup = std::make_shared<MixGroup>();
+		newGroup->downmix = downmix;
+		newGroup->mixer.setLayout(layout);
+		newGroup->mixer.setDownmix(downmix);
+		newGroup->ring.setParams(newGroup->mixer.getSlotsCount(), capacity);
+	}
+}
+
+void CaptureFanOut::leaveGroup(MixGroup& group, index id) {
+	group.ring.removeReader(id);
+	group.readersCount--;
+	if (group.readersCount > 0) {
+		return;
+	}
+
+	groups.erase(
+		std::remove_if(
+			groups.begin(), groups.end(), [&](const std::shared_ptr<MixGroup>& ptr) {
+				return ptr.get() == &group;
+			}
+		),
+		groups.end()
+	);
+}
+
+std::shared_ptr<CaptureFanOut::MixGroup> CaptureFanOut::findGroup(const DownmixMatrix& downmix) const {
+	for (const auto& group : groups) {
+		if (group->downmix == downmix) {
+			return group;
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include <mutex>
+
+#include "CaptureRing.h"
+#include "rxtd/SpmcChannelRing.h"
+#include "rxtd/audio_analyzer/sound_processing/AudioSource.h"
+
+namespace rxtd::audio_analyzer {
+	/// <summary>
+	/// Same as CaptureRing, but for any number of processing threads that listen to the same capture thread.
+	/// Each Reader has its own read cursor, so readers can update at different rates.
+	///
+	/// Readers with the same downmix matrix form a group.
+	/// Writer mixes captured data once for each group, and stores all channels of the group in the ring of the group,
+	/// so readers only copy data that is ready to use.
+	/// Reader that changes its downmix moves to another group, and only sees data that is written after that.
+	///
+	/// Readers are reference counted: each reader keeps the fan-out alive,
+	/// and releases its cursor when it is destroyed.
+	/// Reader that doesn't read for longer than the ring length loses its data,
+	/// but it doesn't stop the writer, so other readers aren't affected.
+	/// Writer only waits for readers that join or leave a group.
+	/// </summary>
+	class CaptureFanOut : NonMovableBase, public std::enable_shared_from_this<CaptureFanOut> {
+	public:
+		using Stats = CaptureRing::Stats;
+
+	private:
+		struct MixGroup : NonMovableBase {
+			DownmixMatrix downmix;
+			// only used by writer
+			ChannelMixer mixer;
+			// one channel for each slot of the mixer
+			SpmcChannelRing<float> ring;
+			// guarded by the mutex of the fan-out
+			index readersCount = 0;
+		};
+
+	public:
+		class Reader : public AudioSource {
+			std::shared_ptr<CaptureFanOut> fanOut;
+			std::shared_ptr<MixGroup> group;
+			index id = 0;
+			ChannelMixer channelMixer;
+			// only count data that this reader has missed
+			std::atomic<index> overruns{ 0 };
+			std::atomic<index> lostFrames{ 0 };
+			std::atomic<index> underruns{ 0 };
+
+		public:
+			Reader(std::shared_ptr<CaptureFanOut> _fanOut, std::shared_ptr<MixGroup> _group, index _id);
+			~Reader() override;
+
+			/// <summary>
+			/// Must not be called concurrently with #capture().
+			/// </summary>
+			void setDownmix(DownmixMatrix value);
+
+			/// <summary>
+			/// Moves all data that this reader hasn't seen yet into the channel mixer.
+			/// Can only be called from one thread at a time.
+			/// </summary>
+			bool capture() override;
+
+			[[nodiscard]]
+			index getSampleRate() const override {
+				return fanOut->sampleRate;
+			}
+
+			[[nodiscard]]
+			const ChannelLayout& getChannelLayout() const override {
+				return fanOut->layout;
+			}
+
+			[[nodiscard]]
+			const ChannelMixer& getChannelMixer() const override {
+				return channelMixer;
+			}
+
+			[[nodiscard]]
+			Stats getStats() const;
+		};
+
+	private:
+		index sampleRate = 0;
+		ChannelLayout layout;
+		index capacity = 0;
+
+		// guards groups and their readers
+		std::mutex mutex;
+		std::vector<std::shared_ptr<MixGroup>> groups;
+		// there can't be more readers in total than in one ring, so joining a group never fails
+		index readersCount = 0;
+
+		// writes that didn't fit into the ring of at least one group
+		std::atomic<index> overruns{ 0 };
+		// biggest count of dropped frames among groups
+		std::atomic<index> lostFrames{ 0 };
+
+	public:
+		/// <summary>
+		/// Format can't be changed: device with a new format needs a new fan-out.
+		/// </summary>
+		CaptureFanOut(index _sampleRate, const ChannelLayout& _layout, index _capacity);
+
+		/// <summary>
+		/// Returns nullptr if there are already SpmcChannelRing::maxReaders readers.
+		/// Thread-safe.
+		/// </summary>
+		[[nodiscard]]
+		std::shared_ptr<Reader> createReader(const DownmixMatrix& downmix);
+
+		/// <summary>
+		/// Appends data of all channels of the layout for all readers.
+		/// Source is expected to only have the channels of the device, without downmix.
+		/// Can only be called from one thread.
+		/// </summary>
+		void write(const ChannelMixer& source);
+
+		[[nodiscard]]
+		index getSampleRate() const {
+			return sampleRate;
+		}
+
+		[[nodiscard]]
+		const ChannelLayout& getChannelLayout() const {
+			return layout;
+		}
+
+	private:
+		/// <summary>
+		/// Adds a cursor to the group of the matrix, and creates the group if it doesn't exist.
+		/// Caller must already be counted in #readersCount.
+		/// </summary>
+		[[nodiscard]]
+		std::pair<std::shared_ptr<MixGroup>, index> joinGroup(const DownmixMatrix& downmix);
+
+		/// <summary>
+		/// Must be called under the lock.
+		/// </summary>
+		void leaveGroup(MixGroup& group, index id);
+
+		/// <summary>
+		/// Must be called under the lock.
+		/// </summary>
+		[[nodiscard]]
+		std::shared_ptr<MixGroup> findGroup(const DownmixMatrix& downmix) const;
+	};
+}
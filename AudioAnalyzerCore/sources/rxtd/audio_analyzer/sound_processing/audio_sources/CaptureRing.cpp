@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "CaptureRing.h"
+
+using rxtd::audio_analyzer::CaptureRing;
+
+void CaptureRing::setFormat(index _sampleRate, const ChannelLayout& _layout, index capacity) {
+	sampleRate = _sampleRate;
+	layout = _layout;
+	ring.setParams(layout.ordered().size(), capacity);
+	channelMixer.setLayout(layout);
+	channelMixer.reset();
+}
+
+void CaptureRing::write(const ChannelMixer& source) {
+	const auto channels = layout.ordered();
+	if (channels.empty()) {
+		return;
+	}
+
+	const index size = source.getChannelPCM(channels[0]).size();
+	const index writeSize = std::min(size, ring.getFreeSize());
+	if (writeSize < size) {
+		overruns.fetch_add(1, std::memory_order_relaxed);
+		lostFrames.fetch_add(size - writeSize, std::memory_order_relaxed);
+	}
+	if (writeSize == 0) {
+		return;
+	}
+
+	for (index i = 0; i < channels.size(); i++) {
+		auto data = source.getChannelPCM(channels[i]);
+		data.remove_suffix(data.size() - writeSize);
+		ring.write(i, 0, data);
+	}
+	ring.commit(writeSize);
+}
+
+bool CaptureRing::capture() {
+	channelMixer.reset();
+
+	const index size = ring.getAvailableSize();
+	if (size == 0) {
+		underruns.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	const auto channels = layout.ordered();
+	for (index i = 0; i < channels.size(); i++) {
+		const auto parts = ring.read(i, size);
+		channelMixer.appendChannelData(channels[i], parts.first);
+		channelMixer.appendChannelData(channels[i], parts.second);
+	}
+	channelMixer.mix();
+	ring.release(size);
+
+	return true;
+}
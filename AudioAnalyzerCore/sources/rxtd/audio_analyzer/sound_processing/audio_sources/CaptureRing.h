@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "rxtd/SpscChannelRing.h"
+#include "rxtd/audio_analyzer/sound_processing/AudioSource.h"
+
+namespace rxtd::audio_analyzer {
+	/// <summary>
+	/// Moves captured audio from a capture thread to the processing thread.
+	/// Capture thread drains the device often and puts everything it gets into the ring with #write(),
+	/// processing thread takes everything that has accumulated since its previous update with #capture(),
+	/// so slow processing doesn't make the device buffer overflow.
+	///
+	/// When processing is so slow that the ring is full, newest frames are dropped.
+	/// Both this and updates without new data are counted in #getStats().
+	/// </summary>
+	class CaptureRing : public AudioSource {
+	public:
+		struct Stats {
+			// count of writes that didn't fit into the ring
+			index overruns = 0;
+			// count of frames that were dropped because of overruns
+			index lostFrames = 0;
+			// count of reads that found the ring empty
+			index underruns = 0;
+		};
+
+	private:
+		index sampleRate = 0;
+		ChannelLayout layout;
+		SpscChannelRing<float> ring;
+		ChannelMixer channelMixer;
+
+		// written by both threads, can be read from any thread
+		std::atomic<index> overruns{ 0 };
+		std::atomic<index> lostFrames{ 0 };
+		std::atomic<index> underruns{ 0 };
+
+	public:
+		/// <summary>
+		/// Discards all data, even if format hasn't changed:
+		/// it's called after reconnection, and old data belongs to the previous stream.
+		/// Must not be called concurrently with #write() or #capture().
+		/// </summary>
+		void setFormat(index _sampleRate, const ChannelLayout& _layout, index capacity);
+
+		/// <summary>
+		/// Must not be called concurrently with #capture().
+		/// </summary>
+		void setDownmix(DownmixMatrix value) {
+			channelMixer.setDownmix(std::move(value));
+		}
+
+		/// <summary>
+		/// Appends data of all channels of the layout.
+		/// Source is expected to only have the channels of the device, without downmix.
+		/// Can only be called from capture thread.
+		/// </summary>
+		void write(const ChannelMixer& source);
+
+		/// <summary>
+		/// Moves all available data into the channel mixer.
+		/// Can only be called from processing thread.
+		/// </summary>
+		bool capture() override;
+
+		[[nodiscard]]
+		index getSampleRate() const override {
+			return sampleRate;
+		}
+
+		[[nodiscard]]
+		const ChannelLayout& getChannelLayout() const override {
+			return layout;
+		}
+
+		[[nodiscard]]
+		const ChannelMixer& getChannelMixer() const override {
+			return channelMixer;
+		}
+
+		[[nodiscard]]
+		Stats getStats() const {
+			Stats result;
+			result.overruns = overruns.load(std::memory_order_relaxed);
+			result.lostFrames = lostFrames.load(std::memory_order_relaxed);
+			result.underruns = underruns.load(std::memory_order_relaxed);
+			return result;
+		}
+	};
+}
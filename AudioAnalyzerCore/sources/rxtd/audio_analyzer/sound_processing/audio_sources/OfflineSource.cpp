@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "OfflineSource.h"
+
+using rxtd::audio_analyzer::OfflineSource;
+
+bool OfflineSource::capture() {
+	channelMixer.reset();
+
+	if (blockSize == 0 || buffer.getBuffersCount() == 0) {
+		return false;
+	}
+
+	const index written = std::clamp<index>(vFill(buffer), 0, blockSize);
+	if (written == 0) {
+		return false;
+	}
+
+	float* data = buffer.getFlat().data();
+	if (written < blockSize) {
+		// compact channel buffers so that they can be viewed as a 2D array of smaller size
+		// destination is never after the source, so we can move channels in order
+		for (index channel = 1; channel < buffer.getBuffersCount(); channel++) {
+			std::copy_n(data + channel * blockSize, written, data + channel * written);
+		}
+	}
+
+	channelMixer.saveChannelsData({ data, buffer.getBuffersCount(), written });
+	channelMixer.mix();
+	framesProduced += written;
+
+	return true;
+}
+
+void OfflineSource::setFormat(index _sampleRate, index channelsCount, ChannelLayout _layout) {
+	sampleRate = _sampleRate;
+	layout = std::move(_layout);
+	buffer.setBuffersCount(channelsCount);
+	channelMixer.setLayout(layout);
+}
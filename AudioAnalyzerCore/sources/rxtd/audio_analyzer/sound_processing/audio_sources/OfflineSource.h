@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "rxtd/audio_analyzer/sound_processing/AudioSource.h"
+#include "rxtd/std_fixes/Vector2D.h"
+
+namespace rxtd::audio_analyzer {
+	/// <summary>
+	/// Base class for sources that don't depend on real time.
+	/// Each #capture() call produces #blockSize frames, until the source runs out of data.
+	/// </summary>
+	class OfflineSource : public AudioSource {
+		index sampleRate = 0;
+		ChannelLayout layout;
+		index blockSize = 0;
+		std_fixes::Vector2D<float> buffer;
+		ChannelMixer channelMixer;
+		index framesProduced = 0;
+
+	public:
+		void setBlockSize(index value) {
+			blockSize = std::max<index>(value, 1);
+			buffer.setBufferSize(blockSize);
+		}
+
+		// Block size that makes #capture() emulate a device that is polled #updateRate times per second
+		void setBlockSizeForUpdateRate(double updateRate) {
+			setBlockSize(static_cast<index>(static_cast<double>(sampleRate) / updateRate));
+		}
+
+		void setDownmix(DownmixMatrix value) {
+			channelMixer.setDownmix(std::move(value));
+		}
+
+		[[nodiscard]]
+		index getBlockSize() const {
+			return blockSize;
+		}
+
+		[[nodiscard]]
+		index getFramesProduced() const {
+			return framesProduced;
+		}
+
+		bool capture() final;
+
+		[[nodiscard]]
+		index getSampleRate() const final {
+			return sampleRate;
+		}
+
+		[[nodiscard]]
+		const ChannelLayout& getChannelLayout() const final {
+			return layout;
+		}
+
+		[[nodiscard]]
+		const ChannelMixer& getChannelMixer() const final {
+			return channelMixer;
+		}
+
+	protected:
+		// #channelsCount is the count of channels in the stream,
+		// which can be bigger than the count of channels in the layout
+		// when the stream has channels we don't know how to name
+		void setFormat(index _sampleRate, index channelsCount, ChannelLayout _layout);
+
+		// Fills #dest with the next portion of data, one buffer per channel.
+		// Returns count of frames written.
+		// Value less than buffer size means that the source has run out of data.
+		virtual index vFill(std_fixes::array2d_span<float> dest) = 0;
+	};
+}
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "PcmFileSource.h"
+
+#include <cstring>
+#include <fstream>
+
+using rxtd::audio_analyzer::PcmFileSource;
+using rxtd::filter_utils::SampleConverter;
+using SampleType = PcmFileSource::SampleType;
+
+template<>
+std::optional<SampleType> parseEnum<SampleType>(rxtd::isview name) {
+	if (name == L"s16") {
+		return SampleType::eINT16;
+	}
+	if (name == L"s24") {
+		return SampleType::eINT24;
+	}
+	if (name == L"s32") {
+		return SampleType::eINT32;
+	}
+	if (name == L"f32") {
+		return SampleType::eFLOAT32;
+	}
+
+	return {};
+}
+
+namespace {
+	// all multibyte values in WAV files are little-endian
+	template<typename T>
+	T readValue(array_view<std::byte> bytes, rxtd::index offset) {
+		if (offset + static_cast<rxtd::index>(sizeof(T)) > bytes.size()) {
+			throw PcmFileSource::FileException{ "unexpected end of file" };
+		}
+
+		T result;
+		std::memcpy(&result, bytes.data() + offset, sizeof(T));
+		return result;
+	}
+
+	bool compareTag(array_view<std::byte> bytes, rxtd::index offset, const char* tag) {
+		if (offset + 4 > bytes.size()) {
+			return false;
+		}
+		return std::memcmp(bytes.data() + offset, tag, 4) == 0;
+	}
+}
+
+PcmFileSource PcmFileSource::readWav(const std::filesystem::path& path) {
+	const auto file = readFile(path);
+	const array_view<std::byte> bytes = file;
+
+	if (!compareTag(bytes, 0, "RIFF") || !compareTag(bytes, 8, "WAVE")) {
+		throw FileException{ "file is not a WAV file" };
+	}
+
+	struct {
+		uint16_t formatTag = 0;
+		uint16_t channels = 0;
+		uint32_t sampleRate = 0;
+		uint16_t bitsPerSample = 0;
+		uint32_t channelMask = 0;
+	} format;
+	bool formatFound = false;
+	array_view<std::byte> data;
+
+	index offset = 12;
+	while (offset + 8 <= bytes.size()) {
+		const index chunkSize = readValue<uint32_t>(bytes, offset + 4);
+		const index chunkStart = offset + 8;
+
+		if (compareTag(bytes, offset, "fmt ")) {
+			format.formatTag = readValue<uint16_t>(bytes, chunkStart);
+			format.channels = readValue<uint16_t>(bytes, chunkStart + 2);
+			format.sampleRate = readValue<uint32_t>(bytes, chunkStart + 4);
+			format.bitsPerSample = readValue<uint16_t>(bytes, chunkStart + 14);
+
+			constexpr uint16_t waveFormatExtensible = 0xFFFE;
+			if (format.formatTag == waveFormatExtensible) {
+				format.channelMask = readValue<uint32_t>(bytes, chunkStart + 20);
+				// first two bytes of sub format GUID are the actual format tag
+				format.formatTag = readValue<uint16_t>(bytes, chunkStart + 24);
+			}
+			formatFound = true;
+		} else if (compareTag(bytes, offset, "data")) {
+			// some writers don't fill the size when they write into a stream
+			const index size = std::min(chunkSize, bytes.size() - chunkStart);
+			data = { bytes.data() + chunkStart, size };
+		}
+
+		// chunks are word-aligned
+		offset = chunkStart + chunkSize + chunkSize % 2;
+	}
+
+	if (!formatFound) {
+		throw FileException{ "WAV file doesn't have format description" };
+	}
+	if (format.channels == 0 || format.sampleRate == 0) {
+		throw FileException{ "WAV file has invalid format" };
+	}
+
+	constexpr uint16_t waveFormatPcm = 1;
+	constexpr uint16_t waveFormatIeeeFloat = 3;
+	SampleType type;
+	if (format.formatTag == waveFormatPcm && format.bitsPerSample == 16) {
+		type = SampleType::eINT16;
+	} else if (format.formatTag == waveFormatPcm && format.bitsPerSample == 24) {
+		type = SampleType::eINT24;
+	} else if (format.formatTag == waveFormatPcm && format.bitsPerSample == 32) {
+		type = SampleType::eINT32;
+	} else if (format.formatTag == waveFormatIeeeFloat && format.bitsPerSample == 32) {
+		type = SampleType::eFLOAT32;
+	} else {
+		throw FileException{ "WAV sample format is not supported" };
+	}
+
+	auto layout = format.channelMask != 0
+		? ChannelUtils::parseLayout(format.channelMask, false)
+		: ChannelUtils::getDefaultLayout(format.channels);
+
+	return { static_cast<index>(format.sampleRate), std::move(layout), data, type, format.channels };
+}
+
+PcmFileSource PcmFileSource::readRaw(const std::filesystem::path& path, RawFormat format) {
+	if (format.channelsCount <= 0 || format.sampleRate <= 0) {
+		throw FileException{ "invalid raw PCM format" };
+	}
+
+	const auto file = readFile(path);
+	return {
+		format.sampleRate, ChannelUtils::getDefaultLayout(format.channelsCount),
+		file, format.type, format.channelsCount
+	};
+}
+
+rxtd::index PcmFileSource::vFill(std_fixes::array2d_span<float> dest) {
+	const index length = pcm.getBufferSize();
+	const index size = dest.getBufferSize();
+	index written = 0;
+
+	while (written < size && length > 0) {
+		if (position >= length) {
+			if (!loop) {
+				break;
+			}
+			position = 0;
+		}
+
+		const index count = std::min(size - written, length - position);
+		for (index channel = 0; channel < dest.getBuffersCount(); channel++) {
+			std::copy_n(pcm[channel].data() + position, count, dest[channel].data() + written);
+		}
+
+		written += count;
+		position += count;
+	}
+
+	return written;
+}
+
+PcmFileSource::PcmFileSource(
+	index sampleRate,
+	ChannelLayout layout,
+	array_view<std::byte> interleaved,
+	SampleType type,
+	index channelsCount
+) {
+	const index sampleSize = SampleConverter::getSampleSize(type);
+	const index framesCount = interleaved.size() / (sampleSize * channelsCount);
+
+	pcm.setBuffersCount(channelsCount);
+	pcm.setBufferSize(framesCount);
+	SampleConverter{}.deinterleave(interleaved.data(), type, pcm);
+
+	setFormat(sampleRate, channelsCount, std::move(layout));
+}
+
+std::vector<std::byte> PcmFileSource::readFile(const std::filesystem::path& path) {
+	std::ifstream stream{ path, std::ios::binary | std::ios::ate };
+	if (!stream.is_open()) {
+		throw FileException{ "can't open file" };
+	}
+
+	const auto size = static_cast<size_t>(stream.tellg());
+	stream.seekg(0);
+
+	std::vector<std::byte> result(size);
+	stream.read(reinterpret_cast<char*>(result.data()), static_cast<std::streamsize>(size));
+	if (!stream) {
+		throw FileException{ "can't read file" };
+	}
+
+	return result;
+}
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include <filesystem>
+
+#include "OfflineSource.h"
+#include "rxtd/filter_utils/SampleConverter.h"
+
+namespace rxtd::audio_analyzer {
+	/// <summary>
+	/// Plays audio from a WAV or a headerless PCM file.
+	/// The whole file is decoded into memory on creation,
+	/// so that file reading doesn't affect time measurements.
+	/// </summary>
+	class PcmFileSource : public OfflineSource {
+	public:
+		using SampleType = filter_utils::SampleConverter::SampleType;
+
+		struct RawFormat {
+			SampleType type = SampleType::eFLOAT32;
+			index sampleRate = 48000;
+			index channelsCount = 2;
+		};
+
+		class FileException : public std::runtime_error {
+		public:
+			explicit FileException(const char* reason) : runtime_error(reason) {}
+		};
+
+	private:
+		// one buffer per channel
+		std_fixes::Vector2D<float> pcm;
+		index position = 0;
+		bool loop = false;
+
+	public:
+		// Supports PCM, IEEE float and WAVE_FORMAT_EXTENSIBLE files
+		// Can throw FileException
+		[[nodiscard]]
+		static PcmFileSource readWav(const std::filesystem::path& path);
+
+		// Reads interleaved little-endian samples
+		// Can throw FileException
+		[[nodiscard]]
+		static PcmFileSource readRaw(const std::filesystem::path& path, RawFormat format);
+
+		// When enabled, the file is played from the beginning after it has ended, endlessly
+		void setLoop(bool value) {
+			loop = value;
+		}
+
+		// Length of the file, in frames
+		[[nodiscard]]
+		index getLength() const {
+			return pcm.getBufferSize();
+		}
+
+	protected:
+		index vFill(std_fixes::array2d_span<float> dest) override;
+
+	private:
+		PcmFileSource(index sampleRate, ChannelLayout layout, array_view<std::byte> interleaved, SampleType type, index channelsCount);
+
+		[[nodiscard]]
+		static std::vector<std::byte> readFile(const std::filesystem::path& path);
+	};
+}
+
+template<>
+std::optional<rxtd::audio_analyzer::PcmFileSource::SampleType> parseEnum<rxtd::audio_analyzer::PcmFileSource::SampleType>(rxtd::isview name);
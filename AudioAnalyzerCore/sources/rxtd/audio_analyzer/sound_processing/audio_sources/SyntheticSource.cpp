@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "SyntheticSource.h"
+
+#include "rxtd/std_fixes/MyMath.h"
+
+using rxtd::audio_analyzer::SyntheticSource;
+using rxtd::std_fixes::MyMath;
+
+template<>
+std::optional<SyntheticSource::Signal> parseEnum<SyntheticSource::Signal>(rxtd::isview name) {
+	using Signal = SyntheticSource::Signal;
+
+	if (name == L"silence") {
+		return Signal::eSILENCE;
+	}
+	if (name == L"sweep") {
+		return Signal::eSINE_SWEEP;
+	}
+	if (name == L"pink") {
+		return Signal::ePINK_NOISE;
+	}
+
+	return {};
+}
+
+SyntheticSource::SyntheticSource(Params _params) : params(_params) {
+	params.sampleRate = std::max<index>(params.sampleRate, 1);
+	params.channelsCount = std::max<index>(params.channelsCount, 1);
+	params.sweepFrom = std::clamp(params.sweepFrom, 1.0, params.sampleRate * 0.5);
+	params.sweepTo = std::clamp(params.sweepTo, 1.0, params.sampleRate * 0.5);
+	params.sweepPeriod = std::max(params.sweepPeriod, 0.01);
+
+	setFormat(params.sampleRate, params.channelsCount, ChannelUtils::getDefaultLayout(params.channelsCount));
+}
+
+rxtd::index SyntheticSource::vFill(std_fixes::array2d_span<float> dest) {
+	auto first = dest[0];
+
+	switch (params.signal) {
+	case Signal::eSILENCE:
+		std::fill(first.begin(), first.end(), 0.0f);
+		break;
+	case Signal::eSINE_SWEEP:
+		fillSweep(first);
+		break;
+	case Signal::ePINK_NOISE:
+		fillPinkNoise(first);
+		break;
+	}
+
+	for (index channel = 1; channel < dest.getBuffersCount(); channel++) {
+		first.transferToSpan(dest[channel]);
+	}
+
+	return dest.getBufferSize();
+}
+
+void SyntheticSource::fillSweep(array_span<float> dest) {
+	const double sampleRate = static_cast<double>(params.sampleRate);
+	const index periodLength = std::max<index>(static_cast<index>(params.sweepPeriod * sampleRate), 1);
+	const double logRatio = std::log(params.sweepTo / params.sweepFrom);
+
+	for (auto& value : dest) {
+		const double progress = static_cast<double>(sweepPosition) / static_cast<double>(periodLength);
+		const double frequency = params.sweepFrom * std::exp(logRatio * progress);
+
+		value = params.amplitude * static_cast<float>(std::sin(phase));
+
+		phase += 2.0 * MyMath::pi<double>() * frequency / sampleRate;
+		if (phase > 2.0 * MyMath::pi<double>()) {
+			phase -= 2.0 * MyMath::pi<double>();
+		}
+
+		sweepPosition++;
+		if (sweepPosition >= periodLength) {
+			sweepPosition = 0;
+		}
+	}
+}
+
+void SyntheticSource::fillPinkNoise(array_span<float> dest) {
+	// See "refined method" by Paul Kellett: https://www.firstpr.com.au/dsp/pink-noise/
+	auto& b = pinkState;
+	for (auto& value : dest) {
+		const float white = whiteNoise(randomEngine);
+		b[0] = 0.99886f * b[0] + white * 0.0555179f;
+		b[1] = 0.99332f * b[1] + white * 0.0750759f;
+		b[2] = 0.96900f * b[2] + white * 0.1538520f;
+		b[3] = 0.86650f * b[3] + white * 0.3104856f;
+		b[4] = 0.55000f * b[4] + white * 0.5329522f;
+		b[5] = -0.7616f * b[5] - white * 0.0168980f;
+		const float pink = b[0] + b[1] + b[2] + b[3] + b[4] + b[5] + b[6] + white * 0.5362f;
+		b[6] = white * 0.115926f;
+
+		// filter has gain of roughly 10 dB
+		value = params.amplitude * pink * 0.11f;
+	}
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include <random>
+
+#include "OfflineSource.h"
+
+namespace rxtd::audio_analyzer {
+	/// <summary>
+	/// Endless generated signal, the same in every channel.
+	/// Generation is deterministic, so that runs on different machines can be compared.
+	/// </summary>
+	class SyntheticSource : public OfflineSource {
+	public:
+		enum class Signal {
+			eSILENCE,
+			eSINE_SWEEP,
+			ePINK_NOISE,
+		};
+
+		struct Params {
+			Signal signal = Signal::eSILENCE;
+			index sampleRate = 48000;
+			index channelsCount = 2;
+			float amplitude = 0.5f;
+
+			// sweep goes from #sweepFrom to #sweepTo exponentially, then starts again
+			double sweepFrom = 20.0;
+			double sweepTo = 20000.0;
+			double sweepPeriod = 10.0;
+		};
+
+	private:
+		Params params;
+
+		double phase = 0.0;
+		index sweepPosition = 0;
+
+		std::mt19937 randomEngine{ 0 };
+		std::uniform_real_distribution<float> whiteNoise{ -1.0f, 1.0f };
+		// Paul Kellett's pink noise filter state
+		std::array<float, 7> pinkState{};
+
+	public:
+		explicit SyntheticSource(Params _params);
+
+	protected:
+		index vFill(std_fixes::array2d_span<float> dest) override;
+
+	private:
+		void fillSweep(array_span<float> dest);
+		void fillPinkNoise(array_span<float> dest);
+	};
+}
+
+template<>
+std::optional<rxtd::audio_analyzer::SyntheticSource::Signal> parseEnum<rxtd::audio_analyzer::SyntheticSource::Signal>(rxtd::isview name);
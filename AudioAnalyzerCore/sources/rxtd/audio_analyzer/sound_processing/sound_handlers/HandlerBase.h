@@ -24,10 +24,10 @@
 
 #include "ExternalMethods.h"
 #include "rxtd/audio_analyzer/Version.h"
+#include "rxtd/audio_analyzer/options/OptionProvider.h"
 #include "rxtd/buffer_printer/BufferPrinter.h"
 #include "rxtd/option_parsing/Option.h"
 #include "rxtd/option_parsing/OptionParser.h"
-#include "rxtd/rainmeter/Rainmeter.h"
 #include "rxtd/std_fixes/AnyContainer.h"
 #include "rxtd/std_fixes/Vector2D.h"
 
@@ -39,10 +39,10 @@ namespace rxtd::audio_analyzer::handler {
 		using OptionMap = option_parsing::OptionMap;
 		using OptionList = option_parsing::OptionList;
 		using OptionSequence = option_parsing::OptionSequence;
-		using Rainmeter = rainmeter::Rainmeter;
+		using OptionProvider = options::OptionProvider;
 		using ParamsContainer = std_fixes::AnyContainer;
 		using ExternalData = ExternalMethods::ExternalData;
-		using clock = std::chrono::high_resolution_clock;
+		using clock = std::chrono::steady_clock;
 		static_assert(clock::is_steady);
 		using BufferPrinter = buffer_printer::BufferPrinter;
 		template<typename T>
@@ -173,12 +173,12 @@ namespace rxtd::audio_analyzer::handler {
 		struct ParamParseContext {
 			const OptionMap& options;
 			Logger& log;
-			const Rainmeter& rain;
+			const OptionProvider& optionProvider;
 			Version version;
 			Parser& parser;
 
-			ParamParseContext(const OptionMap& options, Logger& log, const Rainmeter& rain, const Version& version, Parser& parser) :
-				options(options), log(log), rain(rain), version(version), parser(parser) {}
+			ParamParseContext(const OptionMap& options, Logger& log, const OptionProvider& optionProvider, const Version& version, Parser& parser) :
+				options(options), log(log), optionProvider(optionProvider), version(version), parser(parser) {}
 		};
 
 		/// <summary>
@@ -45,12 +45,20 @@ BlockHandler::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalDat
 }
 
 void BlockHandler::vProcess(ProcessContext context, ExternalData& externalData) {
-	_process(context.wave);
-}
-
-void BlockHandler::setNextValue(float value) {
-	value = filter.next(value);
-	pushLayer(0)[0] = params.transformer.apply(value);
+	array_view<float> wave = context.wave;
+	while (!wave.empty()) {
+		// counter can be bigger than blockSize after blockSize was changed
+		const index partSize = std::clamp<index>(blockSize - counter, 1, wave.size());
+		accumulate({ wave.data(), partSize });
+		wave.remove_prefix(partSize);
+		counter += partSize;
+
+		if (counter >= blockSize) {
+			counter = 0;
+			const float value = filter.next(finishBlock());
+			pushLayer(0)[0] = params.transformer.apply(value);
+		}
+	}
 }
 
 bool BlockHandler::getProp(
@@ -61,35 +69,22 @@ bool BlockHandler::getProp(
 	return false;
 }
 
-void BlockRms::_process(array_view<float> wave) {
-	for (auto x : wave) {
-		intermediateResult += x * x;
-		counter++;
-		if (counter >= getBlockSize()) {
-			finishBlock();
-		}
-	}
+void BlockRms::accumulate(array_view<float> wave) {
+	intermediateResult += getKernels().sumOfSquares(wave);
 }
 
-void BlockRms::finishBlock() {
+float BlockRms::finishBlock() {
 	const float value = std::sqrt(static_cast<float>(intermediateResult) / static_cast<float>(getBlockSize()));
-	setNextValue(value);
-	counter = 0;
 	intermediateResult = 0.0;
+	return value;
 }
 
-void BlockPeak::_process(array_view<float> wave) {
-	for (auto x : wave) {
-		intermediateResult = std::max(intermediateResult, std::abs(x));
-		counter++;
-		if (counter >= getBlockSize()) {
-			finishBlock();
-		}
-	}
+void BlockPeak::accumulate(array_view<float> wave) {
+	intermediateResult = std::max(intermediateResult, getKernels().maxAbs(wave));
 }
 
-void BlockPeak::finishBlock() {
-	setNextValue(intermediateResult);
-	counter = 0;
-	intermediateResult = 0.0;
+float BlockPeak::finishBlock() {
+	const float value = intermediateResult;
+	intermediateResult = 0.0f;
+	return value;
 }
@@ -4,12 +4,14 @@
 #pragma once
 #include "rxtd/audio_analyzer/audio_utils/CustomizableValueTransformer.h"
 #include "rxtd/audio_analyzer/sound_processing/sound_handlers/HandlerBase.h"
+#include "rxtd/filter_utils/BlockKernels.h"
 #include "rxtd/filter_utils/LogarithmicIRF.h"
 
 namespace rxtd::audio_analyzer::handler {
 	class BlockHandler : public HandlerBase {
 		using CVT = audio_utils::CustomizableValueTransformer;
 		using LogarithmicIRF = filter_utils::LogarithmicIRF;
+		using BlockKernels = filter_utils::BlockKernels;
 
 		struct Params {
 			double updateInterval{};
@@ -38,8 +40,8 @@ namespace rxtd::audio_analyzer::handler {
 		index blockSize{};
 
 		LogarithmicIRF filter;
+		BlockKernels kernels;
 
-	protected:
 		index counter = 0;
 
 	public:
@@ -55,17 +57,31 @@ namespace rxtd::audio_analyzer::handler {
 		[[nodiscard]]
 		ConfigurationResult vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData& externalData) override;
 
+		/// <summary>
+		/// Splits the wave into parts that don't cross block boundaries,
+		/// so that derived classes can reduce each part in one vectorized pass.
+		/// </summary>
 		void vProcess(ProcessContext context, ExternalData& externalData) final;
 
-		void setNextValue(float value);
-
 		[[nodiscard]]
 		index getBlockSize() const {
 			return blockSize;
 		}
 
-		virtual void _process(array_view<float> wave) = 0;
-		virtual void finishBlock() = 0;
+		[[nodiscard]]
+		const BlockKernels& getKernels() const {
+			return kernels;
+		}
+
+		/// <summary>
+		/// Adds part of the current block to the intermediate result.
+		/// </summary>
+		virtual void accumulate(array_view<float> wave) = 0;
+
+		/// <summary>
+		/// Returns value for the finished block and resets the intermediate result.
+		/// </summary>
+		virtual float finishBlock() = 0;
 
 		ExternalMethods::GetPropMethodType vGetExt_getProp() const override {
 			return wrapExternalGetProp<Snapshot, &getProp>();
@@ -83,20 +99,16 @@ namespace rxtd::audio_analyzer::handler {
 	class BlockRms : public BlockHandler {
 		double intermediateResult = 0.0;
 
-	public:
-		void _process(array_view<float> wave) override;
-
 	protected:
-		void finishBlock() override;
+		void accumulate(array_view<float> wave) override;
+		float finishBlock() override;
 	};
 
 	class BlockPeak : public BlockHandler {
 		float intermediateResult = 0.0;
 
-	public:
-		void _process(array_view<float> wave) override;
-
 	protected:
-		void finishBlock() override;
+		void accumulate(array_view<float> wave) override;
+		float finishBlock() override;
 	};
 }
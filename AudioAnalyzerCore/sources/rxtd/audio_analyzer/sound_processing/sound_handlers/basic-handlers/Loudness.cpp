@@ -3,10 +3,12 @@
 
 #include "Loudness.h"
 
+#include "rxtd/filter_utils/BQFilterBuilder.h"
 #include "rxtd/std_fixes/MyMath.h"
 
 using rxtd::std_fixes::MyMath;
 using rxtd::audio_analyzer::handler::Loudness;
+using rxtd::filter_utils::BQFilterBuilder;
 using rxtd::audio_analyzer::handler::HandlerBase;
 using ParamsContainer = HandlerBase::ParamsContainer;
 
@@ -30,6 +32,8 @@ ParamsContainer Loudness::vParseParams(ParamParseContext& context) const noexcep
 
 	params.ignoreGatingForSilence = context.parser.parse(context.options, L"ignoreGatingForSilence").valueOr(true);
 
+	params.kWeighting = context.parser.parse(context.options, L"kWeighting").valueOr(false);
+
 	return params;
 }
 
@@ -51,9 +55,19 @@ HandlerBase::ConfigurationResult Loudness::vConfigure(
 
 	blocks.resize(static_cast<size_t>(blocksCount));
 	std::fill(blocks.begin(), blocks.end(), 0.0);
+	histogram.reset();
+	for (index i = 0; i < blocksCount; i++) {
+		histogram.add(0.0);
+	}
 	prevValue = 0.0;
 
-	gatingValueCoefficient = MyMath::db2amplitude(params.gatingDb) * static_cast<double>(blockSize);
+	gatingValueCoefficient = MyMath::db2amplitude(params.gatingDb);
+
+	const auto sampleRateDouble = static_cast<double>(sampleRate);
+	kWeightingFilters = {
+		BQFilterBuilder::createKWeightingShelf(sampleRateDouble),
+		BQFilterBuilder::createKWeightingHighPass(sampleRateDouble),
+	};
 
 	minBlocksCount = static_cast<index>(static_cast<double>(blocksCount) * (1.0 - params.gatingLimit));
 
@@ -61,7 +75,16 @@ HandlerBase::ConfigurationResult Loudness::vConfigure(
 }
 
 void Loudness::vProcess(ProcessContext context, ExternalData& externalData) {
-	for (const auto value : context.wave) {
+	array_view<float> wave = context.wave;
+	if (params.kWeighting) {
+		filteredWave.assign(wave.begin(), wave.end());
+		for (auto& filter : kWeightingFilters) {
+			filter.apply(filteredWave);
+		}
+		wave = filteredWave;
+	}
+
+	for (const auto value : wave) {
 		blockIntermediate += value * value;
 		blockCounter++;
 		if (blockCounter == blockSize) {
@@ -73,30 +96,30 @@ void Loudness::vProcess(ProcessContext context, ExternalData& externalData) {
 }
 
 void Loudness::pushMicroBlock(double value) {
-	blocks[static_cast<size_t>(nextBlockIndex)] = value;
+	value *= blockNormalizer;
+
+	auto& block = blocks[static_cast<size_t>(nextBlockIndex)];
+	histogram.remove(block);
+	histogram.add(value);
+	block = value;
+
 	nextBlockIndex++;
 	if (nextBlockIndex >= blocksCount) {
 		nextBlockIndex = 0;
 	}
 
+	// blocks above the gate are used, and at least minBlocksCount of the loudest blocks
 	const double gatingValue = prevValue * gatingValueCoefficient;
+	auto stats = histogram.getGated(gatingValue, minBlocksCount);
 
-	tempBlocks = blocks;
-	std::sort(tempBlocks.begin(), tempBlocks.end(), std::greater<>());
-
-	double newValue = 0.0;
-	index counter = 0;
-	for (const auto blockEnergy : blocks) {
-		if (params.ignoreGatingForSilence && blockEnergy == 0.0
-			|| blockEnergy >= gatingValue || counter < minBlocksCount) {
-			newValue += blockEnergy;
-			counter++;
-		}
+	if (params.ignoreGatingForSilence && gatingValue > 0.0) {
+		// zeros are the lowest values, so they are only used after all non-zero values
+		const index nonZeroCount = histogram.getCount() - histogram.getZeroCount();
+		const index usedZeros = std::max<index>(stats.count - nonZeroCount, 0);
+		stats.count += histogram.getZeroCount() - usedZeros;
 	}
-	newValue /= static_cast<double>(counter);
-	newValue *= blockNormalizer;
 
-	pushNextValue(newValue);
+	pushNextValue(stats.getMean());
 }
 
 void Loudness::pushNextValue(double value) {
@@ -4,10 +4,14 @@
 #pragma once
 #include "rxtd/audio_analyzer/audio_utils/CustomizableValueTransformer.h"
 #include "rxtd/audio_analyzer/sound_processing/sound_handlers/HandlerBase.h"
+#include "rxtd/filter_utils/BiQuadIIR.h"
+#include "rxtd/filter_utils/LoudnessHistogram.h"
 
 namespace rxtd::audio_analyzer::handler {
 	class Loudness : public HandlerBase {
 		using CVT = audio_utils::CustomizableValueTransformer;
+		using LoudnessHistogram = filter_utils::LoudnessHistogram;
+		using BiQuadIIR = filter_utils::BiQuadIIR;
 
 		struct Params {
 			CVT transformer{};
@@ -16,6 +20,7 @@ namespace rxtd::audio_analyzer::handler {
 			double timeWindowMs{};
 			double gatingDb{};
 			bool ignoreGatingForSilence{};
+			bool kWeighting{};
 
 			// autogenerated
 			friend bool operator==(const Params& lhs, const Params& rhs) {
@@ -24,7 +29,8 @@ namespace rxtd::audio_analyzer::handler {
 					&& lhs.updatesPerSecond == rhs.updatesPerSecond
 					&& lhs.timeWindowMs == rhs.timeWindowMs
 					&& lhs.gatingDb == rhs.gatingDb
-					&& lhs.ignoreGatingForSilence == rhs.ignoreGatingForSilence;
+					&& lhs.ignoreGatingForSilence == rhs.ignoreGatingForSilence
+					&& lhs.kWeighting == rhs.kWeighting;
 			}
 
 			friend bool operator!=(const Params& lhs, const Params& rhs) {
@@ -40,9 +46,14 @@ namespace rxtd::audio_analyzer::handler {
 		index blockCounter{};
 
 		double blockIntermediate{};
+		// ring buffer of mean energies of blocks in the time window, in the order they came
 		std::vector<double> blocks;
 		index nextBlockIndex{};
-		std::vector<double> tempBlocks;
+		// same values as in blocks, for gating without sorting
+		LoudnessHistogram histogram;
+
+		std::array<BiQuadIIR, 2> kWeightingFilters;
+		std::vector<float> filteredWave;
 
 		double prevValue{};
 		double gatingValueCoefficient{};
@@ -42,7 +42,7 @@ ParamsContainer WaveForm::vParseParams(ParamParseContext& context) const noexcep
 	}
 	params.resolution = 1.0 / updateRate;
 
-	params.folder = context.rain.getPathFromCurrent(options.get(L"folder").asString() % own());
+	params.folder = context.optionProvider.getPathFromCurrent(options.get(L"folder").asString() % own());
 
 	Color::Mode defaultColorSpace;
 	auto defaultColorSpaceOption = options.get(L"DefaultColorSpace").asIString(L"sRGB");
@@ -165,7 +165,7 @@ void WaveForm::updateSnapshot(Snapshot& snapshot) {
 
 	if (!(snapshot.empty && drawer.isEmpty())) {
 		drawer.inflate();
-		snapshot.pixels.copyWithResize(drawer.getResultBuffer());
+		snapshot.pixels.update(drawer.getResultBuffer(), drawer.getVersion());
 		snapshot.empty = drawer.isEmpty();
 	}
 }
@@ -178,7 +178,7 @@ void WaveForm::staticFinisher(const Snapshot& snapshot, const ExternalMethods::C
 
 	context.printer.print(L"{}{}.bmp", snapshot.folder, context.filePrefix);
 
-	snapshot.writerHelper.write(snapshot.pixels, snapshot.empty, context.printer.getBufferView());
+	snapshot.writerHelper->write(snapshot.pixels, snapshot.empty, context.printer.getBufferView());
 	writeNeeded = false;
 }
 
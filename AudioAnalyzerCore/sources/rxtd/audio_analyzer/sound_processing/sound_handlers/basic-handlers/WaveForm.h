@@ -5,6 +5,7 @@
 #include "rxtd/audio_analyzer/audio_utils/CustomizableValueTransformer.h"
 #include "rxtd/audio_analyzer/audio_utils/MinMaxCounter.h"
 #include "rxtd/audio_analyzer/image_utils/ImageWriteHelper.h"
+#include "rxtd/audio_analyzer/image_utils/StripedImageCopy.h"
 #include "rxtd/audio_analyzer/image_utils/WaveFormDrawer.h"
 #include "rxtd/audio_analyzer/sound_processing/sound_handlers/HandlerBase.h"
 
@@ -56,12 +57,13 @@ namespace rxtd::audio_analyzer::handler {
 
 		struct Snapshot {
 			string folder;
-			Vector2D<IntColor> pixels;
+			image_utils::StripedImageCopy pixels;
 			index blockSize{};
 			uint32_t id;
 			bool empty{};
 
-			mutable ImageWriteHelper writerHelper{};
+			// shared between all copies of the snapshot, so that each copy knows what is already in the file
+			std::shared_ptr<ImageWriteHelper> writerHelper = std::make_shared<ImageWriteHelper>();
 			mutable bool writeNeeded{};
 		};
 
@@ -58,6 +58,15 @@ BandCascadeTransformer::vConfigure(const ParamsContainer& _params, Logger& cl, E
 
 	snapshot.clear();
 	snapshot.resize(static_cast<size_t>(dataSize.layersCount));
+	cascadesData.resize(static_cast<size_t>(dataSize.layersCount));
+
+	Vector2D<float> layerWeights;
+	layerWeights.setBuffersCount(dataSize.layersCount);
+	layerWeights.setBufferSize(dataSize.valuesCount);
+	for (index i = 0; i < dataSize.layersCount; i++) {
+		layerWeights[i].copyFrom(resamplerPtr->getLayerWeights(i));
+	}
+	mixer.setParams({ params.minWeight, params.targetWeight, params.mixFunction }, layerWeights);
 
 	return { dataSize.valuesCount, { config.sourcePtr->getDataSize().eqWaveSizes[0] } };
 }
@@ -70,7 +79,7 @@ void BandCascadeTransformer::vProcess(ProcessContext context, ExternalData& exte
 	for (index i = 0; i < layersCount; i++) {
 		auto& meta = snapshot[static_cast<size_t>(i)];
 		meta.nextChunkIndex = 0;
-		meta.data = source.getSavedData(i);
+		cascadesData[static_cast<size_t>(i)] = source.getSavedData(i);
 	}
 
 	auto& eqWS = source.getDataSize().eqWaveSizes;
@@ -94,73 +103,11 @@ void BandCascadeTransformer::vProcess(ProcessContext context, ExternalData& exte
 				continue;
 			}
 
-			meta.data = layerChunks[meta.nextChunkIndex];
+			cascadesData[static_cast<size_t>(i)] = layerChunks[meta.nextChunkIndex];
 			meta.nextChunkIndex++;
 			meta.offset += eqWS[static_cast<size_t>(i)];
-			meta.maxValue = *std::max_element(meta.data.begin(), meta.data.end());
-		}
-
-		for (index band = 0; band < dest.size(); ++band) {
-			dest[band] = computeForBand(band);
-		}
-	}
-}
-
-float BandCascadeTransformer::computeForBand(index band) const {
-	const BandResampler& resampler = *resamplerPtr;
-
-	float weight = 0.0f;
-	float cascadesSummed = 0.0f;
-
-	double valueProduct = 1.0;
-	float valueSum = 0.0f;
-
-	const auto bandWeights = resampler.getBandWeights(band);
-
-	for (index cascade = 0; cascade < static_cast<index>(snapshot.size()); cascade++) {
-		const float bandWeight = bandWeights[cascade];
-		const float magnitude = snapshot[static_cast<size_t>(cascade)].data[band];
-
-		if (snapshot[static_cast<size_t>(cascade)].maxValue == 0.0f) {
-			// this most often happens when there was a silence, and then some sound,
-			// so cascade with index more than N haven't updated yet
-			// so in that case we ignore values of all these cascades
-
-			if (cascade == 0) {
-				return 0.0f;
-			}
-
-			// if cascade is not zero and yet cascadesSummed == 0.0f
-			// then bandWeight < params.minWeight for all previous cascades
-			// let's use value of previous cascade to provide at least something
-			if (cascadesSummed == 0.0f) {
-				return snapshot[static_cast<size_t>(cascade - 1)].data[band];
-			}
-			break;
-		}
-
-		if (bandWeight <= params.minWeight) {
-			continue;
 		}
 
-		cascadesSummed += 1.0f;
-
-		valueProduct *= static_cast<double>(magnitude);
-		valueSum += magnitude;
-		weight += bandWeight;
-
-		if (weight >= params.targetWeight) {
-			break;
-		}
+		mixer.mix(cascadesData, dest);
 	}
-
-	if (cascadesSummed == 0.0f) {
-		// bandWeight < params.minWeight for all cascades
-		// let's use value of the last cascade
-		return snapshot.back().data[band];
-	}
-
-	return params.mixFunction == MixFunction::ePRODUCT
-	       ? static_cast<float>(std::pow(valueProduct, 1.0f / cascadesSummed))
-	       : valueSum / cascadesSummed;
 }
@@ -4,13 +4,12 @@
 #pragma once
 #include "BandResampler.h"
 #include "rxtd/audio_analyzer/sound_processing/sound_handlers/HandlerBase.h"
+#include "rxtd/fft_utils/CascadeMixer.h"
 
 namespace rxtd::audio_analyzer::handler {
 	class BandCascadeTransformer : public HandlerBase {
-		enum class MixFunction {
-			eAVERAGE,
-			ePRODUCT,
-		};
+		using CascadeMixer = fft_utils::CascadeMixer;
+		using MixFunction = CascadeMixer::MixFunction;
 
 		struct Params {
 			float minWeight{};
@@ -36,11 +35,12 @@ namespace rxtd::audio_analyzer::handler {
 		struct CascadeMeta {
 			index offset{};
 			index nextChunkIndex{};
-			array_view<float> data;
-			float maxValue{};
 		};
 
 		std::vector<CascadeMeta> snapshot;
+		// current values of each cascade
+		std::vector<array_view<float>> cascadesData;
+		CascadeMixer mixer;
 
 	public:
 		[[nodiscard]]
@@ -62,9 +62,5 @@ namespace rxtd::audio_analyzer::handler {
 
 	public:
 		void vProcess(ProcessContext context, ExternalData& externalData) override;
-
-	private:
-		[[nodiscard]]
-		float computeForBand(index band) const;
 	};
 }
@@ -149,13 +149,9 @@ BandResampler::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalDa
 }
 
 void BandResampler::vProcess(ProcessContext context, ExternalData& externalData) {
-	auto& config = getConfiguration();
-
 	auto& source = *fftSource;
 	const index layersCount = source.getDataSize().layersCount;
 
-	float binWidth = static_cast<float>(config.sampleRate) / static_cast<float>(source.getFftSize());
-
 	for (index cascadeIndex = 0; cascadeIndex < layersCount; ++cascadeIndex) {
 		for (auto chunk : source.getChunks(cascadeIndex)) {
 			auto dest = pushLayer(cascadeIndex);
@@ -167,49 +163,25 @@ void BandResampler::vProcess(ProcessContext context, ExternalData& externalData)
 				continue;
 			}
 
-			sampleCascade(chunk, dest, binWidth);
+			sampleCascade(chunk, dest, cascadeMatrices[static_cast<size_t>(cascadeIndex)]);
 		}
-
-		binWidth *= 0.5f;
 	}
 }
 
-void BandResampler::sampleCascade(array_view<float> source, array_span<float> dest, float binWidth) {
-	const index fftBinsCount = source.size();
-
-	LinearInterpolator<float> lowerBinBoundInter;
-	lowerBinBoundInter.setParams(
-		-binWidth * 0.5f,
-		(static_cast<float>(fftBinsCount) - 0.5f) * binWidth,
-		0.0f,
-		static_cast<float>(fftBinsCount - 1)
-	);
-
-	audio_utils::CubicInterpolationHelper cih;
-	cih.setSource(source);
+void BandResampler::sampleCascade(array_view<float> source, array_span<float> dest, const CascadeMatrix& matrix) {
+	matrix.values.multiply(source, dest);
 
-	for (index band = 0; band < bandsCount; band++) {
-		const float bandMinFreq = params.bandFreqs[static_cast<size_t>(band)];
-		const float bandMaxFreq = params.bandFreqs[static_cast<size_t>(band + 1)];
+	if (matrix.derivatives.getNonZeroCount() == 0) {
+		return;
+	}
 
-		if (params.useCubicResampling && bandMaxFreq - bandMinFreq < binWidth) {
-			const float interpolatedCoordinate = lowerBinBoundInter.toValue((bandMinFreq + bandMaxFreq) * 0.5f);
-			const float value = cih.getValueFor(interpolatedCoordinate);
-			dest[band] = std::max(value, 0.0f);
-		} else {
-			const index minBin = static_cast<index>(std::floor(lowerBinBoundInter.toValue(bandMinFreq)));
-			if (minBin >= fftBinsCount) {
-				break;
-			}
-			const index maxBin = std::min(static_cast<index>(std::floor(lowerBinBoundInter.toValue(bandMaxFreq))), fftBinsCount - 1);
+	const array_span<float> derivatives{ derivativesBuffer.data(), source.size() };
+	audio_utils::CubicInterpolationHelper::calcDerivatives(source, derivatives);
+	matrix.derivatives.multiplyAdd(derivatives, dest);
 
-			float value = 0.0f;
-			for (index bin = minBin; bin <= maxBin; ++bin) {
-				value += source[bin];
-			}
-			const float binsCount = (1.0f + static_cast<float>(maxBin) - static_cast<float>(minBin));
-			dest[band] = value / binsCount;
-		}
+	// cubic interpolation can overshoot below zero
+	for (auto& value : dest) {
+		value = std::max(value, 0.0f);
 	}
 }
 
@@ -218,8 +190,12 @@ void BandResampler::computeWeights(index fftSize) {
 	const index fftBinsCount = fftSize / 2;
 	float binWidth = static_cast<float>(config.sampleRate) / static_cast<float>(fftSize);
 
+	cascadeMatrices.resize(static_cast<size_t>(layerWeights.getBuffersCount()));
+	derivativesBuffer.resize(static_cast<size_t>(fftBinsCount));
+
 	for (index i = 0; i < layerWeights.getBuffersCount(); ++i) {
 		computeCascadeWeights(layerWeights[i], fftBinsCount, binWidth);
+		computeCascadeMatrix(cascadeMatrices[static_cast<size_t>(i)], fftBinsCount, binWidth);
 		binWidth *= 0.5f;
 	}
 }
@@ -250,6 +226,62 @@ void BandResampler::computeCascadeWeights(array_span<float> result, index fftBin
 	}
 }
 
+void BandResampler::computeCascadeMatrix(CascadeMatrix& result, index fftBinsCount, float binWidth) const {
+	result.values.clear();
+	result.derivatives.clear();
+
+	const LinearInterpolator<float> lowerBinBoundInter{
+		-binWidth * 0.5f,
+		(static_cast<float>(fftBinsCount) - 0.5f) * binWidth,
+		0.0f,
+		static_cast<float>(fftBinsCount - 1)
+	};
+
+	for (index band = 0; band < bandsCount; band++) {
+		const float bandMinFreq = params.bandFreqs[static_cast<size_t>(band)];
+		const float bandMaxFreq = params.bandFreqs[static_cast<size_t>(band + 1)];
+
+		if (params.useCubicResampling && bandMaxFreq - bandMinFreq < binWidth) {
+			const float interpolatedCoordinate = lowerBinBoundInter.toValue((bandMinFreq + bandMaxFreq) * 0.5f);
+			const double floor = std::floor(interpolatedCoordinate);
+			const index x1 = std::lround(floor);
+
+			if (floor < 0.0) {
+				result.values.addRow(0, 1)[0] = 1.0f;
+				result.derivatives.addRow(0, 0);
+			} else if (x1 + 1 >= fftBinsCount) {
+				result.values.addRow(fftBinsCount - 1, 1)[0] = 1.0f;
+				result.derivatives.addRow(0, 0);
+			} else {
+				const auto weights = audio_utils::CubicInterpolationHelper::calcWeights(static_cast<double>(interpolatedCoordinate) - floor);
+
+				auto values = result.values.addRow(x1, 2);
+				values[0] = weights.value1;
+				values[1] = weights.value2;
+
+				auto derivatives = result.derivatives.addRow(x1, 2);
+				derivatives[0] = weights.derivative1;
+				derivatives[1] = weights.derivative2;
+			}
+			continue;
+		}
+
+		result.derivatives.addRow(0, 0);
+
+		const index minBin = static_cast<index>(std::floor(lowerBinBoundInter.toValue(bandMinFreq)));
+		if (minBin >= fftBinsCount) {
+			// band is above the highest frequency of the cascade
+			result.values.addRow(0, 0);
+			continue;
+		}
+		const index maxBin = std::min(static_cast<index>(std::floor(lowerBinBoundInter.toValue(bandMaxFreq))), fftBinsCount - 1);
+
+		const index binsCount = maxBin - minBin + 1;
+		auto values = result.values.addRow(minBin, binsCount);
+		std::fill(values.begin(), values.end(), 1.0f / static_cast<float>(binsCount));
+	}
+}
+
 bool BandResampler::getProp(
 	const Snapshot& snapshot,
 	isview prop,
@@ -3,6 +3,7 @@
 
 #pragma once
 #include "FftAnalyzer.h"
+#include "rxtd/audio_analyzer/audio_utils/SparseMatrix.h"
 #include "rxtd/audio_analyzer/sound_processing/sound_handlers/HandlerBase.h"
 #include "rxtd/std_fixes/Vector2D.h"
 
@@ -31,6 +32,16 @@ namespace rxtd::audio_analyzer::handler {
 		Vector2D<float> bandWeights;
 		index bandsCount = 0;
 
+		// maps fft bins of one cascade to bands
+		struct CascadeMatrix {
+			audio_utils::SparseMatrix values;
+			// only rows of bands with cubic interpolation are not empty
+			audio_utils::SparseMatrix derivatives;
+		};
+
+		std::vector<CascadeMatrix> cascadeMatrices;
+		std::vector<float> derivativesBuffer;
+
 		struct Snapshot {
 			std::vector<float> bandFreqs;
 		};
@@ -75,11 +86,12 @@ namespace rxtd::audio_analyzer::handler {
 		}
 
 	private:
-		void sampleCascade(array_view<float> source, array_span<float> dest, float binWidth);
+		void sampleCascade(array_view<float> source, array_span<float> dest, const CascadeMatrix& matrix);
 
 		// depends on fft size and sample rate
 		void computeWeights(index fftSize);
 		void computeCascadeWeights(array_span<float> result, index fftBinsCount, float binWidth);
+		void computeCascadeMatrix(CascadeMatrix& result, index fftBinsCount, float binWidth) const;
 
 		static bool getProp(
 			const Snapshot& snapshot,
@@ -5,7 +5,9 @@
 
 #include "FftAnalyzer.h"
 
+#include "rxtd/fft_utils/FftPlanCache.h"
 #include "rxtd/fft_utils/FftSizeHelper.h"
+#include "rxtd/fft_utils/FftSizeTuner.h"
 
 using rxtd::audio_analyzer::handler::FftAnalyzer;
 using rxtd::audio_analyzer::handler::HandlerBase;
@@ -27,6 +29,13 @@ ParamsContainer FftAnalyzer::vParseParams(ParamParseContext& context) const noex
 	overlapBoost = std::max(overlapBoost, 1.0);
 	params.overlap = (overlapBoost - 1.0) / overlapBoost;
 
+	params.autotune = context.parser.parse(context.options, L"autotune").valueOr(false);
+	if (params.autotune) {
+		params.autotuneTolerance = context.parser.parse(context.options, L"autotuneTolerance").valueOr(0.1);
+		params.autotuneTolerance = std::clamp(params.autotuneTolerance, 0.0, 0.5);
+		params.autotuneFolder = context.optionProvider.getPathFromCurrent(context.options.get(L"autotuneFolder").asString() % own());
+	}
+
 	params.cascadesCount = context.parser.parse(context.options, L"cascadesCount").valueOr(5);
 	if (params.cascadesCount <= 0) {
 		context.log.warning(L"cascadesCount must be in range [1, 20] but {} found. Assume 1", params.cascadesCount);
@@ -36,6 +45,24 @@ ParamsContainer FftAnalyzer::vParseParams(ParamParseContext& context) const noex
 		params.cascadesCount = 20;
 	}
 
+	const auto downsamplingStr = context.options.get(L"downsampling").asIString(L"IIR");
+	if (auto downsamplingOpt = parseEnum<filter_utils::DownsampleHelper::Method>(downsamplingStr);
+		downsamplingOpt.has_value()) {
+		params.downsampling = downsamplingOpt.value();
+	} else {
+		context.log.error(L"downsampling: unknown value: {}", downsamplingStr);
+		throw InvalidOptionsException{};
+	}
+
+	const auto outputStr = context.options.get(L"output").asIString(L"Magnitude");
+	if (auto outputOpt = parseEnum<fft_utils::RealFft::Output>(outputStr);
+		outputOpt.has_value()) {
+		params.output = outputOpt.value();
+	} else {
+		context.log.error(L"output: unknown value: {}", outputStr);
+		throw InvalidOptionsException{};
+	}
+
 	params.randomTest = std::abs(context.parser.parse(context.options, L"testRandom").valueOr(0.0));
 	params.randomDuration = std::abs(context.parser.parse(context.options, L"randomDuration").valueOr(1000.0)) * 0.001;
 
@@ -56,10 +83,37 @@ FftAnalyzer::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData
 
 	fftSize = fft_utils::FftSizeHelper::findNextAllowedLength(std::max(requestedFftSize, minFftSize), true);
 
+	if (params.autotune) {
+		// bin width within tolerance in both directions, but the default size is always a candidate
+		const double sampleRate = static_cast<double>(config.sampleRate);
+		index minSize = static_cast<index>(sampleRate / (params.binWidth * (1.0 + params.autotuneTolerance)));
+		index maxSize = static_cast<index>(sampleRate / (params.binWidth * (1.0 - params.autotuneTolerance)));
+		minSize = std::clamp(minSize, minFftSize, fftSize);
+		maxSize = std::max(maxSize, fftSize);
+
+		const string cacheFileName = params.autotuneFolder + L"FftSizeTuning.tsv";
+		const std::filesystem::path cacheFile{ std::wstring_view{ cacheFileName } };
+
+		if (fft_utils::FftSizeTuner::takeSaveError(cacheFile)) {
+			cl.warning(L"autotune: can't write file {}, sizes will be measured again after restart", cacheFileName);
+		}
+
+		// measurements take several milliseconds per size, so they are never done here:
+		// until the tuner finishes them in the background, default size is used,
+		// and the fastest size is used after the next reload
+		if (const auto cached = fft_utils::FftSizeTuner::findCachedFastestSize(cacheFile, minSize, maxSize, fftSize, true);
+			cached.has_value()) {
+			fftSize = cached.value();
+		} else {
+			fft_utils::FftSizeTuner::requestTuning(cacheFile, minSize, maxSize, true);
+		}
+	}
+
 	std::vector<float> window;
 	window.resize(static_cast<size_t>(fftSize));
 	params.createWindow(window);
 	fft.setParams(fftSize, std::move(window));
+	fft.setOutput(params.output);
 
 	inputStride = static_cast<index>(static_cast<double>(fftSize) * (1.0 - params.overlap));
 	inputStride = std::clamp<index>(inputStride, minFftSize, fftSize);
@@ -73,6 +127,7 @@ FftAnalyzer::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData
 	cascadeParams.fftSize = fftSize;
 	cascadeParams.samplesPerSec = config.sampleRate;
 	cascadeParams.inputStride = inputStride;
+	cascadeParams.downsampling = params.downsampling;
 	cascadeParams.callback = [this](array_view<float> result, index cascade) {
 		pushLayer(cascade).copyFrom(result);
 	};
@@ -112,6 +167,30 @@ bool FftAnalyzer::getProp(
 	isview prop,
 	const ExternalMethods::CallContext& context
 ) {
+	if (prop == L"fftSize") {
+		context.printer.print(snapshot.fftSize);
+		return true;
+	}
+
+	// plans are shared by all FftAnalyzer handlers in the process,
+	// and stats are collected under the lock of the cache, so only when they are requested
+	if (prop == L"planCacheHits") {
+		context.printer.print(fft_utils::FftPlanCache::getStats().hits);
+		return true;
+	}
+	if (prop == L"planCacheMisses") {
+		context.printer.print(fft_utils::FftPlanCache::getStats().misses);
+		return true;
+	}
+	if (prop == L"planCacheSize") {
+		context.printer.print(fft_utils::FftPlanCache::getStats().plansCount);
+		return true;
+	}
+	if (prop == L"planCacheMemory") {
+		context.printer.print(fft_utils::FftPlanCache::getStats().memorySize);
+		return true;
+	}
+
 	return false;
 }
 
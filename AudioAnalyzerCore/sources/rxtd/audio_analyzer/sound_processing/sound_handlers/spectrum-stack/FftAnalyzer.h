@@ -18,7 +18,13 @@ namespace rxtd::audio_analyzer::handler {
 			double binWidth{};
 			double overlap{};
 
+			bool autotune{};
+			double autotuneTolerance{};
+			string autotuneFolder{};
+
 			index cascadesCount{};
+			filter_utils::DownsampleHelper::Method downsampling{};
+			fft_utils::RealFft::Output output{};
 
 			double randomTest{};
 			double randomDuration{};
@@ -30,7 +36,12 @@ namespace rxtd::audio_analyzer::handler {
 			friend bool operator==(const Params& lhs, const Params& rhs) {
 				return lhs.binWidth == rhs.binWidth
 					&& lhs.overlap == rhs.overlap
+					&& lhs.autotune == rhs.autotune
+					&& lhs.autotuneTolerance == rhs.autotuneTolerance
+					&& lhs.autotuneFolder == rhs.autotuneFolder
 					&& lhs.cascadesCount == rhs.cascadesCount
+					&& lhs.downsampling == rhs.downsampling
+					&& lhs.output == rhs.output
 					&& lhs.randomTest == rhs.randomTest
 					&& lhs.randomDuration == rhs.randomDuration
 					&& lhs.wcfDescription == rhs.wcfDescription;
@@ -32,7 +32,7 @@ ParamsContainer Spectrogram::vParseParams(ParamParseContext& context) const noex
 	}
 	params.resolution = 1.0 / updateRate;
 
-	params.folder = context.rain.getPathFromCurrent(context.options.get(L"folder").asString() % own());
+	params.folder = context.optionProvider.getPathFromCurrent(context.options.get(L"folder").asString() % own());
 
 	Color::Mode defaultColorSpace;
 	auto defaultColorSpaceStr = context.options.get(L"DefaultColorSpace").asIString(L"sRGB");
@@ -131,7 +131,7 @@ Spectrogram::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData
 }
 
 std::pair<std::vector<Spectrogram::ColorDescription>, std::vector<float>>
-Spectrogram::parseColors(const OptionList& list, Color::Mode defaultColorSpace, option_parsing::OptionParser& parser, Logger& cl) {
+Spectrogram::parseColors(const OptionList& list, Color::Mode defaultColorSpace, option_parsing::OptionParser& parser, const Logger& cl) {
 	std::vector<ColorDescription> resultColors;
 	std::vector<float> levels;
 
@@ -223,7 +223,14 @@ void Spectrogram::updateSnapshot(Snapshot& snapshot) {
 			}
 		}
 
-		snapshot.pixels.copyWithResize(params.fading != 0.0 ? fadeHelper.getResultBuffer() : image.getPixels());
+		auto version = image.getVersion();
+		version.extraColumns = params.borderSize;
+		if (params.fading != 0.0) {
+			version.markFullChange();
+		}
+
+		// only new strips are copied, unless something changed all pixels
+		snapshot.pixels.update(params.fading != 0.0 ? fadeHelper.getResultBuffer() : image.getPixels(), version);
 		snapshot.empty = image.isEmpty();
 	}
 }
@@ -235,7 +242,7 @@ void Spectrogram::staticFinisher(const Snapshot& snapshot, const ExternalMethods
 
 	context.printer.print(L"{}{}.bmp", snapshot.folder, context.filePrefix);
 
-	snapshot.writerHelper.write(snapshot.pixels, snapshot.empty, context.printer.getBufferView());
+	snapshot.writerHelper->write(snapshot.pixels, snapshot.empty, context.printer.getBufferView());
 	snapshot.writeNeeded = false;
 }
 
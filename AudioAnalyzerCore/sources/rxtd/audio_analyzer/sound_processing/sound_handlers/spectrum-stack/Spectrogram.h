@@ -6,6 +6,7 @@
 #include "rxtd/audio_analyzer/image_utils/Color.h"
 #include "rxtd/audio_analyzer/image_utils/ImageWriteHelper.h"
 #include "rxtd/audio_analyzer/image_utils/StripedImage.h"
+#include "rxtd/audio_analyzer/image_utils/StripedImageCopy.h"
 #include "rxtd/audio_analyzer/image_utils/StripedImageFadeHelper.h"
 #include "rxtd/audio_analyzer/sound_processing/sound_handlers/HandlerBase.h"
 
@@ -69,12 +70,13 @@ namespace rxtd::audio_analyzer::handler {
 
 		struct Snapshot {
 			string folder;
-			Vector2D<IntColor> pixels;
+			image_utils::StripedImageCopy pixels;
 			index blockSize{};
 			uint32_t id = 0;
 			bool empty{};
 
-			mutable ImageWriteHelper writerHelper{};
+			// shared between all copies of the snapshot, so that each copy knows what is already in the file
+			std::shared_ptr<ImageWriteHelper> writerHelper = std::make_shared<ImageWriteHelper>();
 			mutable bool writeNeeded{};
 		};
 
@@ -139,7 +141,7 @@ namespace rxtd::audio_analyzer::handler {
 
 	private:
 		static std::pair<std::vector<ColorDescription>, std::vector<float>>
-		parseColors(const OptionList& list, Color::Mode defaultColorSpace, option_parsing::OptionParser& parser, Logger& cl);
+		parseColors(const OptionList& list, Color::Mode defaultColorSpace, option_parsing::OptionParser& parser, const Logger& cl);
 
 	public:
 		void vProcess(ProcessContext context, ExternalData& externalData) override;
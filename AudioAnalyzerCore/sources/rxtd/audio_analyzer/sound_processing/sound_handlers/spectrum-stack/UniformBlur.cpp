@@ -2,7 +2,6 @@
 // Copyright (C) 2019 Danil Uzlov
 
 #include "UniformBlur.h"
-#include "rxtd/audio_analyzer/audio_utils/GaussianCoefficientsManager.h"
 
 using rxtd::audio_analyzer::handler::UniformBlur;
 using rxtd::audio_analyzer::handler::HandlerBase;
@@ -17,12 +16,20 @@ ParamsContainer UniformBlur::vParseParams(ParamParseContext& context) const {
 		throw InvalidOptionsException{};
 	}
 
-	params.blurCoefficients = audio_utils::GaussianCoefficientsManager::createGaussianKernel(params.blurRadius);
-	if (params.blurCoefficients.size() < 3) {
+	if (GaussianBlur::createKernel(params.blurRadius).size() < 3) {
 		context.log.error(L"radius: value is too small, remove this handler is you don't need blur");
 		throw InvalidOptionsException{};
 	}
 
+	const auto methodStr = context.options.get(L"method").asIString(L"Auto");
+	if (auto methodOpt = parseEnum<GaussianBlur::Method>(methodStr);
+		methodOpt.has_value()) {
+		params.method = methodOpt.value();
+	} else {
+		context.log.error(L"method: unknown value: {}", methodStr);
+		throw InvalidOptionsException{};
+	}
+
 	return params;
 }
 
@@ -30,6 +37,8 @@ HandlerBase::ConfigurationResult
 UniformBlur::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData& externalData) {
 	params = _params.cast<Params>();
 
+	blur.setParams(params.blurRadius, params.method);
+
 	auto& config = getConfiguration();
 
 	const auto dataSize = config.sourcePtr->getDataSize();
@@ -37,32 +46,5 @@ UniformBlur::vConfigure(const ParamsContainer& _params, Logger& cl, ExternalData
 }
 
 void UniformBlur::vProcessLayer(array_view<float> chunk, array_span<float> dest, ExternalData& handlerSpecificData) {
-	auto kernel = array_view<float>{ params.blurCoefficients };
-
-	auto radius = kernel.size() / 2;
-
-	const auto bandsCount = chunk.size();
-	for (index i = 0; i < bandsCount; ++i) {
-
-		index bandStartIndex = i - radius;
-		index kernelStartIndex = 0;
-
-		if (bandStartIndex < 0) {
-			kernelStartIndex = -bandStartIndex;
-			bandStartIndex = 0;
-		}
-
-		float result = 0.0f;
-		index kernelIndex = kernelStartIndex;
-		index bandIndex = bandStartIndex;
-
-		while (bandIndex < bandsCount && kernelIndex < kernel.size()) {
-			result += kernel[kernelIndex] * chunk[bandIndex];
-
-			kernelIndex++;
-			bandIndex++;
-		}
-
-		dest[i] = result;
-	}
+	blur.apply(chunk, dest);
 }
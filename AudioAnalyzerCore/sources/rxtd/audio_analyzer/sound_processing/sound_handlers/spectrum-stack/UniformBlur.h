@@ -3,15 +3,19 @@
 
 #pragma once
 #include "rxtd/audio_analyzer/sound_processing/sound_handlers/HandlerBase.h"
+#include "rxtd/filter_utils/GaussianBlur.h"
 
 namespace rxtd::audio_analyzer::handler {
 	class UniformBlur : public HandlerBase {
+		using GaussianBlur = filter_utils::GaussianBlur;
+
 		struct Params {
 			float blurRadius{};
-			std::vector<float> blurCoefficients;
+			GaussianBlur::Method method{};
 
 			friend bool operator==(const Params& lhs, const Params& rhs) {
-				return lhs.blurRadius == rhs.blurRadius;
+				return lhs.blurRadius == rhs.blurRadius
+					&& lhs.method == rhs.method;
 			}
 
 			friend bool operator!=(const Params& lhs, const Params& rhs) {
@@ -20,6 +24,7 @@ namespace rxtd::audio_analyzer::handler {
 		};
 
 		Params params{};
+		GaussianBlur blur;
 
 	public:
 		[[nodiscard]]
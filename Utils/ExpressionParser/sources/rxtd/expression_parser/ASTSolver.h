@@ -37,7 +37,7 @@ namespace rxtd::expression_parser {
 		/// </summary>
 		class ValueProvider {
 		public:
-			using NodeData = NodeData;
+			using NodeData = GrammarDescription::NodeData;
 
 			class Exception : public ASTSolver::Exception {
 				sview cause;
@@ -0,0 +1,262 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "CascadeMixer.h"
+
+#include <cstring>
+
+#include "rxtd/std_fixes/CpuFeatures.h"
+
+using rxtd::fft_utils::CascadeMixer;
+
+namespace {
+	using rxtd::index;
+
+	struct ProductAccumulators {
+		float* counts;
+		float* zeros;
+		float* exponents;
+		float* mantissas;
+	};
+
+	float findMax(const float* values, index begin, index end) {
+		float result = 0.0f;
+		for (index i = begin; i < end; i++) {
+			result = std::max(result, values[i]);
+		}
+		return result;
+	}
+
+	float accumulateAverageScalar(const float* values, const float* mask, float* counts, float* sums, index begin, index end) {
+		float maxValue = 0.0f;
+		for (index band = begin; band < end; band++) {
+			const float value = values[band];
+			counts[band] += mask[band];
+			sums[band] += mask[band] * value;
+			maxValue = std::max(maxValue, value);
+		}
+		return maxValue;
+	}
+
+	float accumulateProductScalar(const float* values, const float* mask, ProductAccumulators acc, index begin, index end) {
+		float maxValue = 0.0f;
+		for (index band = begin; band < end; band++) {
+			const float value = values[band];
+			const float m = mask[band];
+
+			// value == mantissa * 2^exponent, where mantissa is in [1, 2)
+			// zeros and denormals are counted separately
+			uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			const uint32_t exponentBits = (bits >> 23) & 0xFF;
+			const uint32_t mantissaBits = (bits & 0x7FFFFF) | 0x3F800000;
+			float mantissa;
+			std::memcpy(&mantissa, &mantissaBits, sizeof(mantissa));
+			const bool isZero = exponentBits == 0;
+
+			acc.counts[band] += m;
+			acc.zeros[band] += isZero ? m : 0.0f;
+			acc.exponents[band] += isZero ? 0.0f : m * static_cast<float>(static_cast<int32_t>(exponentBits) - 127);
+			acc.mantissas[band] *= isZero ? 1.0f : 1.0f + m * (mantissa - 1.0f);
+
+			maxValue = std::max(maxValue, value);
+		}
+		return maxValue;
+	}
+
+#ifdef RXTD_X86
+	float horizontalMax(__m128 value) {
+		value = _mm_max_ps(value, _mm_movehl_ps(value, value));
+		value = _mm_max_ss(value, _mm_shuffle_ps(value, value, 1));
+		return _mm_cvtss_f32(value);
+	}
+
+	float accumulateAverageSse(const float* values, const float* mask, float* counts, float* sums, index begin, index end) {
+		__m128 maxValue = _mm_setzero_ps();
+		index band = begin;
+		for (; band + 4 <= end; band += 4) {
+			const __m128 value = _mm_loadu_ps(values + band);
+			const __m128 m = _mm_loadu_ps(mask + band);
+			_mm_storeu_ps(counts + band, _mm_add_ps(_mm_loadu_ps(counts + band), m));
+			_mm_storeu_ps(sums + band, _mm_add_ps(_mm_loadu_ps(sums + band), _mm_mul_ps(m, value)));
+			maxValue = _mm_max_ps(maxValue, value);
+		}
+		return std::max(horizontalMax(maxValue), accumulateAverageScalar(values, mask, counts, sums, band, end));
+	}
+
+	float accumulateProductSse(const float* values, const float* mask, ProductAccumulators acc, index begin, index end) {
+		const __m128i exponentMask = _mm_set1_epi32(0xFF);
+		const __m128i exponentBias = _mm_set1_epi32(127);
+		const __m128i mantissaMask = _mm_set1_epi32(0x7FFFFF);
+		const __m128i one = _mm_castps_si128(_mm_set1_ps(1.0f));
+		const __m128 oneF = _mm_set1_ps(1.0f);
+
+		__m128 maxValue = _mm_setzero_ps();
+		index band = begin;
+		for (; band + 4 <= end; band += 4) {
+			const __m128 value = _mm_loadu_ps(values + band);
+			const __m128 m = _mm_loadu_ps(mask + band);
+
+			const __m128i bits = _mm_castps_si128(value);
+			const __m128i exponentBits = _mm_and_si128(_mm_srli_epi32(bits, 23), exponentMask);
+			const __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mantissaMask), one));
+			const __m128 isZero = _mm_castsi128_ps(_mm_cmpeq_epi32(exponentBits, _mm_setzero_si128()));
+			const __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(exponentBits, exponentBias));
+
+			_mm_storeu_ps(acc.counts + band, _mm_add_ps(_mm_loadu_ps(acc.counts + band), m));
+			_mm_storeu_ps(acc.zeros + band, _mm_add_ps(_mm_loadu_ps(acc.zeros + band), _mm_and_ps(isZero, m)));
+			_mm_storeu_ps(
+				acc.exponents + band,
+				_mm_add_ps(_mm_loadu_ps(acc.exponents + band), _mm_andnot_ps(isZero, _mm_mul_ps(m, exponent)))
+			);
+			const __m128 factor = _mm_add_ps(oneF, _mm_andnot_ps(isZero, _mm_mul_ps(m, _mm_sub_ps(mantissa, oneF))));
+			_mm_storeu_ps(acc.mantissas + band, _mm_mul_ps(_mm_loadu_ps(acc.mantissas + band), factor));
+
+			maxValue = _mm_max_ps(maxValue, value);
+		}
+		return std::max(horizontalMax(maxValue), accumulateProductScalar(values, mask, acc, band, end));
+	}
+#endif
+}
+
+void CascadeMixer::setParams(Params value, const std_fixes::Vector2D<float>& layerWeights) {
+	params = value;
+
+	const index cascadesCount = layerWeights.getBuffersCount();
+	bandsCount = layerWeights.getBufferSize();
+
+	masks.setBuffersCount(cascadesCount);
+	masks.setBufferSize(bandsCount);
+	masks.fill(0.0f);
+
+	for (index band = 0; band < bandsCount; band++) {
+		float weight = 0.0f;
+		for (index cascade = 0; cascade < cascadesCount; cascade++) {
+			const float bandWeight = layerWeights[cascade][band];
+			if (bandWeight <= params.minWeight) {
+				continue;
+			}
+
+			masks[cascade][band] = 1.0f;
+			weight += bandWeight;
+
+			if (weight >= params.targetWeight) {
+				break;
+			}
+		}
+	}
+
+	cascadeRanges.assign(static_cast<size_t>(cascadesCount), {});
+	for (index cascade = 0; cascade < cascadesCount; cascade++) {
+		const auto row = masks[cascade];
+		const auto first = std::find(row.begin(), row.end(), 1.0f);
+		if (first == row.end()) {
+			continue;
+		}
+		const auto last = std::find(row.rbegin(), row.rend(), 1.0f);
+		cascadeRanges[static_cast<size_t>(cascade)] = { first - row.begin(), row.rend() - last };
+	}
+
+	counts.resize(static_cast<size_t>(bandsCount));
+	sums.resize(static_cast<size_t>(bandsCount));
+	zeros.resize(static_cast<size_t>(bandsCount));
+	exponents.resize(static_cast<size_t>(bandsCount));
+	mantissas.resize(static_cast<size_t>(bandsCount));
+}
+
+void CascadeMixer::mix(array_view<array_view<float>> cascades, array_span<float> result) {
+	resetAccumulators();
+
+	index activeCount = 0;
+	for (index cascade = 0; cascade < getCascadesCount(); cascade++) {
+		const float maxValue = params.mixFunction == MixFunction::ePRODUCT
+		                       ? accumulateProduct(cascades[cascade], cascade)
+		                       : accumulateAverage(cascades[cascade], cascade);
+
+		if (maxValue == 0.0f) {
+			discardZeroCascade(cascade);
+			break;
+		}
+
+		activeCount++;
+	}
+
+	if (activeCount == 0) {
+		std::fill(result.begin(), result.end(), 0.0f);
+		return;
+	}
+
+	finish(cascades[activeCount - 1], result);
+}
+
+void CascadeMixer::resetAccumulators() {
+	std::fill(counts.begin(), counts.end(), 0.0f);
+	if (params.mixFunction == MixFunction::ePRODUCT) {
+		std::fill(zeros.begin(), zeros.end(), 0.0f);
+		std::fill(exponents.begin(), exponents.end(), 0.0f);
+		std::fill(mantissas.begin(), mantissas.end(), 1.0f);
+	} else {
+		std::fill(sums.begin(), sums.end(), 0.0f);
+	}
+}
+
+float CascadeMixer::accumulateAverage(array_view<float> values, index cascade) {
+	const auto [begin, end] = cascadeRanges[static_cast<size_t>(cascade)];
+	const float* mask = masks[cascade].data();
+
+#ifdef RXTD_X86
+	const float maxValue = accumulateAverageSse(values.data(), mask, counts.data(), sums.data(), begin, end);
+#else
+	const float maxValue = accumulateAverageScalar(values.data(), mask, counts.data(), sums.data(), begin, end);
+#endif
+
+	return std::max({ maxValue, findMax(values.data(), 0, begin), findMax(values.data(), end, bandsCount) });
+}
+
+float CascadeMixer::accumulateProduct(array_view<float> values, index cascade) {
+	const auto [begin, end] = cascadeRanges[static_cast<size_t>(cascade)];
+	const float* mask = masks[cascade].data();
+	const ProductAccumulators acc{ counts.data(), zeros.data(), exponents.data(), mantissas.data() };
+
+#ifdef RXTD_X86
+	const float maxValue = accumulateProductSse(values.data(), mask, acc, begin, end);
+#else
+	const float maxValue = accumulateProductScalar(values.data(), mask, acc, begin, end);
+#endif
+
+	return std::max({ maxValue, findMax(values.data(), 0, begin), findMax(values.data(), end, bandsCount) });
+}
+
+void CascadeMixer::discardZeroCascade(index cascade) {
+	// all values are zero, so only counters were changed
+	const auto [begin, end] = cascadeRanges[static_cast<size_t>(cascade)];
+	const float* mask = masks[cascade].data();
+	const bool isProduct = params.mixFunction == MixFunction::ePRODUCT;
+	for (index band = begin; band < end; band++) {
+		counts[static_cast<size_t>(band)] -= mask[band];
+		if (isProduct) {
+			zeros[static_cast<size_t>(band)] -= mask[band];
+		}
+	}
+}
+
+void CascadeMixer::finish(array_view<float> fallback, array_span<float> result) const {
+	if (params.mixFunction == MixFunction::ePRODUCT) {
+		for (index band = 0; band < bandsCount; band++) {
+			const float count = counts[static_cast<size_t>(band)];
+			if (count == 0.0f) {
+				result[band] = fallback[band];
+			} else if (zeros[static_cast<size_t>(band)] > 0.0f) {
+				result[band] = 0.0f;
+			} else {
+				const float log = std::log2(mantissas[static_cast<size_t>(band)]) + exponents[static_cast<size_t>(band)];
+				result[band] = std::exp2(log / count);
+			}
+		}
+	} else {
+		for (index band = 0; band < bandsCount; band++) {
+			const float count = counts[static_cast<size_t>(band)];
+			result[band] = count == 0.0f ? fallback[band] : sums[static_cast<size_t>(band)] / count;
+		}
+	}
+}
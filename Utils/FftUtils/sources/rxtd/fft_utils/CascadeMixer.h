@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "rxtd/std_fixes/Vector2D.h"
+
+namespace rxtd::fft_utils {
+	/// <summary>
+	/// Mixes band values of several fft cascades into one set of values.
+	///
+	/// Each band takes cascades in order, skipping cascades where the band covers no more than minWeight fft bins,
+	/// until the sum of bins of taken cascades reaches targetWeight.
+	/// Cascades starting from the first cascade with only zero values are ignored:
+	/// this happens after a silence, when bigger cascades haven't received new data yet.
+	/// Bands without any taken cascades use the value of the last cascade that is not ignored.
+	///
+	/// The set of taken cascades only depends on weights, so it is computed in setParams.
+	/// Mixing processes all bands of one cascade at a time.
+	/// Product is computed in log domain: exponents of values are summed and mantissas are multiplied,
+	/// so that the product of many small values doesn't underflow,
+	/// and the root only needs one log2 and one exp2 per band.
+	/// </summary>
+	class CascadeMixer {
+	public:
+		enum class MixFunction {
+			eAVERAGE,
+			ePRODUCT,
+		};
+
+		struct Params {
+			float minWeight{};
+			float targetWeight{};
+			MixFunction mixFunction{};
+		};
+
+	private:
+		struct BandRange {
+			index begin{};
+			index end{};
+		};
+
+		Params params{};
+		index bandsCount = 0;
+
+		// masks[cascade][band] is 1 if the cascade is taken for the band, 0 otherwise
+		std_fixes::Vector2D<float> masks;
+		// bands that take the cascade, all masks outside of the range are 0
+		std::vector<BandRange> cascadeRanges;
+
+		// accumulators, one value per band
+		std::vector<float> counts;
+		std::vector<float> sums;
+		std::vector<float> zeros;
+		std::vector<float> exponents;
+		std::vector<float> mantissas;
+
+	public:
+		/// <summary>
+		/// layerWeights[cascade][band] is count of fft bins of the cascade that fall into the band.
+		/// </summary>
+		void setParams(Params value, const std_fixes::Vector2D<float>& layerWeights);
+
+		[[nodiscard]]
+		index getCascadesCount() const {
+			return masks.getBuffersCount();
+		}
+
+		[[nodiscard]]
+		index getBandsCount() const {
+			return bandsCount;
+		}
+
+		/// <summary>
+		/// Cascades must have getCascadesCount() elements, each of getBandsCount() non-negative values.
+		/// </summary>
+		void mix(array_view<array_view<float>> cascades, array_span<float> result);
+
+	private:
+		void resetAccumulators();
+
+		// returns max value of the cascade
+		float accumulateAverage(array_view<float> values, index cascade);
+		float accumulateProduct(array_view<float> values, index cascade);
+
+		// removes counters of the cascade that turned out to contain only zeros
+		void discardZeroCascade(index cascade);
+
+		void finish(array_view<float> fallback, array_span<float> result) const;
+	};
+}
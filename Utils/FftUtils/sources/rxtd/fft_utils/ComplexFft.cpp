@@ -7,6 +7,7 @@
 #define PFFFT_ENABLE_DOUBLE
 #include <libs/pffft/pffft.hpp>
 
+#include "FftPlanCache.h"
 #include "FftSizeHelper.h"
 
 using rxtd::fft_utils::ComplexFft;
@@ -14,29 +15,28 @@ using rxtd::fft_utils::ComplexFft;
 template<typename Float>
 class ComplexFft<Float>::FftImplWrapper {
 public:
-	using scalar_type = scalar_type;
-	using complex_type = complex_type;
+	using scalar_type = typename ComplexFft<Float>::scalar_type;
+	using complex_type = typename ComplexFft<Float>::complex_type;
 
 private:
 	scalar_type scalar{};
 
-	pffft::Fft<complex_type> fft;
+	FftPlanCache::PlanPtr plan;
+	pffft::AlignedVector<complex_type> workBuffer;
 
 public:
 	pffft::AlignedVector<complex_type> inputBuffer;
 	pffft::AlignedVector<complex_type> outputBuffer;
 
 public:
-	FftImplWrapper();
-
 	void setParams(index size, bool reverse);
 	
 	void forward(array_view<complex_type> wave);
 	void inverse(array_view<complex_type> wave);
-};
 
-template<typename Float>
-ComplexFft<Float>::FftImplWrapper::FftImplWrapper() : fft(0) {}
+private:
+	void transformOrdered(pffft_direction_t direction);
+};
 
 template<typename Float>
 void ComplexFft<Float>::FftImplWrapper::setParams(index size, bool reverse) {
@@ -52,16 +52,18 @@ void ComplexFft<Float>::FftImplWrapper::setParams(index size, bool reverse) {
 		scalar /= static_cast<scalar_type>(size); // NOLINT(bugprone-integer-division)
 	}
 
-	fft.prepareLength(static_cast<int>(size));
+	constexpr auto precision = std::is_same<Float, float>::value ? FftPlanCache::Precision::eFLOAT : FftPlanCache::Precision::eDOUBLE;
+	plan = FftPlanCache::acquire(size, FftPlanCache::Kind::eCOMPLEX, precision);
 
-	inputBuffer = fft.valueVector();
-	outputBuffer = fft.spectrumVector();
+	inputBuffer.resize(static_cast<size_t>(size));
+	outputBuffer.resize(static_cast<size_t>(size));
+	workBuffer.resize(static_cast<size_t>(size));
 }
 
 template<typename Float>
 void ComplexFft<Float>::FftImplWrapper::forward(array_view<complex_type> input) {
 	std::copy(input.begin(), input.end(), inputBuffer.begin());
-	fft.forward(inputBuffer, outputBuffer);
+	transformOrdered(PFFFT_FORWARD);
 	for (auto& val : outputBuffer) {
 		val *= scalar;
 	}
@@ -70,7 +72,19 @@ void ComplexFft<Float>::FftImplWrapper::forward(array_view<complex_type> input)
 template<typename Float>
 void ComplexFft<Float>::FftImplWrapper::inverse(array_view<complex_type> input) {
 	std::copy(input.begin(), input.end(), inputBuffer.begin());
-	fft.inverse(inputBuffer, outputBuffer);
+	transformOrdered(PFFFT_BACKWARD);
+}
+
+template<typename Float>
+void ComplexFft<Float>::FftImplWrapper::transformOrdered(pffft_direction_t direction) {
+	const auto input = reinterpret_cast<const scalar_type*>(inputBuffer.data());
+	const auto output = reinterpret_cast<scalar_type*>(outputBuffer.data());
+	const auto work = reinterpret_cast<scalar_type*>(workBuffer.data());
+	if constexpr (std::is_same<Float, float>::value) {
+		pffft_transform_ordered(static_cast<PFFFT_Setup*>(plan->getSetup()), input, output, work, direction);
+	} else {
+		pffftd_transform_ordered(static_cast<PFFFTD_Setup*>(plan->getSetup()), input, output, work, direction);
+	}
 }
 
 
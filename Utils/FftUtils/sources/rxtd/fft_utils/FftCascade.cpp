@@ -15,8 +15,9 @@ void FftCascade::setParams(Params _params, RealFft* _fftPtr, FftCascade* _succes
 	fftPtr = _fftPtr;
 	cascadeIndex = _cascadeIndex;
 
-	buffer.reset();
-	buffer.setMaxSize(params.fftSize * 5);
+	downsampleHelper.setMethod(params.downsampling);
+
+	buffer.setCapacity(params.fftSize * 2);
 
 	resampleResult();
 }
@@ -26,29 +27,33 @@ void FftCascade::process(array_view<float> wave, clock::time_point killTime) {
 		return;
 	}
 
-	array_span<float> newChunk;
-
 	const bool needDownsample = cascadeIndex != 0;
-	if (needDownsample) {
-		const auto requiredSize = downsampleHelper.pushData(wave);
-		newChunk = buffer.allocateNext(requiredSize);
-		downsampleHelper.downsampleFixed<2>(newChunk);
-	} else {
-		newChunk = buffer.allocateNext(wave.size());
-		wave.transferToSpan(newChunk);
-	}
+	index remainingSize = needDownsample ? downsampleHelper.pushData(wave) : wave.size();
+
+	// wave can be bigger than free space in the buffer, so it's written in several chunks,
+	// and all frames that are ready are processed after each chunk to free the space
+	while (remainingSize > 0) {
+		const index chunkSize = std::min(remainingSize, buffer.getFreeSize());
+		array_span<float> newChunk = buffer.allocateNext(chunkSize);
+		if (needDownsample) {
+			downsampleHelper.downsampleFixed<2>(newChunk);
+		} else {
+			std::copy_n(wave.end() - remainingSize, chunkSize, newChunk.begin());
+		}
+		buffer.commitNext(chunkSize);
+		remainingSize -= chunkSize;
+
+		if (successorPtr != nullptr) {
+			successorPtr->process(newChunk, killTime);
+		}
 
-	if (successorPtr != nullptr) {
-		successorPtr->process(newChunk, killTime);
+		processReadyFrames(killTime);
 	}
+}
 
+void FftCascade::processReadyFrames(clock::time_point killTime) {
 	if (clock::now() > killTime) {
-		while (true) {
-			auto chunk = buffer.getFirst(params.fftSize);
-			if (chunk.empty()) {
-				break;
-			}
-
+		while (!buffer.getFirst(params.fftSize).empty()) {
 			params.callback(values, cascadeIndex);
 
 			buffer.removeFirst(params.inputStride);
@@ -57,20 +62,28 @@ void FftCascade::process(array_view<float> wave, clock::time_point killTime) {
 		return;
 	}
 
-	while (true) {
-		auto chunk = buffer.getFirst(params.fftSize);
-		if (chunk.empty()) {
-			break;
-		}
-
-		fftPtr->process(chunk);
-		fftPtr->fillMagnitudes(values);
-		hasChanges = true;
+	batchFrames.clear();
+	for (index offset = 0; offset + params.fftSize <= buffer.getRemainingSize(); offset += params.inputStride) {
+		batchFrames.push_back(buffer.getView(offset, params.fftSize));
+	}
+	if (batchFrames.empty()) {
+		return;
+	}
 
-		params.callback(values, cascadeIndex);
+	const index framesCount = static_cast<index>(batchFrames.size());
+	const index valuesCount = static_cast<index>(values.size());
+	batchValues.resize(static_cast<size_t>(framesCount * valuesCount));
+	fftPtr->processBatch(batchFrames, batchValues);
+	hasChanges = true;
 
-		buffer.removeFirst(params.inputStride);
+	array_view<float> frameValues;
+	for (index i = 0; i < framesCount; i++) {
+		frameValues = { batchValues.data() + i * valuesCount, valuesCount };
+		params.callback(frameValues, cascadeIndex);
 	}
+	frameValues.transferToSpan(values);
+
+	buffer.removeFirst(framesCount * params.inputStride);
 }
 
 void FftCascade::resampleResult() {
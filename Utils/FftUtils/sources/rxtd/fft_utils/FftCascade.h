@@ -6,7 +6,7 @@
 #include <functional>
 
 #include "RealFft.h"
-#include "rxtd/GrowingVector.h"
+#include "rxtd/MirroredRingBuffer.h"
 #include "rxtd/filter_utils/DownsampleHelper.h"
 
 namespace rxtd::fft_utils {
@@ -14,7 +14,7 @@ namespace rxtd::fft_utils {
 	public:
 		using DownsampleHelper = filter_utils::DownsampleHelper;
 
-		using clock = std::chrono::high_resolution_clock;
+		using clock = std::chrono::steady_clock;
 		static_assert(clock::is_steady);
 
 		struct Params {
@@ -23,6 +23,8 @@ namespace rxtd::fft_utils {
 
 			index inputStride;
 
+			DownsampleHelper::Method downsampling = DownsampleHelper::Method::eIIR;
+
 			std::function<void(array_view<float> result, index cascade)> callback;
 		};
 
@@ -33,16 +35,24 @@ namespace rxtd::fft_utils {
 		Params params{};
 		index cascadeIndex{};
 
-		GrowingVector<float> buffer;
+		// capacity of 2 * fftSize: after all ready frames are transformed less than fftSize samples remain,
+		// so there is always room for new samples, and all frames are read right from the buffer
+		MirroredRingBuffer<float> buffer;
 		DownsampleHelper downsampleHelper{ 2 };
 		std::vector<float> values;
 		bool hasChanges = false;
 
+		// all frames that are ready in one process call are transformed at once
+		std::vector<array_view<float>> batchFrames;
+		std::vector<float> batchValues;
+
 	public:
 		void setParams(Params _params, RealFft* _fftPtr, FftCascade* _successorPtr, index _cascadeIndex);
 		void process(array_view<float> wave, clock::time_point killTime);
 
 	private:
+		void processReadyFrames(clock::time_point killTime);
+
 		void resampleResult();
 	};
 }
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "FftKernels.h"
+
+#include "rxtd/std_fixes/CpuFeatures.h"
+
+using rxtd::fft_utils::FftKernels;
+using rxtd::std_fixes::CpuFeatures;
+
+namespace {
+	using rxtd::index;
+
+	void applyWindowScalar(const float* wave, const float* window, float* result, index size) {
+		for (index i = 0; i < size; i++) {
+			result[i] = wave[i] * window[i];
+		}
+	}
+
+	void magnitudesScalar(const float* packed, float scalar, float* result, index binsCount) {
+		for (index block = 0; block < binsCount; block += 4) {
+			for (index lane = 0; lane < 4; lane++) {
+				const float real = packed[block * 2 + lane];
+				const float imag = packed[block * 2 + 4 + lane];
+				result[block + lane] = std::sqrt(real * real + imag * imag) * scalar;
+			}
+		}
+	}
+
+	void powerScalar(const float* packed, float scalar, float* result, index binsCount) {
+		for (index block = 0; block < binsCount; block += 4) {
+			for (index lane = 0; lane < 4; lane++) {
+				const float real = packed[block * 2 + lane];
+				const float imag = packed[block * 2 + 4 + lane];
+				result[block + lane] = (real * real + imag * imag) * scalar;
+			}
+		}
+	}
+
+#ifdef RXTD_X86
+	void applyWindowSse(const float* wave, const float* window, float* result, index size) {
+		index i = 0;
+		for (; i + 4 <= size; i += 4) {
+			_mm_storeu_ps(result + i, _mm_mul_ps(_mm_loadu_ps(wave + i), _mm_loadu_ps(window + i)));
+		}
+		applyWindowScalar(wave + i, window + i, result + i, size - i);
+	}
+
+	__m128 squaredSse(const float* block) {
+		const __m128 real = _mm_loadu_ps(block);
+		const __m128 imag = _mm_loadu_ps(block + 4);
+		return _mm_add_ps(_mm_mul_ps(real, real), _mm_mul_ps(imag, imag));
+	}
+
+	void magnitudesSse(const float* packed, float scalar, float* result, index binsCount) {
+		const __m128 scalarVec = _mm_set1_ps(scalar);
+		for (index block = 0; block < binsCount; block += 4) {
+			_mm_storeu_ps(result + block, _mm_mul_ps(_mm_sqrt_ps(squaredSse(packed + block * 2)), scalarVec));
+		}
+	}
+
+	void powerSse(const float* packed, float scalar, float* result, index binsCount) {
+		const __m128 scalarVec = _mm_set1_ps(scalar);
+		for (index block = 0; block < binsCount; block += 4) {
+			_mm_storeu_ps(result + block, _mm_mul_ps(squaredSse(packed + block * 2), scalarVec));
+		}
+	}
+
+	RXTD_TARGET_AVX
+	void applyWindowAvx(const float* wave, const float* window, float* result, index size) {
+		index i = 0;
+		for (; i + 8 <= size; i += 8) {
+			_mm256_storeu_ps(result + i, _mm256_mul_ps(_mm256_loadu_ps(wave + i), _mm256_loadu_ps(window + i)));
+		}
+		applyWindowSse(wave + i, window + i, result + i, size - i);
+	}
+
+	// 2 blocks at once: [re0..re3 im0..im3] [re4..re7 im4..im7]
+	RXTD_TARGET_AVX
+	__m256 squaredAvx(const float* blocks) {
+		const __m256 first = _mm256_loadu_ps(blocks);
+		const __m256 second = _mm256_loadu_ps(blocks + 8);
+		const __m256 real = _mm256_permute2f128_ps(first, second, 0x20);
+		const __m256 imag = _mm256_permute2f128_ps(first, second, 0x31);
+		return _mm256_add_ps(_mm256_mul_ps(real, real), _mm256_mul_ps(imag, imag));
+	}
+
+	RXTD_TARGET_AVX
+	void magnitudesAvx(const float* packed, float scalar, float* result, index binsCount) {
+		const __m256 scalarVec = _mm256_set1_ps(scalar);
+		index block = 0;
+		for (; block + 8 <= binsCount; block += 8) {
+			_mm256_storeu_ps(result + block, _mm256_mul_ps(_mm256_sqrt_ps(squaredAvx(packed + block * 2)), scalarVec));
+		}
+		magnitudesSse(packed + block * 2, scalar, result + block, binsCount - block);
+	}
+
+	RXTD_TARGET_AVX
+	void powerAvx(const float* packed, float scalar, float* result, index binsCount) {
+		const __m256 scalarVec = _mm256_set1_ps(scalar);
+		index block = 0;
+		for (; block + 8 <= binsCount; block += 8) {
+			_mm256_storeu_ps(result + block, _mm256_mul_ps(squaredAvx(packed + block * 2), scalarVec));
+		}
+		powerSse(packed + block * 2, scalar, result + block, binsCount - block);
+	}
+#endif
+}
+
+FftKernels::FftKernels(InstructionSet value) {
+	if (!isSupported(value)) {
+		value = getBestInstructionSet();
+	}
+	instructionSet = value;
+
+	switch (value) {
+	case InstructionSet::eSCALAR:
+		windowFunction = applyWindowScalar;
+		magnitudesFunction = magnitudesScalar;
+		powerFunction = powerScalar;
+		break;
+#ifdef RXTD_X86
+	case InstructionSet::eSSE:
+		windowFunction = applyWindowSse;
+		magnitudesFunction = magnitudesSse;
+		powerFunction = powerSse;
+		break;
+	case InstructionSet::eAVX:
+		windowFunction = applyWindowAvx;
+		magnitudesFunction = magnitudesAvx;
+		powerFunction = powerAvx;
+		break;
+#endif
+	default: break;
+	}
+}
+
+bool FftKernels::isSupported(InstructionSet value) {
+	switch (value) {
+	case InstructionSet::eSCALAR: return true;
+#ifdef RXTD_X86
+	case InstructionSet::eSSE: return true;
+	case InstructionSet::eAVX: return CpuFeatures::hasAvx();
+#endif
+	default: return false;
+	}
+}
+
+FftKernels::InstructionSet FftKernels::getBestInstructionSet() {
+	if (isSupported(InstructionSet::eAVX)) {
+		return InstructionSet::eAVX;
+	}
+	if (isSupported(InstructionSet::eSSE)) {
+		return InstructionSet::eSSE;
+	}
+	return InstructionSet::eSCALAR;
+}
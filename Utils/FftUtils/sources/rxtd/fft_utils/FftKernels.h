@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+
+namespace rxtd::fft_utils {
+	/// <summary>
+	/// Vectorized loops around the transform in RealFft.
+	///
+	/// Instruction set is chosen at runtime:
+	/// AVX when CPU and OS support it, SSE on all other x86 CPUs, plain scalar code elsewhere.
+	/// All instruction sets do the same float operations in the same order, so results don't depend on the CPU.
+	///
+	/// Packed spectrum is the unordered output of pffft:
+	/// blocks of 4 real parts followed by 4 imaginary parts of the same 4 bins.
+	/// Results for packed spectrum are in the same order as bins in the blocks.
+	/// </summary>
+	class FftKernels {
+	public:
+		enum class InstructionSet {
+			eSCALAR,
+			eSSE,
+			eAVX,
+		};
+
+	private:
+		using WindowFunction = void(*)(const float* wave, const float* window, float* result, index size);
+		using PackedFunction = void(*)(const float* packed, float scalar, float* result, index binsCount);
+
+		InstructionSet instructionSet = InstructionSet::eSCALAR;
+		WindowFunction windowFunction = nullptr;
+		PackedFunction magnitudesFunction = nullptr;
+		PackedFunction powerFunction = nullptr;
+
+	public:
+		/// <summary>
+		/// Uses the best instruction set that current CPU supports.
+		/// </summary>
+		FftKernels() : FftKernels(getBestInstructionSet()) { }
+
+		/// <summary>
+		/// Falls back to the best supported instruction set if value is not supported.
+		/// </summary>
+		explicit FftKernels(InstructionSet value);
+
+		[[nodiscard]]
+		InstructionSet getInstructionSet() const {
+			return instructionSet;
+		}
+
+		[[nodiscard]]
+		static bool isSupported(InstructionSet value);
+
+		[[nodiscard]]
+		static InstructionSet getBestInstructionSet();
+
+		/// <summary>
+		/// result[i] = wave[i] * window[i].
+		/// All arrays must have the same size.
+		/// </summary>
+		void applyWindow(array_view<float> wave, array_view<float> window, array_span<float> result) const {
+			windowFunction(wave.data(), window.data(), result.data(), result.size());
+		}
+
+		/// <summary>
+		/// result[i] = sqrt(real^2 + imag^2) * scalar.
+		/// Size of result must be a multiple of 4, packed must be twice as big.
+		/// </summary>
+		void packedToMagnitudes(array_view<float> packed, float scalar, array_span<float> result) const {
+			magnitudesFunction(packed.data(), scalar, result.data(), result.size());
+		}
+
+		/// <summary>
+		/// result[i] = (real^2 + imag^2) * scalar.
+		/// Size of result must be a multiple of 4, packed must be twice as big.
+		/// </summary>
+		void packedToPower(array_view<float> packed, float scalar, array_span<float> result) const {
+			powerFunction(packed.data(), scalar, result.data(), result.size());
+		}
+	};
+}
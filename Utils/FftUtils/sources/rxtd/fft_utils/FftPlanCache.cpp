@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "FftPlanCache.h"
+
+#define PFFFT_ENABLE_FLOAT
+#define PFFFT_ENABLE_DOUBLE
+#include <libs/pffft/pffft.hpp>
+
+using rxtd::fft_utils::FftPlanCache;
+
+FftPlanCache::Plan::~Plan() {
+	if (setup == nullptr) {
+		return;
+	}
+	if (precision == Precision::eFLOAT) {
+		pffft_destroy_setup(static_cast<PFFFT_Setup*>(setup));
+	} else {
+		pffftd_destroy_setup(static_cast<PFFFTD_Setup*>(setup));
+	}
+}
+
+FftPlanCache::PlanPtr FftPlanCache::acquire(index size, Kind kind, Precision precision) {
+	auto& instance = getInstance();
+	const Key key{ size, kind, precision };
+
+	std::lock_guard<std::mutex> lock{ instance.mutex };
+
+	auto& weak = instance.plans[key];
+	if (auto plan = weak.lock(); plan != nullptr) {
+		instance.hits++;
+		return plan;
+	}
+
+	// drop entries of released plans, so that the map doesn't grow when sizes change
+	for (auto iter = instance.plans.begin(); iter != instance.plans.end();) {
+		if (iter->second.expired() && &iter->second != &weak) {
+			iter = instance.plans.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+
+	PlanPtr plan = createPlan(key);
+	weak = plan;
+	instance.misses++;
+	return plan;
+}
+
+FftPlanCache::Stats FftPlanCache::getStats() {
+	auto& instance = getInstance();
+	std::lock_guard<std::mutex> lock{ instance.mutex };
+
+	Stats result;
+	result.hits = instance.hits;
+	result.misses = instance.misses;
+	for (const auto& [key, weak] : instance.plans) {
+		if (const auto plan = weak.lock(); plan != nullptr) {
+			result.plansCount++;
+			result.memorySize += plan->getMemorySize();
+		}
+	}
+	return result;
+}
+
+FftPlanCache& FftPlanCache::getInstance() {
+	static FftPlanCache instance;
+	return instance;
+}
+
+std::shared_ptr<FftPlanCache::Plan> FftPlanCache::createPlan(Key key) {
+	const auto transform = key.kind == Kind::eREAL ? PFFFT_REAL : PFFFT_COMPLEX;
+	auto plan = std::make_shared<Plan>();
+	plan->precision = key.precision;
+
+	index scalarSize;
+	if (key.precision == Precision::eFLOAT) {
+		plan->setup = pffft_new_setup(static_cast<int>(key.size), transform);
+		scalarSize = static_cast<index>(sizeof(float));
+	} else {
+		plan->setup = pffftd_new_setup(static_cast<int>(key.size), transform);
+		scalarSize = static_cast<index>(sizeof(double));
+	}
+	if (plan->setup == nullptr) {
+		throw std::runtime_error{ "FftPlanCache::createPlan(): invalid fft size" };
+	}
+
+	// pffft allocates N scalars of twiddle factors for real transform and 2N for complex
+	const index scalarsCount = key.kind == Kind::eREAL ? key.size : key.size * 2;
+	plan->memorySize = scalarsCount * scalarSize;
+
+	return plan;
+}
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include <mutex>
+#include <tuple>
+
+namespace rxtd::fft_utils {
+	/// <summary>
+	/// Process-wide storage of pffft setups (twiddle factors and factorization of the size).
+	///
+	/// Setup only depends on size, precision and kind of the transform,
+	/// and pffft never modifies it after creation, so one setup can be used by any number of transforms,
+	/// in any thread, as long as each transform has its own work buffers.
+	/// Plans are reference counted: plan is destroyed when the last user releases it,
+	/// and is created again on the next #acquire.
+	/// All static functions are thread-safe.
+	/// </summary>
+	class FftPlanCache {
+	public:
+		enum class Kind {
+			eREAL,
+			eCOMPLEX,
+		};
+
+		enum class Precision {
+			eFLOAT,
+			eDOUBLE,
+		};
+
+		class Plan : NonMovableBase {
+			friend FftPlanCache;
+
+			// pffft.hpp declares C API of pffft in an anonymous namespace,
+			// so setup types can't be named outside of a translation unit
+			void* setup = nullptr;
+			Precision precision{};
+			index memorySize = 0;
+
+		public:
+			Plan() = default;
+			~Plan();
+
+			/// <summary>
+			/// PFFFT_Setup* for float precision, PFFFTD_Setup* for double precision.
+			/// </summary>
+			[[nodiscard]]
+			void* getSetup() const {
+				return setup;
+			}
+
+			/// <summary>
+			/// Approximate size of the setup in bytes.
+			/// </summary>
+			[[nodiscard]]
+			index getMemorySize() const {
+				return memorySize;
+			}
+		};
+
+		using PlanPtr = std::shared_ptr<const Plan>;
+
+		struct Stats {
+			// count of #acquire calls that found an existing plan
+			index hits{};
+			// count of #acquire calls that had to create a new plan
+			index misses{};
+			// count of plans that currently have at least one user
+			index plansCount{};
+			// approximate memory used by all live plans, in bytes
+			index memorySize{};
+		};
+
+	private:
+		struct Key {
+			index size{};
+			Kind kind{};
+			Precision precision{};
+
+			friend bool operator<(const Key& lhs, const Key& rhs) {
+				return std::tie(lhs.size, lhs.kind, lhs.precision) < std::tie(rhs.size, rhs.kind, rhs.precision);
+			}
+		};
+
+		std::mutex mutex;
+		std::map<Key, std::weak_ptr<const Plan>> plans;
+		index hits = 0;
+		index misses = 0;
+
+	public:
+		/// <summary>
+		/// Returns a plan that is shared with all other users of the same parameters.
+		/// Size must be valid for pffft, see FftSizeHelper.
+		/// Throws std::runtime_error if pffft can't create a setup.
+		/// </summary>
+		[[nodiscard]]
+		static PlanPtr acquire(index size, Kind kind, Precision precision);
+
+		[[nodiscard]]
+		static Stats getStats();
+
+	private:
+		static FftPlanCache& getInstance();
+
+		static std::shared_ptr<Plan> createPlan(Key key);
+	};
+}
@@ -0,0 +1,301 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "FftSizeTuner.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#include "FftSizeHelper.h"
+#include "RealFft.h"
+
+#include "rxtd/std_fixes/CpuFeatures.h"
+
+using rxtd::fft_utils::FftSizeTuner;
+
+rxtd::index FftSizeTuner::findFastestSize(const std::filesystem::path& cacheFile, index minSize, index maxSize, index fallback, bool real) {
+	tune(cacheFile, minSize, maxSize, real);
+	return findCachedFastestSize(cacheFile, minSize, maxSize, fallback, real).value_or(fallback);
+}
+
+std::optional<rxtd::index> FftSizeTuner::findCachedFastestSize(const std::filesystem::path& cacheFile, index minSize, index maxSize, index fallback, bool real) {
+	const auto candidates = findCandidates(minSize, maxSize, real);
+	if (candidates.empty()) {
+		return fallback;
+	}
+	if (candidates.size() == 1) {
+		return candidates.front();
+	}
+
+	auto& instance = getInstance();
+	std::lock_guard<std::mutex> lock{ instance.mutex };
+	const auto& table = instance.getTable(cacheFile);
+
+	index bestSize = fallback;
+	double bestTime = std::numeric_limits<double>::infinity();
+	for (const index size : candidates) {
+		const auto measurement = findMeasurement(table, size);
+		if (measurement == nullptr) {
+			return {};
+		}
+
+		if (measurement->nanosecondsPerSample < bestTime) {
+			bestTime = measurement->nanosecondsPerSample;
+			bestSize = size;
+		}
+	}
+
+	return bestSize;
+}
+
+bool FftSizeTuner::tune(const std::filesystem::path& cacheFile, index minSize, index maxSize, bool real) {
+	const auto candidates = findCandidates(minSize, maxSize, real);
+	// single size is chosen without measurements
+	if (candidates.size() < 2) {
+		return true;
+	}
+
+	auto& instance = getInstance();
+
+	std::vector<index> missingSizes;
+	{
+		std::lock_guard<std::mutex> lock{ instance.mutex };
+		const auto& table = instance.getTable(cacheFile);
+		for (const index size : candidates) {
+			if (findMeasurement(table, size) == nullptr) {
+				missingSizes.push_back(size);
+			}
+		}
+	}
+
+	// measurements take a lot of time, and lookups must not wait for them
+	std::vector<Measurement> newMeasurements;
+	for (const index size : missingSizes) {
+		if (instance.stopRequest.load(std::memory_order_relaxed)) {
+			break;
+		}
+		newMeasurements.push_back({ getCpuModel(), size, measure(size) });
+	}
+
+	std::lock_guard<std::mutex> lock{ instance.mutex };
+	auto& table = instance.getTable(cacheFile);
+
+	bool tableChanged = false;
+	for (auto& measurement : newMeasurements) {
+		// another thread could have measured the same size in the meantime
+		if (findMeasurement(table, measurement.size) == nullptr) {
+			table.measurements.push_back(std::move(measurement));
+			tableChanged = true;
+		}
+	}
+
+	if (!tableChanged || cacheFile.empty()) {
+		return true;
+	}
+
+	const bool saved = save(cacheFile, table);
+	table.saveFailed = !saved;
+	return saved;
+}
+
+void FftSizeTuner::requestTuning(const std::filesystem::path& cacheFile, index minSize, index maxSize, bool real) {
+	auto& instance = getInstance();
+	std::lock_guard<std::mutex> lock{ instance.mutex };
+
+	Request request{ cacheFile, minSize, maxSize, real };
+	if (std::find(instance.requests.begin(), instance.requests.end(), request) != instance.requests.end()) {
+		return;
+	}
+	instance.requests.push_back(std::move(request));
+
+	if (!instance.thread.joinable()) {
+		instance.thread = std::thread{
+			[&instance] {
+				instance.threadFunction();
+			}
+		};
+	}
+	instance.requestVariable.notify_one();
+}
+
+bool FftSizeTuner::takeSaveError(const std::filesystem::path& cacheFile) {
+	auto& instance = getInstance();
+	std::lock_guard<std::mutex> lock{ instance.mutex };
+	auto& table = instance.getTable(cacheFile);
+	return std::exchange(table.saveFailed, false);
+}
+
+std::vector<FftSizeTuner::Measurement> FftSizeTuner::getMeasurements(const std::filesystem::path& cacheFile) {
+	auto& instance = getInstance();
+	std::lock_guard<std::mutex> lock{ instance.mutex };
+	return instance.getTable(cacheFile).measurements;
+}
+
+void FftSizeTuner::exportCsv(array_view<Measurement> measurements, std::ostream& stream) {
+	stream << "cpu,size,ns per sample\n";
+	for (const auto& m : measurements) {
+		stream << '"' << m.cpuModel << "\"," << m.size << ',' << m.nanosecondsPerSample << '\n';
+	}
+}
+
+std::vector<rxtd::index> FftSizeTuner::findCandidates(index minSize, index maxSize, bool real) {
+	std::vector<index> result;
+	index size = FftSizeHelper::findNextAllowedLength(std::max<index>(minSize, 1), real);
+	while (size <= maxSize) {
+		result.push_back(size);
+		size = FftSizeHelper::findNextAllowedLength(size + 1, real);
+	}
+	return result;
+}
+
+double FftSizeTuner::measure(index size) {
+	using clock = std::chrono::steady_clock;
+	// each round takes at least this long, so that timer resolution doesn't matter
+	constexpr auto minRoundTime = std::chrono::milliseconds{ 2 };
+	constexpr index roundsCount = 3;
+
+	RealFft fft;
+	fft.setParams(size, {});
+
+	std::vector<float> wave;
+	wave.resize(static_cast<size_t>(size));
+	for (index i = 0; i < size; i++) {
+		// any non-trivial values, to avoid special cases for zeros
+		wave[static_cast<size_t>(i)] = static_cast<float>((i * 7919) % 1000) * 0.001f - 0.5f;
+	}
+	std::vector<float> magnitudes;
+	magnitudes.resize(static_cast<size_t>(size / 2));
+
+	// warm up caches and the plan
+	fft.process(wave);
+	fft.fillMagnitudes(magnitudes);
+
+	// minimum of several rounds filters out interruptions by other threads
+	double best = std::numeric_limits<double>::infinity();
+	for (index round = 0; round < roundsCount; round++) {
+		index iterations = 0;
+		const auto start = clock::now();
+		auto now = start;
+		do {
+			fft.process(wave);
+			fft.fillMagnitudes(magnitudes);
+			iterations++;
+			now = clock::now();
+		} while (now - start < minRoundTime);
+
+		const double nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count());
+		best = std::min(best, nanoseconds / static_cast<double>(iterations * size));
+	}
+
+	return best;
+}
+
+const std::string& FftSizeTuner::getCpuModel() {
+	static const std::string result = [] {
+		std::string model = std_fixes::CpuFeatures::getBrandString();
+		// tabs and quotes would break the file format
+		std::replace(model.begin(), model.end(), '\t', ' ');
+		std::replace(model.begin(), model.end(), '"', '\'');
+		model.erase(0, model.find_first_not_of(' '));
+		model.erase(model.find_last_not_of(' ') + 1);
+		return model.empty() ? std::string{ "unknown" } : model;
+	}();
+	return result;
+}
+
+FftSizeTuner::~FftSizeTuner() {
+	if (!thread.joinable()) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		stopRequest.store(true, std::memory_order_relaxed);
+		requestVariable.notify_one();
+	}
+
+	// measurement that is running is finished, but the rest of the request is skipped
+	thread.join();
+}
+
+void FftSizeTuner::threadFunction() {
+	std::unique_lock<std::mutex> lock{ mutex };
+	while (true) {
+		requestVariable.wait(
+			lock, [this] {
+				return stopRequest.load(std::memory_order_relaxed) || !requests.empty();
+			}
+		);
+		if (stopRequest.load(std::memory_order_relaxed)) {
+			return;
+		}
+
+		// request stays in the queue while it's measured, so that it's not requested again
+		const Request request = requests.front();
+		lock.unlock();
+		tune(request.cacheFile, request.minSize, request.maxSize, request.real);
+		lock.lock();
+		requests.pop_front();
+	}
+}
+
+FftSizeTuner& FftSizeTuner::getInstance() {
+	static FftSizeTuner instance;
+	return instance;
+}
+
+FftSizeTuner::Table& FftSizeTuner::getTable(const std::filesystem::path& cacheFile) {
+	auto& table = tables[cacheFile];
+	if (!table.loaded) {
+		table.loaded = true;
+		if (!cacheFile.empty()) {
+			load(cacheFile, table);
+		}
+	}
+	return table;
+}
+
+const FftSizeTuner::Measurement* FftSizeTuner::findMeasurement(const Table& table, index size) {
+	const auto& cpuModel = getCpuModel();
+	const auto iter = std::find_if(
+		table.measurements.begin(), table.measurements.end(), [&](const Measurement& m) {
+			return m.size == size && m.cpuModel == cpuModel;
+		}
+	);
+	return iter == table.measurements.end() ? nullptr : &*iter;
+}
+
+void FftSizeTuner::load(const std::filesystem::path& cacheFile, Table& table) {
+	std::ifstream stream{ cacheFile };
+	std::string line;
+	while (std::getline(stream, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		const auto firstTab = line.find('\t');
+		const auto secondTab = line.find('\t', firstTab + 1);
+		if (firstTab == std::string::npos || secondTab == std::string::npos) {
+			continue;
+		}
+
+		Measurement m;
+		m.cpuModel = line.substr(0, firstTab);
+		std::istringstream numbers{ line.substr(firstTab + 1) };
+		numbers >> m.size >> m.nanosecondsPerSample;
+		if (!numbers.fail() && m.size > 0 && m.nanosecondsPerSample > 0.0) {
+			table.measurements.push_back(std::move(m));
+		}
+	}
+}
+
+bool FftSizeTuner::save(const std::filesystem::path& cacheFile, const Table& table) {
+	std::ofstream stream{ cacheFile };
+	stream << "# cpu\tsize\tns per sample\n";
+	for (const auto& m : table.measurements) {
+		stream << m.cpuModel << '\t' << m.size << '\t' << m.nanosecondsPerSample << '\n';
+	}
+	stream.flush();
+	return stream.good();
+}
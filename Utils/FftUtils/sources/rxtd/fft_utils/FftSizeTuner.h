@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace rxtd::fft_utils {
+	/// <summary>
+	/// Picks the fastest fft size out of all sizes that FftSizeHelper allows in a range.
+	///
+	/// Speed of pffft depends on factorization of the size,
+	/// so a slightly bigger power of 2 can be cheaper than a size with factors 3 and 5.
+	/// Sizes are compared by time per input sample, because bigger fft is computed less often for the same overlap.
+	///
+	/// Each size is measured once per process and per cache file.
+	/// Measuring takes several milliseconds per size, so callers that can't wait
+	/// should use #findCachedFastestSize and #requestTuning.
+	/// Measurements are done without holding the lock, so lookups never wait for them.
+	/// Measurements are saved into the cache file, one line per size:
+	/// CPU model, size and nanoseconds per sample, separated by tabs.
+	/// Lines of other CPU models are kept, so files from several machines can be merged and compared.
+	/// All static functions are thread-safe.
+	/// </summary>
+	class FftSizeTuner {
+	public:
+		struct Measurement {
+			std::string cpuModel;
+			index size{};
+			double nanosecondsPerSample{};
+		};
+
+	private:
+		struct Table {
+			bool loaded = false;
+			// result of the last save that hasn't been reported yet
+			bool saveFailed = false;
+			std::vector<Measurement> measurements;
+		};
+
+		struct Request {
+			std::filesystem::path cacheFile;
+			index minSize{};
+			index maxSize{};
+			bool real{};
+
+			friend bool operator==(const Request& lhs, const Request& rhs) {
+				return lhs.cacheFile == rhs.cacheFile
+					&& lhs.minSize == rhs.minSize
+					&& lhs.maxSize == rhs.maxSize
+					&& lhs.real == rhs.real;
+			}
+		};
+
+		std::mutex mutex;
+		std::map<std::filesystem::path, Table> tables;
+
+		// background measurements, see #requestTuning
+		// front request is the one being measured, it's removed when it's finished
+		std::deque<Request> requests;
+		std::thread thread;
+		std::condition_variable requestVariable;
+		std::atomic<bool> stopRequest{ false };
+
+		FftSizeTuner() = default;
+		~FftSizeTuner();
+
+	public:
+		/// <summary>
+		/// Returns the fastest size in range [minSize, maxSize].
+		/// Returns fallback if range doesn't contain any allowed size.
+		/// Empty cacheFile disables saving results to disk.
+		/// File errors are ignored: measurements are redone in the next process.
+		/// </summary>
+		[[nodiscard]]
+		static index findFastestSize(const std::filesystem::path& cacheFile, index minSize, index maxSize, index fallback, bool real);
+
+		/// <summary>
+		/// Same as #findFastestSize, but never measures anything.
+		/// Returns empty optional if some of the sizes in the range haven't been measured yet.
+		/// </summary>
+		[[nodiscard]]
+		static std::optional<index> findCachedFastestSize(const std::filesystem::path& cacheFile, index minSize, index maxSize, index fallback, bool real);
+
+		/// <summary>
+		/// Measures all sizes in range [minSize, maxSize] that haven't been measured yet.
+		/// Returns false if new measurements couldn't be written into the cache file.
+		/// </summary>
+		static bool tune(const std::filesystem::path& cacheFile, index minSize, index maxSize, bool real);
+
+		/// <summary>
+		/// Same as #tune, but measurements are done in a background thread that belongs to the tuner,
+		/// so the caller doesn't have to outlive them.
+		/// Requests are done one at a time, and request that is already waiting is not added again.
+		/// Errors of writing the cache file can be checked with #takeSaveError.
+		/// </summary>
+		static void requestTuning(const std::filesystem::path& cacheFile, index minSize, index maxSize, bool real);
+
+		/// <summary>
+		/// Returns true if the last write into the cache file has failed,
+		/// and the error hasn't been returned by this function yet.
+		/// </summary>
+		[[nodiscard]]
+		static bool takeSaveError(const std::filesystem::path& cacheFile);
+
+		/// <summary>
+		/// Returns all measurements from the cache file, of all CPU models.
+		/// </summary>
+		[[nodiscard]]
+		static std::vector<Measurement> getMeasurements(const std::filesystem::path& cacheFile);
+
+		/// <summary>
+		/// Writes measurements as CSV with a header line.
+		/// </summary>
+		static void exportCsv(array_view<Measurement> measurements, std::ostream& stream);
+
+		/// <summary>
+		/// All sizes in range [minSize, maxSize] that FftSizeHelper::findNextAllowedLength can return.
+		/// </summary>
+		[[nodiscard]]
+		static std::vector<index> findCandidates(index minSize, index maxSize, bool real);
+
+		/// <summary>
+		/// Runs RealFft of given size and returns time per input sample in nanoseconds.
+		/// </summary>
+		[[nodiscard]]
+		static double measure(index size);
+
+		/// <summary>
+		/// Processor brand string, or "unknown" if it's not available.
+		/// </summary>
+		[[nodiscard]]
+		static const std::string& getCpuModel();
+
+	private:
+		static FftSizeTuner& getInstance();
+
+		Table& getTable(const std::filesystem::path& cacheFile);
+
+		void threadFunction();
+
+		[[nodiscard]]
+		static const Measurement* findMeasurement(const Table& table, index size);
+
+		static void load(const std::filesystem::path& cacheFile, Table& table);
+		static bool save(const std::filesystem::path& cacheFile, const Table& table);
+	};
+}
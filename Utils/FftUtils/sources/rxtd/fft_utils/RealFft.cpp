@@ -7,35 +7,59 @@
 #define PFFFT_ENABLE_DOUBLE
 #include <libs/pffft/pffft.hpp>
 
+#include "FftKernels.h"
+#include "FftPlanCache.h"
 #include "FftSizeHelper.h"
 
 using rxtd::fft_utils::RealFft;
 
 class RealFft::FftImplWrapper {
 public:
-	using scalar_type = scalar_type;
+	using scalar_type = RealFft::scalar_type;
 
 private:
+	using Complex = std::complex<scalar_type>;
+
 	pffft::AlignedVector<scalar_type> window;
 	// need separate input buffer because of window application
 	pffft::AlignedVector<scalar_type> inputBuffer;
-	pffft::AlignedVector<pffft::Fft<scalar_type>::Complex> outputBuffer;
+	pffft::AlignedVector<Complex> outputBuffer;
+	// unordered result of pffft and magnitudes in the same order, see #fillMagnitudes
+	pffft::AlignedVector<scalar_type> internalBuffer;
+	mutable pffft::AlignedVector<scalar_type> internalMagnitudes;
+	// internalMagnitudes[binOrder[i]] is the magnitude of outputBuffer[i]
+	std::vector<index> binOrder;
+	pffft::AlignedVector<scalar_type> workBuffer;
 
 	scalar_type scalar{};
+	Output output = Output::eMAGNITUDE;
 
-	pffft::Fft<scalar_type> fft;
+	FftPlanCache::PlanPtr plan;
+	FftKernels kernels;
 
 public:
-	FftImplWrapper();
-
 	void setParams(index size, array_view<scalar_type> window);
 
+	void setOutput(Output value) {
+		output = value;
+	}
+
 	void fillMagnitudes(array_span<scalar_type> result) const;
 
 	void process(array_view<scalar_type> wave);
-};
 
-RealFft::FftImplWrapper::FftImplWrapper() : fft(0) {}
+	void processBatch(array_view<array_view<scalar_type>> frames, array_span<scalar_type> result);
+
+private:
+	void applyWindow(array_view<scalar_type> wave);
+
+	void findBinOrder();
+
+	[[nodiscard]]
+	PFFFT_Setup* getSetup() const {
+		return static_cast<PFFFT_Setup*>(plan->getSetup());
+	}
+};
 
 void RealFft::FftImplWrapper::setParams(index size, array_view<scalar_type> _window) {
 	if (!(FftSizeHelper::findNextAllowedLength(size, true) == size)) {
@@ -53,29 +77,99 @@ void RealFft::FftImplWrapper::setParams(index size, array_view<scalar_type> _win
 	window.resize(static_cast<size_t>(_window.size()));
 	std::copy(_window.begin(), _window.end(), window.begin());
 
-	fft.prepareLength(static_cast<int>(size));
+	plan = FftPlanCache::acquire(size, FftPlanCache::Kind::eREAL, FftPlanCache::Precision::eFLOAT);
+
+	inputBuffer.resize(static_cast<size_t>(size));
+	outputBuffer.resize(static_cast<size_t>(size / 2));
+	internalBuffer.resize(static_cast<size_t>(size));
+	workBuffer.resize(static_cast<size_t>(size));
 
-	inputBuffer = fft.valueVector();
-	outputBuffer = fft.spectrumVector();
+	findBinOrder();
 }
 
 void RealFft::FftImplWrapper::fillMagnitudes(array_span<scalar_type> result) const {
+	if (!binOrder.empty()) {
+		// Ordered transform of pffft is an unordered transform followed by a separate reordering pass.
+		// Here magnitudes are computed right from the unordered layout, where they are easy to vectorize,
+		// and then only magnitudes are reordered, which is half as much data.
+		const array_view<scalar_type> packed{ internalBuffer.data(), static_cast<index>(internalBuffer.size()) };
+		const array_span<scalar_type> packedResult{ internalMagnitudes.data(), static_cast<index>(internalMagnitudes.size()) };
+		if (output == Output::ePOWER) {
+			kernels.packedToPower(packed, scalar * scalar, packedResult);
+		} else {
+			kernels.packedToMagnitudes(packed, scalar, packedResult);
+		}
+
+		const scalar_type* magnitudes = internalMagnitudes.data();
+		const index* order = binOrder.data();
+		for (index i = 0; i < result.size(); ++i) {
+			result[i] = magnitudes[order[i]];
+		}
+		return;
+	}
+
 	for (index i = 0; i < result.size(); ++i) {
 		const auto v = outputBuffer[static_cast<size_t>(i)];
 		const float square = v.real() * v.real() + v.imag() * v.imag();
-		result[i] = std::sqrt(square) * scalar;
+		result[i] = output == Output::ePOWER ? square * (scalar * scalar) : std::sqrt(square) * scalar;
 	}
 }
 
 void RealFft::FftImplWrapper::process(array_view<float> wave) {
-	if (!window.empty()) {
-		for (index i = 0; i < wave.size(); ++i) {
-			inputBuffer[static_cast<size_t>(i)] = wave[i] * window[static_cast<size_t>(i)];
+	applyWindow(wave);
+	if (!binOrder.empty()) {
+		pffft_transform(getSetup(), inputBuffer.data(), internalBuffer.data(), workBuffer.data(), PFFFT_FORWARD);
+	} else {
+		pffft_transform_ordered(
+			getSetup(),
+			inputBuffer.data(), reinterpret_cast<scalar_type*>(outputBuffer.data()), workBuffer.data(),
+			PFFFT_FORWARD
+		);
+	}
+}
+
+void RealFft::FftImplWrapper::processBatch(array_view<array_view<scalar_type>> frames, array_span<scalar_type> result) {
+	const index valuesCount = static_cast<index>(outputBuffer.size());
+	for (index frameIndex = 0; frameIndex < frames.size(); frameIndex++) {
+		process(frames[frameIndex]);
+		fillMagnitudes({ result.data() + frameIndex * valuesCount, valuesCount });
+	}
+}
+
+void RealFft::FftImplWrapper::findBinOrder() {
+	binOrder.clear();
+
+	// Ordering of the spectrum in pffft is only a permutation of values,
+	// so it can be found by ordering indices instead of values.
+	// Floats represent integers exactly up to 2^24, which is much more than any allowed fft size.
+	for (index i = 0; i < static_cast<index>(internalBuffer.size()); i++) {
+		internalBuffer[static_cast<size_t>(i)] = static_cast<scalar_type>(i);
+	}
+	pffft_zreorder(getSetup(), internalBuffer.data(), reinterpret_cast<scalar_type*>(outputBuffer.data()), PFFFT_FORWARD);
+
+	// With 4 floats in SIMD vector, pffft keeps real parts of 4 bins in one vector
+	// and imaginary parts of the same bins in the next vector.
+	// If the layout is something else, batches fall back to ordered transform.
+	std::vector<index> order;
+	for (const auto& value : outputBuffer) {
+		const auto realPosition = static_cast<index>(value.real());
+		const auto imagPosition = static_cast<index>(value.imag());
+		if (realPosition % 8 >= 4 || imagPosition != realPosition + 4) {
+			return;
 		}
+		order.push_back(realPosition / 8 * 4 + realPosition % 4);
+	}
+
+	binOrder = std::move(order);
+	internalMagnitudes.resize(binOrder.size());
+}
+
+void RealFft::FftImplWrapper::applyWindow(array_view<scalar_type> wave) {
+	if (!window.empty()) {
+		kernels.applyWindow(wave, { window.data(), wave.size() }, { inputBuffer.data(), wave.size() });
 	} else {
 		std::copy(wave.begin(), wave.end(), inputBuffer.begin());
 	}
-	fft.forward(inputBuffer, outputBuffer);
 }
 
 
@@ -89,6 +183,10 @@ void RealFft::setParams(index size, array_view<scalar_type> window) {
 	impl->setParams(size, window);
 }
 
+void RealFft::setOutput(Output value) {
+	impl->setOutput(value);
+}
+
 void RealFft::fillMagnitudes(array_span<scalar_type> result) const {
 	impl->fillMagnitudes(result);
 }
@@ -96,3 +194,7 @@ void RealFft::fillMagnitudes(array_span<scalar_type> result) const {
 void RealFft::process(array_view<scalar_type> wave) {
 	impl->process(wave);
 }
+
+void RealFft::processBatch(array_view<array_view<scalar_type>> frames, array_span<scalar_type> result) {
+	impl->processBatch(frames, result);
+}
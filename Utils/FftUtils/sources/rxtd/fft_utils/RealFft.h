@@ -11,6 +11,12 @@ namespace rxtd::fft_utils {
 	public:
 		using scalar_type = float;
 
+		enum class Output {
+			eMAGNITUDE,
+			// square of magnitude, doesn't need sqrt
+			ePOWER,
+		};
+
 	private:
 		std::unique_ptr<FftImplWrapper> impl;
 
@@ -20,8 +26,32 @@ namespace rxtd::fft_utils {
 
 		void setParams(index size, array_view<scalar_type> window);
 
+		void setOutput(Output value);
+
+		/// <summary>
+		/// Fills magnitudes or power of the bins, depending on #setOutput.
+		/// </summary>
 		void fillMagnitudes(array_span<scalar_type> result) const;
 
 		void process(array_view<scalar_type> wave);
+
+		/// <summary>
+		/// Same as calling #process and #fillMagnitudes for each frame.
+		/// All frames must have the size from #setParams.
+		/// Magnitudes of frame i are written into result[i * size / 2, (i + 1) * size / 2),
+		/// so result must have at least frames.size() * size / 2 elements.
+		/// </summary>
+		void processBatch(array_view<array_view<scalar_type>> frames, array_span<scalar_type> result);
 	};
 }
+
+template<>
+inline std::optional<rxtd::fft_utils::RealFft::Output> parseEnum<rxtd::fft_utils::RealFft::Output>(rxtd::isview name) {
+	using Output = rxtd::fft_utils::RealFft::Output;
+	if (name == L"Magnitude") {
+		return Output::eMAGNITUDE;
+	} else if (name == L"Power") {
+		return Output::ePOWER;
+	}
+	return {};
+}
@@ -11,7 +11,7 @@ using rxtd::fft_utils::WindowFunctionHelper;
 using rxtd::option_parsing::Option;
 using rxtd::option_parsing::OptionList;
 
-WindowFunctionHelper::WindowCreationFunc WindowFunctionHelper::parse(sview desc, option_parsing::OptionParser parser, Logger& cl) {
+WindowFunctionHelper::WindowCreationFunc WindowFunctionHelper::parse(sview desc, option_parsing::OptionParser parser, const Logger& cl) {
 	auto description = Option{ desc }.asSequence(L'(', L')', L',', false, cl);
 
 	if (description.isEmpty()) {
@@ -13,7 +13,7 @@ namespace rxtd::fft_utils {
 	public:
 		using WindowCreationFunc = std::function<void(array_span<float> result)>;
 
-		static WindowCreationFunc parse(sview desc, option_parsing::OptionParser parser, Logger& cl);
+		static WindowCreationFunc parse(sview desc, option_parsing::OptionParser parser, const Logger& cl);
 
 		/// <summary>
 		/// Create simple rectangular window.
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+#include <random>
+
+#include "rxtd/fft_utils/CascadeMixer.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace rxtd::test::fft_utils {
+	using namespace rxtd::fft_utils;
+
+	TEST_CLASS(CascadeMixer_test) {
+		static constexpr index cascadesCount = 6;
+		static constexpr index bandsCount = 200;
+
+		using Vector2D = std_fixes::Vector2D<float>;
+
+	public:
+		TEST_METHOD(Product) {
+			compareWithReference({ 0.0f, 2.5f, CascadeMixer::MixFunction::ePRODUCT });
+			compareWithReference({ 0.5f, 4.0f, CascadeMixer::MixFunction::ePRODUCT });
+			compareWithReference({ 100.0f, 2.5f, CascadeMixer::MixFunction::ePRODUCT });
+		}
+
+		TEST_METHOD(Average) {
+			compareWithReference({ 0.0f, 2.5f, CascadeMixer::MixFunction::eAVERAGE });
+			compareWithReference({ 0.5f, 4.0f, CascadeMixer::MixFunction::eAVERAGE });
+			compareWithReference({ 100.0f, 2.5f, CascadeMixer::MixFunction::eAVERAGE });
+		}
+
+		TEST_METHOD(TinyValuesDontUnderflow) {
+			const auto weights = generateWeights();
+			Vector2D values;
+			values.setBuffersCount(cascadesCount);
+			values.setBufferSize(bandsCount);
+			values.fill(1e-30f);
+
+			CascadeMixer mixer;
+			mixer.setParams({ 0.0f, 100.0f, CascadeMixer::MixFunction::ePRODUCT }, weights);
+			std::vector<float> result(static_cast<size_t>(bandsCount));
+			mixer.mix(getViews(values), result);
+
+			for (const float value : result) {
+				Assert::AreEqual(1e-30, static_cast<double>(value), 1e-35);
+			}
+		}
+
+	private:
+		// band covers more bins in each next cascade, like in BandResampler
+		static Vector2D generateWeights() {
+			Vector2D result;
+			result.setBuffersCount(cascadesCount);
+			result.setBufferSize(bandsCount);
+			for (index band = 0; band < bandsCount; band++) {
+				float weight = 0.05f * std::pow(1.03f, static_cast<float>(band));
+				for (index cascade = 0; cascade < cascadesCount; cascade++) {
+					result[cascade][band] = weight;
+					weight *= 2.0f;
+				}
+			}
+			return result;
+		}
+
+		static std::vector<array_view<float>> getViews(const Vector2D& values) {
+			std::vector<array_view<float>> result;
+			for (index cascade = 0; cascade < values.getBuffersCount(); cascade++) {
+				result.push_back(values[cascade]);
+			}
+			return result;
+		}
+
+		static void compareWithReference(CascadeMixer::Params params) {
+			const auto weights = generateWeights();
+
+			CascadeMixer mixer;
+			mixer.setParams(params, weights);
+
+			std::mt19937 random{ 42 };
+			std::uniform_real_distribution<float> distribution{ 0.0f, 1.0f };
+
+			Vector2D values;
+			values.setBuffersCount(cascadesCount);
+			values.setBufferSize(bandsCount);
+			std::vector<float> result(static_cast<size_t>(bandsCount));
+
+			// cascades starting from zeroCascade contain only zeros, like after a silence
+			for (index zeroCascade = 0; zeroCascade <= cascadesCount; zeroCascade++) {
+				for (index cascade = 0; cascade < cascadesCount; cascade++) {
+					for (float& value : values[cascade]) {
+						const float x = distribution(random);
+						// wide range of magnitudes, and some exact zeros
+						value = cascade >= zeroCascade || x < 0.05f ? 0.0f : std::pow(x, 8.0f);
+					}
+				}
+
+				mixer.mix(getViews(values), result);
+
+				for (index band = 0; band < bandsCount; band++) {
+					const double expected = computeReference(params, weights, values, band);
+					Assert::AreEqual(expected, static_cast<double>(result[static_cast<size_t>(band)]), std::abs(expected) * 1e-5);
+				}
+			}
+		}
+
+		// Straightforward per band implementation with double precision product
+		static double computeReference(CascadeMixer::Params params, const Vector2D& weights, const Vector2D& values, index band) {
+			float weight = 0.0f;
+			float cascadesSummed = 0.0f;
+
+			double valueProduct = 1.0;
+			float valueSum = 0.0f;
+
+			for (index cascade = 0; cascade < cascadesCount; cascade++) {
+				const float bandWeight = weights[cascade][band];
+				const float magnitude = values[cascade][band];
+				const auto cascadeValues = values[cascade];
+
+				if (*std::max_element(cascadeValues.begin(), cascadeValues.end()) == 0.0f) {
+					if (cascade == 0) {
+						return 0.0;
+					}
+					if (cascadesSummed == 0.0f) {
+						return values[cascade - 1][band];
+					}
+					break;
+				}
+
+				if (bandWeight <= params.minWeight) {
+					continue;
+				}
+
+				cascadesSummed += 1.0f;
+
+				valueProduct *= static_cast<double>(magnitude);
+				valueSum += magnitude;
+				weight += bandWeight;
+
+				if (weight >= params.targetWeight) {
+					break;
+				}
+			}
+
+			if (cascadesSummed == 0.0f) {
+				return values[cascadesCount - 1][band];
+			}
+
+			return params.mixFunction == CascadeMixer::MixFunction::ePRODUCT
+			       ? std::pow(valueProduct, 1.0 / static_cast<double>(cascadesSummed))
+			       : static_cast<double>(valueSum / cascadesSummed);
+		}
+	};
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+#include <random>
+
+#include "rxtd/fft_utils/FftCascade.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace rxtd::test::fft_utils {
+	using namespace rxtd::fft_utils;
+
+	TEST_CLASS(FftCascade_test) {
+		static constexpr index fftSize = 64;
+		static constexpr index inputStride = 24;
+
+		using Results = std::vector<std::vector<std::vector<float>>>;
+
+	public:
+		TEST_METHOD(SameAsDirectTransform) {
+			const auto wave = generateWave(fftSize * 10);
+			// chunks bigger than the buffer capacity are split inside of the cascade
+			const auto results = run(wave, { 1, 7, fftSize * 3 + 5, fftSize * 10 }, 1);
+
+			RealFft fft;
+			fft.setParams(fftSize, {});
+			std::vector<float> expected(static_cast<size_t>(fftSize / 2));
+
+			const auto& frames = results[0];
+			Assert::AreEqual(static_cast<size_t>((wave.size() - fftSize) / inputStride + 1), frames.size());
+			for (index frame = 0; frame < static_cast<index>(frames.size()); frame++) {
+				fft.process({ wave.data() + frame * inputStride, fftSize });
+				fft.fillMagnitudes(expected);
+				Assert::IsTrue(expected == frames[static_cast<size_t>(frame)]);
+			}
+		}
+
+		TEST_METHOD(ChunkSizeDoesntMatter) {
+			const auto wave = generateWave(fftSize * 20);
+			const auto whole = run(wave, { fftSize * 20 }, 3);
+			const auto small = run(wave, { 5, 1, 17, 3 }, 3);
+			const auto big = run(wave, { fftSize * 5 - 1, fftSize * 7 + 1 }, 3);
+
+			Assert::IsTrue(!whole[2].empty());
+			Assert::IsTrue(whole == small);
+			Assert::IsTrue(whole == big);
+		}
+
+	private:
+		static std::vector<float> generateWave(index size) {
+			std::mt19937 random{ 42 };
+			std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+			std::vector<float> result(static_cast<size_t>(size));
+			for (float& value : result) {
+				value = distribution(random);
+			}
+			return result;
+		}
+
+		// chunk sizes are repeated until the whole wave is processed
+		static Results run(const std::vector<float>& wave, std::vector<index> chunkSizes, index cascadesCount) {
+			Results results;
+			results.resize(static_cast<size_t>(cascadesCount));
+
+			FftCascade::Params params;
+			params.fftSize = fftSize;
+			params.samplesPerSec = 48000;
+			params.inputStride = inputStride;
+			params.callback = [&](array_view<float> values, index cascade) {
+				results[static_cast<size_t>(cascade)].emplace_back(values.begin(), values.end());
+			};
+
+			RealFft fft;
+			fft.setParams(fftSize, {});
+			std::vector<FftCascade> cascades;
+			cascades.resize(static_cast<size_t>(cascadesCount));
+			for (index i = 0; i < cascadesCount; i++) {
+				const auto next = i + 1 < cascadesCount ? &cascades[static_cast<size_t>(i + 1)] : nullptr;
+				cascades[static_cast<size_t>(i)].setParams(params, &fft, next, i);
+			}
+
+			index offset = 0;
+			for (index i = 0; offset < static_cast<index>(wave.size()); i++) {
+				const index chunkSize = std::min(chunkSizes[static_cast<size_t>(i) % chunkSizes.size()], static_cast<index>(wave.size()) - offset);
+				cascades[0].process({ wave.data() + offset, chunkSize }, FftCascade::clock::time_point::max());
+				offset += chunkSize;
+			}
+
+			return results;
+		}
+	};
+}
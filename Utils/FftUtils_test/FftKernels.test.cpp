@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+#include <random>
+
+#include "rxtd/fft_utils/FftKernels.h"
+#include "rxtd/fft_utils/RealFft.h"
+#include "rxtd/fft_utils/WindowFunctionHelper.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace rxtd::test::fft_utils {
+	using namespace rxtd::fft_utils;
+
+	TEST_CLASS(FftKernels_test) {
+		using InstructionSet = FftKernels::InstructionSet;
+
+	public:
+		TEST_METHOD(FallbackIsSupported) {
+			Assert::IsTrue(FftKernels::isSupported(FftKernels::getBestInstructionSet()));
+			Assert::IsTrue(FftKernels{}.getInstructionSet() == FftKernels::getBestInstructionSet());
+
+			for (const auto set : { InstructionSet::eSCALAR, InstructionSet::eSSE, InstructionSet::eAVX }) {
+				Assert::IsTrue(FftKernels::isSupported(FftKernels{ set }.getInstructionSet()));
+			}
+		}
+
+		TEST_METHOD(Window_SameAsScalar) {
+			const FftKernels scalar{ InstructionSet::eSCALAR };
+			// odd size checks the tail of vectorized loops
+			for (const index size : { 3, 32, 96, 1021 }) {
+				const auto wave = generateRandom(size, 1);
+				const auto window = generateRandom(size, 2);
+				std::vector<float> expected(static_cast<size_t>(size));
+				scalar.applyWindow(wave, window, expected);
+
+				forEachSupported([&](const FftKernels& kernels) {
+					std::vector<float> actual(static_cast<size_t>(size));
+					kernels.applyWindow(wave, window, actual);
+					assertEquals(expected, actual);
+				});
+			}
+		}
+
+		TEST_METHOD(Magnitudes_SameAsScalar) {
+			const FftKernels scalar{ InstructionSet::eSCALAR };
+			// 4 bins is less than AVX vector, 12 bins has an SSE tail after AVX
+			for (const index binsCount : { 4, 12, 16, 512 }) {
+				const auto packed = generateRandom(binsCount * 2, 3);
+				std::vector<float> expected(static_cast<size_t>(binsCount));
+				scalar.packedToMagnitudes(packed, 0.25f, expected);
+
+				forEachSupported([&](const FftKernels& kernels) {
+					std::vector<float> actual(static_cast<size_t>(binsCount));
+					kernels.packedToMagnitudes(packed, 0.25f, actual);
+					assertEquals(expected, actual);
+				});
+			}
+		}
+
+		TEST_METHOD(Power_SameAsScalar) {
+			const FftKernels scalar{ InstructionSet::eSCALAR };
+			for (const index binsCount : { 4, 12, 16, 512 }) {
+				const auto packed = generateRandom(binsCount * 2, 4);
+				std::vector<float> expected(static_cast<size_t>(binsCount));
+				scalar.packedToPower(packed, 0.25f, expected);
+
+				forEachSupported([&](const FftKernels& kernels) {
+					std::vector<float> actual(static_cast<size_t>(binsCount));
+					kernels.packedToPower(packed, 0.25f, actual);
+					assertEquals(expected, actual);
+				});
+			}
+		}
+
+		TEST_METHOD(ScalarLayout) {
+			// 4 real parts, then 4 imaginary parts
+			const std::vector<float> packed{ 3.0f, 0.0f, 1.0f, 0.0f, 4.0f, 2.0f, 0.0f, 0.0f };
+			std::vector<float> result(4);
+
+			FftKernels{ InstructionSet::eSCALAR }.packedToMagnitudes(packed, 2.0f, result);
+			assertEquals({ 10.0f, 4.0f, 2.0f, 0.0f }, result);
+
+			FftKernels{ InstructionSet::eSCALAR }.packedToPower(packed, 2.0f, result);
+			assertEquals({ 50.0f, 8.0f, 2.0f, 0.0f }, result);
+		}
+
+		TEST_METHOD(RealFft_PowerIsSquaredMagnitude) {
+			for (const index size : { 32, 96, 1024 }) {
+				std::vector<float> window(static_cast<size_t>(size));
+				WindowFunctionHelper::createCosineSum(window, 0.5f);
+				const auto wave = generateRandom(size, 5);
+				const index valuesCount = size / 2;
+
+				RealFft fft;
+				fft.setParams(size, window);
+				fft.process(wave);
+				std::vector<float> magnitudes(static_cast<size_t>(valuesCount));
+				fft.fillMagnitudes(magnitudes);
+
+				fft.setOutput(RealFft::Output::ePOWER);
+				fft.process(wave);
+				std::vector<float> power(static_cast<size_t>(valuesCount));
+				fft.fillMagnitudes(power);
+
+				for (index i = 0; i < valuesCount; i++) {
+					const float magnitude = magnitudes[static_cast<size_t>(i)];
+					Assert::AreEqual(magnitude * magnitude, power[static_cast<size_t>(i)], magnitude * magnitude * 1e-5f + 1e-12f);
+				}
+			}
+		}
+
+	private:
+		template<typename Callback>
+		static void forEachSupported(Callback callback) {
+			for (const auto set : { InstructionSet::eSCALAR, InstructionSet::eSSE, InstructionSet::eAVX }) {
+				if (FftKernels::isSupported(set)) {
+					callback(FftKernels{ set });
+				}
+			}
+		}
+
+		static std::vector<float> generateRandom(index size, unsigned seed) {
+			std::mt19937 random{ seed };
+			std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+			std::vector<float> result(static_cast<size_t>(size));
+			for (float& value : result) {
+				value = distribution(random);
+			}
+			return result;
+		}
+
+		static void assertEquals(const std::vector<float>& expected, const std::vector<float>& actual) {
+			Assert::AreEqual(expected.size(), actual.size());
+			for (size_t i = 0; i < expected.size(); i++) {
+				// all instruction sets do the same operations, so results must be exactly the same
+				Assert::AreEqual(expected[i], actual[i]);
+			}
+		}
+	};
+}
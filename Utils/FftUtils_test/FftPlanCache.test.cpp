@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+
+#include "rxtd/fft_utils/FftPlanCache.h"
+#include "rxtd/fft_utils/RealFft.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace rxtd::test::fft_utils {
+	using namespace rxtd::fft_utils;
+
+	TEST_CLASS(FftPlanCache_test) {
+		using Kind = FftPlanCache::Kind;
+		using Precision = FftPlanCache::Precision;
+
+	public:
+		TEST_METHOD(SameParamsSharePlan) {
+			const auto before = FftPlanCache::getStats();
+
+			const auto first = FftPlanCache::acquire(480, Kind::eREAL, Precision::eFLOAT);
+			const auto second = FftPlanCache::acquire(480, Kind::eREAL, Precision::eFLOAT);
+			Assert::IsTrue(first == second);
+
+			const auto after = FftPlanCache::getStats();
+			Assert::AreEqual(before.misses + 1, after.misses);
+			Assert::AreEqual(before.hits + 1, after.hits);
+			Assert::AreEqual(before.plansCount + 1, after.plansCount);
+			Assert::AreEqual(before.memorySize + first->getMemorySize(), after.memorySize);
+		}
+
+		TEST_METHOD(DifferentParamsDontSharePlan) {
+			const auto realFloat = FftPlanCache::acquire(960, Kind::eREAL, Precision::eFLOAT);
+			const auto realDouble = FftPlanCache::acquire(960, Kind::eREAL, Precision::eDOUBLE);
+			const auto complexFloat = FftPlanCache::acquire(960, Kind::eCOMPLEX, Precision::eFLOAT);
+			const auto otherSize = FftPlanCache::acquire(1920, Kind::eREAL, Precision::eFLOAT);
+
+			Assert::IsTrue(realFloat != realDouble);
+			Assert::IsTrue(realFloat != complexFloat);
+			Assert::IsTrue(realFloat != otherSize);
+			Assert::IsTrue(realDouble->getMemorySize() > realFloat->getMemorySize());
+			Assert::IsTrue(complexFloat->getMemorySize() > realFloat->getMemorySize());
+		}
+
+		TEST_METHOD(ReleasedPlanIsDestroyed) {
+			const auto before = FftPlanCache::getStats();
+			{
+				const auto plan = FftPlanCache::acquire(3840, Kind::eCOMPLEX, Precision::eDOUBLE);
+				Assert::AreEqual(before.plansCount + 1, FftPlanCache::getStats().plansCount);
+			}
+			const auto after = FftPlanCache::getStats();
+			Assert::AreEqual(before.plansCount, after.plansCount);
+			Assert::AreEqual(before.memorySize, after.memorySize);
+		}
+
+		TEST_METHOD(RealFftUsesCache) {
+			const auto before = FftPlanCache::getStats();
+
+			RealFft first;
+			first.setParams(7680, {});
+			RealFft second;
+			second.setParams(7680, {});
+
+			const auto after = FftPlanCache::getStats();
+			Assert::AreEqual(before.misses + 1, after.misses);
+			Assert::AreEqual(before.plansCount + 1, after.plansCount);
+		}
+	};
+}
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+#include "rxtd/fft_utils/FftSizeHelper.h"
+#include "rxtd/fft_utils/FftSizeTuner.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace rxtd::test::fft_utils {
+	using namespace rxtd::fft_utils;
+
+	TEST_CLASS(FftSizeTuner_test) {
+	public:
+		TEST_METHOD(CandidatesAreAllowedSizes) {
+			const auto candidates = FftSizeTuner::findCandidates(700, 1100, true);
+			// 2,3,5-smooth multiples of 32 in range
+			Assert::IsTrue(candidates == std::vector<index>{ 768, 800, 864, 960, 1024 });
+			for (const index size : candidates) {
+				Assert::AreEqual(size, FftSizeHelper::findNextAllowedLength(size, true));
+			}
+
+			Assert::IsTrue(FftSizeTuner::findCandidates(1030, 1100, true).empty());
+		}
+
+		TEST_METHOD(FastestIsCandidate) {
+			const index size = FftSizeTuner::findFastestSize({}, 400, 600, 0, true);
+			const auto candidates = FftSizeTuner::findCandidates(400, 600, true);
+			Assert::IsTrue(std::find(candidates.begin(), candidates.end(), size) != candidates.end());
+
+			Assert::AreEqual(index{ 777 }, FftSizeTuner::findFastestSize({}, 1030, 1100, 777, true));
+		}
+
+		TEST_METHOD(CacheFileIsUsed) {
+			const auto path = std::filesystem::temp_directory_path() / "FftSizeTuner_test.tsv";
+			{
+				// values that real measurements can't produce
+				std::ofstream stream{ path };
+				stream << "# cpu\tsize\tns per sample\n";
+				stream << FftSizeTuner::getCpuModel() << "\t960\t0.001\n";
+				stream << FftSizeTuner::getCpuModel() << "\t1024\t1000\n";
+				stream << "Other CPU\t1024\t0.0001\n";
+			}
+
+			Assert::AreEqual(index{ 960 }, FftSizeTuner::findFastestSize(path, 900, 1100, 0, true));
+			Assert::AreEqual(size_t{ 3 }, FftSizeTuner::getMeasurements(path).size());
+
+			// new sizes are measured and saved, other lines are kept
+			Assert::AreEqual(index{ 960 }, FftSizeTuner::findFastestSize(path, 900, 1300, 0, true));
+			const auto measurements = FftSizeTuner::getMeasurements(path);
+			Assert::AreEqual(3 + FftSizeTuner::findCandidates(1101, 1300, true).size(), measurements.size());
+
+			std::ifstream stream{ path };
+			index linesCount = 0;
+			std::string line;
+			while (std::getline(stream, line)) {
+				linesCount++;
+			}
+			Assert::AreEqual(static_cast<index>(measurements.size()) + 1, linesCount);
+
+			stream.close();
+			std::filesystem::remove(path);
+		}
+
+		TEST_METHOD(CachedSizeIsNotMeasured) {
+			// range that other tests don't measure
+			Assert::IsFalse(FftSizeTuner::findCachedFastestSize({}, 2000, 3000, 0, true).has_value());
+			Assert::IsTrue(FftSizeTuner::tune({}, 2000, 3000, true));
+
+			const auto cached = FftSizeTuner::findCachedFastestSize({}, 2000, 3000, 0, true);
+			Assert::IsTrue(cached.has_value());
+			Assert::AreEqual(FftSizeTuner::findFastestSize({}, 2000, 3000, 0, true), cached.value());
+		}
+
+		TEST_METHOD(CacheWriteErrorIsReported) {
+			const auto path = std::filesystem::temp_directory_path() / "FftSizeTuner_test_missing_folder" / "cache.tsv";
+			Assert::IsFalse(FftSizeTuner::tune(path, 2000, 3000, true));
+			// results are still used in this process
+			Assert::IsTrue(FftSizeTuner::findCachedFastestSize(path, 2000, 3000, 0, true).has_value());
+			Assert::IsTrue(FftSizeTuner::takeSaveError(path));
+			Assert::IsFalse(FftSizeTuner::takeSaveError(path));
+		}
+
+		TEST_METHOD(RequestedTuningIsDoneInBackground) {
+			// range that other tests don't measure
+			FftSizeTuner::requestTuning({}, 3100, 4000, true);
+			FftSizeTuner::requestTuning({}, 3100, 4000, true);
+
+			std::optional<index> cached;
+			const auto stopTime = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+			while (!cached.has_value() && std::chrono::steady_clock::now() < stopTime) {
+				std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+				cached = FftSizeTuner::findCachedFastestSize({}, 3100, 4000, 0, true);
+			}
+			Assert::IsTrue(cached.has_value());
+		}
+	};
+}
@@ -41,7 +41,51 @@ namespace rxtd::test::fft_utils {
 			testForward(1024, 511, 1.0e-4f);
 		}
 
+		TEST_METHOD(Batch_SameAsSingle) {
+			for (const index size : { 32, 96, 1024 }) {
+				testBatch(size, std::vector<float>{});
+
+				std::vector<float> hann;
+				hann.resize(static_cast<size_t>(size));
+				WindowFunctionHelper::createCosineSum(hann, 0.5f);
+				testBatch(size, hann);
+			}
+		}
+
 	private:
+		void testBatch(index size, const std::vector<float>& window) {
+			constexpr index framesCount = 5;
+			const index valuesCount = size / 2;
+
+			// overlapping frames, like in FftCascade
+			wave.resize(static_cast<size_t>(size * 2));
+			generateSinWave(wave, 7.0f);
+			for (index i = 0; i < static_cast<index>(wave.size()); i++) {
+				wave[static_cast<size_t>(i)] += 0.001f * static_cast<float>(i);
+			}
+			const index stride = size / 4;
+
+			fft.setParams(size, window);
+
+			std::vector<array_view<float>> frames;
+			for (index i = 0; i < framesCount; i++) {
+				frames.emplace_back(wave.data() + i * stride, size);
+			}
+			std::vector<float> batchResult;
+			batchResult.resize(static_cast<size_t>(framesCount * valuesCount));
+			fft.processBatch(frames, batchResult);
+
+			frequencies.resize(static_cast<size_t>(valuesCount));
+			for (index frame = 0; frame < framesCount; frame++) {
+				fft.process(frames[frame]);
+				fft.fillMagnitudes(frequencies);
+
+				for (index i = 0; i < valuesCount; i++) {
+					Assert::AreEqual(frequencies[static_cast<size_t>(i)], batchResult[static_cast<size_t>(frame * valuesCount + i)]);
+				}
+			}
+		}
+
 		void doForward(index size, index desiredWaveSinCount) {
 			wave.resize(static_cast<size_t>(size));
 			generateSinWave(wave, static_cast<float>(desiredWaveSinCount));
@@ -50,16 +50,6 @@ namespace rxtd::buffer_printer {
 		}
 	}
 
-	template<typename T>
-	void writeType(std::wostream& stream, const std::vector<T>& array, sview options) {
-		writeType(stream, array_view<T>{ array }, options);
-	}
-
-	template<typename T>
-	void writeType(std::wostream& stream, array_span<T> array, sview options) {
-		writeType(stream, array_view<T>{ array }, options);
-	}
-
 	template<typename T>
 	void writeType(std::wostream& stream, array_view<T> array, sview options) {
 		if (!array.empty()) {
@@ -75,6 +65,16 @@ namespace rxtd::buffer_printer {
 		}
 	}
 
+	template<typename T>
+	void writeType(std::wostream& stream, const std::vector<T>& array, sview options) {
+		writeType(stream, array_view<T>{ array }, options);
+	}
+
+	template<typename T>
+	void writeType(std::wostream& stream, array_span<T> array, sview options) {
+		writeType(stream, array_view<T>{ array }, options);
+	}
+
 	//
 	// Type-safe analogue of printf.
 	// Use format string and a list of arguments.
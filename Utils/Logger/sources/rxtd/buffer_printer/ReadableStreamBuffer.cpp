@@ -23,6 +23,12 @@ rxtd::sview ReadableStreamBuffer::getBuffer() {
 }
 
 void ReadableStreamBuffer::resetPointers() {
+	if (buffer.empty()) {
+		// first write will call overflow() and allocate the buffer
+		setp(nullptr, nullptr);
+		return;
+	}
+
 	char_type* buf = buffer.data();
 	// buffer.size() - 1 because we need size for '\0' symbol at the end
 	setp(buf, buf + buffer.size() - 1);
@@ -71,7 +71,7 @@ namespace rxtd::option_parsing {
 			template<typename T, typename ... Args>
 			T solveCustom(const Args& ...args) {
 				// ReSharper disable once CppStaticAssertFailure
-				static_assert(false, "unknown custom type");
+				static_assert(sizeof(T) == 0, "unknown custom type");
 				return {};
 			}
 
@@ -103,7 +103,7 @@ namespace rxtd::option_parsing {
 					return static_cast<T>(parent.parseFloatImpl(source, loggerPrefix));
 				} else {
 					// ReSharper disable once CppStaticAssertFailure
-					static_assert(false, "unknown type");
+					static_assert(sizeof(T) == 0, "unknown type");
 					return {};
 				}
 			}
@@ -4,6 +4,8 @@
 #pragma once
 
 namespace rxtd::filter_utils {
+	struct BiquadCoefficients;
+
 	class AbstractFilter {
 	public:
 		virtual ~AbstractFilter() = default;
@@ -11,5 +13,13 @@ namespace rxtd::filter_utils {
 		virtual void apply(array_span<float> signal) = 0;
 
 		virtual void addGainDbEnergy(double gainDB) = 0;
+
+		/// <summary>
+		/// Appends coefficients of the filter to sections and multiplies gainAmp by the gain of the filter.
+		/// Returns false when the filter can't be described as a chain of second order sections.
+		/// </summary>
+		virtual bool exportSections(std::vector<BiquadCoefficients>& sections, double& gainAmp) const {
+			return false;
+		}
 	};
 }
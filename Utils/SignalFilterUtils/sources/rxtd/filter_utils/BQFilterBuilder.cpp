@@ -117,3 +117,48 @@ BiQuadIIR BQFilterBuilder::createPeak(double samplingFrequency, double q, double
 		1 - alpha * a,
 	};
 }
+
+BiQuadIIR BQFilterBuilder::createKWeightingShelf(double samplingFrequency) {
+	if (samplingFrequency == 0.0) {
+		return {};
+	}
+
+	const double centralFrequency = 1681.974450955533;
+	const double dbGain = 3.999843853973347;
+	const double q = 0.7071752369554196;
+
+	const double k = std::tan(MyMath::pi<double>() * centralFrequency / samplingFrequency);
+	const double vh = std::pow(10.0, dbGain / 20.0);
+	const double vb = std::pow(vh, 0.4996667741545416);
+
+	return {
+		1.0 + k / q + k * k,
+		2.0 * (k * k - 1.0),
+		1.0 - k / q + k * k,
+		vh + vb * k / q + k * k,
+		2.0 * (k * k - vh),
+		vh - vb * k / q + k * k,
+	};
+}
+
+BiQuadIIR BQFilterBuilder::createKWeightingHighPass(double samplingFrequency) {
+	if (samplingFrequency == 0.0) {
+		return {};
+	}
+
+	const double centralFrequency = 38.13547087602444;
+	const double q = 0.5003270373238773;
+
+	const double k = std::tan(MyMath::pi<double>() * centralFrequency / samplingFrequency);
+
+	// BS.1770 uses unnormalized numerator 1, -2, 1 for this stage
+	const double a0 = 1.0 + k / q + k * k;
+	return {
+		a0,
+		2.0 * (k * k - 1.0),
+		1.0 - k / q + k * k,
+		a0,
+		-2.0 * a0,
+		a0,
+	};
+}
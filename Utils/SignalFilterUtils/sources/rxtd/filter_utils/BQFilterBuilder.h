@@ -32,5 +32,21 @@ namespace rxtd::filter_utils {
 
 		[[nodiscard]]
 		static BiQuadIIR createPeak(double samplingFrequency, double q, double centralFrequency, double dbGain);
+
+		// K-weighting from ITU-R BS.1770 is not from the cookbook:
+		// filters are the analog prototypes of BS.1770 coefficients for 48 kHz,
+		// converted with bilinear transform, so they match the standard exactly at 48 kHz.
+
+		/// <summary>
+		/// First stage of K-weighting: high shelf of about +4 dB, modeling the acoustic effect of the head.
+		/// </summary>
+		[[nodiscard]]
+		static BiQuadIIR createKWeightingShelf(double samplingFrequency);
+
+		/// <summary>
+		/// Second stage of K-weighting: RLB high pass.
+		/// </summary>
+		[[nodiscard]]
+		static BiQuadIIR createKWeightingHighPass(double samplingFrequency);
 	};
 }
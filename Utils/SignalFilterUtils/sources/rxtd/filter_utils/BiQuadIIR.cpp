@@ -2,9 +2,11 @@
 // Copyright (C) 2020 Danil Uzlov
 
 #include "BiQuadIIR.h"
+#include "BiquadCascade.h"
 #include "rxtd/std_fixes/MyMath.h"
 
 using rxtd::filter_utils::BiQuadIIR;
+using rxtd::filter_utils::BiquadCoefficients;
 using rxtd::std_fixes::MyMath;
 
 BiQuadIIR::BiQuadIIR(double _a0, double _a1, double _a2, double _b0, double _b1, double _b2) {
@@ -31,3 +33,9 @@ void BiQuadIIR::addGainDbEnergy(double gainDB) {
 	const double gain = MyMath::db2amplitude(gainDB * 0.5);
 	gainAmp *= gain;
 }
+
+bool BiQuadIIR::exportSections(std::vector<BiquadCoefficients>& sections, double& gainAmp) const {
+	sections.push_back({ b0, b1, b2, a1, a2 });
+	gainAmp *= this->gainAmp;
+	return true;
+}
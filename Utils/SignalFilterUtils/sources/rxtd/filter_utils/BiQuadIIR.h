@@ -26,5 +26,7 @@ namespace rxtd::filter_utils {
 		void apply(array_span<float> signal) override;
 
 		void addGainDbEnergy(double gainDB) override;
+
+		bool exportSections(std::vector<BiquadCoefficients>& sections, double& gainAmp) const override;
 	};
 }
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "BiquadCascade.h"
+
+#include "rxtd/std_fixes/MyMath.h"
+
+using rxtd::filter_utils::BiquadCascade;
+using rxtd::std_fixes::MyMath;
+
+BiquadCascade::BiquadCascade(array_view<BiquadCoefficients> coefficients, double gainAmp) {
+	for (const auto& c : coefficients) {
+		Section section;
+		section.b0 = static_cast<float>(c.b0);
+		section.b1 = static_cast<float>(c.b1);
+		section.b2 = static_cast<float>(c.b2);
+		section.a1 = static_cast<float>(c.a1);
+		section.a2 = static_cast<float>(c.a2);
+		sections.push_back(section);
+	}
+
+	this->gainAmp = static_cast<float>(gainAmp);
+}
+
+void BiquadCascade::apply(array_span<float> signal) {
+	const index sectionsCount = static_cast<index>(sections.size());
+
+	index sectionIndex = 0;
+	for (; sectionIndex + 1 < sectionsCount; sectionIndex += 2) {
+		Section& first = sections[static_cast<size_t>(sectionIndex)];
+		Section& second = sections[static_cast<size_t>(sectionIndex + 1)];
+
+		// local copies let the compiler keep everything in registers
+		const float b0 = first.b0, b1 = first.b1, b2 = first.b2, a1 = first.a1, a2 = first.a2;
+		const float c0 = second.b0, c1 = second.b1, c2 = second.b2, d1 = second.a1, d2 = second.a2;
+		float s0 = first.state0, s1 = first.state1;
+		float t0 = second.state0, t1 = second.state1;
+
+		for (float& value : signal) {
+			const float in = value;
+			const float mid = b0 * in + s0;
+			s0 = b1 * in - a1 * mid + s1;
+			s1 = b2 * in - a2 * mid;
+
+			const float out = c0 * mid + t0;
+			t0 = c1 * mid - d1 * out + t1;
+			t1 = c2 * mid - d2 * out;
+
+			value = out;
+		}
+
+		first.state0 = s0;
+		first.state1 = s1;
+		second.state0 = t0;
+		second.state1 = t1;
+	}
+
+	if (sectionIndex < sectionsCount) {
+		Section& section = sections[static_cast<size_t>(sectionIndex)];
+
+		const float b0 = section.b0, b1 = section.b1, b2 = section.b2, a1 = section.a1, a2 = section.a2;
+		float s0 = section.state0, s1 = section.state1;
+
+		for (float& value : signal) {
+			const float in = value;
+			const float out = b0 * in + s0;
+			s0 = b1 * in - a1 * out + s1;
+			s1 = b2 * in - a2 * out;
+			value = out;
+		}
+
+		section.state0 = s0;
+		section.state1 = s1;
+	}
+
+	if (gainAmp != 1.0f) {
+		for (float& value : signal) {
+			value *= gainAmp;
+		}
+	}
+}
+
+void BiquadCascade::reset() {
+	for (auto& section : sections) {
+		section.state0 = 0.0f;
+		section.state1 = 0.0f;
+	}
+}
+
+void BiquadCascade::addGainDbEnergy(double gainDB) {
+	gainAmp *= static_cast<float>(MyMath::db2amplitude(gainDB * 0.5));
+}
+
+bool BiquadCascade::exportSections(std::vector<BiquadCoefficients>& result, double& resultGainAmp) const {
+	for (const auto& section : sections) {
+		result.push_back({ section.b0, section.b1, section.b2, section.a1, section.a2 });
+	}
+	resultGainAmp *= gainAmp;
+	return true;
+}
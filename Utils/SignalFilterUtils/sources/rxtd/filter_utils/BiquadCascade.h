@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "AbstractFilter.h"
+
+namespace rxtd::filter_utils {
+	/// <summary>
+	/// Coefficients of one second order section, normalized so that a0 == 1.
+	/// First order sections have b2 == a2 == 0.
+	/// </summary>
+	struct BiquadCoefficients {
+		double b0{};
+		double b1{};
+		double b2{};
+		double a1{};
+		double a2{};
+	};
+
+	/// <summary>
+	/// High order IIR filter as a chain of second order sections.
+	/// Unlike InfiniteResponseFilter, each section only has 2 poles,
+	/// so rounding errors in coefficients don't move poles far enough to make the filter unstable,
+	/// and the filter can run in float.
+	///
+	/// Signal is processed in blocks: each pass over the block applies 2 sections,
+	/// which halves memory traffic compared to applying sections one by one.
+	/// </summary>
+	class BiquadCascade : public AbstractFilter {
+		// inspired by https://docs.scipy.org/doc/scipy/reference/generated/scipy.signal.sosfilt.html
+
+		struct Section {
+			float b0{};
+			float b1{};
+			float b2{};
+			float a1{};
+			float a2{};
+
+			float state0{};
+			float state1{};
+		};
+
+		std::vector<Section> sections;
+		float gainAmp = 1.0f;
+
+	public:
+		BiquadCascade() = default;
+		BiquadCascade(array_view<BiquadCoefficients> coefficients, double gainAmp);
+
+		void apply(array_span<float> signal) override;
+
+		void reset();
+
+		void addGainDbEnergy(double gainDB) override;
+
+		bool exportSections(std::vector<BiquadCoefficients>& result, double& resultGainAmp) const override;
+
+		[[nodiscard]]
+		index getSectionsCount() const {
+			return static_cast<index>(sections.size());
+		}
+	};
+}
@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "BlockKernels.h"
+
+#include "rxtd/std_fixes/CpuFeatures.h"
+
+using rxtd::filter_utils::BlockKernels;
+using rxtd::std_fixes::CpuFeatures;
+
+namespace {
+	using rxtd::index;
+
+	constexpr index lanesCount = 8;
+
+	double combineLanes(const double* lanes) {
+		const double s0 = lanes[0] + lanes[4];
+		const double s1 = lanes[1] + lanes[5];
+		const double s2 = lanes[2] + lanes[6];
+		const double s3 = lanes[3] + lanes[7];
+		return (s0 + s2) + (s1 + s3);
+	}
+
+	float combineLanes(const float* lanes) {
+		const float s0 = std::max(lanes[0], lanes[4]);
+		const float s1 = std::max(lanes[1], lanes[5]);
+		const float s2 = std::max(lanes[2], lanes[6]);
+		const float s3 = std::max(lanes[3], lanes[7]);
+		return std::max(std::max(s0, s2), std::max(s1, s3));
+	}
+
+	double sumOfSquaresTail(const float* wave, index size, double result) {
+		for (index i = 0; i < size; i++) {
+			const float x = wave[i];
+			result += static_cast<double>(x * x);
+		}
+		return result;
+	}
+
+	float maxAbsTail(const float* wave, index size, float result) {
+		for (index i = 0; i < size; i++) {
+			result = std::max(result, std::abs(wave[i]));
+		}
+		return result;
+	}
+
+	// values starting from #begin
+	void weightedSumTail(const float* const* sources, const float* weights, index sourcesCount, float* dest, index begin, index size) {
+		for (index i = begin; i < size; i++) {
+			float sum = sources[0][i] * weights[0];
+			for (index j = 1; j < sourcesCount; j++) {
+				sum += sources[j][i] * weights[j];
+			}
+			dest[i] = sum;
+		}
+	}
+
+	double sumOfSquaresScalar(const float* wave, index size) {
+		double lanes[lanesCount]{};
+		index i = 0;
+		for (; i + lanesCount <= size; i += lanesCount) {
+			for (index lane = 0; lane < lanesCount; lane++) {
+				const float x = wave[i + lane];
+				lanes[lane] += static_cast<double>(x * x);
+			}
+		}
+		return sumOfSquaresTail(wave + i, size - i, combineLanes(lanes));
+	}
+
+	float maxAbsScalar(const float* wave, index size) {
+		float lanes[lanesCount]{};
+		index i = 0;
+		for (; i + lanesCount <= size; i += lanesCount) {
+			for (index lane = 0; lane < lanesCount; lane++) {
+				lanes[lane] = std::max(lanes[lane], std::abs(wave[i + lane]));
+			}
+		}
+		return maxAbsTail(wave + i, size - i, combineLanes(lanes));
+	}
+
+	void weightedSumScalar(const float* const* sources, const float* weights, index sourcesCount, float* dest, index size) {
+		weightedSumTail(sources, weights, sourcesCount, dest, 0, size);
+	}
+
+#ifdef RXTD_X86
+	double sumOfSquaresSse(const float* wave, index size) {
+		// lanes 0-1, 2-3, 4-5, 6-7
+		__m128d acc0 = _mm_setzero_pd();
+		__m128d acc1 = _mm_setzero_pd();
+		__m128d acc2 = _mm_setzero_pd();
+		__m128d acc3 = _mm_setzero_pd();
+
+		index i = 0;
+		for (; i + lanesCount <= size; i += lanesCount) {
+			const __m128 a = _mm_loadu_ps(wave + i);
+			const __m128 b = _mm_loadu_ps(wave + i + 4);
+			const __m128 a2 = _mm_mul_ps(a, a);
+			const __m128 b2 = _mm_mul_ps(b, b);
+			acc0 = _mm_add_pd(acc0, _mm_cvtps_pd(a2));
+			acc1 = _mm_add_pd(acc1, _mm_cvtps_pd(_mm_movehl_ps(a2, a2)));
+			acc2 = _mm_add_pd(acc2, _mm_cvtps_pd(b2));
+			acc3 = _mm_add_pd(acc3, _mm_cvtps_pd(_mm_movehl_ps(b2, b2)));
+		}
+
+		double lanes[lanesCount];
+		_mm_storeu_pd(lanes + 0, acc0);
+		_mm_storeu_pd(lanes + 2, acc1);
+		_mm_storeu_pd(lanes + 4, acc2);
+		_mm_storeu_pd(lanes + 6, acc3);
+		return sumOfSquaresTail(wave + i, size - i, combineLanes(lanes));
+	}
+
+	float maxAbsSse(const float* wave, index size) {
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		__m128 acc0 = _mm_setzero_ps();
+		__m128 acc1 = _mm_setzero_ps();
+
+		index i = 0;
+		for (; i + lanesCount <= size; i += lanesCount) {
+			acc0 = _mm_max_ps(acc0, _mm_andnot_ps(signMask, _mm_loadu_ps(wave + i)));
+			acc1 = _mm_max_ps(acc1, _mm_andnot_ps(signMask, _mm_loadu_ps(wave + i + 4)));
+		}
+
+		float lanes[lanesCount];
+		_mm_storeu_ps(lanes + 0, acc0);
+		_mm_storeu_ps(lanes + 4, acc1);
+		return maxAbsTail(wave + i, size - i, combineLanes(lanes));
+	}
+
+	// each block of the output is written once, after all sources are read,
+	// so dest can be one of the sources
+	void weightedSumSse(const float* const* sources, const float* weights, index sourcesCount, float* dest, index size) {
+		index i = 0;
+		for (; i + lanesCount <= size; i += lanesCount) {
+			__m128 w = _mm_set1_ps(weights[0]);
+			__m128 acc0 = _mm_mul_ps(_mm_loadu_ps(sources[0] + i), w);
+			__m128 acc1 = _mm_mul_ps(_mm_loadu_ps(sources[0] + i + 4), w);
+			for (index j = 1; j < sourcesCount; j++) {
+				w = _mm_set1_ps(weights[j]);
+				acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(sources[j] + i), w));
+				acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(sources[j] + i + 4), w));
+			}
+			_mm_storeu_ps(dest + i, acc0);
+			_mm_storeu_ps(dest + i + 4, acc1);
+		}
+		weightedSumTail(sources, weights, sourcesCount, dest, i, size);
+	}
+
+	RXTD_TARGET_AVX
+	double sumOfSquaresAvx(const float* wave, index size) {
+		// lanes 0-3, 4-7
+		__m256d acc0 = _mm256_setzero_pd();
+		__m256d acc1 = _mm256_setzero_pd();
+
+		index i = 0;
+		for (; i + lanesCount <= size; i += lanesCount) {
+			const __m128 a = _mm_loadu_ps(wave + i);
+			const __m128 b = _mm_loadu_ps(wave + i + 4);
+			acc0 = _mm256_add_pd(acc0, _mm256_cvtps_pd(_mm_mul_ps(a, a)));
+			acc1 = _mm256_add_pd(acc1, _mm256_cvtps_pd(_mm_mul_ps(b, b)));
+		}
+
+		double lanes[lanesCount];
+		_mm256_storeu_pd(lanes + 0, acc0);
+		_mm256_storeu_pd(lanes + 4, acc1);
+		return sumOfSquaresTail(wave + i, size - i, combineLanes(lanes));
+	}
+
+	RXTD_TARGET_AVX
+	float maxAbsAvx(const float* wave, index size) {
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+		// 2 independent accumulators hide latency of max
+		__m256 acc0 = _mm256_setzero_ps();
+		__m256 acc1 = _mm256_setzero_ps();
+
+		index i = 0;
+		for (; i + lanesCount * 2 <= size; i += lanesCount * 2) {
+			acc0 = _mm256_max_ps(acc0, _mm256_andnot_ps(signMask, _mm256_loadu_ps(wave + i)));
+			acc1 = _mm256_max_ps(acc1, _mm256_andnot_ps(signMask, _mm256_loadu_ps(wave + i + lanesCount)));
+		}
+		if (i + lanesCount <= size) {
+			acc0 = _mm256_max_ps(acc0, _mm256_andnot_ps(signMask, _mm256_loadu_ps(wave + i)));
+			i += lanesCount;
+		}
+
+		// max doesn't depend on the order, so merging accumulators doesn't change the result
+		float lanes[lanesCount];
+		_mm256_storeu_ps(lanes, _mm256_max_ps(acc0, acc1));
+		return maxAbsTail(wave + i, size - i, combineLanes(lanes));
+	}
+
+	// products are added separately, without FMA, to get the same results as other instruction sets
+	RXTD_TARGET_AVX
+	void weightedSumAvx(const float* const* sources, const float* weights, index sourcesCount, float* dest, index size) {
+		index i = 0;
+		for (; i + lanesCount * 2 <= size; i += lanesCount * 2) {
+			__m256 w = _mm256_set1_ps(weights[0]);
+			__m256 acc0 = _mm256_mul_ps(_mm256_loadu_ps(sources[0] + i), w);
+			__m256 acc1 = _mm256_mul_ps(_mm256_loadu_ps(sources[0] + i + lanesCount), w);
+			for (index j = 1; j < sourcesCount; j++) {
+				w = _mm256_set1_ps(weights[j]);
+				acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(sources[j] + i), w));
+				acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(sources[j] + i + lanesCount), w));
+			}
+			_mm256_storeu_ps(dest + i, acc0);
+			_mm256_storeu_ps(dest + i + lanesCount, acc1);
+		}
+		if (i + lanesCount <= size) {
+			__m256 acc = _mm256_mul_ps(_mm256_loadu_ps(sources[0] + i), _mm256_set1_ps(weights[0]));
+			for (index j = 1; j < sourcesCount; j++) {
+				acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(sources[j] + i), _mm256_set1_ps(weights[j])));
+			}
+			_mm256_storeu_ps(dest + i, acc);
+			i += lanesCount;
+		}
+		weightedSumTail(sources, weights, sourcesCount, dest, i, size);
+	}
+#endif
+}
+
+BlockKernels::BlockKernels(InstructionSet value) {
+	if (!isSupported(value)) {
+		value = getBestInstructionSet();
+	}
+	instructionSet = value;
+
+	switch (value) {
+	case InstructionSet::eSCALAR:
+		sumOfSquaresFunction = sumOfSquaresScalar;
+		maxAbsFunction = maxAbsScalar;
+		weightedSumFunction = weightedSumScalar;
+		break;
+#ifdef RXTD_X86
+	case InstructionSet::eSSE:
+		sumOfSquaresFunction = sumOfSquaresSse;
+		maxAbsFunction = maxAbsSse;
+		weightedSumFunction = weightedSumSse;
+		break;
+	case InstructionSet::eAVX:
+		sumOfSquaresFunction = sumOfSquaresAvx;
+		maxAbsFunction = maxAbsAvx;
+		weightedSumFunction = weightedSumAvx;
+		break;
+#endif
+	default: break;
+	}
+}
+
+bool BlockKernels::isSupported(InstructionSet value) {
+	switch (value) {
+	case InstructionSet::eSCALAR: return true;
+#ifdef RXTD_X86
+	case InstructionSet::eSSE: return true;
+	case InstructionSet::eAVX: return CpuFeatures::hasAvx();
+#endif
+	default: return false;
+	}
+}
+
+BlockKernels::InstructionSet BlockKernels::getBestInstructionSet() {
+	if (isSupported(InstructionSet::eAVX)) {
+		return InstructionSet::eAVX;
+	}
+	if (isSupported(InstructionSet::eSSE)) {
+		return InstructionSet::eSSE;
+	}
+	return InstructionSet::eSCALAR;
+}
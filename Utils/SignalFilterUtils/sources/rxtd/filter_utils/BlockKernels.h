@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+
+namespace rxtd::filter_utils {
+	/// <summary>
+	/// Vectorized reductions of blocks of the wave, for RMS and peak,
+	/// and weighted sums of several waves, for downmixing.
+	///
+	/// Instruction set is chosen at runtime, like in fft_utils::FftKernels.
+	/// Values are reduced in 8 interleaved lanes, which are then summed in a fixed order,
+	/// so all instruction sets do the same operations and results don't depend on the CPU.
+	/// Squares are computed in float and summed in double, like in a plain loop.
+	/// </summary>
+	class BlockKernels {
+	public:
+		// parts shorter than this are reduced inline, without vector code
+		static constexpr index shortSize = 8;
+
+		enum class InstructionSet {
+			eSCALAR,
+			eSSE,
+			eAVX,
+		};
+
+	private:
+		using SumFunction = double(*)(const float* wave, index size);
+		using MaxFunction = float(*)(const float* wave, index size);
+		using WeightedSumFunction = void(*)(const float* const* sources, const float* weights, index sourcesCount, float* dest, index size);
+
+		InstructionSet instructionSet = InstructionSet::eSCALAR;
+		SumFunction sumOfSquaresFunction = nullptr;
+		MaxFunction maxAbsFunction = nullptr;
+		WeightedSumFunction weightedSumFunction = nullptr;
+
+	public:
+		/// <summary>
+		/// Uses the best instruction set that current CPU supports.
+		/// </summary>
+		BlockKernels() : BlockKernels(getBestInstructionSet()) { }
+
+		/// <summary>
+		/// Falls back to the best supported instruction set if value is not supported.
+		/// </summary>
+		explicit BlockKernels(InstructionSet value);
+
+		[[nodiscard]]
+		InstructionSet getInstructionSet() const {
+			return instructionSet;
+		}
+
+		[[nodiscard]]
+		static bool isSupported(InstructionSet value);
+
+		[[nodiscard]]
+		static InstructionSet getBestInstructionSet();
+
+		/// <summary>
+		/// Sum of wave[i]^2.
+		/// </summary>
+		[[nodiscard]]
+		double sumOfSquares(array_view<float> wave) const {
+			if (wave.size() < shortSize) {
+				double result = 0.0;
+				for (const float x : wave) {
+					result += static_cast<double>(x * x);
+				}
+				return result;
+			}
+			return sumOfSquaresFunction(wave.data(), wave.size());
+		}
+
+		/// <summary>
+		/// Max of |wave[i]|, 0 for empty wave.
+		/// </summary>
+		[[nodiscard]]
+		float maxAbs(array_view<float> wave) const {
+			if (wave.size() < shortSize) {
+				float result = 0.0f;
+				for (const float x : wave) {
+					result = std::max(result, std::abs(x));
+				}
+				return result;
+			}
+			return maxAbsFunction(wave.data(), wave.size());
+		}
+
+		/// <summary>
+		/// dest[i] = sources[0][i] * weights[0] + sources[1][i] * weights[1] + ...
+		/// Products are added in the order of sources, like in a plain loop.
+		/// Each source must have at least dest.size() values.
+		/// Dest can be one of the sources.
+		/// </summary>
+		void weightedSum(array_view<const float*> sources, array_view<float> weights, array_span<float> dest) const {
+			if (sources.empty()) {
+				std::fill(dest.begin(), dest.end(), 0.0f);
+				return;
+			}
+			weightedSumFunction(sources.data(), weights.data(), sources.size(), dest.data(), dest.size());
+		}
+	};
+}
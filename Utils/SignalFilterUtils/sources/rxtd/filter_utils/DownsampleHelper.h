@@ -4,20 +4,38 @@
 #pragma once
 #include "rxtd/GrowingVector.h"
 #include "rxtd/filter_utils/InfiniteResponseFilter.h"
+#include "rxtd/filter_utils/PolyphaseDecimator.h"
+#include "rxtd/filter_utils/RationalResampler.h"
 #include "rxtd/filter_utils/butterworth_lib/ButterworthWrapper.h"
 
 namespace rxtd::filter_utils {
 	class DownsampleHelper {
+	public:
+		enum class Method {
+			// Butterworth filters at the original sample rate, then every N-th sample is taken
+			eIIR,
+			// FIR stages that only compute samples that are kept, see PolyphaseDecimator
+			ePOLYPHASE,
+			// polyphase FIR for any rational ratio, see RationalResampler
+			eRATIONAL,
+		};
+
+	private:
 		using ButterworthWrapper = butterworth_lib::ButterworthWrapper;
 		
 		constexpr static index filterOrder = 10;
 		constexpr static index filterSize = ButterworthWrapper::oneSideSlopeSize(filterOrder);
 
+		Method method = Method::eIIR;
 		index decimateFactor = 0;
+		index upsampleFactor = 1;
+		// in polyphase and rational modes contains already resampled data
 		GrowingVector<float> buffer;
 		InfiniteResponseFilterFixed<filterSize> filter1;
 		InfiniteResponseFilterFixed<filterSize> filter2;
 		InfiniteResponseFilterFixed<filterSize> filter3;
+		PolyphaseDecimator polyphase;
+		RationalResampler rational;
 
 	public:
 		DownsampleHelper() {
@@ -29,16 +47,36 @@ namespace rxtd::filter_utils {
 		}
 
 		void setFactor(index value) {
-			if (value == decimateFactor) {
+			setRatio(1, value);
+		}
+
+		/// <summary>
+		/// Output sample rate is input rate * up / down.
+		/// Only Rational method supports up other than 1.
+		/// </summary>
+		void setRatio(index up, index down) {
+			if (up == upsampleFactor && down == decimateFactor) {
 				return;
 			}
 
-			decimateFactor = value;
-			// digital frequency of 0.95 / decimateFactor ensures strong cutoff at new nyquist frequency
-			const double digitalCutoff = 0.95 / static_cast<double>(decimateFactor);
-			filter1 = { ButterworthWrapper::lowPass.calcCoefDigital(filterOrder, digitalCutoff) };
-			filter2 = filter1;
-			filter3 = filter1;
+			upsampleFactor = up;
+			decimateFactor = down;
+			updateFilters();
+		}
+
+		void setMethod(Method value) {
+			if (value == method) {
+				return;
+			}
+
+			method = value;
+			buffer.reset();
+			updateFilters();
+		}
+
+		[[nodiscard]]
+		Method getMethod() const {
+			return method;
 		}
 
 		// returns size of the buffer required to grab all of the data downsampled
@@ -46,6 +84,12 @@ namespace rxtd::filter_utils {
 		index pushData(array_view<float> source) {
 			buffer.compact();
 
+			if (method == Method::ePOLYPHASE || method == Method::eRATIONAL) {
+				const auto result = method == Method::ePOLYPHASE ? polyphase.process(source) : rational.process(source);
+				result.transferToSpan(buffer.allocateNext(result.size()));
+				return buffer.getRemainingSize();
+			}
+
 			auto chunk = buffer.allocateNext(source.size());
 			source.transferToSpan(chunk);
 			filter1.apply(chunk);
@@ -57,6 +101,10 @@ namespace rxtd::filter_utils {
 
 		// returns count of downsampled elements
 		index downsample(array_span<float> dest) {
+			if (method == Method::ePOLYPHASE || method == Method::eRATIONAL) {
+				return takeDecimated(dest);
+			}
+
 			const index size = buffer.getRemainingSize();
 			const index resultSize = std::min(size / decimateFactor, dest.size());
 			const index sourceGrabSize = resultSize * decimateFactor;
@@ -72,6 +120,10 @@ namespace rxtd::filter_utils {
 		// returns count of downsampled elements
 		template<index fixedFactor>
 		index downsampleFixed(array_span<float> dest) {
+			if (method == Method::ePOLYPHASE || method == Method::eRATIONAL) {
+				return takeDecimated(dest);
+			}
+
 			const index size = buffer.getRemainingSize();
 			const index resultSize = std::min(size / fixedFactor, dest.size());
 			const index sourceGrabSize = resultSize * fixedFactor;
@@ -89,6 +141,49 @@ namespace rxtd::filter_utils {
 			filter1.reset();
 			filter2.reset();
 			filter3.reset();
+			polyphase.reset();
+			rational.reset();
+		}
+
+	private:
+		void updateFilters() {
+			if (method == Method::ePOLYPHASE) {
+				polyphase.setFactor(decimateFactor);
+				polyphase.reset();
+				return;
+			}
+			if (method == Method::eRATIONAL) {
+				rational.setRatio(upsampleFactor, decimateFactor);
+				rational.reset();
+				return;
+			}
+
+			// digital frequency of 0.95 / decimateFactor ensures strong cutoff at new nyquist frequency
+			const double digitalCutoff = 0.95 / static_cast<double>(decimateFactor);
+			filter1 = { ButterworthWrapper::lowPass.calcCoefDigital(filterOrder, digitalCutoff) };
+			filter2 = filter1;
+			filter3 = filter1;
+		}
+
+		index takeDecimated(array_span<float> dest) {
+			const index resultSize = std::min(buffer.getRemainingSize(), dest.size());
+			buffer.removeFirst(resultSize).transferToSpan(dest);
+			return resultSize;
 		}
 	};
 }
+
+template<>
+inline std::optional<rxtd::filter_utils::DownsampleHelper::Method> parseEnum<rxtd::filter_utils::DownsampleHelper::Method>(rxtd::isview name) {
+	using Method = rxtd::filter_utils::DownsampleHelper::Method;
+	if (name == L"IIR") {
+		return Method::eIIR;
+	}
+	if (name == L"Polyphase") {
+		return Method::ePOLYPHASE;
+	}
+	if (name == L"Rational") {
+		return Method::eRATIONAL;
+	}
+	return {};
+}
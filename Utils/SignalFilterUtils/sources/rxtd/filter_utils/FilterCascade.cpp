@@ -4,6 +4,7 @@
 #include "FilterCascade.h"
 
 using rxtd::filter_utils::FilterCascade;
+using rxtd::filter_utils::BiquadCoefficients;
 
 void FilterCascade::apply(array_view<float> wave) {
 	wave.transferToVector(processed);
@@ -15,3 +16,12 @@ void FilterCascade::applyInPlace(array_span<float> wave) const {
 		filterPtr->apply(wave);
 	}
 }
+
+bool FilterCascade::exportSections(std::vector<BiquadCoefficients>& sections, double& gainAmp) const {
+	for (const auto& filterPtr : filters) {
+		if (!filterPtr->exportSections(sections, gainAmp)) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -25,6 +25,11 @@ namespace rxtd::filter_utils {
 			return processed;
 		}
 
+		/// <summary>
+		/// Collects sections of all filters in the cascade, see AbstractFilter#exportSections.
+		/// </summary>
+		bool exportSections(std::vector<BiquadCoefficients>& sections, double& gainAmp) const;
+
 		[[nodiscard]]
 		bool isEmpty() const {
 			return filters.empty();
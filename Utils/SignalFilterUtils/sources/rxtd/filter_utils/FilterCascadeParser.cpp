@@ -4,14 +4,14 @@
 #include "FilterCascadeParser.h"
 #include "BiQuadIIR.h"
 #include "BQFilterBuilder.h"
-#include "InfiniteResponseFilter.h"
+#include "BiquadCascade.h"
 #include "rxtd/option_parsing/OptionMap.h"
 #include "rxtd/option_parsing/OptionSequence.h"
 
 using rxtd::filter_utils::FilterCascadeCreator;
 using rxtd::filter_utils::FilterCascadeParser;
 using rxtd::filter_utils::FilterCascade;
-using rxtd::filter_utils::butterworth_lib::ButterworthWrapper;
+using rxtd::filter_utils::butterworth_lib::ButterworthSos;
 using rxtd::std_fixes::StringUtils;
 using rxtd::option_parsing::OptionParser;
 
@@ -120,8 +120,8 @@ FilterCascadeParser::parseBQ(isview name, const OptionMap& description, const Lo
 FilterCascadeParser::FCF
 FilterCascadeParser::parseBW(isview name, const OptionMap& description, const Logger& cl) {
 	const index order = parser.parse(description, L"order").as<index>();
-	if (order <= 0 || order > 5) {
-		cl.error(L"order must be in range [1, 5] but {} found", order);
+	if (order <= 0 || order > 10) {
+		cl.error(L"order must be in range [1, 10] but {} found", order);
 		throw OptionParser::Exception{};
 	}
 
@@ -136,13 +136,9 @@ FilterCascadeParser::parseBW(isview name, const OptionMap& description, const Lo
 		}
 
 		if (name == L"bwLowPass") {
-			return createButterworth<ButterworthWrapper::oneSideSlopeSize>(
-				order, forcedGain, cutoff, 0.0, ButterworthWrapper::lowPass
-			);
+			return createButterworth(order, forcedGain, cutoff, 0.0, ButterworthSos::lowPass);
 		} else {
-			return createButterworth<ButterworthWrapper::oneSideSlopeSize>(
-				order, forcedGain, cutoff, 0.0, ButterworthWrapper::highPass
-			);
+			return createButterworth(order, forcedGain, cutoff, 0.0, ButterworthSos::highPass);
 		}
 
 	}
@@ -157,13 +153,9 @@ FilterCascadeParser::parseBW(isview name, const OptionMap& description, const Lo
 		}
 
 		if (name == L"bwBandPass") {
-			return createButterworth<ButterworthWrapper::twoSideSlopeSize>(
-				order, forcedGain, cutoffLow, cutoffHigh, ButterworthWrapper::bandPass
-			);
+			return createButterworth(order, forcedGain, cutoffLow, cutoffHigh, ButterworthSos::bandPass);
 		} else {
-			return createButterworth<ButterworthWrapper::twoSideSlopeSize>(
-				order, forcedGain, cutoffLow, cutoffHigh, ButterworthWrapper::bandStop
-			);
+			return createButterworth(order, forcedGain, cutoffLow, cutoffHigh, ButterworthSos::bandStop);
 		}
 	}
 
@@ -171,42 +163,14 @@ FilterCascadeParser::parseBW(isview name, const OptionMap& description, const Lo
 	throw OptionParser::Exception{};
 }
 
-template<rxtd::index size>
-FilterCascadeParser::FCF FilterCascadeParser::createButterworthMaker(
-	index order, double forcedGain, double freq1,
-	double freq2,
-	const ButterworthWrapper::GenericCoefCalculator&
-	butterworthMaker
+FilterCascadeParser::FCF FilterCascadeParser::createButterworth(
+	index order, double forcedGain,
+	double freq1, double freq2,
+	ButterworthSos::DesignFuncSignature designFunc
 ) {
 	return [=](double sampleFrequency) {
-		auto ptr = new InfiniteResponseFilterFixed<size>{
-			butterworthMaker.calcCoef(order, sampleFrequency, freq1, freq2)
-		};
+		auto ptr = new BiquadCascade{ ButterworthSos::createFilter(designFunc, order, sampleFrequency, freq1, freq2) };
 		ptr->addGainDbEnergy(forcedGain);
 		return std::unique_ptr<AbstractFilter>{ ptr };
 	};
 }
-
-template<ButterworthWrapper::SizeFuncSignature sizeFunc>
-FilterCascadeParser::FCF FilterCascadeParser::createButterworth(
-	index order, double forcedGain, double freq1,
-	double freq2,
-	const ButterworthWrapper::GenericCoefCalculator&
-	butterworthMaker
-) {
-	switch (order) {
-	case 1: return createButterworthMaker<sizeFunc(1)>(order, forcedGain, freq1, freq2, butterworthMaker);
-	case 2: return createButterworthMaker<sizeFunc(2)>(order, forcedGain, freq1, freq2, butterworthMaker);
-	case 3: return createButterworthMaker<sizeFunc(3)>(order, forcedGain, freq1, freq2, butterworthMaker);
-	case 4: return createButterworthMaker<sizeFunc(4)>(order, forcedGain, freq1, freq2, butterworthMaker);
-	case 5: return createButterworthMaker<sizeFunc(5)>(order, forcedGain, freq1, freq2, butterworthMaker);
-
-	default: return [=](double sampleFrequency) {
-			auto ptr = new InfiniteResponseFilter{
-				butterworthMaker.calcCoef(order, sampleFrequency, freq1, freq2)
-			};
-			ptr->addGainDbEnergy(forcedGain);
-			return std::unique_ptr<AbstractFilter>{ ptr };
-		};
-	}
-}
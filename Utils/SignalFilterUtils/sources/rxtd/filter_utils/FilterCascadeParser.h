@@ -6,7 +6,7 @@
 #include "AbstractFilter.h"
 #include "FilterCascade.h"
 #include "rxtd/Logger.h"
-#include "rxtd/filter_utils/butterworth_lib/ButterworthWrapper.h"
+#include "rxtd/filter_utils/butterworth_lib/ButterworthSos.h"
 #include "rxtd/option_parsing/Option.h"
 #include "rxtd/option_parsing/OptionParser.h"
 
@@ -48,7 +48,7 @@ namespace rxtd::filter_utils {
 		using Option = option_parsing::Option;
 		using OptionList = option_parsing::OptionList;
 		using OptionMap = option_parsing::OptionMap;
-		using ButterworthWrapper = butterworth_lib::ButterworthWrapper;
+		using ButterworthSos = butterworth_lib::ButterworthSos;
 
 		FilterCascadeParser(option_parsing::OptionParser& parser) :
 			parser(parser) {}
@@ -70,22 +70,12 @@ namespace rxtd::filter_utils {
 		[[nodiscard]]
 		FCF parseBW(isview name, const OptionMap& description, const Logger& cl);
 
-		template<index size>
 		[[nodiscard]]
-		FCF createButterworthMaker(
+		static FCF createButterworth(
 			index order,
 			double forcedGain,
 			double freq1, double freq2,
-			const ButterworthWrapper::GenericCoefCalculator& butterworthMaker
-		);
-
-		template<ButterworthWrapper::SizeFuncSignature sizeFunc>
-		[[nodiscard]]
-		FCF createButterworth(
-			index order,
-			double forcedGain,
-			double freq1, double freq2,
-			const ButterworthWrapper::GenericCoefCalculator& butterworthMaker
+			ButterworthSos::DesignFuncSignature designFunc
 		);
 	};
 }
@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "FirDecimator.h"
+
+#include "rxtd/std_fixes/MyMath.h"
+
+using rxtd::filter_utils::FirDecimator;
+using rxtd::filter_utils::HalfbandDecimator;
+using rxtd::std_fixes::MyMath;
+
+namespace {
+	using rxtd::index;
+
+	// zeroth order modified Bessel function of the first kind
+	double besselI0(double x) {
+		double sum = 1.0;
+		double term = 1.0;
+		const double halfX = x * 0.5;
+		for (index k = 1; k < 50; k++) {
+			const double factor = halfX / static_cast<double>(k);
+			term *= factor * factor;
+			sum += term;
+			if (term < sum * 1e-12) {
+				break;
+			}
+		}
+		return sum;
+	}
+
+	double getKaiserBeta(double attenuationDb) {
+		if (attenuationDb > 50.0) {
+			return 0.1102 * (attenuationDb - 8.7);
+		}
+		if (attenuationDb > 21.0) {
+			return 0.5842 * std::pow(attenuationDb - 21.0, 0.4) + 0.07886 * (attenuationDb - 21.0);
+		}
+		return 0.0;
+	}
+
+	// estimation of filter length by Kaiser
+	index getKaiserLength(double transitionWidth, double attenuationDb) {
+		const double length = (attenuationDb - 8.0) / (2.285 * 2.0 * MyMath::pi<double>() * transitionWidth);
+		return static_cast<index>(std::ceil(length)) + 1;
+	}
+
+	double kaiserWindow(double distanceFromCenter, double halfLength, double beta) {
+		const double ratio = distanceFromCenter / halfLength;
+		return besselI0(beta * std::sqrt(std::max(1.0 - ratio * ratio, 0.0))) / besselI0(beta);
+	}
+
+	double sinc(double x) {
+		if (x == 0.0) {
+			return 1.0;
+		}
+		const double arg = MyMath::pi<double>() * x;
+		return std::sin(arg) / arg;
+	}
+}
+
+std::vector<float> FirDecimator::designLowPass(double passbandEdge, double stopbandEdge, double attenuationDb) {
+	index length = getKaiserLength(stopbandEdge - passbandEdge, attenuationDb);
+	if (length % 2 == 0) {
+		length++;
+	}
+
+	const double cutoff = (passbandEdge + stopbandEdge) * 0.5;
+	const double beta = getKaiserBeta(attenuationDb);
+	const double halfLength = static_cast<double>(length - 1) * 0.5;
+
+	std::vector<double> result;
+	result.resize(static_cast<size_t>(length));
+	double sum = 0.0;
+	for (index i = 0; i < length; i++) {
+		const double distance = static_cast<double>(i) - halfLength;
+		const double value = 2.0 * cutoff * sinc(2.0 * cutoff * distance) * kaiserWindow(distance, halfLength, beta);
+		result[static_cast<size_t>(i)] = value;
+		sum += value;
+	}
+
+	std::vector<float> taps;
+	taps.reserve(result.size());
+	for (const double value : result) {
+		// unity gain at DC
+		taps.push_back(static_cast<float>(value / sum));
+	}
+	return taps;
+}
+
+void FirDecimator::setParams(index _factor, std::vector<float> _taps) {
+	factor = std::max<index>(_factor, 1);
+	taps = std::move(_taps);
+	reset();
+}
+
+void FirDecimator::reset() {
+	// filter delay line starts with silence
+	history.reset(static_cast<index>(taps.size()) - 1, 0.0f);
+}
+
+void FirDecimator::process(array_view<float> source, std::vector<float>& dest) {
+	dest.clear();
+
+	history.compact();
+	source.transferToSpan(history.allocateNext(source.size()));
+
+	const index tapsCount = static_cast<index>(taps.size());
+	const index available = history.getRemainingSize();
+	if (available < tapsCount) {
+		return;
+	}
+
+	const index resultSize = (available - tapsCount) / factor + 1;
+	dest.resize(static_cast<size_t>(resultSize));
+
+	const float* data = history.getFirst(available).data();
+	const float* tapsData = taps.data();
+	const index unrolledCount = tapsCount / 4 * 4;
+	for (index i = 0; i < resultSize; i++) {
+		const float* window = data + i * factor;
+		// independent sums don't wait for each other
+		float sum0 = 0.0f;
+		float sum1 = 0.0f;
+		float sum2 = 0.0f;
+		float sum3 = 0.0f;
+		index j = 0;
+		for (; j < unrolledCount; j += 4) {
+			sum0 += window[j + 0] * tapsData[j + 0];
+			sum1 += window[j + 1] * tapsData[j + 1];
+			sum2 += window[j + 2] * tapsData[j + 2];
+			sum3 += window[j + 3] * tapsData[j + 3];
+		}
+		for (; j < tapsCount; j++) {
+			sum0 += window[j] * tapsData[j];
+		}
+		dest[static_cast<size_t>(i)] = (sum0 + sum1) + (sum2 + sum3);
+	}
+
+	history.removeFirst(resultSize * factor);
+}
+
+std::vector<float> HalfbandDecimator::designSideTaps(double passbandEdge, double attenuationDb) {
+	const double transitionWidth = 0.5 - 2.0 * passbandEdge;
+	const index estimatedLength = getKaiserLength(transitionWidth, attenuationDb);
+	// half-band filter length must be 4 * n - 1, so that outermost taps are non-zero
+	const index sideCount = std::max<index>((estimatedLength + 1 + 3) / 4, 1);
+	const index length = sideCount * 4 - 1;
+
+	const double beta = getKaiserBeta(attenuationDb);
+	const double halfLength = static_cast<double>(length - 1) * 0.5;
+
+	std::vector<double> values;
+	double sum = 0.0;
+	for (index i = 0; i < sideCount; i++) {
+		const double distance = static_cast<double>(i * 2 + 1);
+		const double value = 0.5 * sinc(0.5 * distance) * kaiserWindow(distance, halfLength, beta);
+		values.push_back(value);
+		sum += value;
+	}
+
+	// unity gain at DC: 0.5 + 2 * sum(side taps) == 1.0
+	std::vector<float> result;
+	for (const double value : values) {
+		result.push_back(static_cast<float>(value * 0.25 / sum));
+	}
+	return result;
+}
+
+void HalfbandDecimator::setParams(std::vector<float> _sideTaps) {
+	sideTaps = std::move(_sideTaps);
+	reset();
+}
+
+void HalfbandDecimator::reset() {
+	history.reset(getLength() - 1, 0.0f);
+}
+
+void HalfbandDecimator::process(array_view<float> source, std::vector<float>& dest) {
+	dest.clear();
+
+	history.compact();
+	source.transferToSpan(history.allocateNext(source.size()));
+
+	const index length = getLength();
+	const index available = history.getRemainingSize();
+	if (available < length) {
+		return;
+	}
+
+	const index resultSize = (available - length) / 2 + 1;
+	dest.resize(static_cast<size_t>(resultSize));
+
+	const index sideCount = static_cast<index>(sideTaps.size());
+	const index center = length / 2;
+	const float* data = history.getFirst(available).data();
+	const float* tapsData = sideTaps.data();
+	const index unrolledCount = sideCount / 2 * 2;
+	for (index i = 0; i < resultSize; i++) {
+		const float* centerPtr = data + i * 2 + center;
+		float sum0 = 0.0f;
+		float sum1 = 0.0f;
+		index j = 0;
+		for (; j < unrolledCount; j += 2) {
+			const index distance = j * 2 + 1;
+			sum0 += (centerPtr[-distance] + centerPtr[distance]) * tapsData[j];
+			sum1 += (centerPtr[-distance - 2] + centerPtr[distance + 2]) * tapsData[j + 1];
+		}
+		if (j < sideCount) {
+			const index distance = j * 2 + 1;
+			sum0 += (centerPtr[-distance] + centerPtr[distance]) * tapsData[j];
+		}
+		dest[static_cast<size_t>(i)] = (sum0 + sum1) + 0.5f * centerPtr[0];
+	}
+
+	history.removeFirst(resultSize * 2);
+}
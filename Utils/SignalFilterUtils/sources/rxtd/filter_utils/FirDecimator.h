@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "rxtd/GrowingVector.h"
+
+namespace rxtd::filter_utils {
+	/// <summary>
+	/// Linear-phase low-pass FIR filter followed by decimation.
+	/// Only samples that survive decimation are computed,
+	/// so the cost per input sample is taps count / factor.
+	/// </summary>
+	class FirDecimator {
+		index factor = 1;
+		std::vector<float> taps;
+		GrowingVector<float> history;
+
+	public:
+		/// <summary>
+		/// Kaiser-windowed sinc.
+		/// Frequencies are normalized to the sample rate, so 0.5 is the nyquist frequency.
+		/// </summary>
+		[[nodiscard]]
+		static std::vector<float> designLowPass(double passbandEdge, double stopbandEdge, double attenuationDb);
+
+		void setParams(index _factor, std::vector<float> _taps);
+
+		void reset();
+
+		/// <summary>
+		/// Replaces contents of dest with decimated signal.
+		/// </summary>
+		void process(array_view<float> source, std::vector<float>& dest);
+	};
+
+	/// <summary>
+	/// Decimation by 2 with a half-band FIR filter.
+	/// Every second tap of a half-band filter is zero and the center tap is 0.5,
+	/// so only about a quarter of the taps need to be multiplied per output sample.
+	/// </summary>
+	class HalfbandDecimator {
+		// non-zero taps on one side of the center, i-th value is the tap at distance 2*i + 1
+		std::vector<float> sideTaps;
+		GrowingVector<float> history;
+
+	public:
+		/// <summary>
+		/// Half-band filter has symmetric transition band around 0.25,
+		/// so only the passband edge can be specified.
+		/// Frequencies are normalized to the sample rate.
+		/// </summary>
+		[[nodiscard]]
+		static std::vector<float> designSideTaps(double passbandEdge, double attenuationDb);
+
+		void setParams(std::vector<float> _sideTaps);
+
+		void reset();
+
+		/// <summary>
+		/// Replaces contents of dest with decimated signal.
+		/// </summary>
+		void process(array_view<float> source, std::vector<float>& dest);
+
+	private:
+		[[nodiscard]]
+		index getLength() const {
+			return static_cast<index>(sideTaps.size()) * 4 - 1;
+		}
+	};
+}
@@ -0,0 +1,246 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "GaussianBlur.h"
+
+#include <complex>
+
+#include "rxtd/std_fixes/MyMath.h"
+
+using rxtd::filter_utils::GaussianBlur;
+
+std::vector<float> GaussianBlur::createKernel(float radius) {
+	std::vector<float> kernel;
+	kernel.resize(std_fixes::MyMath::roundTo<size_t>(radius) * 2 + 1);
+	if (kernel.empty()) {
+		return kernel;
+	}
+
+	const float sigma = radius * (1.0f / 3.0f);
+	const float powerFactor = 1.0f / (2.0f * sigma * sigma);
+
+	float r = -radius;
+	float sum = 0.0;
+	for (auto& k : kernel) {
+		k = std::exp(-r * r * powerFactor);
+		sum += k;
+		r += 1.0f;
+	}
+	const float sumInverse = 1.0f / sum;
+	for (auto& c : kernel) {
+		c *= sumInverse;
+	}
+
+	return kernel;
+}
+
+void GaussianBlur::setParams(float _radius, Method _method) {
+	radius = _radius;
+	method = _method;
+	if (method == Method::eAUTO) {
+		method = radius <= autoKernelMaxRadius ? Method::eKERNEL : Method::eRECURSIVE;
+	}
+
+	const double sigma = static_cast<double>(radius) / 3.0;
+
+	switch (method) {
+	case Method::eAUTO:
+	case Method::eKERNEL: {
+		kernel = createKernel(radius);
+		break;
+	}
+	case Method::eRECURSIVE: {
+		// Young, van Vliet, van Ginkel, "Recursive Gabor filtering", 2002:
+		// poles of the filter for sigma == 2 are scaled as d^(1/q),
+		// where q is chosen so that variance of forward + backward filter is sigma^2.
+		// Variance of a pole is 2d / (d - 1)^2 and increases with q
+		using complex = std::complex<double>;
+		const std::array<complex, 3> basePoles{
+			complex{ 1.41650, 1.00829 },
+			complex{ 1.41650, -1.00829 },
+			complex{ 1.86543, 0.0 },
+		};
+
+		const auto getPoles = [&](double q) {
+			std::array<complex, 3> result{};
+			for (index i = 0; i < 3; i++) {
+				result[static_cast<size_t>(i)] = std::pow(basePoles[static_cast<size_t>(i)], 1.0 / q);
+			}
+			return result;
+		};
+		const auto getVariance = [&](double q) {
+			complex result = 0.0;
+			for (const auto d : getPoles(q)) {
+				result += 2.0 * d / ((d - 1.0) * (d - 1.0));
+			}
+			return result.real();
+		};
+
+		double qMin = 0.01;
+		double qMax = 1000.0;
+		for (index i = 0; i < 100; i++) {
+			const double q = (qMin + qMax) * 0.5;
+			if (getVariance(q) < sigma * sigma) {
+				qMin = q;
+			} else {
+				qMax = q;
+			}
+		}
+		const auto poles = getPoles((qMin + qMax) * 0.5);
+
+		// (1 - z^-1 / d1) (1 - z^-1 / d2) (1 - z^-1 / d3) == 1 - a1 z^-1 - a2 z^-2 - a3 z^-3
+		const complex p1 = 1.0 / poles[0];
+		const complex p2 = 1.0 / poles[1];
+		const complex p3 = 1.0 / poles[2];
+		recursive.a1 = (p1 + p2 + p3).real();
+		recursive.a2 = -(p1 * p2 + p1 * p3 + p2 * p3).real();
+		recursive.a3 = (p1 * p2 * p3).real();
+		recursive.b = 1.0 - recursive.a1 - recursive.a2 - recursive.a3;
+		// response of forward pass is negligible after 6 sigma
+		recursive.tailSize = static_cast<index>(std::ceil(sigma * 6.0)) + 3;
+		break;
+	}
+	case Method::eBOX: {
+		// Widths of boxes are odd numbers w or w + 2,
+		// count of each width is chosen so that the variance of all passes is closest to sigma^2.
+		// Variance of a box of width w is (w^2 - 1) / 12
+		const double n = static_cast<double>(boxPassesCount);
+		const double idealWidth = std::sqrt(12.0 * sigma * sigma / n + 1.0);
+		index lowerWidth = static_cast<index>(std::floor(idealWidth));
+		if (lowerWidth % 2 == 0) {
+			lowerWidth--;
+		}
+		const auto wl = static_cast<double>(lowerWidth);
+		const double lowerCount = (12.0 * sigma * sigma - n * wl * wl - 4.0 * n * wl - 3.0 * n) / (-4.0 * wl - 4.0);
+		const index lowerCountRounded = std::clamp<index>(std::lround(lowerCount), 0, boxPassesCount);
+
+		for (index i = 0; i < boxPassesCount; i++) {
+			const index width = i < lowerCountRounded ? lowerWidth : lowerWidth + 2;
+			boxRadii[static_cast<size_t>(i)] = width / 2;
+		}
+		break;
+	}
+	}
+}
+
+void GaussianBlur::apply(array_view<float> source, array_span<float> dest) {
+	switch (method) {
+	case Method::eAUTO:
+	case Method::eKERNEL:
+		applyKernel(source, dest);
+		break;
+	case Method::eRECURSIVE:
+		applyRecursive(source, dest);
+		break;
+	case Method::eBOX:
+		applyBox(source, dest);
+		break;
+	}
+}
+
+void GaussianBlur::applyKernel(array_view<float> source, array_span<float> dest) const {
+	const index kernelRadius = static_cast<index>(kernel.size()) / 2;
+	const index size = source.size();
+
+	for (index i = 0; i < size; ++i) {
+		index sourceIndex = i - kernelRadius;
+		index kernelIndex = 0;
+
+		if (sourceIndex < 0) {
+			kernelIndex = -sourceIndex;
+			sourceIndex = 0;
+		}
+
+		float result = 0.0f;
+		while (sourceIndex < size && kernelIndex < static_cast<index>(kernel.size())) {
+			result += kernel[static_cast<size_t>(kernelIndex)] * source[sourceIndex];
+
+			kernelIndex++;
+			sourceIndex++;
+		}
+
+		dest[i] = result;
+	}
+}
+
+void GaussianBlur::applyRecursive(array_view<float> source, array_span<float> dest) {
+	const index size = source.size();
+	const index extendedSize = size + recursive.tailSize;
+	buffer.resize(static_cast<size_t>(extendedSize));
+
+	const double b = recursive.b;
+	const double a1 = recursive.a1;
+	const double a2 = recursive.a2;
+	const double a3 = recursive.a3;
+
+	// zero initial state is exact for zeros before the array
+	double w1 = 0.0;
+	double w2 = 0.0;
+	double w3 = 0.0;
+	for (index i = 0; i < extendedSize; i++) {
+		const double x = i < size ? static_cast<double>(source[i]) : 0.0;
+		const double w = b * x + a1 * w1 + a2 * w2 + a3 * w3;
+		buffer[static_cast<size_t>(i)] = static_cast<float>(w);
+		w3 = w2;
+		w2 = w1;
+		w1 = w;
+	}
+
+	double y1 = 0.0;
+	double y2 = 0.0;
+	double y3 = 0.0;
+	for (index i = extendedSize - 1; i >= 0; i--) {
+		const double y = b * static_cast<double>(buffer[static_cast<size_t>(i)]) + a1 * y1 + a2 * y2 + a3 * y3;
+		if (i < size) {
+			dest[i] = static_cast<float>(y);
+		}
+		y3 = y2;
+		y2 = y1;
+		y1 = y;
+	}
+}
+
+void GaussianBlur::applyBox(array_view<float> source, array_span<float> dest) {
+	// Each pass widens non-zero range, so array is padded by the sum of radii on both sides.
+	// Values outside of the padded array are zero after all passes,
+	// so the result is exactly the convolution with zeros outside of the source
+	index padding = 0;
+	for (const index boxRadius : boxRadii) {
+		padding += boxRadius;
+	}
+
+	const index size = source.size();
+	const index extendedSize = size + padding * 2;
+	buffer.assign(static_cast<size_t>(extendedSize), 0.0f);
+	buffer2.resize(static_cast<size_t>(extendedSize));
+	std::copy(source.begin(), source.end(), buffer.begin() + padding);
+
+	for (const index boxRadius : boxRadii) {
+		boxPass(buffer, buffer2, boxRadius);
+		std::swap(buffer, buffer2);
+	}
+
+	std::copy_n(buffer.begin() + padding, size, dest.begin());
+}
+
+void GaussianBlur::boxPass(array_view<float> source, array_span<float> dest, index boxRadius) {
+	const index size = source.size();
+	const double widthInverse = 1.0 / static_cast<double>(boxRadius * 2 + 1);
+
+	// sum of source[i - boxRadius, i + boxRadius]
+	// double prevents error from accumulating over the array
+	double sum = 0.0;
+	for (index i = 0; i < std::min(boxRadius, size); i++) {
+		sum += static_cast<double>(source[i]);
+	}
+
+	for (index i = 0; i < size; i++) {
+		if (i + boxRadius < size) {
+			sum += static_cast<double>(source[i + boxRadius]);
+		}
+		dest[i] = static_cast<float>(sum * widthInverse);
+		if (i - boxRadius >= 0) {
+			sum -= static_cast<double>(source[i - boxRadius]);
+		}
+	}
+}
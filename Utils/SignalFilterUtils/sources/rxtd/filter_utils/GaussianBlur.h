@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+
+namespace rxtd::filter_utils {
+	/// <summary>
+	/// Gaussian blur of a finite array, with zeros outside of the array.
+	/// Radius is 3 sigma, like in createKernel.
+	///
+	/// Explicit kernel costs O(radius) per value, other methods cost O(1) per value,
+	/// but they only approximate the shape of the kernel.
+	/// </summary>
+	class GaussianBlur {
+	public:
+		enum class Method {
+			// kernel for small radius, recursive for big radius
+			eAUTO,
+			// convolution with kernel from createKernel
+			eKERNEL,
+			// Young - van Vliet recursive filter of 3rd order, forward and backward
+			eRECURSIVE,
+			// three box filters with running sums
+			eBOX,
+		};
+
+		// eAUTO uses kernel up to this radius
+		static constexpr float autoKernelMaxRadius = 10.0f;
+
+	private:
+		static constexpr index boxPassesCount = 3;
+
+		Method method = Method::eKERNEL;
+		float radius = 0.0f;
+
+		std::vector<float> kernel;
+
+		struct {
+			double b = 0.0;
+			double a1 = 0.0;
+			double a2 = 0.0;
+			double a3 = 0.0;
+			// zeros after the end of the array, for the tail of the forward pass
+			index tailSize = 0;
+		} recursive;
+
+		std::array<index, boxPassesCount> boxRadii{};
+
+		std::vector<float> buffer;
+		std::vector<float> buffer2;
+
+	public:
+		/// <summary>
+		/// Returns normalized kernel of size round(radius) * 2 + 1.
+		/// </summary>
+		[[nodiscard]]
+		static std::vector<float> createKernel(float radius);
+
+		void setParams(float radius, Method method);
+
+		/// <summary>
+		/// Returns actual method, never eAUTO.
+		/// </summary>
+		[[nodiscard]]
+		Method getMethod() const {
+			return method;
+		}
+
+		/// <summary>
+		/// Source and dest must have the same size and must not overlap.
+		/// </summary>
+		void apply(array_view<float> source, array_span<float> dest);
+
+	private:
+		void applyKernel(array_view<float> source, array_span<float> dest) const;
+		void applyRecursive(array_view<float> source, array_span<float> dest);
+		void applyBox(array_view<float> source, array_span<float> dest);
+
+		static void boxPass(array_view<float> source, array_span<float> dest, index boxRadius);
+	};
+}
+
+template<>
+inline std::optional<rxtd::filter_utils::GaussianBlur::Method> parseEnum<rxtd::filter_utils::GaussianBlur::Method>(rxtd::isview name) {
+	using Method = rxtd::filter_utils::GaussianBlur::Method;
+	if (name == L"Auto") {
+		return Method::eAUTO;
+	}
+	if (name == L"Kernel") {
+		return Method::eKERNEL;
+	}
+	if (name == L"Recursive") {
+		return Method::eRECURSIVE;
+	}
+	if (name == L"Box") {
+		return Method::eBOX;
+	}
+	return {};
+}
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "LoudnessHistogram.h"
+
+using rxtd::filter_utils::LoudnessHistogram;
+
+LoudnessHistogram::LoudnessHistogram() {
+	bins.resize(static_cast<size_t>(std::lround((maxDb - minDb) / binWidthDb)));
+}
+
+void LoudnessHistogram::reset() {
+	std::fill(bins.begin(), bins.end(), Bin{});
+	zeroCount = 0;
+	totalCount = 0;
+	highestBin = -1;
+}
+
+void LoudnessHistogram::add(double energy) {
+	totalCount++;
+	if (energy <= 0.0) {
+		zeroCount++;
+		return;
+	}
+
+	const index binIndex = getBinIndex(energy);
+	auto& bin = bins[static_cast<size_t>(binIndex)];
+	bin.count++;
+	bin.sum += energy;
+	highestBin = std::max(highestBin, binIndex);
+}
+
+void LoudnessHistogram::remove(double energy) {
+	totalCount--;
+	if (energy <= 0.0) {
+		zeroCount--;
+		return;
+	}
+
+	const index binIndex = getBinIndex(energy);
+	auto& bin = bins[static_cast<size_t>(binIndex)];
+	bin.count--;
+	bin.sum -= energy;
+	if (bin.count > 0) {
+		return;
+	}
+
+	// don't let rounding errors accumulate in empty bins
+	bin.sum = 0.0;
+
+	if (binIndex == highestBin) {
+		while (highestBin >= 0 && bins[static_cast<size_t>(highestBin)].count == 0) {
+			highestBin--;
+		}
+	}
+}
+
+LoudnessHistogram::Stats LoudnessHistogram::getGated(double gate, index minCount) const {
+	Stats result;
+
+	if (gate <= 0.0) {
+		for (index i = 0; i <= highestBin; i++) {
+			result.sum += bins[static_cast<size_t>(i)].sum;
+		}
+		result.count = totalCount;
+		return result;
+	}
+
+	const index gateBin = getBinIndex(gate);
+	for (index i = highestBin; i >= 0; i--) {
+		const auto& bin = bins[static_cast<size_t>(i)];
+		if (bin.count == 0) {
+			continue;
+		}
+
+		if (i >= gateBin || minCount - result.count >= bin.count) {
+			result.count += bin.count;
+			result.sum += bin.sum;
+			continue;
+		}
+
+		if (result.count >= minCount) {
+			return result;
+		}
+
+		// only some of the values from the bin are needed, they are assumed to be equal to the average of the bin
+		const index needed = minCount - result.count;
+		result.count += needed;
+		result.sum += bin.sum * static_cast<double>(needed) / static_cast<double>(bin.count);
+		return result;
+	}
+
+	result.count += std::clamp<index>(minCount - result.count, 0, zeroCount);
+	return result;
+}
+
+rxtd::index LoudnessHistogram::getBinIndex(double energy) const {
+	const double db = 10.0 * std::log10(energy);
+	const double binIndex = std::floor((db - minDb) * (1.0 / binWidthDb));
+	return static_cast<index>(std::clamp(binIndex, 0.0, static_cast<double>(bins.size() - 1)));
+}
@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+
+namespace rxtd::filter_utils {
+	/// <summary>
+	/// Multiset of block energies for loudness gating, like in BS.1770 meters.
+	/// Energies are grouped into bins of binWidthDb,
+	/// each bin keeps exact count and exact sum of its energies,
+	/// so only the gate position is quantized.
+	///
+	/// Adding and removing values costs O(1), gating costs O(bins above the gate).
+	/// Energies below minDb are put into the lowest bin, energies above maxDb into the highest,
+	/// zeros are counted separately and are lower than any other value.
+	/// </summary>
+	class LoudnessHistogram {
+	public:
+		static constexpr double binWidthDb = 0.01;
+		static constexpr double minDb = -130.0;
+		static constexpr double maxDb = 20.0;
+
+		struct Stats {
+			index count = 0;
+			double sum = 0.0;
+
+			[[nodiscard]]
+			double getMean() const {
+				return count == 0 ? 0.0 : sum / static_cast<double>(count);
+			}
+		};
+
+	private:
+		struct Bin {
+			index count = 0;
+			double sum = 0.0;
+		};
+
+		std::vector<Bin> bins;
+		index zeroCount = 0;
+		index totalCount = 0;
+		// -1 when there are only zeros
+		index highestBin = -1;
+
+	public:
+		LoudnessHistogram();
+
+		void reset();
+
+		/// <summary>
+		/// Energy must not be negative.
+		/// </summary>
+		void add(double energy);
+
+		/// <summary>
+		/// Energy must be equal to some previously added value.
+		/// </summary>
+		void remove(double energy);
+
+		[[nodiscard]]
+		index getCount() const {
+			return totalCount;
+		}
+
+		[[nodiscard]]
+		index getZeroCount() const {
+			return zeroCount;
+		}
+
+		/// <summary>
+		/// Returns count and sum of values that are not lower than gate.
+		/// If there are less than minCount such values,
+		/// the biggest of the remaining values are added until there are minCount values.
+		/// Gate <= 0 includes zeros.
+		/// </summary>
+		[[nodiscard]]
+		Stats getGated(double gate, index minCount = 0) const;
+
+	private:
+		[[nodiscard]]
+		index getBinIndex(double energy) const;
+	};
+}
@@ -0,0 +1,300 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "MultiChannelBiquadCascade.h"
+
+#include "rxtd/std_fixes/CpuFeatures.h"
+#include "rxtd/std_fixes/MyMath.h"
+
+using rxtd::filter_utils::MultiChannelBiquadCascade;
+using rxtd::filter_utils::BlockKernels;
+using InstructionSet = MultiChannelBiquadCascade::InstructionSet;
+using rxtd::std_fixes::MyMath;
+
+namespace {
+	using rxtd::index;
+
+	// minimal set of operations that the filter needs,
+	// each operation processes #width channels at once
+	struct ScalarVec {
+		static constexpr index width = 1;
+		using type = float;
+
+		static type load(const float* ptr) { return *ptr; }
+		static void store(float* ptr, type value) { *ptr = value; }
+		static type broadcast(float value) { return value; }
+		static type add(type a, type b) { return a + b; }
+		static type sub(type a, type b) { return a - b; }
+		static type mul(type a, type b) { return a * b; }
+	};
+
+#ifdef RXTD_X86
+	struct SseVec {
+		static constexpr index width = 4;
+		using type = __m128;
+
+		static type load(const float* ptr) { return _mm_loadu_ps(ptr); }
+		static void store(float* ptr, type value) { _mm_storeu_ps(ptr, value); }
+		static type broadcast(float value) { return _mm_set1_ps(value); }
+		static type add(type a, type b) { return _mm_add_ps(a, b); }
+		static type sub(type a, type b) { return _mm_sub_ps(a, b); }
+		static type mul(type a, type b) { return _mm_mul_ps(a, b); }
+	};
+
+	static_assert(MultiChannelBiquadCascade::maxChannels % SseVec::width == 0);
+
+	// AVX version is written with plain intrinsics, like in BlockKernels:
+	// AVX vectors can't be passed between functions that are compiled without AVX
+	constexpr index avxWidth = 8;
+	static_assert(MultiChannelBiquadCascade::maxChannels % avxWidth == 0);
+#endif
+}
+
+MultiChannelBiquadCascade::MultiChannelBiquadCascade(
+	array_view<BiquadCoefficients> coefficients, double gainAmp, InstructionSet instructionSet
+) {
+	if (!BlockKernels::isSupported(instructionSet)) {
+		instructionSet = BlockKernels::getBestInstructionSet();
+	}
+	this->instructionSet = instructionSet;
+
+	for (const auto& c : coefficients) {
+		Section section;
+		section.b0 = static_cast<float>(c.b0);
+		section.b1 = static_cast<float>(c.b1);
+		section.b2 = static_cast<float>(c.b2);
+		section.a1 = static_cast<float>(c.a1);
+		section.a2 = static_cast<float>(c.a2);
+		sections.push_back(section);
+	}
+
+	this->gainAmp = static_cast<float>(gainAmp);
+}
+
+void MultiChannelBiquadCascade::apply(array_view<array_span<float>> channels) {
+	const index channelsCount = std::min(channels.size(), maxChannels);
+	if (channelsCount == 0) {
+		return;
+	}
+	const index framesCount = channels[0].size();
+	// channels that share a vector with real channels must have some sane values,
+	// the rest of the channels are never touched
+	const index vectorWidth = getVectorWidth();
+	const index vectorChannelsCount = (channelsCount + vectorWidth - 1) / vectorWidth * vectorWidth;
+
+	interleaved.resize(static_cast<size_t>(framesCount * maxChannels));
+	for (index channel = 0; channel < vectorChannelsCount; channel++) {
+		float* dst = interleaved.data() + channel;
+		if (channel < channelsCount) {
+			for (const float value : channels[channel]) {
+				*dst = value;
+				dst += maxChannels;
+			}
+		} else {
+			for (index frame = 0; frame < framesCount; frame++) {
+				*dst = 0.0f;
+				dst += maxChannels;
+			}
+		}
+	}
+
+	switch (instructionSet) {
+	case InstructionSet::eSCALAR:
+		applySections<ScalarVec>(interleaved.data(), vectorChannelsCount, framesCount);
+		break;
+#ifdef RXTD_X86
+	case InstructionSet::eSSE:
+		applySections<SseVec>(interleaved.data(), vectorChannelsCount, framesCount);
+		break;
+	case InstructionSet::eAVX:
+		applySectionsAvx(interleaved.data(), vectorChannelsCount, framesCount);
+		break;
+#endif
+	default: break;
+	}
+
+	for (index channel = 0; channel < channelsCount; channel++) {
+		const float* src = interleaved.data() + channel;
+		// spans inside array_view are const, but the data they point to is not
+		array_span<float> span = channels[channel];
+		for (float& value : span) {
+			value = *src * gainAmp;
+			src += maxChannels;
+		}
+	}
+}
+
+void MultiChannelBiquadCascade::reset() {
+	for (auto& section : sections) {
+		section.state0 = {};
+		section.state1 = {};
+	}
+}
+
+void MultiChannelBiquadCascade::addGainDbEnergy(double gainDB) {
+	gainAmp *= static_cast<float>(MyMath::db2amplitude(gainDB * 0.5));
+}
+
+rxtd::index MultiChannelBiquadCascade::getVectorWidth() const {
+	switch (instructionSet) {
+#ifdef RXTD_X86
+	case InstructionSet::eSSE: return SseVec::width;
+	case InstructionSet::eAVX: return avxWidth;
+#endif
+	default: return ScalarVec::width;
+	}
+}
+
+bool MultiChannelBiquadCascade::hasCoefficients(array_view<BiquadCoefficients> coefficients, double gainAmp) const {
+	if (coefficients.size() != getSectionsCount() || this->gainAmp != static_cast<float>(gainAmp)) {
+		return false;
+	}
+
+	for (index i = 0; i < coefficients.size(); i++) {
+		const auto& c = coefficients[i];
+		const auto& section = sections[static_cast<size_t>(i)];
+		if (section.b0 != static_cast<float>(c.b0)
+			|| section.b1 != static_cast<float>(c.b1)
+			|| section.b2 != static_cast<float>(c.b2)
+			|| section.a1 != static_cast<float>(c.a1)
+			|| section.a2 != static_cast<float>(c.a2)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename Vec>
+void MultiChannelBiquadCascade::applySections(float* data, index vectorChannelsCount, index framesCount) {
+	const index sectionsCount = static_cast<index>(sections.size());
+
+	index sectionIndex = 0;
+	for (; sectionIndex + 1 < sectionsCount; sectionIndex += 2) {
+		Section& first = sections[static_cast<size_t>(sectionIndex)];
+		Section& second = sections[static_cast<size_t>(sectionIndex + 1)];
+
+		const auto b0 = Vec::broadcast(first.b0), b1 = Vec::broadcast(first.b1), b2 = Vec::broadcast(first.b2);
+		const auto a1 = Vec::broadcast(first.a1), a2 = Vec::broadcast(first.a2);
+		const auto c0 = Vec::broadcast(second.b0), c1 = Vec::broadcast(second.b1), c2 = Vec::broadcast(second.b2);
+		const auto d1 = Vec::broadcast(second.a1), d2 = Vec::broadcast(second.a2);
+
+		for (index lane = 0; lane < vectorChannelsCount; lane += Vec::width) {
+			auto s0 = Vec::load(first.state0.data() + lane), s1 = Vec::load(first.state1.data() + lane);
+			auto t0 = Vec::load(second.state0.data() + lane), t1 = Vec::load(second.state1.data() + lane);
+
+			float* ptr = data + lane;
+			for (index frame = 0; frame < framesCount; frame++) {
+				const auto in = Vec::load(ptr);
+				const auto mid = Vec::add(Vec::mul(b0, in), s0);
+				s0 = Vec::add(Vec::sub(Vec::mul(b1, in), Vec::mul(a1, mid)), s1);
+				s1 = Vec::sub(Vec::mul(b2, in), Vec::mul(a2, mid));
+
+				const auto out = Vec::add(Vec::mul(c0, mid), t0);
+				t0 = Vec::add(Vec::sub(Vec::mul(c1, mid), Vec::mul(d1, out)), t1);
+				t1 = Vec::sub(Vec::mul(c2, mid), Vec::mul(d2, out));
+
+				Vec::store(ptr, out);
+				ptr += maxChannels;
+			}
+
+			Vec::store(first.state0.data() + lane, s0);
+			Vec::store(first.state1.data() + lane, s1);
+			Vec::store(second.state0.data() + lane, t0);
+			Vec::store(second.state1.data() + lane, t1);
+		}
+	}
+
+	if (sectionIndex < sectionsCount) {
+		Section& section = sections[static_cast<size_t>(sectionIndex)];
+
+		const auto b0 = Vec::broadcast(section.b0), b1 = Vec::broadcast(section.b1), b2 = Vec::broadcast(section.b2);
+		const auto a1 = Vec::broadcast(section.a1), a2 = Vec::broadcast(section.a2);
+
+		for (index lane = 0; lane < vectorChannelsCount; lane += Vec::width) {
+			auto s0 = Vec::load(section.state0.data() + lane), s1 = Vec::load(section.state1.data() + lane);
+
+			float* ptr = data + lane;
+			for (index frame = 0; frame < framesCount; frame++) {
+				const auto in = Vec::load(ptr);
+				const auto out = Vec::add(Vec::mul(b0, in), s0);
+				s0 = Vec::add(Vec::sub(Vec::mul(b1, in), Vec::mul(a1, out)), s1);
+				s1 = Vec::sub(Vec::mul(b2, in), Vec::mul(a2, out));
+
+				Vec::store(ptr, out);
+				ptr += maxChannels;
+			}
+
+			Vec::store(section.state0.data() + lane, s0);
+			Vec::store(section.state1.data() + lane, s1);
+		}
+	}
+}
+
+#ifdef RXTD_X86
+RXTD_TARGET_AVX
+void MultiChannelBiquadCascade::applySectionsAvx(float* data, index vectorChannelsCount, index framesCount) {
+	const index sectionsCount = static_cast<index>(sections.size());
+
+	index sectionIndex = 0;
+	for (; sectionIndex + 1 < sectionsCount; sectionIndex += 2) {
+		Section& first = sections[static_cast<size_t>(sectionIndex)];
+		Section& second = sections[static_cast<size_t>(sectionIndex + 1)];
+
+		const auto b0 = _mm256_set1_ps(first.b0), b1 = _mm256_set1_ps(first.b1), b2 = _mm256_set1_ps(first.b2);
+		const auto a1 = _mm256_set1_ps(first.a1), a2 = _mm256_set1_ps(first.a2);
+		const auto c0 = _mm256_set1_ps(second.b0), c1 = _mm256_set1_ps(second.b1), c2 = _mm256_set1_ps(second.b2);
+		const auto d1 = _mm256_set1_ps(second.a1), d2 = _mm256_set1_ps(second.a2);
+
+		for (index lane = 0; lane < vectorChannelsCount; lane += avxWidth) {
+			auto s0 = _mm256_loadu_ps(first.state0.data() + lane), s1 = _mm256_loadu_ps(first.state1.data() + lane);
+			auto t0 = _mm256_loadu_ps(second.state0.data() + lane), t1 = _mm256_loadu_ps(second.state1.data() + lane);
+
+			float* ptr = data + lane;
+			for (index frame = 0; frame < framesCount; frame++) {
+				const auto in = _mm256_loadu_ps(ptr);
+				const auto mid = _mm256_add_ps(_mm256_mul_ps(b0, in), s0);
+				s0 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(b1, in), _mm256_mul_ps(a1, mid)), s1);
+				s1 = _mm256_sub_ps(_mm256_mul_ps(b2, in), _mm256_mul_ps(a2, mid));
+
+				const auto out = _mm256_add_ps(_mm256_mul_ps(c0, mid), t0);
+				t0 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(c1, mid), _mm256_mul_ps(d1, out)), t1);
+				t1 = _mm256_sub_ps(_mm256_mul_ps(c2, mid), _mm256_mul_ps(d2, out));
+
+				_mm256_storeu_ps(ptr, out);
+				ptr += maxChannels;
+			}
+
+			_mm256_storeu_ps(first.state0.data() + lane, s0);
+			_mm256_storeu_ps(first.state1.data() + lane, s1);
+			_mm256_storeu_ps(second.state0.data() + lane, t0);
+			_mm256_storeu_ps(second.state1.data() + lane, t1);
+		}
+	}
+
+	if (sectionIndex < sectionsCount) {
+		Section& section = sections[static_cast<size_t>(sectionIndex)];
+
+		const auto b0 = _mm256_set1_ps(section.b0), b1 = _mm256_set1_ps(section.b1), b2 = _mm256_set1_ps(section.b2);
+		const auto a1 = _mm256_set1_ps(section.a1), a2 = _mm256_set1_ps(section.a2);
+
+		for (index lane = 0; lane < vectorChannelsCount; lane += avxWidth) {
+			auto s0 = _mm256_loadu_ps(section.state0.data() + lane), s1 = _mm256_loadu_ps(section.state1.data() + lane);
+
+			float* ptr = data + lane;
+			for (index frame = 0; frame < framesCount; frame++) {
+				const auto in = _mm256_loadu_ps(ptr);
+				const auto out = _mm256_add_ps(_mm256_mul_ps(b0, in), s0);
+				s0 = _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(b1, in), _mm256_mul_ps(a1, out)), s1);
+				s1 = _mm256_sub_ps(_mm256_mul_ps(b2, in), _mm256_mul_ps(a2, out));
+
+				_mm256_storeu_ps(ptr, out);
+				ptr += maxChannels;
+			}
+
+			_mm256_storeu_ps(section.state0.data() + lane, s0);
+			_mm256_storeu_ps(section.state1.data() + lane, s1);
+		}
+	}
+}
+#endif
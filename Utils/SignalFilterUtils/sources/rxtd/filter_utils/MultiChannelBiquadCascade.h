@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "BiquadCascade.h"
+#include "BlockKernels.h"
+
+namespace rxtd::filter_utils {
+	/// <summary>
+	/// Same filter as BiquadCascade, but applied to up to #maxChannels channels at once.
+	///
+	/// All channels share the coefficients, each channel has its own state.
+	/// Samples of all channels are interleaved, so that one sample of every channel
+	/// fits into a single SIMD register, and each section is then computed for all channels with one instruction.
+	/// Instruction set is chosen at runtime, like in BlockKernels: AVX (8 channels per instruction) when the CPU supports it,
+	/// SSE (4 channels per instruction) on other x86 CPUs, plain scalar code otherwise.
+	/// Any supported set can be forced in the constructor.
+	/// All instruction sets do the same operations in the same order, so results don't depend on the CPU.
+	/// </summary>
+	class MultiChannelBiquadCascade {
+	public:
+		static constexpr index maxChannels = 8;
+
+		using InstructionSet = BlockKernels::InstructionSet;
+
+	private:
+		struct Section {
+			float b0{};
+			float b1{};
+			float b2{};
+			float a1{};
+			float a2{};
+
+			// indexed by channel
+			std::array<float, maxChannels> state0{};
+			std::array<float, maxChannels> state1{};
+		};
+
+		InstructionSet instructionSet = BlockKernels::getBestInstructionSet();
+		std::vector<Section> sections;
+		float gainAmp = 1.0f;
+
+		// frame-major: all channels of sample 0, then all channels of sample 1, and so on
+		std::vector<float> interleaved;
+
+	public:
+		MultiChannelBiquadCascade() = default;
+
+		/// <summary>
+		/// Uses the best instruction set that current CPU supports.
+		/// </summary>
+		MultiChannelBiquadCascade(array_view<BiquadCoefficients> coefficients, double gainAmp) :
+			MultiChannelBiquadCascade(coefficients, gainAmp, BlockKernels::getBestInstructionSet()) { }
+
+		/// <summary>
+		/// Falls back to the best supported instruction set if value is not supported.
+		/// </summary>
+		MultiChannelBiquadCascade(array_view<BiquadCoefficients> coefficients, double gainAmp, InstructionSet instructionSet);
+
+		/// <summary>
+		/// Filters each channel in place.
+		/// There must be at most #maxChannels channels, all of the same size.
+		/// Channel with index i always uses state number i,
+		/// so order of the channels must be the same on each call.
+		/// </summary>
+		void apply(array_view<array_span<float>> channels);
+
+		void reset();
+
+		void addGainDbEnergy(double gainDB);
+
+		[[nodiscard]]
+		index getSectionsCount() const {
+			return static_cast<index>(sections.size());
+		}
+
+		[[nodiscard]]
+		InstructionSet getInstructionSet() const {
+			return instructionSet;
+		}
+
+		/// <summary>
+		/// Count of channels that are processed by one instruction.
+		/// </summary>
+		[[nodiscard]]
+		index getVectorWidth() const;
+
+		/// <summary>
+		/// True if the filter has exactly these coefficients,
+		/// so that it can be reused without losing its state.
+		/// </summary>
+		[[nodiscard]]
+		bool hasCoefficients(array_view<BiquadCoefficients> coefficients, double gainAmp) const;
+
+	private:
+		// applies all sections to the interleaved data
+		template<typename Vec>
+		void applySections(float* data, index vectorChannelsCount, index framesCount);
+		void applySectionsAvx(float* data, index vectorChannelsCount, index framesCount);
+	};
+}
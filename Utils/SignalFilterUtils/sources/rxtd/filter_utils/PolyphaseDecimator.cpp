@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "PolyphaseDecimator.h"
+
+using rxtd::filter_utils::PolyphaseDecimator;
+
+void PolyphaseDecimator::setFactor(index value) {
+	value = std::max<index>(value, 1);
+	if (value == factor) {
+		return;
+	}
+	factor = value;
+
+	halfbandStages.clear();
+	lastStage.reset();
+
+	// in the units of original sample rate
+	const double finalStopbandEdge = (2.0 - passbandRatio) * 0.5 / static_cast<double>(factor);
+
+	index remaining = factor;
+	index stageRateDivider = 1;
+	while (remaining % 2 == 0) {
+		remaining /= 2;
+		const bool isLast = remaining == 1;
+
+		// Stage output nyquist is 0.25 of stage input rate.
+		// Last stage keeps its own passband.
+		// Others only need to keep everything below final stopband edge,
+		// so that aliases that they let through are removed by the following stages
+		const double passbandEdge = isLast
+			? passbandRatio * 0.25
+			: finalStopbandEdge * static_cast<double>(stageRateDivider);
+
+		HalfbandDecimator stage;
+		stage.setParams(HalfbandDecimator::designSideTaps(passbandEdge, attenuationDb));
+		halfbandStages.push_back(std::move(stage));
+
+		stageRateDivider *= 2;
+	}
+
+	if (remaining > 1) {
+		const double newNyquist = 0.5 / static_cast<double>(remaining);
+		lastStage = FirDecimator{};
+		lastStage->setParams(
+			remaining,
+			FirDecimator::designLowPass(passbandRatio * newNyquist, (2.0 - passbandRatio) * newNyquist, attenuationDb)
+		);
+	}
+}
+
+void PolyphaseDecimator::reset() {
+	for (auto& stage : halfbandStages) {
+		stage.reset();
+	}
+	if (lastStage.has_value()) {
+		lastStage->reset();
+	}
+}
+
+array_view<float> PolyphaseDecimator::process(array_view<float> source) {
+	if (factor <= 1) {
+		return source;
+	}
+
+	array_view<float> current = source;
+	std::vector<float>* output = &bufferA;
+
+	for (auto& stage : halfbandStages) {
+		stage.process(current, *output);
+		current = *output;
+		output = output == &bufferA ? &bufferB : &bufferA;
+	}
+
+	if (lastStage.has_value()) {
+		lastStage->process(current, *output);
+		current = *output;
+	}
+
+	return current;
+}
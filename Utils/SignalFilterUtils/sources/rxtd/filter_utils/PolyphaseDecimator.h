@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "FirDecimator.h"
+
+namespace rxtd::filter_utils {
+	/// <summary>
+	/// Decimation by an integer factor with a chain of FIR stages:
+	/// half-band stages for each factor of 2, then one generic stage for the remaining odd factor.
+	/// Each stage only computes the samples that it keeps.
+	///
+	/// All stages but the last only need to protect frequencies below the final stopband edge,
+	/// so they get wide transition bands and very few taps.
+	/// Final passband ends at 0.9 of the new nyquist frequency.
+	/// </summary>
+	class PolyphaseDecimator {
+	public:
+		static constexpr double passbandRatio = 0.9;
+		static constexpr double attenuationDb = 100.0;
+
+	private:
+		index factor = 0;
+		std::vector<HalfbandDecimator> halfbandStages;
+		std::optional<FirDecimator> lastStage;
+
+		std::vector<float> bufferA;
+		std::vector<float> bufferB;
+
+	public:
+		[[nodiscard]]
+		index getFactor() const {
+			return factor;
+		}
+
+		void setFactor(index value);
+
+		void reset();
+
+		/// <summary>
+		/// Returned view is valid until the next call.
+		/// </summary>
+		[[nodiscard]]
+		array_view<float> process(array_view<float> source);
+	};
+}
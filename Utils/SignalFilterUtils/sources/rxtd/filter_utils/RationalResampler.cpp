@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "RationalResampler.h"
+
+#include <mutex>
+#include <numeric>
+
+#include "FirDecimator.h"
+
+using rxtd::filter_utils::RationalResampler;
+
+void RationalResampler::setRatio(index _up, index _down) {
+	_up = std::max<index>(_up, 1);
+	_down = std::max<index>(_down, 1);
+	const index divisor = std::gcd(_up, _down);
+	_up /= divisor;
+	_down /= divisor;
+	if (_up == up && _down == down) {
+		return;
+	}
+
+	if (_up > maxPhases) {
+		throw std::runtime_error{ "RationalResampler::setRatio(): too many phases" };
+	}
+
+	up = _up;
+	down = _down;
+	bank = up == down ? nullptr : acquireBank(up, down);
+	reset();
+}
+
+void RationalResampler::reset() {
+	phase = 0;
+	// filter delay line starts with silence
+	const index delayLength = bank == nullptr ? 0 : bank->tapsPerPhase - 1;
+	history.reset(delayLength, 0.0f);
+}
+
+array_view<float> RationalResampler::process(array_view<float> source) {
+	if (bank == nullptr) {
+		return source;
+	}
+
+	history.compact();
+	source.transferToSpan(history.allocateNext(source.size()));
+
+	const index tapsCount = bank->tapsPerPhase;
+	const index available = history.getRemainingSize();
+	const float* data = history.getFirst(available).data();
+	const index unrolledCount = tapsCount / 4 * 4;
+
+	result.clear();
+	// index of the oldest input sample of the current output
+	index windowBegin = 0;
+	while (windowBegin + tapsCount <= available) {
+		const float* window = data + windowBegin;
+		const float* tapsData = bank->getPhase(phase);
+		// independent sums don't wait for each other
+		float sum0 = 0.0f;
+		float sum1 = 0.0f;
+		float sum2 = 0.0f;
+		float sum3 = 0.0f;
+		index j = 0;
+		for (; j < unrolledCount; j += 4) {
+			sum0 += window[j + 0] * tapsData[j + 0];
+			sum1 += window[j + 1] * tapsData[j + 1];
+			sum2 += window[j + 2] * tapsData[j + 2];
+			sum3 += window[j + 3] * tapsData[j + 3];
+		}
+		for (; j < tapsCount; j++) {
+			sum0 += window[j] * tapsData[j];
+		}
+		result.push_back((sum0 + sum1) + (sum2 + sum3));
+
+		phase += down;
+		windowBegin += phase / up;
+		phase %= up;
+	}
+
+	history.removeFirst(windowBegin);
+
+	return result;
+}
+
+RationalResampler::BankPtr RationalResampler::acquireBank(index up, index down) {
+	static std::mutex mutex;
+	static std::map<std::pair<index, index>, std::weak_ptr<const Bank>> banks;
+
+	const index divisor = std::gcd(up, down);
+	const auto key = std::make_pair(up / divisor, down / divisor);
+
+	std::lock_guard<std::mutex> lock{ mutex };
+
+	auto& weak = banks[key];
+	if (auto bank = weak.lock(); bank != nullptr) {
+		return bank;
+	}
+
+	// drop entries of released banks, so that the map doesn't grow when ratios change
+	for (auto iter = banks.begin(); iter != banks.end();) {
+		if (iter->second.expired() && &iter->second != &weak) {
+			iter = banks.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+
+	BankPtr bank = createBank(key.first, key.second);
+	weak = bank;
+	return bank;
+}
+
+std::shared_ptr<RationalResampler::Bank> RationalResampler::createBank(index up, index down) {
+	// in the units of upsampled rate
+	const double nyquist = 0.5 / static_cast<double>(std::max(up, down));
+	std::vector<float> prototype = FirDecimator::designLowPass(
+		passbandRatio * nyquist,
+		(2.0 - passbandRatio) * nyquist,
+		attenuationDb
+	);
+
+	auto bank = std::make_shared<Bank>();
+	bank->phasesCount = up;
+	bank->tapsPerPhase = (static_cast<index>(prototype.size()) + up - 1) / up;
+	bank->taps.resize(static_cast<size_t>(bank->phasesCount * bank->tapsPerPhase));
+
+	// Output sample with phase p is sum of prototype[p + k * up] * input[newest - k].
+	// Prototype has unity gain at DC, and only each up-th sample of upsampled signal is non-zero,
+	// so taps are scaled by up.
+	const auto gain = static_cast<float>(up);
+	for (index p = 0; p < up; p++) {
+		float* phaseTaps = bank->taps.data() + p * bank->tapsPerPhase;
+		for (index k = 0; k < bank->tapsPerPhase; k++) {
+			const index prototypeIndex = p + k * up;
+			const float value = prototypeIndex < static_cast<index>(prototype.size())
+				? prototype[static_cast<size_t>(prototypeIndex)] * gain
+				: 0.0f;
+			phaseTaps[bank->tapsPerPhase - 1 - k] = value;
+		}
+	}
+
+	return bank;
+}
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "rxtd/GrowingVector.h"
+
+namespace rxtd::filter_utils {
+	/// <summary>
+	/// Changes sample rate by a rational ratio up / down:
+	/// conceptually the signal is upsampled by #up, filtered with a low-pass FIR, and decimated by #down.
+	/// Filter is split into #up phases, and each output sample only uses the taps of one phase,
+	/// so the cost per output sample is taps count / up.
+	///
+	/// Filter is a Kaiser-windowed sinc, with the same passband and attenuation as PolyphaseDecimator,
+	/// relative to the lower of input and output nyquist frequencies.
+	/// Filter banks only depend on the ratio, so they are shared between all instances with the same ratio.
+	/// </summary>
+	class RationalResampler {
+	public:
+		static constexpr double passbandRatio = 0.9;
+		static constexpr double attenuationDb = 100.0;
+		// size of the filter bank grows linearly with the count of phases
+		static constexpr index maxPhases = 1024;
+
+		/// <summary>
+		/// Filter taps sorted by phase.
+		/// Taps of each phase are stored in reverse order, so that they can be applied to the input as is.
+		/// </summary>
+		struct Bank {
+			index phasesCount = 1;
+			index tapsPerPhase = 0;
+			std::vector<float> taps;
+
+			[[nodiscard]]
+			const float* getPhase(index phase) const {
+				return taps.data() + phase * tapsPerPhase;
+			}
+		};
+
+		using BankPtr = std::shared_ptr<const Bank>;
+
+	private:
+		index up = 0;
+		index down = 0;
+		BankPtr bank;
+
+		// phase of the next output sample
+		index phase = 0;
+		GrowingVector<float> history;
+		std::vector<float> result;
+
+	public:
+		/// <summary>
+		/// Ratio is reduced by the greatest common divisor.
+		/// Count of phases after the reduction must not exceed #maxPhases, otherwise std::runtime_error is thrown.
+		/// </summary>
+		void setRatio(index _up, index _down);
+
+		[[nodiscard]]
+		index getUp() const {
+			return up;
+		}
+
+		[[nodiscard]]
+		index getDown() const {
+			return down;
+		}
+
+		void reset();
+
+		/// <summary>
+		/// Returned view is valid until the next call.
+		/// </summary>
+		[[nodiscard]]
+		array_view<float> process(array_view<float> source);
+
+		/// <summary>
+		/// Returns a bank that is shared with all other users of the same reduced ratio.
+		/// Thread-safe.
+		/// </summary>
+		[[nodiscard]]
+		static BankPtr acquireBank(index up, index down);
+
+	private:
+		[[nodiscard]]
+		static std::shared_ptr<Bank> createBank(index up, index down);
+	};
+}
@@ -0,0 +1,336 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "SampleConverter.h"
+
+#include <cstring>
+
+#include "rxtd/std_fixes/CpuFeatures.h"
+
+using rxtd::filter_utils::SampleConverter;
+using rxtd::std_fixes::CpuFeatures;
+
+namespace {
+	using rxtd::index;
+
+	// count of samples in a chunk, chunk must fit into L1 cache together with its part of destination
+	constexpr index chunkSize = 2048;
+
+	constexpr float int16Scale = 1.0f / 32768.0f;
+	constexpr float int32Scale = 1.0f / 2147483648.0f;
+
+	void convertInt16Scalar(const std::byte* source, index count, float* dest) {
+		for (index i = 0; i < count; i++) {
+			int16_t value;
+			std::memcpy(&value, source + i * 2, sizeof(value));
+			dest[i] = static_cast<float>(value) * int16Scale;
+		}
+	}
+
+	void convertInt24Scalar(const std::byte* source, index count, float* dest) {
+		for (index i = 0; i < count; i++) {
+			const std::byte* ptr = source + i * 3;
+			// put 24 bits into the high part of int32 to keep the sign
+			const uint32_t bits = static_cast<uint32_t>(ptr[0]) << 8
+				| static_cast<uint32_t>(ptr[1]) << 16
+				| static_cast<uint32_t>(ptr[2]) << 24;
+			dest[i] = static_cast<float>(static_cast<int32_t>(bits)) * int32Scale;
+		}
+	}
+
+	void convertInt32Scalar(const std::byte* source, index count, float* dest) {
+		for (index i = 0; i < count; i++) {
+			int32_t value;
+			std::memcpy(&value, source + i * 4, sizeof(value));
+			dest[i] = static_cast<float>(value) * int32Scale;
+		}
+	}
+
+	void convertFloat(const std::byte* source, index count, float* dest) {
+		std::memcpy(dest, source, static_cast<size_t>(count) * sizeof(float));
+	}
+
+	// fixedCount == 0 means that the count of channels is only known at runtime
+	template<index fixedCount>
+	void splitScalarFixed(const float* source, index channelsCount, index framesCount, float* dest, index destStride) {
+		const index count = fixedCount != 0 ? fixedCount : channelsCount;
+		for (index channel = 0; channel < count; channel++) {
+			float* channelDest = dest + channel * destStride;
+			const float* channelSource = source + channel;
+			for (index frame = 0; frame < framesCount; frame++) {
+				channelDest[frame] = channelSource[frame * count];
+			}
+		}
+	}
+
+	void splitScalar(const float* source, index channelsCount, index framesCount, float* dest, index destStride) {
+		switch (channelsCount) {
+		case 1:
+			std::copy_n(source, framesCount, dest);
+			break;
+		case 2:
+			splitScalarFixed<2>(source, channelsCount, framesCount, dest, destStride);
+			break;
+		case 6:
+			splitScalarFixed<6>(source, channelsCount, framesCount, dest, destStride);
+			break;
+		case 8:
+			splitScalarFixed<8>(source, channelsCount, framesCount, dest, destStride);
+			break;
+		default:
+			splitScalarFixed<0>(source, channelsCount, framesCount, dest, destStride);
+			break;
+		}
+	}
+
+#ifdef RXTD_X86
+	// SSE2 is enough for these conversions, but they are only used in the SSSE3 set
+
+	void convertInt16Sse(const std::byte* source, index count, float* dest) {
+		const __m128 scale = _mm_set1_ps(int16Scale);
+		index i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 2));
+			// each value is put into both halves of int32, and shift of the high half extends the sign
+			const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+			const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+			_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+			_mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+		}
+		convertInt16Scalar(source + i * 2, count - i, dest + i);
+	}
+
+	RXTD_TARGET_SSSE3
+	void convertInt24Ssse3(const std::byte* source, index count, float* dest) {
+		// 3 bytes of each sample go into the high bytes of int32, like in scalar code
+		const __m128i shuffle = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+		const __m128 scale = _mm_set1_ps(int32Scale);
+		index i = 0;
+		// each iteration reads 16 bytes but only uses 12 of them
+		for (; i * 3 + 16 <= count * 3; i += 4) {
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 3));
+			const __m128i values = _mm_shuffle_epi8(bytes, shuffle);
+			_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(values), scale));
+		}
+		convertInt24Scalar(source + i * 3, count - i, dest + i);
+	}
+
+	void convertInt32Sse(const std::byte* source, index count, float* dest) {
+		const __m128 scale = _mm_set1_ps(int32Scale);
+		index i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+			_mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(values), scale));
+		}
+		convertInt32Scalar(source + i * 4, count - i, dest + i);
+	}
+
+	void splitStereoSse(const float* source, index framesCount, float* dest, index destStride) {
+		float* left = dest;
+		float* right = dest + destStride;
+		index frame = 0;
+		for (; frame + 4 <= framesCount; frame += 4) {
+			const __m128 a = _mm_loadu_ps(source + frame * 2);
+			const __m128 b = _mm_loadu_ps(source + frame * 2 + 4);
+			_mm_storeu_ps(left + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(right + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+		splitScalarFixed<2>(source + frame * 2, 2, framesCount - frame, dest + frame, destStride);
+	}
+
+	// Splits 4 frames at a time by transposing 4x4 blocks of consecutive channels.
+	// Count of channels must be at least 4.
+	// When it is not a multiple of 4, the last block is moved back to fit,
+	// so it overlaps the previous one and some values are written twice.
+	template<index fixedCount>
+	void splitBlocksSse(const float* source, index channelsCount, index framesCount, float* dest, index destStride) {
+		const index count = fixedCount != 0 ? fixedCount : channelsCount;
+		index frame = 0;
+		for (; frame + 4 <= framesCount; frame += 4) {
+			const float* frameSource = source + frame * count;
+			for (index block = 0; block < count; block += 4) {
+				const index first = std::min(block, count - 4);
+				__m128 row0 = _mm_loadu_ps(frameSource + first);
+				__m128 row1 = _mm_loadu_ps(frameSource + count + first);
+				__m128 row2 = _mm_loadu_ps(frameSource + count * 2 + first);
+				__m128 row3 = _mm_loadu_ps(frameSource + count * 3 + first);
+				_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+				float* blockDest = dest + first * destStride + frame;
+				_mm_storeu_ps(blockDest, row0);
+				_mm_storeu_ps(blockDest + destStride, row1);
+				_mm_storeu_ps(blockDest + destStride * 2, row2);
+				_mm_storeu_ps(blockDest + destStride * 3, row3);
+			}
+		}
+		splitScalarFixed<fixedCount>(source + frame * count, count, framesCount - frame, dest + frame, destStride);
+	}
+
+	void splitSse(const float* source, index channelsCount, index framesCount, float* dest, index destStride) {
+		switch (channelsCount) {
+		case 1:
+			std::copy_n(source, framesCount, dest);
+			break;
+		case 2:
+			splitStereoSse(source, framesCount, dest, destStride);
+			break;
+		case 3:
+			splitScalarFixed<0>(source, channelsCount, framesCount, dest, destStride);
+			break;
+		case 6:
+			splitBlocksSse<6>(source, channelsCount, framesCount, dest, destStride);
+			break;
+		case 8:
+			splitBlocksSse<8>(source, channelsCount, framesCount, dest, destStride);
+			break;
+		default:
+			splitBlocksSse<0>(source, channelsCount, framesCount, dest, destStride);
+			break;
+		}
+	}
+
+	RXTD_TARGET_AVX2
+	void convertInt16Avx2(const std::byte* source, index count, float* dest) {
+		const __m256 scale = _mm256_set1_ps(int16Scale);
+		index i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 2));
+			_mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(values)), scale));
+		}
+		convertInt16Scalar(source + i * 2, count - i, dest + i);
+	}
+
+	RXTD_TARGET_AVX2
+	void convertInt24Avx2(const std::byte* source, index count, float* dest) {
+		// shuffle works within 128-bit lanes, so each lane gets its own 12 bytes
+		const __m256i shuffle = _mm256_setr_epi8(
+			-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+			-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11
+		);
+		const __m256 scale = _mm256_set1_ps(int32Scale);
+		index i = 0;
+		// second lane is read 12 bytes after the first one, and both read 16 bytes
+		for (; i * 3 + 28 <= count * 3; i += 8) {
+			const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 3));
+			const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 3 + 12));
+			const __m256i bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1);
+			const __m256i values = _mm256_shuffle_epi8(bytes, shuffle);
+			_mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_cvtepi32_ps(values), scale));
+		}
+		convertInt24Ssse3(source + i * 3, count - i, dest + i);
+	}
+
+	RXTD_TARGET_AVX2
+	void convertInt32Avx2(const std::byte* source, index count, float* dest) {
+		const __m256 scale = _mm256_set1_ps(int32Scale);
+		index i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4));
+			_mm256_storeu_ps(dest + i, _mm256_mul_ps(_mm256_cvtepi32_ps(values), scale));
+		}
+		convertInt32Scalar(source + i * 4, count - i, dest + i);
+	}
+#endif
+}
+
+SampleConverter::SampleConverter(InstructionSet value) {
+	if (!isSupported(value)) {
+		value = getBestInstructionSet();
+	}
+	instructionSet = value;
+
+	switch (value) {
+	case InstructionSet::eSCALAR:
+		convertFunctions = { convertInt16Scalar, convertInt24Scalar, convertInt32Scalar, convertFloat };
+		splitFunction = splitScalar;
+		break;
+#ifdef RXTD_X86
+	case InstructionSet::eSSSE3:
+		convertFunctions = { convertInt16Sse, convertInt24Ssse3, convertInt32Sse, convertFloat };
+		splitFunction = splitSse;
+		break;
+	case InstructionSet::eAVX2:
+		convertFunctions = { convertInt16Avx2, convertInt24Avx2, convertInt32Avx2, convertFloat };
+		// 8x8 transpose with 256-bit stores was slower than SSE for some alignments of buffers,
+		// see --convert-bench, which warns if AVX2 becomes slower than SSSE3
+		splitFunction = splitSse;
+		break;
+#endif
+	default: break;
+	}
+}
+
+bool SampleConverter::isSupported(InstructionSet value) {
+	switch (value) {
+	case InstructionSet::eSCALAR: return true;
+#ifdef RXTD_X86
+	case InstructionSet::eSSSE3: return CpuFeatures::hasSsse3();
+	case InstructionSet::eAVX2: return CpuFeatures::hasAvx2();
+#endif
+	default: return false;
+	}
+}
+
+SampleConverter::InstructionSet SampleConverter::getBestInstructionSet() {
+	if (isSupported(InstructionSet::eAVX2)) {
+		return InstructionSet::eAVX2;
+	}
+	if (isSupported(InstructionSet::eSSSE3)) {
+		return InstructionSet::eSSSE3;
+	}
+	return InstructionSet::eSCALAR;
+}
+
+rxtd::index SampleConverter::getSampleSize(SampleType type) {
+	switch (type) {
+	case SampleType::eINT16: return 2;
+	case SampleType::eINT24: return 3;
+	case SampleType::eINT32: return 4;
+	case SampleType::eFLOAT32: return 4;
+	}
+	return 4;
+}
+
+void SampleConverter::deinterleave(const std::byte* source, SampleType type, std_fixes::array2d_span<float> dest) const {
+	const index channelsCount = dest.getBuffersCount();
+	const index framesCount = dest.getBufferSize();
+	if (channelsCount == 0 || framesCount == 0) {
+		return;
+	}
+
+	// buffers of array2d_span follow each other
+	float* destData = dest[0].data();
+	const index destStride = framesCount;
+	const index sampleSize = getSampleSize(type);
+	const auto convert = convertFunctions[static_cast<size_t>(type)];
+
+	// channels are split in chunks too, so that strided reads of each channel hit the cache
+	const index chunkFrames = std::max<index>(chunkSize / channelsCount, 1);
+
+	// float samples don't need conversion, but they can only be read in place when they are aligned
+	if (type == SampleType::eFLOAT32 && reinterpret_cast<std::uintptr_t>(source) % alignof(float) == 0) {
+		const auto floatSource = reinterpret_cast<const float*>(source);
+		for (index frame = 0; frame < framesCount; frame += chunkFrames) {
+			const index size = std::min(chunkFrames, framesCount - frame);
+			splitFunction(floatSource + frame * channelsCount, channelsCount, size, destData + frame, destStride);
+		}
+		return;
+	}
+
+	if (channelsCount > chunkSize) {
+		// not a real use case, but chunk can't hold even one frame
+		for (index frame = 0; frame < framesCount; frame++) {
+			for (index channel = 0; channel < channelsCount; channel++) {
+				convert(source + (frame * channelsCount + channel) * sampleSize, 1, destData + channel * destStride + frame);
+			}
+		}
+		return;
+	}
+
+	std::array<float, chunkSize> chunk;
+	for (index frame = 0; frame < framesCount; frame += chunkFrames) {
+		const index size = std::min(chunkFrames, framesCount - frame);
+		convert(source + frame * channelsCount * sampleSize, size * channelsCount, chunk.data());
+		splitFunction(chunk.data(), channelsCount, size, destData + frame, destStride);
+	}
+}
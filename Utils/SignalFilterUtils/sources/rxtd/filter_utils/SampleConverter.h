@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "rxtd/std_fixes/Vector2D.h"
+
+namespace rxtd::filter_utils {
+	/// <summary>
+	/// Converts interleaved PCM samples into float buffers, one buffer per channel.
+	///
+	/// Instruction set is chosen at runtime, like in BlockKernels.
+	/// Integer samples are converted in chunks that fit into L1 cache,
+	/// and then each chunk is split into channels, so source is only read once.
+	/// 1, 2, 6 and 8 channels have specialized splitting code.
+	/// All samples are converted exactly, or rounded the same way as static_cast would do,
+	/// so results don't depend on the instruction set.
+	/// </summary>
+	class SampleConverter {
+	public:
+		enum class SampleType {
+			eINT16,
+			eINT24,
+			eINT32,
+			eFLOAT32,
+		};
+
+		enum class InstructionSet {
+			eSCALAR,
+			eSSSE3,
+			eAVX2,
+		};
+
+	private:
+		using ConvertFunction = void(*)(const std::byte* source, index count, float* dest);
+		using SplitFunction = void(*)(const float* source, index channelsCount, index framesCount, float* dest, index destStride);
+
+		InstructionSet instructionSet = InstructionSet::eSCALAR;
+		// indexed by SampleType
+		std::array<ConvertFunction, 4> convertFunctions{};
+		SplitFunction splitFunction = nullptr;
+
+	public:
+		/// <summary>
+		/// Uses the best instruction set that current CPU supports.
+		/// </summary>
+		SampleConverter() : SampleConverter(getBestInstructionSet()) { }
+
+		/// <summary>
+		/// Falls back to the best supported instruction set if value is not supported.
+		/// </summary>
+		explicit SampleConverter(InstructionSet value);
+
+		[[nodiscard]]
+		InstructionSet getInstructionSet() const {
+			return instructionSet;
+		}
+
+		[[nodiscard]]
+		static bool isSupported(InstructionSet value);
+
+		[[nodiscard]]
+		static InstructionSet getBestInstructionSet();
+
+		[[nodiscard]]
+		static index getSampleSize(SampleType type);
+
+		/// <summary>
+		/// Reads dest.getBufferSize() frames of dest.getBuffersCount() channels from source.
+		/// Source doesn't need to be aligned.
+		/// Integer samples are scaled so that the lowest possible value becomes -1.0.
+		/// </summary>
+		void deinterleave(const std::byte* source, SampleType type, std_fixes::array2d_span<float> dest) const;
+	};
+}
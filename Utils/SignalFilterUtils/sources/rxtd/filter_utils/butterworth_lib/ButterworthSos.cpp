@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "ButterworthSos.h"
+
+#include <complex>
+
+#include "rxtd/std_fixes/MyMath.h"
+
+using rxtd::filter_utils::BiquadCoefficients;
+using rxtd::filter_utils::butterworth_lib::ButterworthSos;
+using rxtd::std_fixes::MyMath;
+
+namespace {
+	using rxtd::index;
+	using complex = std::complex<double>;
+
+	// analog frequency that bilinear transform maps to the given digital frequency
+	double prewarp(double digitalFrequency) {
+		// ButterworthWrapper has to limit frequencies to [0.01, 0.99] to keep polynomials sane,
+		// sections only need to keep poles away from 0 and nyquist
+		digitalFrequency = std::clamp(digitalFrequency, 1e-5, 1.0 - 1e-5);
+		return std::tan(MyMath::pi<double>() * digitalFrequency * 0.5);
+	}
+
+	complex bilinear(complex s) {
+		return (1.0 + s) / (1.0 - s);
+	}
+
+	// Poles of analog low pass prototype with cutoff at 1.
+	// Only poles with positive imaginary part are returned, the other half is conjugate,
+	// for odd orders the last pole is -1.
+	std::vector<complex> getPrototypePoles(index order) {
+		std::vector<complex> result;
+		for (index k = 0; k < order / 2; k++) {
+			const double theta = MyMath::pi<double>() * static_cast<double>(2 * k + 1) / static_cast<double>(2 * order);
+			result.emplace_back(-std::sin(theta), std::cos(theta));
+		}
+		if (order % 2 == 1) {
+			result.emplace_back(-1.0, 0.0);
+		}
+		return result;
+	}
+
+	// Poles and zeros must be either a conjugate pair or 2 real values.
+	// First order sections should pass 0 as the second pole and zero.
+	BiquadCoefficients makeSection(complex pole1, complex pole2, complex zero1, complex zero2) {
+		BiquadCoefficients result;
+		result.b0 = 1.0;
+		result.b1 = -(zero1 + zero2).real();
+		result.b2 = (zero1 * zero2).real();
+		result.a1 = -(pole1 + pole2).real();
+		result.a2 = (pole1 * pole2).real();
+		return result;
+	}
+
+	// scales numerator so that the section has unity gain at digital angular frequency omega
+	void normalize(BiquadCoefficients& section, double omega) {
+		const complex z1 = std::polar(1.0, -omega);
+		const complex z2 = z1 * z1;
+		const complex numerator = section.b0 + section.b1 * z1 + section.b2 * z2;
+		const complex denominator = 1.0 + section.a1 * z1 + section.a2 * z2;
+		const double gain = std::abs(numerator / denominator);
+
+		section.b0 /= gain;
+		section.b1 /= gain;
+		section.b2 /= gain;
+	}
+
+	// both roots of s^2 - p*s + q == 0
+	std::pair<complex, complex> solveQuadratic(complex p, complex q) {
+		const complex root = std::sqrt(p * p - 4.0 * q);
+		return { (p + root) * 0.5, (p - root) * 0.5 };
+	}
+
+	std::vector<BiquadCoefficients> finish(std::vector<BiquadCoefficients> sections, double normalizationOmega) {
+		for (auto& section : sections) {
+			normalize(section, normalizationOmega);
+		}
+
+		// poles that are closer to the unit circle have sharper resonance, so they go last
+		std::stable_sort(
+			sections.begin(), sections.end(), [](const BiquadCoefficients& lhs, const BiquadCoefficients& rhs) {
+				return std::abs(lhs.a2) < std::abs(rhs.a2);
+			}
+		);
+
+		return sections;
+	}
+}
+
+std::vector<BiquadCoefficients> ButterworthSos::lowPass(index order, double digitalCutoff, double) {
+	const double omega = prewarp(digitalCutoff);
+
+	std::vector<BiquadCoefficients> result;
+	for (const auto prototypePole : getPrototypePoles(order)) {
+		const complex pole = bilinear(omega * prototypePole);
+		if (prototypePole.imag() == 0.0) {
+			result.push_back(makeSection(pole, 0.0, -1.0, 0.0));
+		} else {
+			result.push_back(makeSection(pole, std::conj(pole), -1.0, -1.0));
+		}
+	}
+
+	return finish(std::move(result), 0.0);
+}
+
+std::vector<BiquadCoefficients> ButterworthSos::highPass(index order, double digitalCutoff, double) {
+	const double omega = prewarp(digitalCutoff);
+
+	std::vector<BiquadCoefficients> result;
+	for (const auto prototypePole : getPrototypePoles(order)) {
+		const complex pole = bilinear(omega / prototypePole);
+		if (prototypePole.imag() == 0.0) {
+			result.push_back(makeSection(pole, 0.0, 1.0, 0.0));
+		} else {
+			result.push_back(makeSection(pole, std::conj(pole), 1.0, 1.0));
+		}
+	}
+
+	return finish(std::move(result), MyMath::pi<double>());
+}
+
+std::vector<BiquadCoefficients> ButterworthSos::bandPass(index order, double digitalCutoffLow, double digitalCutoffHigh) {
+	const double omegaLow = prewarp(std::min(digitalCutoffLow, digitalCutoffHigh));
+	const double omegaHigh = prewarp(std::max(digitalCutoffLow, digitalCutoffHigh));
+	const double bandwidth = omegaHigh - omegaLow;
+	const double centerSquared = omegaLow * omegaHigh;
+
+	// low pass to band pass: s -> (s^2 + center^2) / (bandwidth * s)
+	// each prototype pole p becomes 2 poles, the roots of s^2 - p * bandwidth * s + center^2
+	std::vector<BiquadCoefficients> result;
+	for (const auto prototypePole : getPrototypePoles(order)) {
+		const auto [s1, s2] = solveQuadratic(prototypePole * bandwidth, centerSquared);
+		const complex pole1 = bilinear(s1);
+		const complex pole2 = bilinear(s2);
+		if (prototypePole.imag() == 0.0) {
+			// roots of a real polynomial: either conjugate or both real
+			result.push_back(makeSection(pole1, pole2, 1.0, -1.0));
+		} else {
+			result.push_back(makeSection(pole1, std::conj(pole1), 1.0, -1.0));
+			result.push_back(makeSection(pole2, std::conj(pole2), 1.0, -1.0));
+		}
+	}
+
+	return finish(std::move(result), 2.0 * std::atan(std::sqrt(centerSquared)));
+}
+
+std::vector<BiquadCoefficients> ButterworthSos::bandStop(index order, double digitalCutoffLow, double digitalCutoffHigh) {
+	const double omegaLow = prewarp(std::min(digitalCutoffLow, digitalCutoffHigh));
+	const double omegaHigh = prewarp(std::max(digitalCutoffLow, digitalCutoffHigh));
+	const double bandwidth = omegaHigh - omegaLow;
+	const double centerSquared = omegaLow * omegaHigh;
+
+	// low pass to band stop: s -> bandwidth * s / (s^2 + center^2)
+	// each prototype pole p becomes 2 poles, the roots of s^2 - bandwidth / p * s + center^2,
+	// and all zeros are at +-j*center
+	const complex zero = bilinear(complex{ 0.0, std::sqrt(centerSquared) });
+
+	std::vector<BiquadCoefficients> result;
+	for (const auto prototypePole : getPrototypePoles(order)) {
+		const auto [s1, s2] = solveQuadratic(bandwidth / prototypePole, centerSquared);
+		const complex pole1 = bilinear(s1);
+		const complex pole2 = bilinear(s2);
+		if (prototypePole.imag() == 0.0) {
+			result.push_back(makeSection(pole1, pole2, zero, std::conj(zero)));
+		} else {
+			result.push_back(makeSection(pole1, std::conj(pole1), zero, std::conj(zero)));
+			result.push_back(makeSection(pole2, std::conj(pole2), zero, std::conj(zero)));
+		}
+	}
+
+	return finish(std::move(result), 0.0);
+}
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include "rxtd/filter_utils/BiquadCascade.h"
+
+namespace rxtd::filter_utils::butterworth_lib {
+	/// <summary>
+	/// Butterworth filters designed directly as second order sections.
+	///
+	/// ButterworthWrapper multiplies all poles into one polynomial,
+	/// which loses precision quickly with high orders and low cutoff frequencies.
+	/// Here poles of the analog prototype are moved to digital domain one by one with bilinear transform,
+	/// and then each conjugate pair of poles makes one section.
+	///
+	/// Digital cutoff frequencies use the same convention as ButterworthWrapper: 1.0 is the nyquist frequency.
+	/// Each section is normalized to have unity gain in the middle of the passband,
+	/// so that intermediate values stay in the range of the signal.
+	/// Sections are sorted by pole radius, the most resonant section is the last one.
+	/// </summary>
+	class ButterworthSos {
+	public:
+		using DesignFuncSignature = std::vector<BiquadCoefficients>(*)(index order, double digitalCutoffLow, double digitalCutoffHigh);
+
+		/// <summary>
+		/// digitalCutoffHigh is ignored.
+		/// </summary>
+		[[nodiscard]]
+		static std::vector<BiquadCoefficients> lowPass(index order, double digitalCutoff, double digitalCutoffHigh = 0.0);
+
+		/// <summary>
+		/// digitalCutoffHigh is ignored.
+		/// </summary>
+		[[nodiscard]]
+		static std::vector<BiquadCoefficients> highPass(index order, double digitalCutoff, double digitalCutoffHigh = 0.0);
+
+		/// <summary>
+		/// Has 2*order poles, so the result has order sections.
+		/// </summary>
+		[[nodiscard]]
+		static std::vector<BiquadCoefficients> bandPass(index order, double digitalCutoffLow, double digitalCutoffHigh);
+
+		/// <summary>
+		/// Has 2*order poles, so the result has order sections.
+		/// </summary>
+		[[nodiscard]]
+		static std::vector<BiquadCoefficients> bandStop(index order, double digitalCutoffLow, double digitalCutoffHigh);
+
+		[[nodiscard]]
+		static BiquadCascade createFilter(
+			DesignFuncSignature designFunc,
+			index order,
+			double samplingFrequency,
+			double cutoffLow, double cutoffHigh
+		) {
+			return {
+				designFunc(order, 2.0 * cutoffLow / samplingFrequency, 2.0 * cutoffHigh / samplingFrequency),
+				1.0
+			};
+		}
+	};
+}
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+#include <random>
+
+#include "rxtd/filter_utils/BlockKernels.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace rxtd::test::filter_utils {
+	using namespace rxtd::filter_utils;
+
+	TEST_CLASS(BlockKernels_test) {
+		using InstructionSet = BlockKernels::InstructionSet;
+
+		// short sizes use inline loop, other sizes check tails of vectorized loops
+		static constexpr std::array<index, 9> sizes{ 0, 1, 7, 8, 9, 16, 23, 1021, 4096 };
+
+	public:
+		TEST_METHOD(FallbackIsSupported) {
+			Assert::IsTrue(BlockKernels::isSupported(BlockKernels::getBestInstructionSet()));
+			Assert::IsTrue(BlockKernels{}.getInstructionSet() == BlockKernels::getBestInstructionSet());
+
+			for (const auto set : { InstructionSet::eSCALAR, InstructionSet::eSSE, InstructionSet::eAVX }) {
+				Assert::IsTrue(BlockKernels::isSupported(BlockKernels{ set }.getInstructionSet()));
+			}
+		}
+
+		TEST_METHOD(SumOfSquares_SameAsScalar) {
+			const BlockKernels scalar{ InstructionSet::eSCALAR };
+			for (const index size : sizes) {
+				const auto wave = generateRandom(size, 1);
+				const double expected = scalar.sumOfSquares(wave);
+
+				forEachSupported([&](const BlockKernels& kernels) {
+					// all instruction sets do the same operations, so results must be exactly the same
+					Assert::AreEqual(expected, kernels.sumOfSquares(wave));
+				});
+			}
+		}
+
+		TEST_METHOD(MaxAbs_SameAsScalar) {
+			const BlockKernels scalar{ InstructionSet::eSCALAR };
+			for (const index size : sizes) {
+				const auto wave = generateRandom(size, 2);
+				const float expected = scalar.maxAbs(wave);
+
+				forEachSupported([&](const BlockKernels& kernels) {
+					Assert::AreEqual(expected, kernels.maxAbs(wave));
+				});
+			}
+		}
+
+		TEST_METHOD(SumOfSquares_SameAsLoop) {
+			for (const index size : sizes) {
+				const auto wave = generateRandom(size, 3);
+
+				double expected = 0.0;
+				for (const float x : wave) {
+					expected += static_cast<double>(x * x);
+				}
+
+				// only the order of additions is different
+				Assert::AreEqual(expected, BlockKernels{ InstructionSet::eSCALAR }.sumOfSquares(wave), expected * 1e-14);
+			}
+		}
+
+		TEST_METHOD(MaxAbs_SameAsLoop) {
+			for (const index size : sizes) {
+				// negative peak must be found as well as positive
+				for (const float sign : { 1.0f, -1.0f }) {
+					auto wave = generateRandom(size, 4);
+					if (size > 0) {
+						wave[static_cast<size_t>(size) - 1] = sign * 2.0f;
+					}
+
+					float expected = 0.0f;
+					for (const float x : wave) {
+						expected = std::max(expected, std::abs(x));
+					}
+
+					forEachSupported([&](const BlockKernels& kernels) {
+						Assert::AreEqual(expected, kernels.maxAbs(wave));
+					});
+				}
+			}
+		}
+
+		TEST_METHOD(WeightedSum_SameAsLoop) {
+			for (const index sourcesCount : { 1, 2, 3, 6, 8 }) {
+				for (const index size : sizes) {
+					std::vector<std::vector<float>> waves;
+					std::vector<const float*> sources;
+					std::vector<float> weights;
+					for (index j = 0; j < sourcesCount; j++) {
+						waves.push_back(generateRandom(size, static_cast<unsigned>(10 + j)));
+						weights.push_back(0.25f + static_cast<float>(j) * 0.125f);
+					}
+					for (const auto& wave : waves) {
+						sources.push_back(wave.data());
+					}
+
+					std::vector<float> expected(static_cast<size_t>(size));
+					for (index i = 0; i < size; i++) {
+						float sum = waves[0][static_cast<size_t>(i)] * weights[0];
+						for (index j = 1; j < sourcesCount; j++) {
+							sum += waves[static_cast<size_t>(j)][static_cast<size_t>(i)] * weights[static_cast<size_t>(j)];
+						}
+						expected[static_cast<size_t>(i)] = sum;
+					}
+
+					forEachSupported([&](const BlockKernels& kernels) {
+						std::vector<float> dest(static_cast<size_t>(size));
+						kernels.weightedSum(sources, weights, dest);
+						Assert::IsTrue(expected == dest);
+
+						// result can be written over the first source
+						auto inPlace = waves[0];
+						auto inPlaceSources = sources;
+						inPlaceSources[0] = inPlace.data();
+						kernels.weightedSum(inPlaceSources, weights, inPlace);
+						Assert::IsTrue(expected == inPlace);
+					});
+				}
+			}
+		}
+
+	private:
+		template<typename Callback>
+		static void forEachSupported(Callback callback) {
+			for (const auto set : { InstructionSet::eSCALAR, InstructionSet::eSSE, InstructionSet::eAVX }) {
+				if (BlockKernels::isSupported(set)) {
+					callback(BlockKernels{ set });
+				}
+			}
+		}
+
+		static std::vector<float> generateRandom(index size, unsigned seed) {
+			std::mt19937 random{ seed };
+			std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+			std::vector<float> result(static_cast<size_t>(size));
+			for (float& value : result) {
+				value = distribution(random);
+			}
+			return result;
+		}
+	};
+}
@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+#include <complex>
+
+#include "rxtd/filter_utils/butterworth_lib/ButterworthSos.h"
+#include "rxtd/filter_utils/butterworth_lib/ButterworthWrapper.h"
+#include "rxtd/std_fixes/MyMath.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+using rxtd::std_fixes::MyMath;
+
+namespace rxtd::test::filter_utils {
+	using namespace rxtd::filter_utils;
+	using namespace rxtd::filter_utils::butterworth_lib;
+
+	TEST_CLASS(ButterworthSos_test) {
+		using complex = std::complex<double>;
+
+		static constexpr index responsePoints = 500;
+
+	public:
+		TEST_METHOD(LowPass_SameAsPolynomial) {
+			for (index order = 1; order <= 5; order++) {
+				for (const double cutoff : { 0.05, 0.2, 0.5, 0.9 }) {
+					compareResponse(ButterworthSos::lowPass(order, cutoff), ButterworthWrapper::lowPass.calcCoefDigital(order, cutoff));
+				}
+			}
+		}
+
+		TEST_METHOD(HighPass_SameAsPolynomial) {
+			for (index order = 1; order <= 5; order++) {
+				for (const double cutoff : { 0.05, 0.2, 0.5, 0.9 }) {
+					compareResponse(ButterworthSos::highPass(order, cutoff), ButterworthWrapper::highPass.calcCoefDigital(order, cutoff));
+				}
+			}
+		}
+
+		TEST_METHOD(BandPass_SameAsPolynomial) {
+			for (index order = 1; order <= 5; order++) {
+				for (const auto [low, high] : { std::pair{ 0.05, 0.1 }, std::pair{ 0.2, 0.6 }, std::pair{ 0.5, 0.9 } }) {
+					compareResponse(ButterworthSos::bandPass(order, low, high), ButterworthWrapper::bandPass.calcCoefDigital(order, low, high));
+				}
+			}
+		}
+
+		TEST_METHOD(BandStop_SameAsPolynomial) {
+			for (index order = 1; order <= 5; order++) {
+				for (const auto [low, high] : { std::pair{ 0.05, 0.1 }, std::pair{ 0.2, 0.6 }, std::pair{ 0.5, 0.9 } }) {
+					compareResponse(ButterworthSos::bandStop(order, low, high), ButterworthWrapper::bandStop.calcCoefDigital(order, low, high));
+				}
+			}
+		}
+
+		TEST_METHOD(SectionsAreStable) {
+			// 20-25 Hz at 48 kHz: polynomial form can't represent such filters reliably
+			const double low = 20.0 / 24000.0;
+			const double high = 25.0 / 24000.0;
+			for (index order = 1; order <= 10; order++) {
+				checkStable(ButterworthSos::lowPass(order, low));
+				checkStable(ButterworthSos::highPass(order, low));
+				checkStable(ButterworthSos::bandPass(order, low, high));
+				checkStable(ButterworthSos::bandStop(order, low, high));
+			}
+		}
+
+		TEST_METHOD(FloatRuntime_MatchesDesign) {
+			// low cutoff and high order is where polynomial form used to fail
+			const double low = 40.0 / 24000.0;
+			const double high = 80.0 / 24000.0;
+			const auto sections = ButterworthSos::bandPass(5, low, high);
+
+			for (const double frequency : { 30.0 / 24000.0, 40.0 / 24000.0, 56.0 / 24000.0, 80.0 / 24000.0, 120.0 / 24000.0 }) {
+				const double expected = 20.0 * std::log10(std::abs(getResponse(sections, frequency)));
+				const double actual = measureGainDb(sections, frequency);
+				Assert::AreEqual(expected, actual, 0.05);
+			}
+		}
+
+		TEST_METHOD(FloatRuntime_Decays) {
+			BiquadCascade filter{ ButterworthSos::bandPass(5, 20.0 / 24000.0, 25.0 / 24000.0), 1.0 };
+
+			std::vector<float> signal;
+			signal.resize(48000 * 10);
+			signal[0] = 1.0f;
+			filter.apply(signal);
+
+			float tailMax = 0.0f;
+			for (index i = static_cast<index>(signal.size()) - 48000; i < static_cast<index>(signal.size()); i++) {
+				tailMax = std::max(tailMax, std::abs(signal[static_cast<size_t>(i)]));
+			}
+			Assert::IsTrue(tailMax < 1e-6f);
+		}
+
+	private:
+		// frequency is digital, 1.0 is nyquist
+		static complex getResponse(array_view<BiquadCoefficients> sections, double frequency) {
+			const complex z1 = std::polar(1.0, -MyMath::pi<double>() * frequency);
+			const complex z2 = z1 * z1;
+			complex result = 1.0;
+			for (const auto& s : sections) {
+				result *= (s.b0 + s.b1 * z1 + s.b2 * z2) / (1.0 + s.a1 * z1 + s.a2 * z2);
+			}
+			return result;
+		}
+
+		static complex getResponse(const FilterParameters& params, double frequency) {
+			const complex z1 = std::polar(1.0, -MyMath::pi<double>() * frequency);
+			complex numerator = 0.0;
+			complex denominator = 0.0;
+			complex power = 1.0;
+			for (index i = 0; i < static_cast<index>(std::max(params.a.size(), params.b.size())); i++) {
+				if (i < static_cast<index>(params.b.size())) {
+					numerator += params.b[static_cast<size_t>(i)] * power;
+				}
+				if (i < static_cast<index>(params.a.size())) {
+					denominator += params.a[static_cast<size_t>(i)] * power;
+				}
+				power *= z1;
+			}
+			return params.gainAmp * numerator / denominator;
+		}
+
+		static void compareResponse(array_view<BiquadCoefficients> sections, const FilterParameters& reference) {
+			for (index i = 1; i < responsePoints; i++) {
+				const double frequency = static_cast<double>(i) / static_cast<double>(responsePoints);
+				const double expected = 20.0 * std::log10(std::abs(getResponse(reference, frequency)));
+				if (expected < -40.0) {
+					// deep stopband is where polynomial form is the least precise
+					continue;
+				}
+				const double actual = 20.0 * std::log10(std::abs(getResponse(sections, frequency)));
+				Assert::AreEqual(expected, actual, 0.01);
+			}
+		}
+
+		static void checkStable(array_view<BiquadCoefficients> sections) {
+			for (const auto& s : sections) {
+				// stability triangle of a second order section
+				Assert::IsTrue(std::abs(s.a2) < 1.0);
+				Assert::IsTrue(std::abs(s.a1) < 1.0 + s.a2);
+			}
+		}
+
+		static double measureGainDb(array_view<BiquadCoefficients> sections, double frequency) {
+			BiquadCascade filter{ sections, 1.0 };
+
+			const double step = MyMath::pi<double>() * frequency;
+			std::vector<float> signal;
+			signal.resize(48000 * 4);
+			for (index i = 0; i < static_cast<index>(signal.size()); i++) {
+				signal[static_cast<size_t>(i)] = static_cast<float>(std::sin(step * static_cast<double>(i)));
+			}
+
+			// several blocks like in real use
+			array_span<float> span = signal;
+			constexpr index blockSize = 480;
+			for (index offset = 0; offset < span.size(); offset += blockSize) {
+				filter.apply({ span.data() + offset, std::min(blockSize, span.size() - offset) });
+			}
+
+			// skip filter warm up
+			double sum = 0.0;
+			const index begin = static_cast<index>(signal.size()) / 2;
+			for (index i = begin; i < static_cast<index>(signal.size()); i++) {
+				const auto value = static_cast<double>(signal[static_cast<size_t>(i)]);
+				sum += value * value;
+			}
+			const double rms = std::sqrt(sum / static_cast<double>(static_cast<index>(signal.size()) - begin));
+
+			return 20.0 * std::log10(rms * std::sqrt(2.0));
+		}
+	};
+}
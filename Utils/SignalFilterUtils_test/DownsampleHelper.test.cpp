@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+
+#include "rxtd/filter_utils/DownsampleHelper.h"
+#include "rxtd/std_fixes/MyMath.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+using rxtd::std_fixes::MyMath;
+
+namespace rxtd::test::filter_utils {
+	using namespace rxtd::filter_utils;
+	TEST_CLASS(DownsampleHelper_test) {
+		using Method = DownsampleHelper::Method;
+
+		static constexpr index chunkSize = 480;
+		static constexpr index outputSize = 8192;
+
+	public:
+		TEST_METHOD(Iir_Passband) {
+			for (const index factor : { 2, 3, 4, 8 }) {
+				testPassband(Method::eIIR, factor, 0.7, 0.1);
+			}
+		}
+
+		TEST_METHOD(Iir_Stopband) {
+			for (const index factor : { 2, 3, 4, 8 }) {
+				testStopband(Method::eIIR, factor, 1.2, 55.0);
+			}
+		}
+
+		TEST_METHOD(Polyphase_Passband) {
+			for (const index factor : { 2, 3, 4, 5, 6, 8, 12, 16 }) {
+				testPassband(Method::ePOLYPHASE, factor, 0.9, 0.01);
+			}
+		}
+
+		TEST_METHOD(Polyphase_Stopband) {
+			for (const index factor : { 2, 3, 4, 5, 6, 8, 12, 16 }) {
+				testStopband(Method::ePOLYPHASE, factor, 1.1, 85.0);
+			}
+		}
+
+		TEST_METHOD(Polyphase_NotWorseThanIir) {
+			for (const index factor : { 2, 3, 4, 8 }) {
+				double iirPassbandError = 0.0;
+				double polyphasePassbandError = 0.0;
+				for (double ratio = 0.05; ratio <= 0.7; ratio += 0.05) {
+					iirPassbandError = std::max(iirPassbandError, std::abs(measureGainDb(Method::eIIR, factor, ratio)));
+					polyphasePassbandError = std::max(polyphasePassbandError, std::abs(measureGainDb(Method::ePOLYPHASE, factor, ratio)));
+				}
+				Assert::IsTrue(polyphasePassbandError <= iirPassbandError);
+
+				double iirWorstStopband = 0.0;
+				double polyphaseWorstStopband = 0.0;
+				for (double ratio = 1.2; ratio < static_cast<double>(factor); ratio += 0.1) {
+					iirWorstStopband = std::max(iirWorstStopband, measureGainDb(Method::eIIR, factor, ratio));
+					polyphaseWorstStopband = std::max(polyphaseWorstStopband, measureGainDb(Method::ePOLYPHASE, factor, ratio));
+				}
+				Assert::IsTrue(polyphaseWorstStopband <= iirWorstStopband);
+			}
+		}
+
+		TEST_METHOD(Polyphase_OutputSize) {
+			DownsampleHelper dh;
+			dh.setMethod(Method::ePOLYPHASE);
+			dh.setFactor(6);
+
+			std::vector<float> wave;
+			wave.resize(static_cast<size_t>(chunkSize + 5));
+			std::vector<float> result;
+
+			index total = 0;
+			for (index i = 0; i < 6; i++) {
+				result.resize(static_cast<size_t>(dh.pushData(wave)));
+				total += dh.downsample(result);
+			}
+
+			Assert::AreEqual(static_cast<index>(wave.size()), total);
+		}
+
+	private:
+		void testPassband(Method method, index factor, double maxRatio, double toleranceDb) {
+			for (double ratio = 0.05; ratio <= maxRatio; ratio += 0.05) {
+				const double gain = measureGainDb(method, factor, ratio);
+				Assert::AreEqual(0.0, gain, toleranceDb);
+			}
+		}
+
+		void testStopband(Method method, index factor, double minRatio, double attenuationDb) {
+			// everything between new nyquist and old nyquist is aliased into the result
+			for (double ratio = minRatio; ratio < static_cast<double>(factor); ratio += 0.1) {
+				const double gain = measureGainDb(method, factor, ratio);
+				Assert::IsTrue(gain < -attenuationDb);
+			}
+		}
+
+		// frequencyRatio is sine frequency relative to new nyquist frequency
+		static double measureGainDb(Method method, index factor, double frequencyRatio) {
+			DownsampleHelper dh;
+			dh.setMethod(method);
+			dh.setFactor(factor);
+
+			const double frequency = frequencyRatio * 0.5 / static_cast<double>(factor);
+			const index inputSize = outputSize * factor;
+
+			std::vector<float> chunk;
+			std::vector<float> result;
+			std::vector<float> output;
+			for (index offset = 0; offset < inputSize; offset += chunkSize) {
+				chunk.resize(static_cast<size_t>(std::min(chunkSize, inputSize - offset)));
+				for (index i = 0; i < static_cast<index>(chunk.size()); i++) {
+					chunk[static_cast<size_t>(i)] = static_cast<float>(std::sin(2.0 * MyMath::pi<double>() * frequency * static_cast<double>(offset + i)));
+				}
+
+				result.resize(static_cast<size_t>(dh.pushData(chunk)));
+				const index size = dh.downsample(result);
+				output.insert(output.end(), result.begin(), result.begin() + size);
+			}
+
+			// skip filter warm up
+			double sum = 0.0;
+			const index begin = static_cast<index>(output.size()) / 4;
+			for (index i = begin; i < static_cast<index>(output.size()); i++) {
+				sum += static_cast<double>(output[static_cast<size_t>(i)]) * static_cast<double>(output[static_cast<size_t>(i)]);
+			}
+			const double rms = std::sqrt(sum / static_cast<double>(static_cast<index>(output.size()) - begin));
+
+			return 20.0 * std::log10(std::max(rms * std::sqrt(2.0), 1e-12));
+		}
+	};
+}
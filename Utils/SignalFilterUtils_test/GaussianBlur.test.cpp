@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+#include <numeric>
+
+#include "rxtd/filter_utils/GaussianBlur.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace rxtd::test::filter_utils {
+	using namespace rxtd::filter_utils;
+
+	TEST_CLASS(GaussianBlur_test) {
+		using Method = GaussianBlur::Method;
+
+		static constexpr index size = 1000;
+
+	public:
+		TEST_METHOD(AutoMethod) {
+			GaussianBlur blur;
+			blur.setParams(GaussianBlur::autoKernelMaxRadius, Method::eAUTO);
+			Assert::IsTrue(blur.getMethod() == Method::eKERNEL);
+			blur.setParams(GaussianBlur::autoKernelMaxRadius + 1.0f, Method::eAUTO);
+			Assert::IsTrue(blur.getMethod() == Method::eRECURSIVE);
+		}
+
+		TEST_METHOD(KernelIsConvolution) {
+			for (const float radius : { 1.0f, 2.5f, 7.0f }) {
+				const auto source = generateNoise();
+				const auto kernel = GaussianBlur::createKernel(radius);
+				const auto expected = convolve(source, kernel);
+				const auto result = run(source, radius, Method::eKERNEL);
+				Assert::IsTrue(result == expected);
+			}
+		}
+
+		TEST_METHOD(Recursive_KernelShape) {
+			for (const float radius : { 6.0f, 15.0f, 60.0f }) {
+				testShape(Method::eRECURSIVE, radius, 0.03);
+			}
+		}
+
+		TEST_METHOD(Box_KernelShape) {
+			for (const float radius : { 6.0f, 15.0f, 60.0f }) {
+				testShape(Method::eBOX, radius, 0.08);
+			}
+		}
+
+		TEST_METHOD(Recursive_Edges) {
+			for (const float radius : { 6.0f, 15.0f, 60.0f }) {
+				testEdges(Method::eRECURSIVE, radius, 0.03);
+			}
+		}
+
+		TEST_METHOD(Box_Edges) {
+			for (const float radius : { 6.0f, 15.0f, 60.0f }) {
+				testEdges(Method::eBOX, radius, 0.08);
+			}
+		}
+
+	private:
+		static std::vector<float> generateNoise() {
+			std::vector<float> result(static_cast<size_t>(size));
+			uint32_t state = 1;
+			for (float& value : result) {
+				state = state * 1664525u + 1013904223u;
+				value = static_cast<float>(state >> 8) / static_cast<float>(1 << 24);
+			}
+			return result;
+		}
+
+		// zeros outside of the source
+		static std::vector<float> convolve(const std::vector<float>& source, const std::vector<float>& kernel) {
+			const index radius = static_cast<index>(kernel.size()) / 2;
+			std::vector<float> result(source.size());
+			for (index i = 0; i < static_cast<index>(source.size()); i++) {
+				float sum = 0.0f;
+				for (index k = 0; k < static_cast<index>(kernel.size()); k++) {
+					const index j = i - radius + k;
+					if (j >= 0 && j < static_cast<index>(source.size())) {
+						sum += kernel[static_cast<size_t>(k)] * source[static_cast<size_t>(j)];
+					}
+				}
+				result[static_cast<size_t>(i)] = sum;
+			}
+			return result;
+		}
+
+		static std::vector<float> run(const std::vector<float>& source, float radius, Method method) {
+			GaussianBlur blur;
+			blur.setParams(radius, method);
+			std::vector<float> result(source.size());
+			blur.apply(source, result);
+			return result;
+		}
+
+		// max difference relative to the max value of the exact result
+		static double compare(const std::vector<float>& expected, const std::vector<float>& actual) {
+			double maxError = 0.0;
+			double maxValue = 0.0;
+			for (size_t i = 0; i < expected.size(); i++) {
+				maxError = std::max(maxError, std::abs(static_cast<double>(expected[i]) - actual[i]));
+				maxValue = std::max(maxValue, std::abs(static_cast<double>(expected[i])));
+			}
+			return maxError / maxValue;
+		}
+
+		// impulse response in the middle is compared with the exact kernel
+		static void testShape(Method method, float radius, double maxError) {
+			std::vector<float> impulse(static_cast<size_t>(size));
+			impulse[size / 2] = 1.0f;
+
+			const auto expected = convolve(impulse, GaussianBlur::createKernel(radius));
+			const auto result = run(impulse, radius, method);
+
+			Assert::IsTrue(compare(expected, result) < maxError);
+
+			// blur must preserve the sum
+			const double sum = std::accumulate(result.begin(), result.end(), 0.0);
+			Assert::AreEqual(1.0, sum, 1e-4);
+		}
+
+		// values near edges only get contributions from inside of the array
+		static void testEdges(Method method, float radius, double maxError) {
+			const std::vector<float> constant(static_cast<size_t>(size), 1.0f);
+			const auto expected = convolve(constant, GaussianBlur::createKernel(radius));
+			const auto result = run(constant, radius, method);
+			Assert::IsTrue(compare(expected, result) < maxError);
+
+			// edge values are a bit more than half of the values in the middle
+			Assert::AreEqual(static_cast<double>(expected.front()), static_cast<double>(result.front()), maxError);
+			Assert::AreEqual(static_cast<double>(expected.back()), static_cast<double>(result.back()), maxError);
+
+			const auto noise = generateNoise();
+			Assert::IsTrue(compare(convolve(noise, GaussianBlur::createKernel(radius)), run(noise, radius, method)) < maxError);
+		}
+	};
+}
@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+#include <random>
+
+#include "rxtd/filter_utils/BiquadCascade.h"
+#include "rxtd/filter_utils/BQFilterBuilder.h"
+#include "rxtd/filter_utils/LoudnessHistogram.h"
+#include "rxtd/std_fixes/MyMath.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace rxtd::test::filter_utils {
+	using namespace rxtd::filter_utils;
+
+	TEST_CLASS(LoudnessHistogram_test) {
+		static constexpr index sampleRate = 48000;
+
+		// stereo signal from a mono signal on both channels
+		static constexpr double channelsCount = 2.0;
+
+		struct Segment {
+			double seconds;
+			double dbfs;
+		};
+
+	public:
+		TEST_METHOD(KWeightingCoefficients) {
+			// BS.1770-4, table 1 and table 2
+			std::vector<BiquadCoefficients> sections;
+			double gain = 1.0;
+			BQFilterBuilder::createKWeightingShelf(48000.0).exportSections(sections, gain);
+			BQFilterBuilder::createKWeightingHighPass(48000.0).exportSections(sections, gain);
+
+			Assert::AreEqual(size_t{ 2 }, sections.size());
+			Assert::AreEqual(1.0, gain);
+
+			Assert::AreEqual(1.53512485958697, sections[0].b0, 1e-9);
+			Assert::AreEqual(-2.69169618940638, sections[0].b1, 1e-9);
+			Assert::AreEqual(1.19839281085285, sections[0].b2, 1e-9);
+			Assert::AreEqual(-1.69065929318241, sections[0].a1, 1e-9);
+			Assert::AreEqual(0.73248077421585, sections[0].a2, 1e-9);
+
+			Assert::AreEqual(1.0, sections[1].b0, 1e-9);
+			Assert::AreEqual(-2.0, sections[1].b1, 1e-9);
+			Assert::AreEqual(1.0, sections[1].b2, 1e-9);
+			Assert::AreEqual(-1.99004745483398, sections[1].a1, 1e-9);
+			Assert::AreEqual(0.99007225036621, sections[1].a2, 1e-9);
+		}
+
+		// EBU Tech 3341, minimum requirements test signals 1 to 5:
+		// stereo 1 kHz sine, integrated loudness must be within 0.1 LU
+
+		TEST_METHOD(Tech3341_Case1) {
+			Assert::AreEqual(-23.0, measureIntegrated({ { 20.0, -23.0 } }), 0.1);
+		}
+
+		TEST_METHOD(Tech3341_Case2) {
+			Assert::AreEqual(-33.0, measureIntegrated({ { 20.0, -33.0 } }), 0.1);
+		}
+
+		TEST_METHOD(Tech3341_Case3) {
+			Assert::AreEqual(-23.0, measureIntegrated({ { 10.0, -36.0 }, { 60.0, -23.0 }, { 10.0, -36.0 } }), 0.1);
+		}
+
+		TEST_METHOD(Tech3341_Case4) {
+			const double result = measureIntegrated(
+				{ { 10.0, -72.0 }, { 10.0, -36.0 }, { 60.0, -23.0 }, { 10.0, -36.0 }, { 10.0, -72.0 } }
+			);
+			Assert::AreEqual(-23.0, result, 0.1);
+		}
+
+		TEST_METHOD(Tech3341_Case5) {
+			Assert::AreEqual(-23.0, measureIntegrated({ { 20.0, -26.0 }, { 20.1, -20.0 }, { 20.0, -26.0 } }), 0.1);
+		}
+
+		TEST_METHOD(SlidingWindow) {
+			// random blocks with silence, compared with sorting all blocks in the window.
+			// Values and gates are far from bin edges, so quantization of the gate doesn't matter
+			const index windowSize = 50;
+			const index minCount = 10;
+
+			std::mt19937 random{ 42 };
+			std::uniform_real_distribution<double> distribution{ -80.0, 0.0 };
+
+			LoudnessHistogram histogram;
+			std::vector<double> window(static_cast<size_t>(windowSize), 0.0);
+			for (index i = 0; i < windowSize; i++) {
+				histogram.add(0.0);
+			}
+
+			for (index i = 0; i < 2000; i++) {
+				const double db = std::round(distribution(random) * 10.0) * 0.1 + 0.005;
+				const double energy = db < -70.0 ? 0.0 : std::pow(10.0, db / 10.0);
+
+				auto& slot = window[static_cast<size_t>(i % windowSize)];
+				histogram.remove(slot);
+				histogram.add(energy);
+				slot = energy;
+
+				for (const double gateDb : { -100.05, -40.05, -20.05, -5.05 }) {
+					const double gate = std::pow(10.0, gateDb / 10.0);
+					const auto expected = computeReference(window, gate, minCount);
+					const auto actual = histogram.getGated(gate, minCount);
+					Assert::AreEqual(expected.count, actual.count);
+					Assert::AreEqual(expected.sum, actual.sum, expected.sum * 1e-9 + 1e-15);
+				}
+
+				const auto all = histogram.getGated(0.0);
+				Assert::AreEqual(windowSize, all.count);
+			}
+		}
+
+	private:
+		static double energyToLufs(double energy) {
+			return -0.691 + 10.0 * std::log10(energy * channelsCount);
+		}
+
+		static double lufsToEnergy(double lufs) {
+			return std::pow(10.0, (lufs + 0.691) / 10.0) / channelsCount;
+		}
+
+		static std::vector<float> generateSine(const std::vector<Segment>& segments) {
+			std::vector<float> result;
+			double phase = 0.0;
+			const double phaseStep = 2.0 * std_fixes::MyMath::pi<double>() * 1000.0 / static_cast<double>(sampleRate);
+			for (const auto& segment : segments) {
+				const double amplitude = std::pow(10.0, segment.dbfs / 20.0);
+				const auto length = std::lround(segment.seconds * static_cast<double>(sampleRate));
+				for (index i = 0; i < length; i++) {
+					result.push_back(static_cast<float>(amplitude * std::sin(phase)));
+					phase += phaseStep;
+				}
+			}
+			return result;
+		}
+
+		// BS.1770 integrated loudness: 400 ms blocks with 75% overlap,
+		// absolute gate at -70 LUFS, relative gate at -10 LU
+		static double measureIntegrated(const std::vector<Segment>& segments) {
+			auto wave = generateSine(segments);
+
+			auto shelf = BQFilterBuilder::createKWeightingShelf(static_cast<double>(sampleRate));
+			auto highPass = BQFilterBuilder::createKWeightingHighPass(static_cast<double>(sampleRate));
+			shelf.apply(wave);
+			highPass.apply(wave);
+
+			std::vector<double> prefixSums{ 0.0 };
+			for (const float value : wave) {
+				prefixSums.push_back(prefixSums.back() + static_cast<double>(value) * value);
+			}
+
+			const index blockSize = sampleRate * 400 / 1000;
+			const index stepSize = blockSize / 4;
+
+			LoudnessHistogram histogram;
+			for (index begin = 0; begin + blockSize <= static_cast<index>(wave.size()); begin += stepSize) {
+				const double sum = prefixSums[static_cast<size_t>(begin + blockSize)] - prefixSums[static_cast<size_t>(begin)];
+				histogram.add(sum / static_cast<double>(blockSize));
+			}
+
+			const double absoluteGate = lufsToEnergy(-70.0);
+			const double relativeGate = histogram.getGated(absoluteGate).getMean() * 0.1;
+			return energyToLufs(histogram.getGated(std::max(absoluteGate, relativeGate)).getMean());
+		}
+
+		static LoudnessHistogram::Stats computeReference(std::vector<double> values, double gate, index minCount) {
+			std::sort(values.begin(), values.end(), std::greater<>());
+
+			LoudnessHistogram::Stats result;
+			for (const double value : values) {
+				if (value >= gate || result.count < minCount) {
+					result.count++;
+					result.sum += value;
+				}
+			}
+			return result;
+		}
+	};
+}
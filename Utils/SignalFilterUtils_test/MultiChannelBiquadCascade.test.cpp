@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+#include <random>
+
+#include "rxtd/filter_utils/BiquadCascade.h"
+#include "rxtd/filter_utils/MultiChannelBiquadCascade.h"
+#include "rxtd/filter_utils/butterworth_lib/ButterworthSos.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace rxtd::test::filter_utils {
+	using namespace rxtd::filter_utils;
+	using namespace rxtd::filter_utils::butterworth_lib;
+
+	TEST_CLASS(MultiChannelBiquadCascade_test) {
+	public:
+		TEST_METHOD(SameAsSingleChannel) {
+			// odd sections count checks both the paired and the last single section
+			const auto sections = ButterworthSos::bandPass(5, 100.0 / 24000.0, 3000.0 / 24000.0);
+			for (index channelsCount = 1; channelsCount <= MultiChannelBiquadCascade::maxChannels; channelsCount++) {
+				compare(sections, channelsCount);
+			}
+		}
+
+		TEST_METHOD(SameAsSingleChannel_EvenSections) {
+			compare(ButterworthSos::lowPass(4, 10000.0 / 24000.0), 6);
+		}
+
+		TEST_METHOD(InstructionSetsAreSame) {
+			const auto sections = ButterworthSos::bandPass(5, 100.0 / 24000.0, 3000.0 / 24000.0);
+			for (index channelsCount = 1; channelsCount <= MultiChannelBiquadCascade::maxChannels; channelsCount++) {
+				const auto expected = filterNoise(sections, channelsCount, InstructionSet::eSCALAR);
+				for (const auto set : { InstructionSet::eSSE, InstructionSet::eAVX }) {
+					if (!BlockKernels::isSupported(set)) {
+						continue;
+					}
+					Assert::IsTrue(MultiChannelBiquadCascade{ sections, 1.0, set }.getInstructionSet() == set);
+					// all sets do the same operations in the same order
+					Assert::IsTrue(expected == filterNoise(sections, channelsCount, set));
+				}
+			}
+		}
+
+		TEST_METHOD(ChannelsAreIndependent) {
+			MultiChannelBiquadCascade filter{ ButterworthSos::lowPass(3, 0.1), 1.0 };
+
+			std::vector<float> silent(1000);
+			std::vector<float> loud(1000);
+			loud[0] = 1.0f;
+
+			std::vector<array_span<float>> channels{ silent, loud, silent };
+			filter.apply(channels);
+
+			for (const float value : silent) {
+				Assert::AreEqual(0.0f, value);
+			}
+		}
+
+		TEST_METHOD(HasCoefficients) {
+			const auto sections = ButterworthSos::lowPass(3, 0.1);
+			const MultiChannelBiquadCascade filter{ sections, 0.5 };
+
+			Assert::IsTrue(filter.hasCoefficients(sections, 0.5));
+			Assert::IsFalse(filter.hasCoefficients(sections, 1.0));
+			Assert::IsFalse(filter.hasCoefficients(ButterworthSos::lowPass(3, 0.2), 0.5));
+			Assert::IsFalse(filter.hasCoefficients(ButterworthSos::lowPass(4, 0.1), 0.5));
+		}
+
+	private:
+		using InstructionSet = MultiChannelBiquadCascade::InstructionSet;
+
+		static std::vector<std::vector<float>> filterNoise(
+			const std::vector<BiquadCoefficients>& sections, index channelsCount, InstructionSet instructionSet
+		) {
+			MultiChannelBiquadCascade filter{ sections, 0.7, instructionSet };
+
+			std::mt19937 random{ 42 };
+			std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+			std::vector<std::vector<float>> data;
+			std::vector<array_span<float>> channels;
+			for (index channel = 0; channel < channelsCount; channel++) {
+				auto& wave = data.emplace_back(1000);
+				for (float& value : wave) {
+					value = distribution(random);
+				}
+			}
+			for (auto& wave : data) {
+				channels.emplace_back(wave);
+			}
+
+			filter.apply(channels);
+			return data;
+		}
+
+		static void compare(const std::vector<BiquadCoefficients>& sections, index channelsCount) {
+			constexpr double gainAmp = 0.7;
+			MultiChannelBiquadCascade multiFilter{ sections, gainAmp };
+			std::vector<BiquadCascade> singleFilters;
+			std::vector<std::vector<float>> multiData;
+			std::vector<std::vector<float>> singleData;
+
+			std::mt19937 random{ 42 };
+			std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+			for (index channel = 0; channel < channelsCount; channel++) {
+				singleFilters.emplace_back(sections, gainAmp);
+
+				std::vector<float> wave;
+				wave.resize(4800);
+				for (float& value : wave) {
+					value = distribution(random);
+				}
+				multiData.push_back(wave);
+				singleData.push_back(wave);
+			}
+
+			// several blocks of different size check that state is kept between calls
+			index offset = 0;
+			for (const index blockSize : { 480, 1, 0, 1024, 3295 }) {
+				std::vector<array_span<float>> blocks;
+				for (index channel = 0; channel < channelsCount; channel++) {
+					blocks.emplace_back(multiData[static_cast<size_t>(channel)].data() + offset, blockSize);
+					singleFilters[static_cast<size_t>(channel)].apply({ singleData[static_cast<size_t>(channel)].data() + offset, blockSize });
+				}
+				multiFilter.apply(blocks);
+				offset += blockSize;
+			}
+
+			for (index channel = 0; channel < channelsCount; channel++) {
+				const auto& expected = singleData[static_cast<size_t>(channel)];
+				const auto& actual = multiData[static_cast<size_t>(channel)];
+				for (index i = 0; i < static_cast<index>(expected.size()); i++) {
+					// SIMD code may be compiled with different contraction of multiply-add
+					Assert::AreEqual(expected[static_cast<size_t>(i)], actual[static_cast<size_t>(i)], 1e-4f);
+				}
+			}
+		}
+	};
+}
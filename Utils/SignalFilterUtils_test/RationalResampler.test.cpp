@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+
+#include "rxtd/filter_utils/RationalResampler.h"
+#include "rxtd/std_fixes/MyMath.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+using rxtd::std_fixes::MyMath;
+
+namespace rxtd::test::filter_utils {
+	using namespace rxtd::filter_utils;
+	TEST_CLASS(RationalResampler_test) {
+		static constexpr index chunkSize = 480;
+		static constexpr index outputSize = 8192;
+
+		struct Ratio {
+			index up;
+			index down;
+		};
+
+		// 48 -> 44.1, 44.1 -> 48, 48 -> 32, 192 -> 48, 192 -> 44.1
+		static constexpr std::array<Ratio, 5> ratios{ { { 147, 160 }, { 160, 147 }, { 2, 3 }, { 1, 4 }, { 147, 640 } } };
+
+	public:
+		TEST_METHOD(Passband_Snr) {
+			for (const auto ratio : ratios) {
+				for (const double frequencyRatio : { 0.05, 0.3, 0.6, 0.85 }) {
+					const double snr = measureSnrDb(ratio, frequencyRatio);
+					Assert::IsTrue(snr > 100.0);
+					Assert::AreEqual(0.0, getRmsDb(resampleSine(ratio, frequencyRatio, chunkSize)), 0.01);
+				}
+			}
+		}
+
+		TEST_METHOD(Stopband) {
+			for (const auto ratio : ratios) {
+				if (ratio.up > ratio.down) {
+					// upsampling doesn't have frequencies above new nyquist
+					continue;
+				}
+				const double maxFrequencyRatio = static_cast<double>(ratio.down) / static_cast<double>(ratio.up);
+				for (double frequencyRatio = 1.1; frequencyRatio < maxFrequencyRatio; frequencyRatio += 0.1) {
+					const auto output = resampleSine(ratio, frequencyRatio, chunkSize);
+					Assert::IsTrue(getRmsDb(output) < -85.0);
+				}
+			}
+		}
+
+		TEST_METHOD(OutputSize) {
+			for (const auto ratio : ratios) {
+				RationalResampler resampler;
+				resampler.setRatio(ratio.up, ratio.down);
+
+				std::vector<float> wave;
+				wave.resize(static_cast<size_t>(chunkSize + 5));
+
+				index total = 0;
+				index inputTotal = 0;
+				for (index i = 0; i < 50; i++) {
+					total += resampler.process(wave).size();
+					inputTotal += static_cast<index>(wave.size());
+				}
+
+				// first output sample is computed from the first input sample, so the count is rounded up
+				const index expected = (inputTotal * ratio.up + ratio.down - 1) / ratio.down;
+				Assert::AreEqual(expected, total);
+			}
+		}
+
+		TEST_METHOD(Result_DoesNotDependOnChunks) {
+			for (const auto ratio : ratios) {
+				const auto whole = resampleSine(ratio, 0.5, outputSize * 4);
+				const auto chunked = resampleSine(ratio, 0.5, 37);
+				Assert::IsTrue(whole == chunked);
+			}
+		}
+
+		TEST_METHOD(Ratio_IsReduced) {
+			RationalResampler resampler;
+			resampler.setRatio(44100, 48000);
+			Assert::AreEqual(index{ 147 }, resampler.getUp());
+			Assert::AreEqual(index{ 160 }, resampler.getDown());
+
+			resampler.setRatio(48000, 48000);
+			std::vector<float> wave{ 1.0f, 2.0f, 3.0f };
+			const auto result = resampler.process(wave);
+			Assert::IsTrue(result.data() == wave.data());
+		}
+
+	private:
+		// frequencyRatio is sine frequency relative to the lower of input and output nyquist frequencies
+		static double getInputFrequency(Ratio ratio, double frequencyRatio) {
+			const double minRateRatio = std::min(1.0, static_cast<double>(ratio.up) / static_cast<double>(ratio.down));
+			return frequencyRatio * 0.5 * minRateRatio;
+		}
+
+		static std::vector<float> resampleSine(Ratio ratio, double frequencyRatio, index chunk) {
+			RationalResampler resampler;
+			resampler.setRatio(ratio.up, ratio.down);
+
+			const double frequency = getInputFrequency(ratio, frequencyRatio);
+			const index inputSize = outputSize * ratio.down / ratio.up;
+
+			std::vector<float> wave;
+			std::vector<float> output;
+			for (index offset = 0; offset < inputSize; offset += chunk) {
+				wave.resize(static_cast<size_t>(std::min(chunk, inputSize - offset)));
+				for (index i = 0; i < static_cast<index>(wave.size()); i++) {
+					wave[static_cast<size_t>(i)] = static_cast<float>(std::sin(2.0 * MyMath::pi<double>() * frequency * static_cast<double>(offset + i)));
+				}
+
+				const auto result = resampler.process(wave);
+				output.insert(output.end(), result.begin(), result.end());
+			}
+
+			return output;
+		}
+
+		static double getRmsDb(const std::vector<float>& output) {
+			// skip filter warm up
+			double sum = 0.0;
+			const index begin = static_cast<index>(output.size()) / 4;
+			for (index i = begin; i < static_cast<index>(output.size()); i++) {
+				sum += static_cast<double>(output[static_cast<size_t>(i)]) * static_cast<double>(output[static_cast<size_t>(i)]);
+			}
+			const double rms = std::sqrt(sum / static_cast<double>(static_cast<index>(output.size()) - begin));
+
+			return 20.0 * std::log10(std::max(rms * std::sqrt(2.0), 1e-12));
+		}
+
+		// Output is compared with the best fitting sine of the expected frequency,
+		// so that filter delay doesn't matter.
+		static double measureSnrDb(Ratio ratio, double frequencyRatio) {
+			const auto output = resampleSine(ratio, frequencyRatio, chunkSize);
+			const double outputFrequency = getInputFrequency(ratio, frequencyRatio)
+				* static_cast<double>(ratio.down) / static_cast<double>(ratio.up);
+
+			const index begin = static_cast<index>(output.size()) / 4;
+			const index end = static_cast<index>(output.size());
+
+			// least squares fit of a * sin + b * cos
+			double ss = 0.0;
+			double sc = 0.0;
+			double cc = 0.0;
+			double ys = 0.0;
+			double yc = 0.0;
+			for (index i = begin; i < end; i++) {
+				const double phase = 2.0 * MyMath::pi<double>() * outputFrequency * static_cast<double>(i);
+				const double s = std::sin(phase);
+				const double c = std::cos(phase);
+				const auto y = static_cast<double>(output[static_cast<size_t>(i)]);
+				ss += s * s;
+				sc += s * c;
+				cc += c * c;
+				ys += y * s;
+				yc += y * c;
+			}
+			const double determinant = ss * cc - sc * sc;
+			const double a = (ys * cc - yc * sc) / determinant;
+			const double b = (yc * ss - ys * sc) / determinant;
+
+			double signal = 0.0;
+			double noise = 0.0;
+			for (index i = begin; i < end; i++) {
+				const double phase = 2.0 * MyMath::pi<double>() * outputFrequency * static_cast<double>(i);
+				const double fit = a * std::sin(phase) + b * std::cos(phase);
+				const double error = static_cast<double>(output[static_cast<size_t>(i)]) - fit;
+				signal += fit * fit;
+				noise += error * error;
+			}
+
+			return 10.0 * std::log10(signal / std::max(noise, 1e-30));
+		}
+	};
+}
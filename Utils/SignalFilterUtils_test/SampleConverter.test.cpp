@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include <CppUnitTest.h>
+#include <cstring>
+#include <random>
+
+#include "rxtd/filter_utils/SampleConverter.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace rxtd::test::filter_utils {
+	using namespace rxtd::filter_utils;
+
+	TEST_CLASS(SampleConverter_test) {
+		using InstructionSet = SampleConverter::InstructionSet;
+		using SampleType = SampleConverter::SampleType;
+
+		// specialized and generic channel counts, counts below and above the block size of vector code
+		static constexpr std::array<index, 10> channelCounts{ 1, 2, 3, 4, 5, 6, 7, 8, 12, 24 };
+		// tails of vectorized loops, and sizes that take several chunks
+		static constexpr std::array<index, 11> sizes{ 0, 1, 3, 4, 5, 7, 8, 9, 17, 1021, 4096 };
+		static constexpr std::array<SampleType, 4> types{ SampleType::eINT16, SampleType::eINT24, SampleType::eINT32, SampleType::eFLOAT32 };
+
+	public:
+		TEST_METHOD(FallbackIsSupported) {
+			Assert::IsTrue(SampleConverter::isSupported(SampleConverter::getBestInstructionSet()));
+			Assert::IsTrue(SampleConverter{}.getInstructionSet() == SampleConverter::getBestInstructionSet());
+
+			for (const auto set : { InstructionSet::eSCALAR, InstructionSet::eSSSE3, InstructionSet::eAVX2 }) {
+				Assert::IsTrue(SampleConverter::isSupported(SampleConverter{ set }.getInstructionSet()));
+			}
+		}
+
+		TEST_METHOD(KnownValues) {
+			const std::vector<uint8_t> int16Bytes{ 0x00, 0x80, 0x00, 0x00, 0x00, 0x40, 0xFF, 0x7F };
+			const std::vector<uint8_t> int24Bytes{ 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0xFF, 0xFF, 0xFF };
+			const std::vector<uint8_t> int32Bytes{ 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0xFF, 0xFF, 0xFF, 0xFF };
+
+			forEachSupported([&](const SampleConverter& converter) {
+				assertMono(converter, SampleType::eINT16, int16Bytes, { -1.0f, 0.0f, 0.5f, 32767.0f / 32768.0f });
+				assertMono(converter, SampleType::eINT24, int24Bytes, { -1.0f, 0.0f, 0.5f, -1.0f / 8388608.0f });
+				assertMono(converter, SampleType::eINT32, int32Bytes, { -1.0f, 0.0f, 0.5f, -1.0f / 2147483648.0f });
+			});
+		}
+
+		TEST_METHOD(SameAsPlainLoop) {
+			for (const auto type : types) {
+				for (const index channels : channelCounts) {
+					for (const index size : sizes) {
+						const auto source = generateRandom(type, channels * size, static_cast<unsigned>(channels * 1000 + size));
+						const auto expected = decodePlain(source, type, channels, size);
+
+						forEachSupported([&](const SampleConverter& converter) {
+							// results must be bit-exact, no matter how the samples were converted and split
+							Assert::IsTrue(expected == deinterleave(converter, source.data(), type, channels, size));
+						});
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(UnalignedSource) {
+			for (const auto type : types) {
+				for (const index channels : { index{ 2 }, index{ 6 }, index{ 8 } }) {
+					const index size = 1021;
+					const auto source = generateRandom(type, channels * size, 42);
+					const auto expected = decodePlain(source, type, channels, size);
+
+					std::vector<std::byte> shifted(source.size() + 1);
+					std::copy(source.begin(), source.end(), shifted.begin() + 1);
+
+					forEachSupported([&](const SampleConverter& converter) {
+						Assert::IsTrue(expected == deinterleave(converter, shifted.data() + 1, type, channels, size));
+					});
+				}
+			}
+		}
+
+	private:
+		template<typename Callback>
+		static void forEachSupported(Callback callback) {
+			for (const auto set : { InstructionSet::eSCALAR, InstructionSet::eSSSE3, InstructionSet::eAVX2 }) {
+				if (SampleConverter::isSupported(set)) {
+					callback(SampleConverter{ set });
+				}
+			}
+		}
+
+		static void assertMono(const SampleConverter& converter, SampleType type, const std::vector<uint8_t>& bytes, std::vector<float> expected) {
+			std_fixes::Vector2D<float> dest;
+			dest.setBuffersCount(1);
+			dest.setBufferSize(static_cast<index>(expected.size()));
+			converter.deinterleave(reinterpret_cast<const std::byte*>(bytes.data()), type, dest);
+
+			for (index i = 0; i < dest.getBufferSize(); i++) {
+				Assert::AreEqual(expected[static_cast<size_t>(i)], dest[0][i]);
+			}
+		}
+
+		static std::vector<std::vector<float>> deinterleave(
+			const SampleConverter& converter,
+			const std::byte* source, SampleType type, index channels, index size
+		) {
+			std_fixes::Vector2D<float> dest;
+			dest.setBuffersCount(channels);
+			dest.setBufferSize(size);
+			converter.deinterleave(source, type, dest);
+
+			std::vector<std::vector<float>> result;
+			for (index channel = 0; channel < channels; channel++) {
+				result.emplace_back(dest[channel].begin(), dest[channel].end());
+			}
+			return result;
+		}
+
+		// random bytes for integer samples, random values in [-1, 1] for floats, so that there are no NaNs
+		static std::vector<std::byte> generateRandom(SampleType type, index count, unsigned seed) {
+			std::mt19937 random{ seed };
+			std::vector<std::byte> result(static_cast<size_t>(count * SampleConverter::getSampleSize(type)));
+
+			if (type == SampleType::eFLOAT32) {
+				std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+				for (index i = 0; i < count; i++) {
+					const float value = distribution(random);
+					std::memcpy(result.data() + i * 4, &value, sizeof(value));
+				}
+				return result;
+			}
+
+			std::uniform_int_distribution<int> distribution{ 0, 255 };
+			for (auto& value : result) {
+				value = static_cast<std::byte>(distribution(random));
+			}
+			return result;
+		}
+
+		// sample by sample, like PcmFileSource used to decode files
+		static std::vector<std::vector<float>> decodePlain(const std::vector<std::byte>& source, SampleType type, index channels, index size) {
+			const index sampleSize = SampleConverter::getSampleSize(type);
+			std::vector<std::vector<float>> result(static_cast<size_t>(channels), std::vector<float>(static_cast<size_t>(size)));
+
+			for (index frame = 0; frame < size; frame++) {
+				for (index channel = 0; channel < channels; channel++) {
+					const std::byte* ptr = source.data() + (frame * channels + channel) * sampleSize;
+					result[static_cast<size_t>(channel)][static_cast<size_t>(frame)] = decodeSample(ptr, type);
+				}
+			}
+			return result;
+		}
+
+		static float decodeSample(const std::byte* ptr, SampleType type) {
+			switch (type) {
+			case SampleType::eINT16: {
+				int16_t value;
+				std::memcpy(&value, ptr, sizeof(value));
+				return static_cast<float>(value) / 32768.0f;
+			}
+			case SampleType::eINT24: {
+				const int32_t value = static_cast<int32_t>(
+					static_cast<uint32_t>(ptr[0]) << 8
+					| static_cast<uint32_t>(ptr[1]) << 16
+					| static_cast<uint32_t>(ptr[2]) << 24
+				) >> 8;
+				return static_cast<float>(value) / 8388608.0f;
+			}
+			case SampleType::eINT32: {
+				int32_t value;
+				std::memcpy(&value, ptr, sizeof(value));
+				return static_cast<float>(value) / 2147483648.0f;
+			}
+			case SampleType::eFLOAT32: {
+				float value;
+				std::memcpy(&value, ptr, sizeof(value));
+				return value;
+			}
+			}
+			return 0.0f;
+		}
+	};
+}
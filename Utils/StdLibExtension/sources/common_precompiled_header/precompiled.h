@@ -8,9 +8,13 @@
 
 #include <algorithm>
 #include <any>
+#include <array>
+#include <cmath>
 #include <cstdint>
 #include <cwctype>
+#include <functional>
 #include <map>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
@@ -56,6 +60,6 @@ namespace rxtd {
 template<typename T>
 std::optional<T> parseEnum(rxtd::isview) {
 	// ReSharper disable once CppStaticAssertFailure
-	static_assert(false, "Template specialization of parseEnum() must be created by user.");
+	static_assert(sizeof(T) == 0, "Template specialization of parseEnum() must be created by user.");
 	return {};
 }
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+
+namespace rxtd {
+	//
+	// Ring buffer with fixed capacity where any range of stored elements is contiguous in memory.
+	//
+	// Storage is twice as big as the capacity, and each element is written twice:
+	// at position p and at position p + capacity (or p - capacity).
+	// Thus a range that wraps around the end of the ring
+	// can be read from the second copy without any reordering.
+	//
+	template<typename T>
+	class MirroredRingBuffer {
+		std::vector<T> storage{};
+		index capacity = 0;
+		// position of the oldest element, always in [0, capacity)
+		index readPosition = 0;
+		index size = 0;
+
+	public:
+		// Clears the buffer
+		void setCapacity(index value) {
+			capacity = value;
+			storage.assign(static_cast<size_t>(capacity * 2), T{});
+			reset();
+		}
+
+		[[nodiscard]]
+		index getCapacity() const {
+			return capacity;
+		}
+
+		[[nodiscard]]
+		index getRemainingSize() const {
+			return size;
+		}
+
+		[[nodiscard]]
+		index getFreeSize() const {
+			return capacity - size;
+		}
+
+		// Returns memory for #chunkSize elements after the last element.
+		// Elements become part of the buffer after #commitNext.
+		// #chunkSize must not exceed #getFreeSize()
+		[[nodiscard]]
+		array_span<T> allocateNext(index chunkSize) {
+			return { storage.data() + getWritePosition(), chunkSize };
+		}
+
+		// Adds #chunkSize elements written into memory from #allocateNext
+		void commitNext(index chunkSize) {
+			const index writePosition = getWritePosition();
+			for (index i = writePosition; i < writePosition + chunkSize; i++) {
+				const index mirror = i < capacity ? i + capacity : i - capacity;
+				storage[static_cast<size_t>(mirror)] = storage[static_cast<size_t>(i)];
+			}
+			size += chunkSize;
+		}
+
+		// Returns #chunkSize elements starting from #offset-th oldest element,
+		// or empty view if buffer doesn't have enough elements
+		[[nodiscard]]
+		array_view<T> getView(index offset, index chunkSize) const {
+			if (offset + chunkSize > size) {
+				return {};
+			}
+			const index position = (readPosition + offset) % capacity;
+			return { storage.data() + position, chunkSize };
+		}
+
+		[[nodiscard]]
+		array_view<T> getFirst(index chunkSize) const {
+			return getView(0, chunkSize);
+		}
+
+		void removeFirst(index chunkSize) {
+			chunkSize = std::min(chunkSize, size);
+			readPosition = (readPosition + chunkSize) % capacity;
+			size -= chunkSize;
+		}
+
+		void reset() {
+			readPosition = 0;
+			size = 0;
+		}
+
+	private:
+		[[nodiscard]]
+		index getWritePosition() const {
+			return (readPosition + size) % capacity;
+		}
+	};
+}
@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "GenericBaseClasses.h"
+#include "SpscChannelRing.h"
+
+namespace rxtd {
+	/// <summary>
+	/// Same as SpscChannelRing, but each element is delivered to several readers.
+	/// Each reader has its own cursor, and reads and releases data independently of others.
+	///
+	/// Writer doesn't wait for readers that don't read:
+	/// reader that is too far behind is evicted, its data is overwritten,
+	/// and on its next read it skips to the newest data.
+	/// Reader can't be evicted between #beginRead() and #endRead(),
+	/// so writer can only be blocked for the time of one read.
+	///
+	/// Reader that is added later only sees data committed after it was added.
+	/// #addReader() and #removeReader() can be called while writer works,
+	/// but they must not be called concurrently with each other.
+	/// </summary>
+	template<typename T>
+	class SpmcChannelRing : NonMovableBase {
+	public:
+		static constexpr index maxReaders = 32;
+		static constexpr index noReader = -1;
+
+		using Parts = typename SpscChannelRing<T>::Parts;
+
+	private:
+		enum class CursorState {
+			eFREE,
+			eIDLE,
+			eREADING,
+			eEVICTED,
+		};
+
+		struct alignas(64) Cursor {
+			std::atomic<index> readCounter{ 0 };
+			std::atomic<CursorState> state{ CursorState::eFREE };
+		};
+
+		index channelsCount = 0;
+		index capacity = 0;
+		std::vector<T> buffer;
+
+		alignas(64) std::atomic<index> writeCounter{ 0 };
+		std::array<Cursor, maxReaders> cursors;
+
+	public:
+		/// <summary>
+		/// Discards all data and removes all readers.
+		/// Must not be called concurrently with anything else.
+		/// </summary>
+		void setParams(index _channelsCount, index _capacity) {
+			channelsCount = std::max<index>(_channelsCount, 0);
+			capacity = std::max<index>(_capacity, 1);
+			buffer.resize(static_cast<size_t>(channelsCount * capacity));
+			writeCounter.store(0, std::memory_order_relaxed);
+			for (auto& cursor : cursors) {
+				cursor.readCounter.store(0, std::memory_order_relaxed);
+				cursor.state.store(CursorState::eFREE, std::memory_order_relaxed);
+			}
+		}
+
+		[[nodiscard]]
+		index getChannelsCount() const {
+			return channelsCount;
+		}
+
+		[[nodiscard]]
+		index getCapacity() const {
+			return capacity;
+		}
+
+		/// <summary>
+		/// Returns id of the new reader, or #noReader if there are already #maxReaders readers.
+		/// </summary>
+		[[nodiscard]]
+		index addReader() {
+			for (index i = 0; i < maxReaders; i++) {
+				auto& cursor = cursors[static_cast<size_t>(i)];
+				if (cursor.state.load(std::memory_order_relaxed) != CursorState::eFREE) {
+					continue;
+				}
+
+				// Data between this position and the write position isn't committed yet,
+				// so even if writer has already decided how much to write without knowing about this reader,
+				// it can't overwrite anything that the reader can see
+				cursor.readCounter.store(writeCounter.load(std::memory_order_acquire), std::memory_order_relaxed);
+				cursor.state.store(CursorState::eIDLE, std::memory_order_release);
+				return i;
+			}
+			return noReader;
+		}
+
+		/// <summary>
+		/// Reader must not use the ring after this call.
+		/// Must not be called between #beginRead() and #endRead().
+		/// </summary>
+		void removeReader(index reader) {
+			cursors[static_cast<size_t>(reader)].state.store(CursorState::eFREE, std::memory_order_release);
+		}
+
+		/// <summary>
+		/// Evicts readers that don't leave enough space for #size elements,
+		/// and returns count of elements in each channel that can be written.
+		/// Result is less than #size only if #size is bigger than capacity,
+		/// or if some reader that is too far behind is reading right now.
+		/// Can only be called from writer thread.
+		/// </summary>
+		[[nodiscard]]
+		index reserve(index size) {
+			size = std::min(size, capacity);
+			const index write = writeCounter.load(std::memory_order_relaxed);
+			index used = 0;
+			for (auto& cursor : cursors) {
+				// seq_cst, together with #commit() and #beginRead():
+				// reader that leaves EVICTED state either is seen here, or sees the newest write position
+				auto state = cursor.state.load(std::memory_order_seq_cst);
+				if (state == CursorState::eFREE || state == CursorState::eEVICTED) {
+					continue;
+				}
+
+				// acquire: reader must be done with the data before writer overwrites it
+				index lag = write - cursor.readCounter.load(std::memory_order_acquire);
+
+				// Reader that is idle doesn't use any data, so its data can be overwritten.
+				// If it has just started reading, it needs its data, and the writer has to drop some.
+				if (lag + size > capacity
+					&& state == CursorState::eIDLE
+					&& cursor.state.compare_exchange_strong(state, CursorState::eEVICTED, std::memory_order_seq_cst)) {
+					// reader could have read everything and become IDLE again after its counter was loaded,
+					// then it is not behind, and must not lose anything
+					lag = write - cursor.readCounter.load(std::memory_order_acquire);
+					auto evicted = CursorState::eEVICTED;
+					if (lag + size > capacity
+						|| !cursor.state.compare_exchange_strong(evicted, CursorState::eIDLE, std::memory_order_seq_cst)) {
+						// if the reader has already left EVICTED state, it moves to the newest data
+						continue;
+					}
+				}
+				if (state == CursorState::eFREE) {
+					continue;
+				}
+
+				// reader that is leaving EVICTED state can briefly have a counter that is more than capacity behind
+				used = std::max(used, std::min(lag, capacity));
+			}
+			return std::min(size, capacity - used);
+		}
+
+		/// <summary>
+		/// See SpscChannelRing#write().
+		/// </summary>
+		void write(index channel, index offset, array_view<T> data) {
+			const index begin = (writeCounter.load(std::memory_order_relaxed) + offset) % capacity;
+			const index firstSize = std::min(data.size(), capacity - begin);
+			T* ring = getRing(channel);
+			std::copy(data.begin(), data.begin() + firstSize, ring + begin);
+			std::copy(data.begin() + firstSize, data.end(), ring);
+		}
+
+		/// <summary>
+		/// Makes #size written elements of each channel available for all readers.
+		/// Can only be called from writer thread.
+		/// </summary>
+		void commit(index size) {
+			writeCounter.store(writeCounter.load(std::memory_order_relaxed) + size, std::memory_order_seq_cst);
+		}
+
+		/// <summary>
+		/// Must be called before reader accesses any data.
+		/// If reader was evicted, moves it to the newest data,
+		/// and returns count of elements in each channel that the reader has missed.
+		/// Can only be called from the thread of the reader.
+		/// </summary>
+		[[nodiscard]]
+		index beginRead(index reader) {
+			auto& cursor = cursors[static_cast<size_t>(reader)];
+
+			// writer can move the reader from IDLE to EVICTED, and back, if it has evicted the reader by mistake
+			while (true) {
+				auto state = CursorState::eIDLE;
+				if (cursor.state.compare_exchange_strong(state, CursorState::eREADING, std::memory_order_seq_cst)) {
+					return 0;
+				}
+				state = CursorState::eEVICTED;
+				if (cursor.state.compare_exchange_strong(state, CursorState::eREADING, std::memory_order_seq_cst)) {
+					break;
+				}
+			}
+
+			// Reader is evicted, and writer skips it, so the counter can only be moved after the state is READING:
+			// otherwise writer could overwrite the new position before the reader has claimed it.
+			// Writer that has seen READING with the old counter only drops data until the new counter is stored.
+			const index oldPosition = cursor.readCounter.load(std::memory_order_relaxed);
+			const index newPosition = writeCounter.load(std::memory_order_seq_cst);
+			cursor.readCounter.store(newPosition, std::memory_order_release);
+			return newPosition - oldPosition;
+		}
+
+		/// <summary>
+		/// Marks #size oldest elements of each channel as read by the reader,
+		/// after this call reader must not access any data until next #beginRead().
+		/// Can only be called from the thread of the reader.
+		/// </summary>
+		void endRead(index reader, index size) {
+			auto& cursor = cursors[static_cast<size_t>(reader)];
+			cursor.readCounter.store(cursor.readCounter.load(std::memory_order_relaxed) + size, std::memory_order_release);
+			cursor.state.store(CursorState::eIDLE, std::memory_order_release);
+		}
+
+		/// <summary>
+		/// Count of elements in each channel that the reader can read.
+		/// Can only be called between #beginRead() and #endRead().
+		/// </summary>
+		[[nodiscard]]
+		index getAvailableSize(index reader) const {
+			const auto& cursor = cursors[static_cast<size_t>(reader)];
+			const index size = writeCounter.load(std::memory_order_acquire) - cursor.readCounter.load(std::memory_order_relaxed);
+			return std::min(size, capacity);
+		}
+
+		/// <summary>
+		/// Returns the oldest #size elements of the channel that the reader hasn't released.
+		/// Size must not be bigger than #getAvailableSize().
+		/// Can only be called between #beginRead() and #endRead().
+		/// </summary>
+		[[nodiscard]]
+		Parts read(index reader, index channel, index size) const {
+			const index begin = cursors[static_cast<size_t>(reader)].readCounter.load(std::memory_order_relaxed) % capacity;
+			const index firstSize = std::min(size, capacity - begin);
+			const T* ring = getRing(channel);
+			return {
+				array_view<T>{ ring + begin, firstSize },
+				array_view<T>{ ring, size - firstSize },
+			};
+		}
+
+	private:
+		[[nodiscard]]
+		T* getRing(index channel) {
+			return buffer.data() + channel * capacity;
+		}
+
+		[[nodiscard]]
+		const T* getRing(index channel) const {
+			return buffer.data() + channel * capacity;
+		}
+	};
+}
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include <atomic>
+#include <vector>
+
+#include "GenericBaseClasses.h"
+
+namespace rxtd {
+	/// <summary>
+	/// Passes a stream of multichannel data from one writer thread to one reader thread without locking.
+	/// Each channel has its own ring of #capacity elements,
+	/// all rings share the same read and write positions, so channels always stay in sync.
+	///
+	/// Writer fills uncommitted space of the rings with #write() and then makes it visible with #commit().
+	/// Reader takes views of available data with #read() and then returns the space to writer with #release().
+	/// Ring never overwrites data that reader hasn't released, so when it is full writer must drop something.
+	/// </summary>
+	template<typename T>
+	class SpscChannelRing : NonMovableBase {
+	public:
+		// data at the end of the ring is followed by data at the beginning of the ring
+		struct Parts {
+			array_view<T> first;
+			array_view<T> second;
+		};
+
+	private:
+		index channelsCount = 0;
+		index capacity = 0;
+		std::vector<T> buffer;
+
+		// count of elements in each channel that was ever written and read,
+		// positions in the rings are taken modulo capacity
+		alignas(64) std::atomic<index> writeCounter{ 0 };
+		alignas(64) std::atomic<index> readCounter{ 0 };
+
+	public:
+		/// <summary>
+		/// Discards all data.
+		/// Must not be called concurrently with anything else.
+		/// </summary>
+		void setParams(index _channelsCount, index _capacity) {
+			channelsCount = std::max<index>(_channelsCount, 0);
+			capacity = std::max<index>(_capacity, 1);
+			buffer.resize(static_cast<size_t>(channelsCount * capacity));
+			writeCounter.store(0, std::memory_order_relaxed);
+			readCounter.store(0, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]]
+		index getChannelsCount() const {
+			return channelsCount;
+		}
+
+		[[nodiscard]]
+		index getCapacity() const {
+			return capacity;
+		}
+
+		/// <summary>
+		/// Count of elements in each channel that can be written.
+		/// Can only be called from writer thread.
+		/// </summary>
+		[[nodiscard]]
+		index getFreeSize() const {
+			// acquire: reader must be done with the data before writer overwrites it
+			const index read = readCounter.load(std::memory_order_acquire);
+			return capacity - (writeCounter.load(std::memory_order_relaxed) - read);
+		}
+
+		/// <summary>
+		/// Copies data into the ring of the channel, #offset elements after the last committed element.
+		/// Caller must make sure that offset + data.size() is not bigger than #getFreeSize().
+		/// Can only be called from writer thread.
+		/// </summary>
+		void write(index channel, index offset, array_view<T> data) {
+			const index begin = (writeCounter.load(std::memory_order_relaxed) + offset) % capacity;
+			const index firstSize = std::min(data.size(), capacity - begin);
+			T* ring = getRing(channel);
+			std::copy(data.begin(), data.begin() + firstSize, ring + begin);
+			std::copy(data.begin() + firstSize, data.end(), ring);
+		}
+
+		/// <summary>
+		/// Makes #size written elements of each channel available for reader.
+		/// Can only be called from writer thread.
+		/// </summary>
+		void commit(index size) {
+			writeCounter.store(writeCounter.load(std::memory_order_relaxed) + size, std::memory_order_release);
+		}
+
+		/// <summary>
+		/// Count of elements in each channel that can be read.
+		/// Can only be called from reader thread.
+		/// </summary>
+		[[nodiscard]]
+		index getAvailableSize() const {
+			return writeCounter.load(std::memory_order_acquire) - readCounter.load(std::memory_order_relaxed);
+		}
+
+		/// <summary>
+		/// Returns the oldest #size unreleased elements of the channel.
+		/// Size must not be bigger than #getAvailableSize().
+		/// Can only be called from reader thread.
+		/// </summary>
+		[[nodiscard]]
+		Parts read(index channel, index size) const {
+			const index begin = readCounter.load(std::memory_order_relaxed) % capacity;
+			const index firstSize = std::min(size, capacity - begin);
+			const T* ring = getRing(channel);
+			return {
+				array_view<T>{ ring + begin, firstSize },
+				array_view<T>{ ring, size - firstSize },
+			};
+		}
+
+		/// <summary>
+		/// Gives #size oldest elements of each channel back to writer.
+		/// Can only be called from reader thread.
+		/// </summary>
+		void release(index size) {
+			readCounter.store(readCounter.load(std::memory_order_relaxed) + size, std::memory_order_release);
+		}
+
+	private:
+		[[nodiscard]]
+		T* getRing(index channel) {
+			return buffer.data() + channel * capacity;
+		}
+
+		[[nodiscard]]
+		const T* getRing(index channel) const {
+			return buffer.data() + channel * capacity;
+		}
+	};
+}
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "GenericBaseClasses.h"
+
+namespace rxtd {
+	/// <summary>
+	/// Passes the latest version of data from one writer thread to one reader thread without locking.
+	/// There are 3 preallocated buffers: one is owned by the writer, one by the reader,
+	/// and one is the latest published buffer that is waiting for the reader.
+	/// Publishing and acquiring only exchange buffer indices, so neither side ever waits for the other.
+	/// If the writer publishes several times between reads, reader only sees the last version.
+	///
+	/// Buffers are reused: after publish writer gets back whatever was in the buffer it received,
+	/// so writer must not assume anything about its contents.
+	/// </summary>
+	template<typename T>
+	class TripleBuffer : NonMovableBase {
+		static constexpr uint8_t indexMask = 0b011;
+		static constexpr uint8_t freshBit = 0b100;
+
+		std::array<T, 3> buffers{};
+
+		// index of the shared buffer + flag that reader hasn't seen it yet
+		alignas(64) std::atomic<uint8_t> shared{ 1 };
+		alignas(64) uint8_t writerIndex = 0;
+		alignas(64) uint8_t readerIndex = 2;
+
+	public:
+		/// <summary>
+		/// Can only be called from writer thread.
+		/// </summary>
+		[[nodiscard]]
+		T& getWriteBuffer() {
+			return buffers[writerIndex];
+		}
+
+		/// <summary>
+		/// Makes write buffer available for reader.
+		/// Can only be called from writer thread.
+		/// </summary>
+		void publish() {
+			const uint8_t previous = shared.exchange(static_cast<uint8_t>(writerIndex | freshBit), std::memory_order_acq_rel);
+			writerIndex = previous & indexMask;
+		}
+
+		/// <summary>
+		/// Makes the latest published buffer the read buffer.
+		/// Can only be called from reader thread.
+		/// </summary>
+		/// <returns>true if there was a new buffer, false if read buffer is still the latest one</returns>
+		bool acquire() {
+			if ((shared.load(std::memory_order_relaxed) & freshBit) == 0) {
+				return false;
+			}
+			const uint8_t previous = shared.exchange(readerIndex, std::memory_order_acq_rel);
+			readerIndex = previous & indexMask;
+			return true;
+		}
+
+		/// <summary>
+		/// Can only be called from reader thread.
+		/// </summary>
+		[[nodiscard]]
+		T& getReadBuffer() {
+			return buffers[readerIndex];
+		}
+	};
+}
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#include "CpuFeatures.h"
+
+#if defined(_MSC_VER) && defined(RXTD_X86)
+#include <intrin.h>
+#define RXTD_CPUID_MSVC
+#elif defined(RXTD_X86)
+#include <cpuid.h>
+#define RXTD_CPUID_GCC
+#endif
+
+using rxtd::std_fixes::CpuFeatures;
+
+namespace {
+#if defined(RXTD_CPUID_MSVC)
+	bool cpuidBit(int leaf, int registerIndex, int bit) {
+		int info[4];
+		__cpuidex(info, leaf, 0);
+		return (info[registerIndex] & (1 << bit)) != 0;
+	}
+#endif
+}
+
+const std::string& CpuFeatures::getBrandString() {
+	static const std::string result = [] {
+		std::array<unsigned, 12> brand{};
+#if defined(RXTD_CPUID_MSVC)
+		int info[4];
+		__cpuid(info, 0x80000000);
+		if (static_cast<unsigned>(info[0]) < 0x80000004) {
+			return std::string{};
+		}
+		for (int i = 0; i < 3; i++) {
+			__cpuid(info, 0x80000002 + i);
+			std::copy(std::begin(info), std::end(info), brand.begin() + i * 4);
+		}
+#elif defined(RXTD_CPUID_GCC)
+		if (__get_cpuid_max(0x80000000, nullptr) < 0x80000004) {
+			return std::string{};
+		}
+		for (unsigned i = 0; i < 3; i++) {
+			__get_cpuid(0x80000002 + i, &brand[i * 4], &brand[i * 4 + 1], &brand[i * 4 + 2], &brand[i * 4 + 3]);
+		}
+#else
+		return std::string{};
+#endif
+
+		std::string model{ reinterpret_cast<const char*>(brand.data()), sizeof(brand) };
+		return model.substr(0, model.find('\0'));
+	}();
+	return result;
+}
+
+const CpuFeatures::Flags& CpuFeatures::getFlags() {
+	static const Flags result = [] {
+		Flags flags;
+#if defined(RXTD_CPUID_MSVC)
+		flags.ssse3 = cpuidBit(1, 2, 9);
+
+		const bool osUsesXsave = cpuidBit(1, 2, 27);
+		const bool cpuHasAvx = cpuidBit(1, 2, 28);
+		// OS must save both SSE and AVX registers on context switch
+		flags.avx = osUsesXsave && cpuHasAvx && (_xgetbv(0) & 0b110) == 0b110;
+		int info[4];
+		__cpuid(info, 0);
+		const bool hasLeaf7 = info[0] >= 7;
+		flags.avx2 = flags.avx && hasLeaf7 && cpuidBit(7, 1, 5);
+#elif defined(RXTD_CPUID_GCC)
+		// GCC also checks that the OS saves AVX registers
+		flags.ssse3 = __builtin_cpu_supports("ssse3");
+		flags.avx = __builtin_cpu_supports("avx");
+		flags.avx2 = __builtin_cpu_supports("avx2");
+#endif
+		return flags;
+	}();
+	return result;
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright (C) 2021 Danil Uzlov
+
+#pragma once
+
+// x86 CPU with at least SSE2, which is the baseline for all vector kernels
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || (defined(__i386__) && defined(__SSE2__))
+#define RXTD_X86
+#include <immintrin.h>
+// Functions that use instructions above the baseline must be marked with these,
+// and must only be called when CpuFeatures says that they are supported.
+#if defined(_MSC_VER)
+// MSVC allows any intrinsics in any function
+#define RXTD_TARGET_SSSE3
+#define RXTD_TARGET_AVX
+#define RXTD_TARGET_AVX2
+#else
+#define RXTD_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define RXTD_TARGET_AVX __attribute__((target("avx")))
+#define RXTD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace rxtd::std_fixes {
+	/// <summary>
+	/// Instruction set extensions that both the CPU and the OS support.
+	/// CPU is only queried once per process.
+	/// All extensions are unsupported on CPUs other than x86.
+	/// </summary>
+	class CpuFeatures {
+	public:
+		[[nodiscard]]
+		static bool hasSsse3() {
+			return getFlags().ssse3;
+		}
+
+		[[nodiscard]]
+		static bool hasAvx() {
+			return getFlags().avx;
+		}
+
+		[[nodiscard]]
+		static bool hasAvx2() {
+			return getFlags().avx2;
+		}
+
+		/// <summary>
+		/// Processor brand string, or empty string if CPU doesn't report it.
+		/// </summary>
+		[[nodiscard]]
+		static const std::string& getBrandString();
+
+	private:
+		struct Flags {
+			bool ssse3 = false;
+			bool avx = false;
+			bool avx2 = false;
+		};
+
+		[[nodiscard]]
+		static const Flags& getFlags();
+	};
+}
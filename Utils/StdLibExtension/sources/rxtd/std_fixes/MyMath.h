@@ -60,13 +60,13 @@ namespace rxtd::std_fixes {
 		static TOut roundTo(TIn value) {
 			static_assert(std::is_integral<TOut>::value);
 
-			if constexpr (sizeof(TOut) == sizeof(long)) {
+			if constexpr (sizeof(TOut) <= sizeof(long)) {
 				return static_cast<TOut>(std::lround(value));
 			} else if constexpr (sizeof(TOut) == sizeof(long long)) {
 				return static_cast<TOut>(std::llround(value));
 			} else {
 				// ReSharper disable once CppStaticAssertFailure
-				static_assert(false);
+				static_assert(sizeof(TOut) == 0);
 				return {};
 			}
 		}
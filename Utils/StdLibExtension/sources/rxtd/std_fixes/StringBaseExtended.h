@@ -135,13 +135,13 @@ namespace rxtd::std_fixes {
 		[[nodiscard]]
 		constexpr bool startsWith(view_type prefix) const noexcept {
 			// from stackoverflow
-			return base::size() >= prefix.size() && 0 == compare(0, prefix.size(), prefix);
+			return base::size() >= prefix.size() && 0 == base::compare(0, prefix.size(), prefix);
 		}
 
 		[[nodiscard]]
 		constexpr bool endsWith(view_type suffix) const noexcept {
 			// from stackoverflow
-			return base::size() >= suffix.size() && 0 == compare(base::size() - suffix.size(), suffix.size(), suffix);
+			return base::size() >= suffix.size() && 0 == base::compare(base::size() - suffix.size(), suffix.size(), suffix);
 		}
 	};
 
@@ -258,13 +258,13 @@ namespace rxtd::std_fixes {
 		[[nodiscard]]
 		constexpr bool startsWith(view_type prefix) const noexcept {
 			// from stackoverflow
-			return base::size() >= prefix.size() && 0 == compare(0, prefix.size(), prefix);
+			return base::size() >= prefix.size() && 0 == base::compare(0, prefix.size(), prefix);
 		}
 
 		[[nodiscard]]
 		constexpr bool endsWith(view_type suffix) const noexcept {
 			// from stackoverflow
-			return base::size() >= suffix.size() && 0 == compare(base::size() - suffix.size(), suffix.size(), suffix);
+			return base::size() >= suffix.size() && 0 == base::compare(base::size() - suffix.size(), suffix.size(), suffix);
 		}
 	};
 
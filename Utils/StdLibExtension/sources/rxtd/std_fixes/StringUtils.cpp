@@ -3,7 +3,9 @@
 
 #include "StringUtils.h"
 
+#ifdef _WIN32
 #include "rxtd/my-windows.h"
+#endif
 
 using rxtd::std_fixes::SubstringViewInfo;
 using rxtd::std_fixes::StringUtils;
@@ -37,7 +39,11 @@ void StringUtils::makeUppercaseInPlace(sview str) {
 	// Hopefully this will require no more than 10-15 years.
 	auto* data = const_cast<wchar_t*>(str.data());
 
+#ifdef _WIN32
 	CharUpperBuffW(data, static_cast<DWORD>(str.length()));
+#else
+	std::transform(data, data + str.length(), data, [](wchar_t c) { return static_cast<wchar_t>(std::towupper(c)); });
+#endif
 }
 
 